@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "allocator.hpp"
+#include "scheduler.hpp"
+
+namespace {
+
+constexpr uint64_t kEvents = 1 << 18;
+constexpr unsigned kSteps = 1024;
+
+struct Payload {
+  uint64_t net;
+  uint64_t value;
+  uint64_t mask;
+  uint64_t tag;
+};
+
+struct Sink {
+  uint64_t sum = 0;
+};
+
+// Prototype style: each event owns a heap-allocated std::function whose
+// capture is too large for the small buffer, so two mallocs per event
+void BM_EventsHeapFunction(benchmark::State& f_state) {
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    Sink l_sink;
+    for (uint64_t l_idx = 0; l_idx < kEvents; ++l_idx) {
+      Payload l_payload{l_idx, l_idx * 3, ~uint64_t(0), l_idx % kSteps};
+      auto* l_fn = new std::function<void()>([l_payload, &l_sink] {
+        l_sink.sum += l_payload.value & l_payload.mask;
+      });
+      l_sched.schedule(
+          ghls::SimTime::fromTicks(1000 * (l_idx % kSteps)),
+          [](void*, uint64_t f_arg) {
+            auto* l_fn = reinterpret_cast<std::function<void()>*>(f_arg);
+            (*l_fn)();
+            delete l_fn;
+          },
+          nullptr, reinterpret_cast<uintptr_t>(l_fn));
+    }
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sink.sum);
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kEvents);
+}
+BENCHMARK(BM_EventsHeapFunction)->Unit(benchmark::kMillisecond);
+
+// Event nodes and payloads both from the scheduler's pools
+void BM_EventsPooledPayload(benchmark::State& f_state) {
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    Sink l_sink;
+    for (uint64_t l_idx = 0; l_idx < kEvents; ++l_idx) {
+      void* l_storage = l_sched.schedulePayload(
+          ghls::SimTime::fromTicks(1000 * (l_idx % kSteps)),
+          [](void* f_ctx, uint64_t f_arg) {
+            const Payload* l_payload = reinterpret_cast<const Payload*>(f_arg);
+            static_cast<Sink*>(f_ctx)->sum += l_payload->value & l_payload->mask;
+          },
+          &l_sink, sizeof(Payload));
+      *static_cast<Payload*>(l_storage) = Payload{l_idx, l_idx * 3, ~uint64_t(0), l_idx % kSteps};
+    }
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sink.sum);
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kEvents);
+}
+BENCHMARK(BM_EventsPooledPayload)->Unit(benchmark::kMillisecond);
+
+// Per-timestep scratch: a few growing vectors built and dropped every step
+template <typename MakeVector>
+void scratchSteps(benchmark::State& f_state, MakeVector f_make, ghls::Arena* f_arena) {
+  uint64_t l_sum = 0;
+  for (auto _ : f_state) {
+    for (unsigned l_step = 0; l_step < kSteps; ++l_step) {
+      for (unsigned l_vec = 0; l_vec < 8; ++l_vec) {
+        auto l_scratch = f_make();
+        for (unsigned l_idx = 0; l_idx < 64 + l_vec * 16; ++l_idx) {
+          l_scratch.push_back(l_idx ^ l_step);
+        }
+        l_sum += l_scratch.back();
+      }
+      if (f_arena != nullptr) {
+        f_arena->reset();
+      }
+    }
+  }
+  benchmark::DoNotOptimize(l_sum);
+  f_state.SetItemsProcessed(f_state.iterations() * kSteps * 8);
+}
+
+void BM_ScratchDefault(benchmark::State& f_state) {
+  scratchSteps(f_state, [] { return std::vector<uint32_t>(); }, nullptr);
+}
+BENCHMARK(BM_ScratchDefault);
+
+void BM_ScratchArena(benchmark::State& f_state) {
+  ghls::Arena l_arena;
+  scratchSteps(
+      f_state,
+      [&l_arena] {
+        return std::vector<uint32_t, ghls::ArenaAllocator<uint32_t>>(
+            ghls::ArenaAllocator<uint32_t>(l_arena));
+      },
+      &l_arena);
+}
+BENCHMARK(BM_ScratchArena);
+
+// Node containers: sensitivity-list style insert/erase churn
+void BM_ListDefault(benchmark::State& f_state) {
+  std::list<uint64_t> l_list;
+  uint64_t l_idx = 0;
+  for (auto _ : f_state) {
+    l_list.push_back(l_idx++);
+    if (l_list.size() > 1024) {
+      l_list.pop_front();
+    }
+  }
+  benchmark::DoNotOptimize(l_list.size());
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_ListDefault);
+
+void BM_ListPool(benchmark::State& f_state) {
+  ghls::FixedPool l_pool(32);
+  std::list<uint64_t, ghls::PoolAllocator<uint64_t>> l_list{
+      ghls::PoolAllocator<uint64_t>(l_pool)};
+  uint64_t l_idx = 0;
+  for (auto _ : f_state) {
+    l_list.push_back(l_idx++);
+    if (l_list.size() > 1024) {
+      l_list.pop_front();
+    }
+  }
+  benchmark::DoNotOptimize(l_list.size());
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_ListPool);
+
+}  // namespace
+
+BENCHMARK_MAIN();
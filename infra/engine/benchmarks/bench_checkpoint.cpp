@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "checkpoint.hpp"
+#include "netStore.hpp"
+
+namespace {
+
+// Net database of range(0) 64-bit nets with mostly repetitive values, plus a
+// queue of pending events
+struct World {
+  ghls::Scheduler sched;
+  ghls::NetStore nets;
+  ghls::Checkpointer cp;
+
+  explicit World(size_t f_nets) : cp(sched) {
+    std::mt19937_64 l_rng(1);
+    for (size_t l_idx = 0; l_idx < f_nets; ++l_idx) {
+      ghls::NetId l_net = nets.addNet(64, ghls::Logic::zero);
+      nets.writeValue(l_net, l_rng() % 16 == 0 ? l_rng() : l_idx & 0xff);
+    }
+    nets.commit(ghls::SimTime());
+    for (uint64_t l_idx = 0; l_idx < 10000; ++l_idx) {
+      sched.schedule(ghls::SimTime::fromTicks(l_idx * 997), onEvent, this, l_idx);
+    }
+    cp.addEvent("event", onEvent);
+    cp.addContext("world", this);
+    cp.addState("nets", nets);
+  }
+
+  static void onEvent(void*, uint64_t) {}
+};
+
+std::string snapshotPath() {
+  return (std::filesystem::temp_directory_path() / "ghls_bench_checkpoint.ghck").string();
+}
+
+// The simulation is blocked for the whole write
+void BM_SaveBlocking(benchmark::State& f_state) {
+  World l_world(f_state.range(0));
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_world.cp.save(snapshotPath()));
+  }
+  f_state.counters["file_MB"] = std::filesystem::file_size(snapshotPath()) / 1e6;
+}
+BENCHMARK(BM_SaveBlocking)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// The simulation only waits for fork(); the child writes in the background
+void BM_SaveForked(benchmark::State& f_state) {
+  World l_world(f_state.range(0));
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_world.cp.saveAsync(snapshotPath()));
+    f_state.PauseTiming();
+    l_world.cp.wait();
+    f_state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_SaveForked)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Restore(benchmark::State& f_state) {
+  World l_world(f_state.range(0));
+  l_world.cp.save(snapshotPath());
+  World l_target(f_state.range(0));
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_target.cp.restore(snapshotPath()));
+  }
+  std::remove(snapshotPath().c_str());
+}
+BENCHMARK(BM_Restore)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
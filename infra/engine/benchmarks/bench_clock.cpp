@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "clock.hpp"
+
+namespace {
+
+constexpr uint64_t kEdges = 1 << 20;
+
+// SoC-like mix of periods from 1 ns to ~40 ns on a 50 ps grid
+std::vector<ghls::Clock> makeClocks(size_t f_count) {
+  std::vector<ghls::Clock> l_clocks;
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    ghls::SimTime l_period = ghls::SimTime(50.0, ghls::SimTimeUnit::ps) * (20 + 17 * l_idx % 780);
+    l_clocks.emplace_back(l_period, ghls::SimTime::fromTicks(l_period.ticks() / 2));
+  }
+  return l_clocks;
+}
+
+// Previous approach: every edge recomputed as period * cycle and the next
+// domain found by scanning all of them
+void BM_MultiplyScan(benchmark::State& f_state) {
+  std::vector<ghls::Clock> l_clocks = makeClocks(static_cast<size_t>(f_state.range(0)));
+  for (auto _ : f_state) {
+    std::vector<uint64_t> l_halfCycles(l_clocks.size(), 0);
+    for (uint64_t l_edge = 0; l_edge < kEdges; ++l_edge) {
+      size_t l_best = 0;
+      ghls::SimTime l_bestTime;
+      for (size_t l_domain = 0; l_domain < l_clocks.size(); ++l_domain) {
+        const ghls::Clock& l_clk = l_clocks[l_domain];
+        uint64_t l_half = l_halfCycles[l_domain];
+        ghls::SimTime l_time = l_clk.period() * (l_half / 2) +
+                               (l_half % 2 == 1 ? l_clk.highTime() : ghls::SimTime());
+        if (l_domain == 0 || l_time < l_bestTime) {
+          l_best = l_domain;
+          l_bestTime = l_time;
+        }
+      }
+      ++l_halfCycles[l_best];
+      benchmark::DoNotOptimize(l_bestTime);
+    }
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kEdges);
+}
+BENCHMARK(BM_MultiplyScan)->Arg(4)->Arg(16)->Arg(64);
+
+void BM_ClockSet(benchmark::State& f_state) {
+  std::vector<ghls::Clock> l_clocks = makeClocks(static_cast<size_t>(f_state.range(0)));
+  for (auto _ : f_state) {
+    ghls::ClockSet l_set;
+    for (const ghls::Clock& l_clock : l_clocks) {
+      l_set.add(l_clock);
+    }
+    for (uint64_t l_edge = 0; l_edge < kEdges; ++l_edge) {
+      ghls::DomainEdge l_next = l_set.pop();
+      benchmark::DoNotOptimize(l_next);
+    }
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kEdges);
+}
+BENCHMARK(BM_ClockSet)->Arg(4)->Arg(16)->Arg(64);
+
+}  // namespace
+
+BENCHMARK_MAIN();
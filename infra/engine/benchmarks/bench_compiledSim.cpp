@@ -0,0 +1,179 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compiledSim.hpp"
+
+namespace {
+
+constexpr uint32_t kInputs = 64;
+constexpr uint32_t kFlops = 256;
+constexpr uint32_t kLevels = 40;
+constexpr uint32_t kGatesPerLevel = 200;
+constexpr uint64_t kCycles = 200;
+
+// Layered random design: every level reads the two previous levels (and the
+// inputs and flop outputs at the bottom), the last level drives the flops
+struct Design {
+  ghls::Netlist netlist;
+  std::vector<ghls::NetId> inputs;
+};
+
+const Design& design() {
+  static const Design s_design = [] {
+    Design l_design;
+    ghls::Netlist& l_nl = l_design.netlist;
+    std::mt19937 l_rng(7);
+    std::vector<ghls::NetId> l_prev;
+    for (uint32_t l_idx = 0; l_idx < kInputs; ++l_idx) {
+      l_design.inputs.push_back(l_nl.addNet(1, ghls::Logic::zero));
+      l_prev.push_back(l_design.inputs.back());
+    }
+    std::vector<ghls::NetId> l_qs;
+    for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+      l_qs.push_back(l_nl.addNet(1, ghls::Logic::zero));
+      l_prev.push_back(l_qs.back());
+    }
+    std::vector<ghls::NetId> l_before = l_prev;
+    for (uint32_t l_level = 0; l_level < kLevels; ++l_level) {
+      std::vector<ghls::NetId> l_cur;
+      for (uint32_t l_idx = 0; l_idx < kGatesPerLevel; ++l_idx) {
+        ghls::GateOp l_op = static_cast<ghls::GateOp>(l_rng() % 9);
+        auto l_pick = [&] {
+          const std::vector<ghls::NetId>& l_from = l_rng() % 4 == 0 ? l_before : l_prev;
+          return l_from[l_rng() % l_from.size()];
+        };
+        l_cur.push_back(l_nl.addNet());
+        l_nl.addGate(l_op, l_cur.back(), l_prev[l_rng() % l_prev.size()], l_pick(), l_pick());
+      }
+      l_before = std::move(l_prev);
+      l_prev = std::move(l_cur);
+    }
+    for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+      l_nl.addFlop(l_prev[l_idx % l_prev.size()], l_qs[l_idx]);
+    }
+    return l_design;
+  }();
+  return s_design;
+}
+
+// Runs kCycles clock cycles, changing a few inputs between edges. With
+// kNative the pass is the compiled native module, loaded from the cache (the
+// compile happens once before timing starts).
+template <typename Sim, bool kNative = false>
+void runCycles(benchmark::State& f_state) {
+  const Design& l_design = design();
+  const ghls::SimTime l_period(10.0, ghls::SimTimeUnit::ns);
+  if constexpr (kNative) {
+    ghls::Scheduler l_sched;
+    Sim l_sim(l_design.netlist, l_sched);
+    std::string l_error;
+    if (!l_sim.useNative({}, &l_error)) {
+      f_state.SkipWithError(l_error.c_str());
+      return;
+    }
+  }
+  uint64_t l_evals = 0;
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    Sim l_sim(l_design.netlist, l_sched);
+    if constexpr (kNative) {
+      l_sim.useNative();
+    }
+    l_sim.addClock(ghls::Clock(l_period, ghls::SimTime(5.0, ghls::SimTimeUnit::ns),
+                               l_period),
+                   0);
+    std::mt19937_64 l_rng(3);
+    for (uint64_t l_cycle = 1; l_cycle <= kCycles; ++l_cycle) {
+      l_sched.runUntil(l_period * l_cycle + ghls::SimTime(1.0, ghls::SimTimeUnit::ns));
+      for (int l_idx = 0; l_idx < 4; ++l_idx) {
+        l_sim.setInput(l_design.inputs[l_rng() % kInputs], {l_rng() & 1, 0});
+      }
+    }
+    l_sched.runUntil(l_period * (kCycles + 1));
+    l_evals += l_sim.gateEvaluations();
+    benchmark::DoNotOptimize(l_sim.value(0));
+  }
+  f_state.counters["cycles/s"] =
+      benchmark::Counter(double(kCycles) * f_state.iterations(), benchmark::Counter::kIsRate);
+  f_state.counters["gate_evals/cycle"] = double(l_evals) / (kCycles * f_state.iterations());
+}
+
+void BM_EventDriven(benchmark::State& f_state) { runCycles<ghls::EventSim>(f_state); }
+BENCHMARK(BM_EventDriven)->Unit(benchmark::kMillisecond);
+
+void BM_Compiled(benchmark::State& f_state) { runCycles<ghls::CompiledSim>(f_state); }
+BENCHMARK(BM_Compiled)->Unit(benchmark::kMillisecond);
+
+void BM_Native(benchmark::State& f_state) { runCycles<ghls::CompiledSim, true>(f_state); }
+BENCHMARK(BM_Native)->Unit(benchmark::kMillisecond);
+
+// Inputs pass through four-flop pipelines into a random cone with no
+// feedback, so the design settles a few cycles after its inputs stop
+const ghls::Netlist& pipelineDesign() {
+  static const ghls::Netlist s_netlist = [] {
+    ghls::Netlist l_nl;
+    std::mt19937 l_rng(9);
+    std::vector<ghls::NetId> l_prev;
+    for (uint32_t l_idx = 0; l_idx < kInputs; ++l_idx) {
+      ghls::NetId l_net = l_nl.addNet(1, ghls::Logic::zero);
+      for (int l_stage = 0; l_stage < 4; ++l_stage) {
+        ghls::NetId l_q = l_nl.addNet(1, ghls::Logic::zero);
+        l_nl.addFlop(l_net, l_q);
+        l_net = l_q;
+      }
+      l_prev.push_back(l_net);
+    }
+    for (uint32_t l_level = 0; l_level < kLevels; ++l_level) {
+      std::vector<ghls::NetId> l_cur;
+      for (uint32_t l_idx = 0; l_idx < kGatesPerLevel; ++l_idx) {
+        l_cur.push_back(l_nl.addNet());
+        l_nl.addGate(static_cast<ghls::GateOp>(l_rng() % 9), l_cur.back(),
+                     l_prev[l_rng() % l_prev.size()], l_prev[l_rng() % l_prev.size()],
+                     l_prev[l_rng() % l_prev.size()]);
+      }
+      l_prev = std::move(l_cur);
+    }
+    return l_nl;
+  }();
+  return s_netlist;
+}
+
+// Timer-bound test: 20 busy cycles, then 100k cycles of waiting, repeated.
+// range(0) turns fast-forward on.
+void BM_IdleBursts(benchmark::State& f_state) {
+  const ghls::Netlist& l_nl = pipelineDesign();
+  const ghls::SimTime l_period(10.0, ghls::SimTimeUnit::ns);
+  constexpr uint64_t kBursts = 5;
+  constexpr uint64_t kGap = 100000;
+  double l_skipped = 0;
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    ghls::CompiledSim l_sim(l_nl, l_sched);
+    l_sim.setFastForward(f_state.range(0) != 0);
+    l_sim.addClock(ghls::Clock(l_period, ghls::SimTime(5.0, ghls::SimTimeUnit::ns)), 0);
+    std::mt19937_64 l_rng(3);
+    for (uint64_t l_burst = 0; l_burst < kBursts; ++l_burst) {
+      for (uint64_t l_cycle = 0; l_cycle < 20; ++l_cycle) {
+        l_sched.runUntil(l_period * (l_burst * kGap + l_cycle) +
+                         ghls::SimTime(1.0, ghls::SimTimeUnit::ns));
+        l_sim.setInput(static_cast<ghls::NetId>(l_rng() % kInputs * 5), {l_rng() & 1, 0});
+      }
+    }
+    l_sched.runUntil(l_period * (kBursts * kGap));
+    l_skipped = l_sim.skippedTime().simTimeInNsec() / (l_period * (kBursts * kGap)).simTimeInNsec();
+    benchmark::DoNotOptimize(l_sim.value(0));
+  }
+  f_state.counters["sim_ms/s"] = benchmark::Counter(
+      (l_period * (kBursts * kGap)).simTimeInMsec() * f_state.iterations(),
+      benchmark::Counter::kIsRate);
+  f_state.counters["skipped"] = l_skipped;
+}
+BENCHMARK(BM_IdleBursts)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "injectionChannel.hpp"
+
+namespace {
+
+constexpr uint64_t kEvents = 1 << 18;
+constexpr size_t kBatch = 64;
+
+void onEvent(void* f_ctx, uint64_t f_arg) { *static_cast<uint64_t*>(f_ctx) += f_arg; }
+
+// Prototype style: producers push into a vector under a mutex, the
+// simulation thread swaps it out at each boundary
+struct LockedQueue {
+  std::mutex mutex;
+  std::vector<ghls::Injection> events;
+
+  void post(const ghls::Injection& f_event) {
+    std::lock_guard<std::mutex> l_lock(mutex);
+    events.push_back(f_event);
+  }
+  size_t drain(ghls::Scheduler& f_sched, std::vector<ghls::Injection>& f_scratch) {
+    {
+      std::lock_guard<std::mutex> l_lock(mutex);
+      f_scratch.swap(events);
+    }
+    for (const ghls::Injection& l_event : f_scratch) {
+      f_sched.scheduleAt(l_event.time, l_event.fn, l_event.ctx, l_event.arg);
+    }
+    size_t l_count = f_scratch.size();
+    f_scratch.clear();
+    return l_count;
+  }
+};
+
+// range(0) producers share kEvents; the calling thread drains until all
+// arrived, then runs the scheduler
+template <typename PostFn, typename DrainFn>
+void runProducers(benchmark::State& f_state, PostFn f_post, DrainFn f_drain) {
+  const unsigned l_producers = static_cast<unsigned>(f_state.range(0));
+  const uint64_t l_perProducer = kEvents / l_producers;
+  std::vector<std::thread> l_threads;
+  for (unsigned l_producer = 0; l_producer < l_producers; ++l_producer) {
+    l_threads.emplace_back([&f_post, l_producer, l_perProducer] {
+      f_post(l_producer, l_perProducer);
+    });
+  }
+  uint64_t l_received = 0;
+  while (l_received < l_perProducer * l_producers) {
+    size_t l_count = f_drain();
+    if (l_count == 0) {
+      std::this_thread::yield();
+    }
+    l_received += l_count;
+  }
+  for (std::thread& l_thread : l_threads) {
+    l_thread.join();
+  }
+}
+
+void BM_MutexQueue(benchmark::State& f_state) {
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    LockedQueue l_queue;
+    std::vector<ghls::Injection> l_scratch;
+    uint64_t l_sum = 0;
+    runProducers(
+        f_state,
+        [&](unsigned, uint64_t f_count) {
+          for (uint64_t l_idx = 0; l_idx < f_count; ++l_idx) {
+            l_queue.post({ghls::SimTime::fromTicks(l_idx), onEvent, &l_sum, 1});
+          }
+        },
+        [&] { return l_queue.drain(l_sched, l_scratch); });
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sum);
+  }
+  f_state.counters["events/s"] =
+      benchmark::Counter(double(kEvents) * f_state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MutexQueue)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Channel(benchmark::State& f_state) {
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    ghls::InjectionChannel l_channel(l_sched);
+    uint64_t l_sum = 0;
+    runProducers(
+        f_state,
+        [&](unsigned, uint64_t f_count) {
+          for (uint64_t l_idx = 0; l_idx < f_count; ++l_idx) {
+            l_channel.post({ghls::SimTime::fromTicks(l_idx), onEvent, &l_sum, 1});
+          }
+        },
+        [&] { return l_channel.drain(); });
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sum);
+    f_state.counters["stalls"] = double(l_channel.stalls());
+  }
+  f_state.counters["events/s"] =
+      benchmark::Counter(double(kEvents) * f_state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Channel)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_ChannelBatched(benchmark::State& f_state) {
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    ghls::InjectionChannel l_channel(l_sched);
+    uint64_t l_sum = 0;
+    runProducers(
+        f_state,
+        [&](unsigned, uint64_t f_count) {
+          ghls::Injection l_batch[kBatch];
+          for (uint64_t l_idx = 0; l_idx < f_count; l_idx += kBatch) {
+            size_t l_size = std::min<uint64_t>(kBatch, f_count - l_idx);
+            for (size_t l_item = 0; l_item < l_size; ++l_item) {
+              l_batch[l_item] = {ghls::SimTime::fromTicks(l_idx + l_item), onEvent, &l_sum, 1};
+            }
+            l_channel.post(l_batch, l_size);
+          }
+        },
+        [&] { return l_channel.drain(); });
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sum);
+  }
+  f_state.counters["events/s"] =
+      benchmark::Counter(double(kEvents) * f_state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ChannelBatched)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "compiledSim.hpp"
+#include "laneSim.hpp"
+
+namespace {
+
+constexpr uint32_t kInputs = 32;
+constexpr uint32_t kFlops = 128;
+constexpr uint32_t kLevels = 20;
+constexpr uint32_t kGatesPerLevel = 100;
+constexpr uint64_t kCycles = 100;
+constexpr size_t kVectors = 512;
+
+// Layered random design of 1-bit nets, the last level driving the flops
+struct Design {
+  ghls::Netlist netlist;
+  std::vector<ghls::NetId> inputs;
+};
+
+const Design& design() {
+  static const Design s_design = [] {
+    Design l_design;
+    ghls::Netlist& l_nl = l_design.netlist;
+    std::mt19937 l_rng(11);
+    std::vector<ghls::NetId> l_prev;
+    for (uint32_t l_idx = 0; l_idx < kInputs; ++l_idx) {
+      l_design.inputs.push_back(l_nl.addNet(1, ghls::Logic::zero));
+      l_prev.push_back(l_design.inputs.back());
+    }
+    std::vector<ghls::NetId> l_qs;
+    for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+      l_qs.push_back(l_nl.addNet(1, ghls::Logic::zero));
+      l_prev.push_back(l_qs.back());
+    }
+    for (uint32_t l_level = 0; l_level < kLevels; ++l_level) {
+      std::vector<ghls::NetId> l_cur;
+      for (uint32_t l_idx = 0; l_idx < kGatesPerLevel; ++l_idx) {
+        l_cur.push_back(l_nl.addNet());
+        l_nl.addGate(static_cast<ghls::GateOp>(l_rng() % 9), l_cur.back(),
+                     l_prev[l_rng() % l_prev.size()], l_prev[l_rng() % l_prev.size()],
+                     l_prev[l_rng() % l_prev.size()]);
+      }
+      l_prev = std::move(l_cur);
+    }
+    for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+      l_nl.addFlop(l_prev[l_idx % l_prev.size()], l_qs[l_idx]);
+    }
+    return l_design;
+  }();
+  return s_design;
+}
+
+const ghls::SimTime kPeriod(10.0, ghls::SimTimeUnit::ns);
+
+ghls::SimTime stimulusTime(uint64_t f_cycle) {
+  return kPeriod * f_cycle + ghls::SimTime(1.0, ghls::SimTimeUnit::ns);
+}
+
+ghls::Clock clock() { return ghls::Clock(kPeriod, ghls::SimTime(5.0, ghls::SimTimeUnit::ns)); }
+
+// Baseline: one compiled-mode run per stimulus vector
+void BM_SerialVectors(benchmark::State& f_state) {
+  const Design& l_design = design();
+  for (auto _ : f_state) {
+    for (size_t l_vector = 0; l_vector < kVectors; ++l_vector) {
+      ghls::Scheduler l_sched;
+      ghls::CompiledSim l_sim(l_design.netlist, l_sched);
+      l_sim.addClock(clock(), 0);
+      std::mt19937_64 l_rng(l_vector);
+      for (uint64_t l_cycle = 1; l_cycle <= kCycles; ++l_cycle) {
+        l_sched.runUntil(stimulusTime(l_cycle));
+        for (ghls::NetId l_input : l_design.inputs) {
+          l_sim.setInput(l_input, {l_rng() & 1, 0});
+        }
+      }
+      l_sched.runUntil(stimulusTime(kCycles + 1));
+      benchmark::DoNotOptimize(l_sim.value(0));
+    }
+  }
+  f_state.counters["vectors/s"] =
+      benchmark::Counter(double(kVectors) * f_state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SerialVectors)->Unit(benchmark::kMillisecond);
+
+// All vectors at once, range(0) lanes per run, stimulus injected a word of
+// 64 lanes at a time
+void BM_LaneVectors(benchmark::State& f_state) {
+  const Design& l_design = design();
+  const size_t l_lanes = f_state.range(0);
+  for (auto _ : f_state) {
+    for (size_t l_first = 0; l_first < kVectors; l_first += l_lanes) {
+      ghls::Scheduler l_sched;
+      ghls::LaneSim l_sim(l_design.netlist, l_sched, l_lanes);
+      l_sim.addClock(clock(), 0);
+      std::mt19937_64 l_rng(l_first);
+      for (uint64_t l_cycle = 1; l_cycle <= kCycles; ++l_cycle) {
+        l_sched.runUntil(stimulusTime(l_cycle));
+        for (ghls::NetId l_input : l_design.inputs) {
+          for (size_t l_word = 0; l_word < l_lanes / 64; ++l_word) {
+            l_sim.setLanes(l_input, 0, l_word, {l_rng(), 0});
+          }
+        }
+      }
+      l_sched.runUntil(stimulusTime(kCycles + 1));
+      benchmark::DoNotOptimize(l_sim.lanesOf(0, 0, 0));
+    }
+  }
+  f_state.counters["vectors/s"] =
+      benchmark::Counter(double(kVectors) * f_state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_LaneVectors)->Arg(64)->Arg(256)->Arg(512)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
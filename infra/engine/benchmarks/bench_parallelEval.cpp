@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "parallelEval.hpp"
+
+namespace {
+
+constexpr size_t kGates = 1 << 20;
+constexpr int kDeltas = 8;
+
+struct Gate {
+  ghls::NetId a;
+  ghls::NetId b;
+  ghls::NetId out;
+};
+
+// A little arithmetic per gate so evaluation, not the write-back, dominates
+void evalGate(void* f_ctx, ghls::EvalContext& f_eval) {
+  const Gate& l_gate = *static_cast<Gate*>(f_ctx);
+  uint64_t l_value = f_eval.nets().word(l_gate.a).aval ^ f_eval.nets().word(l_gate.b).aval;
+  for (int l_round = 0; l_round < 8; ++l_round) {
+    l_value = (l_value ^ (l_value >> 29)) * 0xbf58476d1ce4e5b9ULL;
+  }
+  f_eval.writeValue(l_gate.out, l_value);
+}
+
+// Gate network over 64-bit nets; every gate fires in every delta cycle
+struct Network {
+  ghls::NetStore nets;
+  std::vector<Gate> gates;
+  ghls::ParallelEvaluator eval;
+
+  explicit Network(unsigned f_threads) : gates(kGates), eval(nets, f_threads) {
+    for (size_t l_idx = 0; l_idx < kGates; ++l_idx) {
+      nets.addNet(64, ghls::Logic::zero);
+      nets.writeValue(static_cast<ghls::NetId>(l_idx), l_idx);
+    }
+    nets.commit(ghls::SimTime());
+    for (size_t l_idx = 0; l_idx < kGates; ++l_idx) {
+      gates[l_idx] = {static_cast<ghls::NetId>(l_idx),
+                      static_cast<ghls::NetId>((l_idx * 7919) % kGates),
+                      static_cast<ghls::NetId>((l_idx + 1) % kGates)};
+      eval.addProcess(evalGate, &gates[l_idx]);
+    }
+  }
+
+  void run() {
+    for (int l_delta = 0; l_delta < kDeltas; ++l_delta) {
+      for (size_t l_idx = 0; l_idx < kGates; ++l_idx) {
+        eval.markReady(static_cast<ghls::ProcessId>(l_idx));
+      }
+      eval.runDelta(ghls::SimTime(static_cast<double>(l_delta), ghls::SimTimeUnit::ns));
+    }
+  }
+
+  uint64_t hash() const {
+    uint64_t l_hash = 0;
+    for (size_t l_idx = 0; l_idx < kGates; ++l_idx) {
+      l_hash = l_hash * 31 + nets.word(static_cast<ghls::NetId>(l_idx)).aval;
+    }
+    return l_hash;
+  }
+};
+
+uint64_t serialHash() {
+  Network l_net(1);
+  l_net.run();
+  return l_net.hash();
+}
+
+void BM_ParallelDeltas(benchmark::State& f_state) {
+  static const uint64_t s_serialHash = serialHash();
+  const unsigned l_threads = static_cast<unsigned>(f_state.range(0));
+  for (auto _ : f_state) {
+    f_state.PauseTiming();
+    Network l_net(l_threads);
+    f_state.ResumeTiming();
+    l_net.run();
+    f_state.PauseTiming();
+    bool l_identical = l_net.hash() == s_serialHash;
+    f_state.ResumeTiming();
+    if (!l_identical) {
+      f_state.SkipWithError("parallel result differs from the serial run");
+      break;
+    }
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kGates * kDeltas);
+}
+BENCHMARK(BM_ParallelDeltas)
+    ->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
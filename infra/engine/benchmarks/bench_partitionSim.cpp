@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "partitionSim.hpp"
+
+namespace {
+
+constexpr uint32_t kParts = 8;
+constexpr uint32_t kNodesPerPart = 64;
+constexpr uint32_t kTokens = 4096;
+constexpr ghls::SimTick kLinkDelay = 1000;
+const ghls::SimTime kEnd = ghls::SimTime::fromTicks(200000);
+
+uint64_t mix(uint64_t f_value) {
+  f_value ^= f_value >> 33;
+  f_value *= 0xff51afd7ed558ccdULL;
+  f_value ^= f_value >> 33;
+  return f_value;
+}
+
+// PHOLD: every event spins on some work and forwards its token, mostly to a
+// node of the same partition and one time in four to another partition
+struct Phold {
+  ghls::PartitionedSim* pdes = nullptr;
+  ghls::Scheduler* sequential = nullptr;
+  uint32_t work = 0;
+  std::vector<uint64_t> state = std::vector<uint64_t>(kParts * kNodesPerPart, 0);
+
+  struct Target {
+    Phold* model;
+    uint32_t node;
+  };
+  std::vector<Target> targets;
+
+  Phold() {
+    for (uint32_t l_node = 0; l_node < state.size(); ++l_node) {
+      targets.push_back({this, l_node});
+    }
+  }
+
+  static void onToken(void* f_ctx, uint64_t f_token) {
+    Target* l_target = static_cast<Target*>(f_ctx);
+    Phold* l_model = l_target->model;
+    uint64_t l_acc = f_token;
+    for (uint32_t l_idx = 0; l_idx < l_model->work; ++l_idx) {
+      l_acc = mix(l_acc + l_idx);
+    }
+    l_model->state[l_target->node] += l_acc;
+
+    uint32_t l_part = l_target->node / kNodesPerPart;
+    uint64_t l_hash = mix(f_token);
+    uint32_t l_toPart = (l_hash & 3) == 0 ? static_cast<uint32_t>((l_hash >> 8) % kParts) : l_part;
+    uint32_t l_to =
+        l_toPart * kNodesPerPart + static_cast<uint32_t>((l_hash >> 16) % kNodesPerPart);
+    ghls::SimTime l_delay = ghls::SimTime::fromTicks(kLinkDelay + (l_hash >> 40) % 4000);
+    if (l_model->pdes != nullptr) {
+      l_model->pdes->send(l_part, l_toPart, l_delay, onToken, &l_model->targets[l_to], l_hash);
+    } else {
+      l_model->sequential->schedule(l_delay, onToken, &l_model->targets[l_to], l_hash);
+    }
+  }
+};
+
+void BM_Sequential(benchmark::State& f_state) {
+  uint64_t l_events = 0;
+  for (auto _ : f_state) {
+    Phold l_model;
+    l_model.work = static_cast<uint32_t>(f_state.range(0));
+    ghls::Scheduler l_sched;
+    l_model.sequential = &l_sched;
+    for (uint32_t l_token = 0; l_token < kTokens; ++l_token) {
+      l_sched.schedule(ghls::SimTime::fromTicks(l_token % 1000), Phold::onToken,
+                       &l_model.targets[l_token % l_model.targets.size()], l_token + 1);
+    }
+    l_sched.runUntil(kEnd);
+    l_events += l_sched.eventsExecuted();
+  }
+  f_state.counters["events/s"] = benchmark::Counter(double(l_events), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Sequential)->Arg(0)->Arg(200)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// range(0) work per event, range(1) threads
+void BM_Partitioned(benchmark::State& f_state) {
+  uint64_t l_events = 0;
+  uint64_t l_windows = 0;
+  for (auto _ : f_state) {
+    Phold l_model;
+    l_model.work = static_cast<uint32_t>(f_state.range(0));
+    ghls::PartitionedSim l_sim(kParts, static_cast<unsigned>(f_state.range(1)));
+    for (uint32_t l_from = 0; l_from < kParts; ++l_from) {
+      for (uint32_t l_to = 0; l_to < kParts; ++l_to) {
+        if (l_from != l_to) {
+          l_sim.link(l_from, l_to, ghls::SimTime::fromTicks(kLinkDelay));
+        }
+      }
+    }
+    l_model.pdes = &l_sim;
+    for (uint32_t l_token = 0; l_token < kTokens; ++l_token) {
+      uint32_t l_node = l_token % l_model.targets.size();
+      l_sim.scheduler(l_node / kNodesPerPart)
+          .schedule(ghls::SimTime::fromTicks(l_token % 1000), Phold::onToken,
+                    &l_model.targets[l_node], l_token + 1);
+    }
+    l_sim.runUntil(kEnd);
+    l_events += l_sim.eventsExecuted();
+    l_windows += l_sim.windows();
+  }
+  f_state.counters["events/s"] = benchmark::Counter(double(l_events), benchmark::Counter::kIsRate);
+  f_state.counters["windows"] = double(l_windows) / f_state.iterations();
+}
+BENCHMARK(BM_Partitioned)
+    ->ArgsProduct({{0, 200}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
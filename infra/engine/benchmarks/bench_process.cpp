@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "process.hpp"
+
+namespace {
+
+constexpr uint64_t kSteps = 20;
+
+ghls::SimTime periodOf(uint64_t f_proc) {
+  // Spread over a few periods so timesteps hold many, but not all, processes
+  return ghls::SimTime::fromTicks(1000 + (f_proc % 7) * 100);
+}
+
+// Hand-written state machine: the callback reschedules itself until done
+struct CallbackProc {
+  ghls::Scheduler* sched;
+  ghls::SimTime period;
+  uint64_t remaining;
+  uint64_t work;
+};
+
+void onWake(void* f_ctx, uint64_t) {
+  auto* l_proc = static_cast<CallbackProc*>(f_ctx);
+  l_proc->work += l_proc->remaining;
+  if (--l_proc->remaining != 0) {
+    l_proc->sched->schedule(l_proc->period, onWake, l_proc);
+  }
+}
+
+ghls::Process delayLoop(ghls::SimTime f_period, uint64_t& f_work) {
+  for (uint64_t l_left = kSteps; l_left != 0; --l_left) {
+    co_await ghls::delay(f_period);
+    f_work += l_left;
+  }
+}
+
+// range(0) processes each waking kSteps times
+void BM_CallbackDelay(benchmark::State& f_state) {
+  const uint64_t l_count = static_cast<uint64_t>(f_state.range(0));
+  std::vector<CallbackProc> l_procs(l_count);
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    for (uint64_t l_idx = 0; l_idx < l_count; ++l_idx) {
+      l_procs[l_idx] = {&l_sched, periodOf(l_idx), kSteps, 0};
+      l_sched.schedule(l_procs[l_idx].period, onWake, &l_procs[l_idx]);
+    }
+    l_sched.run();
+    benchmark::DoNotOptimize(l_procs.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * l_count * kSteps);
+}
+BENCHMARK(BM_CallbackDelay)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Same workload as coroutine processes; includes creating the frames
+void BM_CoroutineDelay(benchmark::State& f_state) {
+  const uint64_t l_count = static_cast<uint64_t>(f_state.range(0));
+  std::vector<uint64_t> l_work(l_count);
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    ghls::ProcessGroup l_group(l_sched);
+    for (uint64_t l_idx = 0; l_idx < l_count; ++l_idx) {
+      l_group.spawn(delayLoop(periodOf(l_idx), l_work[l_idx]));
+    }
+    l_sched.run();
+    benchmark::DoNotOptimize(l_work.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * l_count * kSteps);
+}
+BENCHMARK(BM_CoroutineDelay)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+ghls::Process clockGen(ghls::Signal& f_clk, uint64_t f_cycles) {
+  for (uint64_t l_idx = 0; l_idx < f_cycles; ++l_idx) {
+    f_clk.writeValue(1);
+    co_await ghls::delay(ghls::SimTime::fromTicks(500));
+    f_clk.writeValue(0);
+    co_await ghls::delay(ghls::SimTime::fromTicks(500));
+  }
+}
+
+ghls::Process clocked(ghls::Signal& f_clk, uint64_t& f_work) {
+  for (;;) {
+    co_await ghls::posedge(f_clk);
+    ++f_work;
+  }
+}
+
+// range(0) processes all waiting on the rising edge of one clock signal
+void BM_CoroutinePosedge(benchmark::State& f_state) {
+  const uint64_t l_count = static_cast<uint64_t>(f_state.range(0));
+  std::vector<uint64_t> l_work(l_count);
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    ghls::Signal l_clk(l_sched, {0, 0});
+    ghls::ProcessGroup l_group(l_sched);
+    for (uint64_t l_idx = 0; l_idx < l_count; ++l_idx) {
+      l_group.spawn(clocked(l_clk, l_work[l_idx]));
+    }
+    l_group.spawn(clockGen(l_clk, kSteps));
+    l_sched.run();
+    benchmark::DoNotOptimize(l_work.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * l_count * kSteps);
+}
+BENCHMARK(BM_CoroutinePosedge)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
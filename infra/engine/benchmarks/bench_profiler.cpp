@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "profiler.hpp"
+
+namespace {
+
+constexpr uint64_t kEvents = 4000000;
+constexpr ghls::SimTick kNearStep = ghls::SimTime(10.0, ghls::SimTimeUnit::ps).ticks();
+
+// Processes rescheduling themselves on a 10 ps grid with a zero-delay
+// follow-up every eighth event, so timesteps carry a few delta cycles
+struct Workload {
+  ghls::Scheduler* sched;
+  uint64_t remaining;
+  uint64_t rng;
+};
+
+void fire(void* f_ctx, uint64_t f_arg) {
+  auto* l_work = static_cast<Workload*>(f_ctx);
+  if (l_work->remaining == 0) {
+    return;
+  }
+  --l_work->remaining;
+  l_work->rng = l_work->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+  uint64_t l_bits = l_work->rng >> 33;
+  if ((l_bits & 7) == 0) {
+    l_work->sched->scheduleDelta(fire, l_work, f_arg);
+  } else {
+    l_work->sched->schedule(ghls::SimTime::fromTicks((l_bits % 100) * kNearStep), fire, l_work,
+                            f_arg);
+  }
+}
+
+// range(0): 0 without a profiler, 1 with one constructed but disabled,
+// 2 with it enabled
+void BM_ProfilerOverhead(benchmark::State& f_state) {
+  const int l_mode = static_cast<int>(f_state.range(0));
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    ghls::Profiler l_profiler(l_sched);
+    if (l_mode == 2) {
+      l_profiler.enable();
+    }
+    Workload l_work{&l_sched, kEvents, 42};
+    for (uint64_t l_proc = 0; l_proc < 4096; ++l_proc) {
+      l_sched.schedule(ghls::SimTime::fromTicks(l_proc % 100 * kNearStep), fire, &l_work,
+                       l_proc);
+    }
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sched.now());
+    if (l_mode != 0) {
+      benchmark::DoNotOptimize(l_profiler.eventsPerStep().sum());
+    }
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kEvents);
+}
+BENCHMARK(BM_ProfilerOverhead)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
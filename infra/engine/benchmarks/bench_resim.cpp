@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "resim.hpp"
+
+namespace {
+
+constexpr uint32_t kInputs = 16;
+constexpr uint32_t kFlops = 64;
+constexpr uint32_t kLevels = 10;
+constexpr uint32_t kGatesPerLevel = 100;
+constexpr uint64_t kCycles = 20000;
+constexpr uint64_t kWindowCycles = 500;
+
+const ghls::SimTime kPeriod(10.0, ghls::SimTimeUnit::ns);
+
+// Layered random design, as in bench_compiledSim but smaller
+struct Design {
+  ghls::Netlist netlist;
+  std::vector<ghls::NetId> inputs;
+  std::vector<ghls::Stimulus> stimulus;
+};
+
+const Design& design() {
+  static const Design s_design = [] {
+    Design l_design;
+    ghls::Netlist& l_nl = l_design.netlist;
+    std::mt19937 l_rng(5);
+    std::vector<ghls::NetId> l_prev;
+    for (uint32_t l_idx = 0; l_idx < kInputs; ++l_idx) {
+      l_design.inputs.push_back(l_nl.addNet(1, ghls::Logic::zero));
+      l_prev.push_back(l_design.inputs.back());
+    }
+    std::vector<ghls::NetId> l_qs;
+    for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+      l_qs.push_back(l_nl.addNet(1, ghls::Logic::zero));
+      l_prev.push_back(l_qs.back());
+    }
+    for (uint32_t l_level = 0; l_level < kLevels; ++l_level) {
+      std::vector<ghls::NetId> l_cur;
+      for (uint32_t l_idx = 0; l_idx < kGatesPerLevel; ++l_idx) {
+        ghls::GateOp l_op = static_cast<ghls::GateOp>(l_rng() % 9);
+        l_cur.push_back(l_nl.addNet());
+        l_nl.addGate(l_op, l_cur.back(), l_prev[l_rng() % l_prev.size()],
+                     l_prev[l_rng() % l_prev.size()], l_prev[l_rng() % l_prev.size()]);
+      }
+      l_prev = std::move(l_cur);
+    }
+    for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+      l_nl.addFlop(l_prev[l_idx % l_prev.size()], l_qs[l_idx]);
+    }
+    // Two inputs change between edges every cycle
+    for (uint64_t l_cycle = 0; l_cycle < kCycles; ++l_cycle) {
+      for (int l_idx = 0; l_idx < 2; ++l_idx) {
+        l_design.stimulus.push_back({kPeriod * l_cycle + ghls::SimTime(1.0, ghls::SimTimeUnit::ns),
+                                     l_design.inputs[l_rng() % kInputs],
+                                     {l_rng() & 1, 0}});
+      }
+    }
+    return l_design;
+  }();
+  return s_design;
+}
+
+std::string benchDir() {
+  std::filesystem::path l_dir = std::filesystem::temp_directory_path() / "ghls_bench_resim";
+  std::filesystem::create_directories(l_dir);
+  return l_dir.string();
+}
+
+std::unique_ptr<ghls::Resim> makeResim(const Design& f_design) {
+  auto l_resim = std::make_unique<ghls::Resim>(f_design.netlist, kPeriod * kWindowCycles,
+                                               benchDir());
+  l_resim->addClock(ghls::Clock(kPeriod, ghls::SimTime(5.0, ghls::SimTimeUnit::ns),
+                                ghls::SimTime(5.0, ghls::SimTimeUnit::ns)),
+                    0);
+  for (uint32_t l_idx = 0; l_idx < kFlops; ++l_idx) {
+    l_resim->watch(f_design.inputs.size() + l_idx);
+  }
+  l_resim->setStimulus(f_design.stimulus);
+  return l_resim;
+}
+
+// Every debug iteration simulating the whole test again
+void BM_FullRun(benchmark::State& f_state) {
+  const Design& l_design = design();
+  for (auto _ : f_state) {
+    std::unique_ptr<ghls::Resim> l_resim = makeResim(l_design);
+    l_resim->run(kPeriod * kCycles);
+    benchmark::DoNotOptimize(l_resim->sim().value(0));
+  }
+  f_state.counters["cycles/s"] =
+      benchmark::Counter(double(kCycles) * f_state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FullRun)->Unit(benchmark::kMillisecond);
+
+// Stimulus edited at range(0) percent of the run, then brought up to date
+void BM_Rerun(benchmark::State& f_state) {
+  const Design& l_design = design();
+  std::unique_ptr<ghls::Resim> l_resim = makeResim(l_design);
+  l_resim->run(kPeriod * kCycles);
+  std::vector<ghls::Stimulus> l_stimulus = l_design.stimulus;
+  size_t l_edit = l_stimulus.size() * f_state.range(0) / 100;
+  uint64_t l_simulated = 0;
+  for (auto _ : f_state) {
+    l_stimulus[l_edit].value.aval ^= 1;
+    l_resim->setStimulus(l_stimulus);
+    l_resim->rerun();
+    l_simulated += l_resim->windowsSimulated();
+  }
+  f_state.counters["windows/rerun"] = double(l_simulated) / f_state.iterations();
+}
+BENCHMARK(BM_Rerun)->Arg(10)->Arg(50)->Arg(90)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
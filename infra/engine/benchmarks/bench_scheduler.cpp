@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "scheduler.hpp"
+
+namespace {
+
+constexpr uint64_t kEvents = 20000000;
+
+// Each process reschedules itself with a gate-like delay on a 10 ps grid and
+// occasionally parks on a far-future timeout, until the event budget is spent
+constexpr ghls::SimTick kNearStep = ghls::SimTime(10.0, ghls::SimTimeUnit::ps).ticks();
+constexpr ghls::SimTick kFarStep = ghls::SimTime(1.0, ghls::SimTimeUnit::us).ticks();
+
+struct Workload {
+  ghls::Scheduler* sched;
+  uint64_t remaining;
+  uint64_t rng;
+
+  ghls::SimTime nextDelay() {
+    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t l_bits = rng >> 33;
+    if ((l_bits & 4095) == 0) {
+      return ghls::SimTime::fromTicks((l_bits % 10) * kFarStep);
+    }
+    return ghls::SimTime::fromTicks((l_bits % 100) * kNearStep);
+  }
+};
+
+void fire(void* f_ctx, uint64_t f_arg) {
+  auto* l_work = static_cast<Workload*>(f_ctx);
+  if (l_work->remaining > 0) {
+    --l_work->remaining;
+    l_work->sched->schedule(l_work->nextDelay(), fire, l_work, f_arg);
+  }
+}
+
+void BM_SchedulerEvents(benchmark::State& f_state) {
+  const uint64_t l_processes = static_cast<uint64_t>(f_state.range(0));
+  const uint64_t l_events = kEvents;
+  for (auto _ : f_state) {
+    ghls::Scheduler l_sched;
+    Workload l_work{&l_sched, l_events, 42};
+    for (uint64_t l_proc = 0; l_proc < l_processes; ++l_proc) {
+      l_sched.schedule(l_work.nextDelay(), fire, &l_work, l_proc);
+    }
+    l_sched.run();
+    benchmark::DoNotOptimize(l_sched.now());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * l_events);
+}
+BENCHMARK(BM_SchedulerEvents)->Arg(1024)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+// Reference: a std::priority_queue keyed on time and insertion order
+struct QueuedEvent {
+  ghls::SimTick time;
+  uint64_t seq;
+  uint64_t proc;
+  bool operator>(const QueuedEvent& f_rhs) const {
+    return time != f_rhs.time ? time > f_rhs.time : seq > f_rhs.seq;
+  }
+};
+
+void BM_PriorityQueueEvents(benchmark::State& f_state) {
+  const uint64_t l_processes = static_cast<uint64_t>(f_state.range(0));
+  const uint64_t l_events = kEvents;
+  for (auto _ : f_state) {
+    std::priority_queue<QueuedEvent, std::vector<QueuedEvent>, std::greater<QueuedEvent>> l_queue;
+    Workload l_work{nullptr, l_events, 42};
+    uint64_t l_seq = 0;
+    for (uint64_t l_proc = 0; l_proc < l_processes; ++l_proc) {
+      l_queue.push({l_work.nextDelay().ticks(), l_seq++, l_proc});
+    }
+    while (!l_queue.empty()) {
+      QueuedEvent l_event = l_queue.top();
+      l_queue.pop();
+      if (l_work.remaining > 0) {
+        --l_work.remaining;
+        l_queue.push({l_event.time + l_work.nextDelay().ticks(), l_seq++, l_event.proc});
+      }
+    }
+    benchmark::DoNotOptimize(l_seq);
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * l_events);
+}
+BENCHMARK(BM_PriorityQueueEvents)->Arg(1024)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
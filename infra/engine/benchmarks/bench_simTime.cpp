@@ -0,0 +1,203 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "simTime.hpp"
+
+namespace {
+
+// Double-in-nanoseconds representation SimTime used before integer ticks,
+// kept here only as a reference point for the throughput numbers
+class LegacySimTime {
+ public:
+  LegacySimTime() : c_simTime(0.0) {}
+  explicit LegacySimTime(double f_nsec) : c_simTime(std::round(f_nsec * 100.0) / 100.0) {}
+  LegacySimTime operator+(const LegacySimTime& f_rhs) const {
+    return LegacySimTime(c_simTime + f_rhs.c_simTime, 0);
+  }
+  LegacySimTime operator*(uint64_t f_cycle) const {
+    return LegacySimTime(c_simTime * static_cast<double>(f_cycle), 0);
+  }
+  bool operator<(const LegacySimTime& f_rhs) const { return c_simTime < f_rhs.c_simTime; }
+ private:
+  LegacySimTime(double f_raw, int) : c_simTime(f_raw) {}
+  double c_simTime;
+};
+
+// Construction from a runtime value; the argument selects the SimTimeUnit
+void BM_Construct(benchmark::State& f_state) {
+  const ghls::SimTimeUnit l_unit = static_cast<ghls::SimTimeUnit>(f_state.range(0));
+  double l_value = 1.25;
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_value);
+    ghls::SimTime l_time(l_value, l_unit);
+    benchmark::DoNotOptimize(l_time);
+  }
+  f_state.SetLabel(ghls::simTimeUnitStr(l_unit));
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_Construct)->DenseRange(static_cast<int>(ghls::SimTimeUnit::s),
+                                    static_cast<int>(ghls::SimTimeUnit::ps));
+
+// Gate delay built inside the loop as generated models used to, unit and
+// value opaque to the optimizer
+void BM_DelayRuntime(benchmark::State& f_state) {
+  ghls::SimTimeUnit l_unit = ghls::SimTimeUnit::ns;
+  double l_value = 1.25;
+  ghls::SimTime l_acc;
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_value);
+    benchmark::DoNotOptimize(l_unit);
+    l_acc += ghls::SimTime(l_value, l_unit) + ghls::SimTime(0.25, l_unit);
+    benchmark::DoNotOptimize(l_acc);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_DelayRuntime);
+
+// Same delay from literals, folded to one immediate add
+void BM_DelayLiteral(benchmark::State& f_state) {
+  using namespace ghls::literals;
+  ghls::SimTime l_acc;
+  for (auto _ : f_state) {
+    l_acc += 1.25_ns + 250_ps;
+    benchmark::DoNotOptimize(l_acc);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_DelayLiteral);
+
+void BM_LegacyAdd(benchmark::State& f_state) {
+  LegacySimTime l_period(1.25);
+  LegacySimTime l_acc;
+  for (auto _ : f_state) {
+    l_acc = l_acc + l_period;
+    benchmark::DoNotOptimize(l_acc);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_LegacyAdd);
+
+void BM_TickAdd(benchmark::State& f_state) {
+  ghls::SimTime l_period(1.25, ghls::SimTimeUnit::ns);
+  ghls::SimTime l_acc;
+  for (auto _ : f_state) {
+    l_acc = l_acc + l_period;
+    benchmark::DoNotOptimize(l_acc);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_TickAdd);
+
+void BM_LegacyCompare(benchmark::State& f_state) {
+  LegacySimTime l_lhs(10.0);
+  LegacySimTime l_rhs(12.5);
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_lhs);
+    benchmark::DoNotOptimize(l_rhs);
+    bool l_less = l_lhs < l_rhs;
+    benchmark::DoNotOptimize(l_less);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_LegacyCompare);
+
+void BM_TickCompare(benchmark::State& f_state) {
+  ghls::SimTime l_lhs(10.0, ghls::SimTimeUnit::ns);
+  ghls::SimTime l_rhs(12.5, ghls::SimTimeUnit::ns);
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_lhs);
+    benchmark::DoNotOptimize(l_rhs);
+    bool l_less = l_lhs < l_rhs;
+    benchmark::DoNotOptimize(l_less);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_TickCompare);
+
+void BM_LegacyMul(benchmark::State& f_state) {
+  LegacySimTime l_period(1.25);
+  uint64_t l_cycle = 0;
+  for (auto _ : f_state) {
+    LegacySimTime l_edge = l_period * ++l_cycle;
+    benchmark::DoNotOptimize(l_edge);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_LegacyMul);
+
+void BM_TickMul(benchmark::State& f_state) {
+  ghls::SimTime l_period(1.25, ghls::SimTimeUnit::ns);
+  uint64_t l_cycle = 0;
+  for (auto _ : f_state) {
+    ghls::SimTime l_edge = l_period * ++l_cycle;
+    benchmark::DoNotOptimize(l_edge);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_TickMul);
+
+// All five simTimeIn* getters per iteration
+void BM_Getters(benchmark::State& f_state) {
+  ghls::SimTime l_time(1234.5, ghls::SimTimeUnit::ns);
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(l_time);
+    double l_sum = l_time.simTimeInSec() + l_time.simTimeInMsec() + l_time.simTimeInUsec() +
+                   l_time.simTimeInNsec() + l_time.simTimeInPsec();
+    benchmark::DoNotOptimize(l_sum);
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * 5);
+}
+BENCHMARK(BM_Getters);
+
+// conv2str as it was implemented before formatSimTime, through ostringstream
+std::string legacyConv2str(double f_nsec) {
+  std::ostringstream l_stream;
+  l_stream.precision(2);
+  l_stream << std::fixed << std::round(f_nsec * 100.0) / 100.0;
+  return l_stream.str() + " " + std::string("ns");
+}
+
+void BM_LegacyConv2str(benchmark::State& f_state) {
+  double l_nsec = 1234.5;
+  for (auto _ : f_state) {
+    std::string l_str = legacyConv2str(l_nsec);
+    benchmark::DoNotOptimize(l_str);
+    l_nsec += 1.25;
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_LegacyConv2str);
+
+void BM_Conv2str(benchmark::State& f_state) {
+  ghls::SimTime l_time(1234.5, ghls::SimTimeUnit::ns);
+  ghls::SimTime l_step(1.25, ghls::SimTimeUnit::ns);
+  for (auto _ : f_state) {
+    std::string l_str = ghls::conv2str(l_time);
+    benchmark::DoNotOptimize(l_str);
+    l_time += l_step;
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_Conv2str);
+
+void BM_FormatSimTime(benchmark::State& f_state) {
+  char l_buf[ghls::kSimTimeStrMax];
+  ghls::SimTime l_time(1234.5, ghls::SimTimeUnit::ns);
+  ghls::SimTime l_step(1.25, ghls::SimTimeUnit::ns);
+  for (auto _ : f_state) {
+    char* l_end = ghls::formatSimTime(l_buf, l_buf + sizeof(l_buf), l_time);
+    benchmark::DoNotOptimize(l_end);
+    benchmark::ClobberMemory();
+    l_time += l_step;
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_FormatSimTime);
+
+}  // namespace
+
+BENCHMARK_MAIN();
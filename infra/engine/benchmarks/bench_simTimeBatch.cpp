@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "simTimeBatch.hpp"
+
+namespace {
+
+constexpr size_t kElements = 1 << 20;
+
+std::vector<ghls::SimTime> makeTimes() {
+  std::vector<ghls::SimTime> l_times(kElements);
+  uint64_t l_rng = 12345;
+  for (ghls::SimTime& l_time : l_times) {
+    l_rng = l_rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    l_time = ghls::SimTime::fromTicks(l_rng >> 12);
+  }
+  return l_times;
+}
+
+// Per-element getter loop, the baseline the batch kernels replace
+void BM_GetterLoop(benchmark::State& f_state) {
+  std::vector<ghls::SimTime> l_times = makeTimes();
+  std::vector<double> l_out(kElements);
+  for (auto _ : f_state) {
+    for (size_t l_idx = 0; l_idx < kElements; ++l_idx) {
+      l_out[l_idx] = l_times[l_idx].simTimeInUsec();
+    }
+    benchmark::DoNotOptimize(l_out.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kElements);
+}
+BENCHMARK(BM_GetterLoop);
+
+void BM_ConvertTimes(benchmark::State& f_state) {
+  ghls::setSimdLevel(static_cast<ghls::SimdLevel>(f_state.range(0)));
+  std::vector<ghls::SimTime> l_times = makeTimes();
+  std::vector<double> l_out(kElements);
+  for (auto _ : f_state) {
+    ghls::convertTimes(l_times.data(), kElements, ghls::SimTimeUnit::us, l_out.data());
+    benchmark::DoNotOptimize(l_out.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kElements);
+  f_state.SetLabel(ghls::activeSimdLevel() == ghls::SimdLevel::avx2 ? "avx2" : "scalar");
+}
+BENCHMARK(BM_ConvertTimes)->Arg(0)->Arg(1);
+
+void BM_AddOffset(benchmark::State& f_state) {
+  ghls::setSimdLevel(static_cast<ghls::SimdLevel>(f_state.range(0)));
+  std::vector<ghls::SimTime> l_times = makeTimes();
+  ghls::SimTime l_offset(1.25, ghls::SimTimeUnit::ns);
+  for (auto _ : f_state) {
+    ghls::addOffset(l_times.data(), kElements, l_offset);
+    benchmark::DoNotOptimize(l_times.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kElements);
+  f_state.SetLabel(ghls::activeSimdLevel() == ghls::SimdLevel::avx2 ? "avx2" : "scalar");
+}
+BENCHMARK(BM_AddOffset)->Arg(0)->Arg(1);
+
+void BM_ScaleCycles(benchmark::State& f_state) {
+  ghls::setSimdLevel(static_cast<ghls::SimdLevel>(f_state.range(0)));
+  std::vector<uint64_t> l_cycles(kElements);
+  for (size_t l_idx = 0; l_idx < kElements; ++l_idx) {
+    l_cycles[l_idx] = l_idx * 3;
+  }
+  std::vector<ghls::SimTime> l_out(kElements);
+  ghls::SimTime l_period(1.25, ghls::SimTimeUnit::ns);
+  for (auto _ : f_state) {
+    ghls::scaleCycles(l_cycles.data(), kElements, l_period, l_out.data());
+    benchmark::DoNotOptimize(l_out.data());
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kElements);
+  f_state.SetLabel(ghls::activeSimdLevel() == ghls::SimdLevel::avx2 ? "avx2" : "scalar");
+}
+BENCHMARK(BM_ScaleCycles)->Arg(0)->Arg(1);
+
+void BM_MinMaxTimes(benchmark::State& f_state) {
+  ghls::setSimdLevel(static_cast<ghls::SimdLevel>(f_state.range(0)));
+  std::vector<ghls::SimTime> l_times = makeTimes();
+  for (auto _ : f_state) {
+    auto l_range = ghls::minMaxTimes(l_times.data(), kElements);
+    benchmark::DoNotOptimize(l_range);
+  }
+  f_state.SetItemsProcessed(f_state.iterations() * kElements);
+  f_state.SetLabel(ghls::activeSimdLevel() == ghls::SimdLevel::avx2 ? "avx2" : "scalar");
+}
+BENCHMARK(BM_MinMaxTimes)->Arg(0)->Arg(1);
+
+}  // namespace
+
+BENCHMARK_MAIN();
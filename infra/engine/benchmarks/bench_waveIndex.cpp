@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "waveIndex.hpp"
+
+namespace {
+
+constexpr uint32_t kSignals = 1024;
+
+// Dump size in millions of changes, set GHLS_WAVE_BENCH_MCHANGES=100 or more
+// for multi-GB index files
+uint64_t changeCount() {
+  const char* l_env = std::getenv("GHLS_WAVE_BENCH_MCHANGES");
+  uint64_t l_millions = l_env != nullptr ? std::strtoull(l_env, nullptr, 10) : 4;
+  return std::max<uint64_t>(1, l_millions) * 1000000;
+}
+
+std::string wavePath() {
+  return (std::filesystem::temp_directory_path() / "ghls_bench_index.ghw").string();
+}
+
+std::string indexPath() {
+  return (std::filesystem::temp_directory_path() / "ghls_bench_index.idx").string();
+}
+
+// Every signal changes once per step, one step per 100 ps
+uint64_t lastTick() { return changeCount() / kSignals * 100000; }
+
+void writeDump() {
+  ghls::WaveWriter l_wave;
+  l_wave.open(wavePath(), ghls::WaveFormat::binary);
+  for (uint32_t l_signal = 0; l_signal < kSignals; ++l_signal) {
+    l_wave.declare("top.s" + std::to_string(l_signal), 32);
+  }
+  uint64_t l_steps = changeCount() / kSignals;
+  for (uint64_t l_step = 0; l_step < l_steps; ++l_step) {
+    for (uint32_t l_signal = 0; l_signal < kSignals; ++l_signal) {
+      l_wave.change(ghls::SimTime::fromTicks(l_step * 100000), l_signal,
+                    ghls::LogicWord{(l_step * 2654435761u + l_signal) & 0xffffffff, 0});
+    }
+  }
+}
+
+void BM_BuildIndex(benchmark::State& f_state) {
+  writeDump();
+  for (auto _ : f_state) {
+    benchmark::DoNotOptimize(ghls::buildWaveIndex(wavePath(), indexPath()));
+  }
+  f_state.counters["indexBytes"] = static_cast<double>(std::filesystem::file_size(indexPath()));
+  f_state.SetItemsProcessed(f_state.iterations() * changeCount());
+}
+BENCHMARK(BM_BuildIndex)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+void BM_IndexLookup(benchmark::State& f_state) {
+  ghls::WaveIndex l_index;
+  l_index.open(indexPath());
+  std::mt19937_64 l_rng(1);
+  for (auto _ : f_state) {
+    ghls::WaveSignal l_signal = static_cast<ghls::WaveSignal>(l_rng() % kSignals);
+    ghls::SimTime l_time = ghls::SimTime::fromTicks(l_rng() % lastTick());
+    benchmark::DoNotOptimize(l_index.valueAt(l_signal, l_time));
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_IndexLookup);
+
+// Previous approach: scan the dump from the start up to the query time
+void BM_StreamScan(benchmark::State& f_state) {
+  std::mt19937_64 l_rng(1);
+  for (auto _ : f_state) {
+    ghls::WaveSignal l_signal = static_cast<ghls::WaveSignal>(l_rng() % kSignals);
+    ghls::SimTick l_tick = l_rng() % lastTick();
+    ghls::WaveStreamReader l_reader;
+    l_reader.open(wavePath());
+    ghls::WaveChange l_change;
+    uint64_t l_value = 0;
+    while (l_reader.next(l_change) && l_change.tick <= l_tick) {
+      if (l_change.signal == l_signal) {
+        l_value = l_change.words[0].aval;
+      }
+    }
+    benchmark::DoNotOptimize(l_value);
+  }
+  f_state.SetItemsProcessed(f_state.iterations());
+}
+BENCHMARK(BM_StreamScan)->Iterations(8)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  std::remove(wavePath().c_str());
+  std::remove(indexPath().c_str());
+  return 0;
+}
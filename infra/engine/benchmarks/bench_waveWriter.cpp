@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "waveWriter.hpp"
+
+namespace {
+
+constexpr uint32_t kNets = 4096;
+constexpr uint64_t kSteps = 2000;
+
+// 0 = dumping off, 1 = VCD, 2 = binary
+enum DumpMode { kOff, kVcd, kBinary };
+
+// Counter-style activity: every timestep a quarter of the nets change. The
+// simulation work is deliberately light so the dumping cost dominates.
+void BM_Simulate(benchmark::State& f_state) {
+  const DumpMode l_mode = static_cast<DumpMode>(f_state.range(0));
+  std::string l_path = (std::filesystem::temp_directory_path() / "ghls_bench_wave").string();
+  uint64_t l_bytes = 0;
+  for (auto _ : f_state) {
+    ghls::NetStore l_nets;
+    for (uint32_t l_net = 0; l_net < kNets; ++l_net) {
+      l_nets.addNet(l_net % 4 == 0 ? 1 : 16, ghls::Logic::zero);
+    }
+    ghls::WaveWriter l_wave;
+    if (l_mode != kOff) {
+      l_wave.open(l_path, l_mode == kVcd ? ghls::WaveFormat::vcd : ghls::WaveFormat::binary);
+      for (uint32_t l_net = 0; l_net < kNets; ++l_net) {
+        l_wave.declareNet("n" + std::to_string(l_net), l_nets, l_net);
+      }
+    }
+    for (uint64_t l_step = 1; l_step <= kSteps; ++l_step) {
+      for (uint32_t l_net = static_cast<uint32_t>(l_step % 4); l_net < kNets; l_net += 4) {
+        l_nets.writeValue(l_net, l_nets.word(l_net).aval + 1);
+      }
+      ghls::SimTime l_now = ghls::SimTime::fromTicks(l_step * 10000);
+      l_nets.commit(l_now);
+      if (l_mode != kOff) {
+        l_wave.dumpChanges(l_now, l_nets);
+      }
+    }
+    l_wave.close();
+    l_bytes = l_wave.bytesWritten();
+  }
+  std::remove(l_path.c_str());
+  f_state.SetItemsProcessed(f_state.iterations() * kSteps * kNets / 4);
+  f_state.counters["fileBytes"] = static_cast<double>(l_bytes);
+}
+BENCHMARK(BM_Simulate)->Arg(kOff)->Arg(kVcd)->Arg(kBinary)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Compares Google Benchmark JSON results against a stored baseline.
+
+  compare.py BASELINE CURRENT [--threshold 0.10] [--metric cpu_time]
+  compare.py --save CURRENT BASELINE
+
+BASELINE and CURRENT are JSON files written with --benchmark_out or
+directories of them (the 'bench' target writes one file per executable).
+A benchmark regresses when its time grows by more than the threshold; the
+exit status is 1 if any benchmark regressed and 2 if either side has no
+results, e.g. before the first bench_baseline run.
+"""
+
+import argparse
+import json
+import pathlib
+import shutil
+import sys
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def result_files(path):
+    path = pathlib.Path(path)
+    if path.is_dir():
+        return sorted(path.glob("*.json"))
+    # A baseline that was never stored is reported by the caller
+    return [path] if path.exists() else []
+
+
+def load(path, metric):
+    """Returns {(file stem, benchmark name): time in ns}.
+
+    With --benchmark_repetitions the median aggregate is used, otherwise the
+    single iteration entry.
+    """
+    times = {}
+    medians = {}
+    for file in result_files(path):
+        # A run whose filter matched nothing leaves an empty file behind
+        if file.stat().st_size == 0:
+            continue
+        with open(file) as handle:
+            data = json.load(handle)
+        for bench in data.get("benchmarks", []):
+            if bench.get("error_occurred"):
+                continue
+            scale = TO_NS.get(bench.get("time_unit", "ns"), 1.0)
+            name = bench.get("run_name", bench["name"])
+            key = (file.stem, name)
+            if bench.get("run_type") == "aggregate":
+                if bench.get("aggregate_name") == "median":
+                    medians[key] = bench[metric] * scale
+            else:
+                times.setdefault(key, bench[metric] * scale)
+    times.update(medians)
+    return times
+
+
+def format_ns(value):
+    for unit in ("s", "ms", "us"):
+        if value >= TO_NS[unit]:
+            return "%.3g %s" % (value / TO_NS[unit], unit)
+    return "%.3g ns" % value
+
+
+def compare(args):
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+    if not baseline:
+        print("no baseline results in %s, run the bench_baseline target first" % args.baseline,
+              file=sys.stderr)
+        return 2
+    if not current:
+        print("no benchmark results in %s" % args.current, file=sys.stderr)
+        return 2
+
+    regressions = 0
+    width = max((len("%s/%s" % key) for key in current), default=10)
+    print("%-*s %12s %12s %8s" % (width, "benchmark", "baseline", "current", "change"))
+    for key in sorted(current):
+        label = "%s/%s" % key
+        if key not in baseline:
+            print("%-*s %12s %12s %8s" % (width, label, "-", format_ns(current[key]), "new"))
+            continue
+        change = current[key] / baseline[key] - 1.0 if baseline[key] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "  improved"
+        print("%-*s %12s %12s %+7.1f%%%s" % (width, label, format_ns(baseline[key]),
+                                             format_ns(current[key]), 100.0 * change, flag))
+    for key in sorted(set(baseline) - set(current)):
+        print("%-*s %12s %12s %8s" % (width, "%s/%s" % key, format_ns(baseline[key]), "-",
+                                      "missing"))
+
+    print("\n%d regression(s) above %.0f%% (%s)" % (regressions, 100.0 * args.threshold,
+                                                    args.metric))
+    return 1 if regressions else 0
+
+
+def save(args):
+    target = pathlib.Path(args.baseline)
+    target.mkdir(parents=True, exist_ok=True)
+    files = result_files(args.current)
+    if not files:
+        print("no benchmark results in %s" % args.current, file=sys.stderr)
+        return 2
+    for file in files:
+        shutil.copy(file, target / file.name)
+    print("stored %d result file(s) in %s" % (len(files), target))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--save", action="store_true",
+                        help="copy CURRENT into BASELINE instead of comparing")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown reported as a regression (default 0.10)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="cpu_time")
+    parser.add_argument("first")
+    parser.add_argument("second")
+    args = parser.parse_args()
+    if args.save:
+        args.current, args.baseline = args.first, args.second
+        return save(args)
+    args.baseline, args.current = args.first, args.second
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
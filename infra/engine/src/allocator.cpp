@@ -0,0 +1,79 @@
+#include "allocator.hpp"
+
+#include <algorithm>
+
+// Without a block the position starts past the end, so every request takes the
+// slow path, including zero-byte ones that would otherwise get a null pointer
+ghls::Arena::Arena(size_t f_blockSize)
+    : c_blockSize(f_blockSize), c_block(0), c_usedBefore(0), c_pos(1), c_end(0) {}
+
+void ghls::Arena::reset() noexcept {
+  c_block = 0;
+  c_usedBefore = 0;
+  if (c_blocks.empty()) {
+    c_pos = 1;
+    c_end = 0;
+    return;
+  }
+  c_pos = reinterpret_cast<uintptr_t>(c_blocks[0].data.get());
+  c_end = c_pos + c_blocks[0].size;
+}
+
+size_t ghls::Arena::used() const noexcept {
+  if (c_blocks.empty()) {
+    return 0;
+  }
+  return c_usedBefore + (c_pos - reinterpret_cast<uintptr_t>(c_blocks[c_block].data.get()));
+}
+
+size_t ghls::Arena::capacity() const noexcept {
+  size_t l_total = 0;
+  for (const Block& l_block : c_blocks) {
+    l_total += l_block.size;
+  }
+  return l_total;
+}
+
+void* ghls::Arena::allocateSlow(size_t f_size, size_t f_align) {
+  size_t l_needed = f_size + f_align;
+  size_t l_next = c_blocks.empty() ? 0 : c_block + 1;
+  if (!c_blocks.empty()) {
+    c_usedBefore += c_pos - reinterpret_cast<uintptr_t>(c_blocks[c_block].data.get());
+  }
+  // Reuse a block kept from before the last reset if one is large enough
+  auto l_fit = std::find_if(c_blocks.begin() + l_next, c_blocks.end(),
+                            [l_needed](const Block& f_block) { return f_block.size >= l_needed; });
+  if (l_fit == c_blocks.end()) {
+    size_t l_size = std::max(c_blockSize, l_needed);
+    c_blocks.insert(c_blocks.begin() + l_next, Block{std::unique_ptr<char[]>(new char[l_size]),
+                                                     l_size});
+  } else {
+    std::iter_swap(c_blocks.begin() + l_next, l_fit);
+  }
+  c_block = l_next;
+  c_pos = reinterpret_cast<uintptr_t>(c_blocks[c_block].data.get());
+  c_end = c_pos + c_blocks[c_block].size;
+  return allocate(f_size, f_align);
+}
+
+ghls::Arena& ghls::threadArena() {
+  thread_local Arena t_arena;
+  return t_arena;
+}
+
+ghls::FixedPool::FixedPool(size_t f_slotSize, size_t f_slotsPerChunk)
+    : c_slotsPerChunk(std::max<size_t>(1, f_slotsPerChunk)), c_free(nullptr), c_inUse(0) {
+  // Every slot starts on a max_align_t boundary and can hold the free-list link
+  const size_t l_align = alignof(std::max_align_t);
+  c_slotSize = (std::max(f_slotSize, sizeof(Slot)) + l_align - 1) / l_align * l_align;
+}
+
+void ghls::FixedPool::grow() {
+  c_chunks.emplace_back(new char[c_slotSize * c_slotsPerChunk]);
+  char* l_chunk = c_chunks.back().get();
+  for (size_t l_idx = c_slotsPerChunk; l_idx-- > 0;) {
+    Slot* l_slot = reinterpret_cast<Slot*>(l_chunk + l_idx * c_slotSize);
+    l_slot->next = c_free;
+    c_free = l_slot;
+  }
+}
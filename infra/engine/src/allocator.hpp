@@ -0,0 +1,185 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ghls {
+
+// Bump allocator for short-lived simulation data. Allocation is a pointer
+// increment; nothing is freed individually, reset() releases everything at
+// once (typically at a timestep boundary) and keeps the blocks for reuse.
+class Arena {
+ public:
+  explicit Arena(size_t f_blockSize = 64 * 1024);
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* allocate(size_t f_size, size_t f_align = alignof(std::max_align_t)) {
+    uintptr_t l_pos = (c_pos + f_align - 1) & ~uintptr_t(f_align - 1);
+    if (l_pos + f_size > c_end) {
+      return allocateSlow(f_size, f_align);
+    }
+    c_pos = l_pos + f_size;
+    return reinterpret_cast<void*>(l_pos);
+  }
+
+  // Objects are never destroyed, so only trivially destructible types fit
+  template <typename T, typename... Args>
+  T* create(Args&&... f_args) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "arena objects are released without running destructors");
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(f_args)...);
+  }
+
+  // Releases every allocation, invalidating all pointers handed out
+  void reset() noexcept;
+
+  // Bytes handed out since the last reset, including alignment padding
+  size_t used() const noexcept;
+  size_t capacity() const noexcept;
+
+ private:
+  void* allocateSlow(size_t f_size, size_t f_align);
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  size_t c_blockSize;
+  std::vector<Block> c_blocks;
+  size_t c_block;
+  size_t c_usedBefore;
+  uintptr_t c_pos;
+  uintptr_t c_end;
+};
+
+// Arena owned by the calling thread, for scratch data of the code running on
+// it. Whoever defines the lifetime (e.g. the end of a timestep) resets it.
+Arena& threadArena();
+
+// Free-list allocator for blocks of one size. Memory is taken from the system
+// in chunks and only returned when the pool is destroyed.
+class FixedPool {
+ public:
+  explicit FixedPool(size_t f_slotSize, size_t f_slotsPerChunk = 4096);
+  FixedPool(const FixedPool&) = delete;
+  FixedPool& operator=(const FixedPool&) = delete;
+
+  void* allocate() {
+    if (c_free == nullptr) {
+      grow();
+    }
+    Slot* l_slot = c_free;
+    c_free = l_slot->next;
+    ++c_inUse;
+    return l_slot;
+  }
+  void deallocate(void* f_ptr) noexcept {
+    Slot* l_slot = static_cast<Slot*>(f_ptr);
+    l_slot->next = c_free;
+    c_free = l_slot;
+    --c_inUse;
+  }
+
+  size_t slotSize() const noexcept { return c_slotSize; }
+  size_t inUse() const noexcept { return c_inUse; }
+  size_t capacity() const noexcept { return c_chunks.size() * c_slotsPerChunk; }
+
+ private:
+  struct Slot {
+    Slot* next;
+  };
+
+  void grow();
+
+  size_t c_slotSize;
+  size_t c_slotsPerChunk;
+  std::vector<std::unique_ptr<char[]>> c_chunks;
+  Slot* c_free;
+  size_t c_inUse;
+};
+
+// Standard allocator over an Arena, for containers whose contents die with the
+// arena (e.g. per-timestep scratch vectors). deallocate() is a no-op.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& f_arena) noexcept : c_arena(&f_arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& f_other) noexcept : c_arena(f_other.arena()) {}
+
+  T* allocate(size_t f_count) {
+    return static_cast<T*>(c_arena->allocate(f_count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) noexcept {}
+
+  Arena* arena() const noexcept { return c_arena; }
+
+ private:
+  Arena* c_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& f_lhs, const ArenaAllocator<U>& f_rhs) noexcept {
+  return f_lhs.arena() == f_rhs.arena();
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& f_lhs, const ArenaAllocator<U>& f_rhs) noexcept {
+  return !(f_lhs == f_rhs);
+}
+
+// Standard allocator over a FixedPool for node-based containers (lists, maps,
+// sets). Single objects that fit the pool slot come from the pool, anything
+// else (arrays, rebinds to larger types) from operator new. Size the pool for
+// the container's node type, which is larger than T.
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  explicit PoolAllocator(FixedPool& f_pool) noexcept : c_pool(&f_pool) {}
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& f_other) noexcept : c_pool(f_other.pool()) {}
+
+  T* allocate(size_t f_count) {
+    if (fitsPool(f_count)) {
+      return static_cast<T*>(c_pool->allocate());
+    }
+    return static_cast<T*>(::operator new(f_count * sizeof(T)));
+  }
+  void deallocate(T* f_ptr, size_t f_count) noexcept {
+    if (fitsPool(f_count)) {
+      c_pool->deallocate(f_ptr);
+    } else {
+      ::operator delete(f_ptr);
+    }
+  }
+
+  FixedPool* pool() const noexcept { return c_pool; }
+
+ private:
+  bool fitsPool(size_t f_count) const noexcept {
+    return f_count == 1 && sizeof(T) <= c_pool->slotSize() &&
+           alignof(T) <= alignof(std::max_align_t);
+  }
+
+  FixedPool* c_pool;
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>& f_lhs, const PoolAllocator<U>& f_rhs) noexcept {
+  return f_lhs.pool() == f_rhs.pool();
+}
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>& f_lhs, const PoolAllocator<U>& f_rhs) noexcept {
+  return !(f_lhs == f_rhs);
+}
+
+}  // namespace ghls
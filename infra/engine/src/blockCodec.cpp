@@ -0,0 +1,129 @@
+#include "blockCodec.hpp"
+
+#include <cstring>
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 65535;
+constexpr unsigned kHashBits = 12;
+
+uint32_t load32(const uint8_t* f_ptr) noexcept {
+  uint32_t l_value;
+  std::memcpy(&l_value, f_ptr, sizeof(l_value));
+  return l_value;
+}
+
+uint32_t hash4(const uint8_t* f_ptr) noexcept {
+  return (load32(f_ptr) * 2654435761u) >> (32 - kHashBits);
+}
+
+// Nibble value 15 means the length continues in 255-saturated extension bytes
+void putLength(std::vector<uint8_t>& f_dst, size_t f_length) {
+  if (f_length < 15) {
+    return;
+  }
+  f_length -= 15;
+  while (f_length >= 255) {
+    f_dst.push_back(255);
+    f_length -= 255;
+  }
+  f_dst.push_back(static_cast<uint8_t>(f_length));
+}
+
+bool getLength(const uint8_t*& f_pos, const uint8_t* f_end, size_t& f_length) {
+  if (f_length < 15) {
+    return true;
+  }
+  for (;;) {
+    if (f_pos >= f_end) {
+      return false;
+    }
+    uint8_t l_byte = *f_pos++;
+    f_length += l_byte;
+    if (l_byte != 255) {
+      return true;
+    }
+  }
+}
+
+void putToken(std::vector<uint8_t>& f_dst, const uint8_t* f_literals, size_t f_literalLen,
+              size_t f_matchLen, size_t f_offset) {
+  size_t l_matchCode = f_matchLen == 0 ? 0 : f_matchLen - kMinMatch;
+  uint8_t l_token = static_cast<uint8_t>((f_literalLen < 15 ? f_literalLen : 15) << 4);
+  l_token |= static_cast<uint8_t>(l_matchCode < 15 ? l_matchCode : 15);
+  f_dst.push_back(l_token);
+  putLength(f_dst, f_literalLen);
+  f_dst.insert(f_dst.end(), f_literals, f_literals + f_literalLen);
+  if (f_matchLen != 0) {
+    f_dst.push_back(static_cast<uint8_t>(f_offset));
+    f_dst.push_back(static_cast<uint8_t>(f_offset >> 8));
+    putLength(f_dst, l_matchCode);
+  }
+}
+
+}  // namespace
+
+void ghls::compressBlock(const uint8_t* f_src, size_t f_size, std::vector<uint8_t>& f_dst) {
+  uint32_t l_table[1u << kHashBits];
+  std::memset(l_table, 0xff, sizeof(l_table));
+  size_t l_anchor = 0;
+  size_t l_pos = 0;
+  while (f_size >= kMinMatch && l_pos + kMinMatch <= f_size) {
+    uint32_t l_hash = hash4(f_src + l_pos);
+    uint32_t l_candidate = l_table[l_hash];
+    l_table[l_hash] = static_cast<uint32_t>(l_pos);
+    if (l_candidate == 0xffffffffu || l_pos - l_candidate > kMaxOffset ||
+        load32(f_src + l_candidate) != load32(f_src + l_pos)) {
+      ++l_pos;
+      continue;
+    }
+    size_t l_length = kMinMatch;
+    while (l_pos + l_length < f_size && f_src[l_candidate + l_length] == f_src[l_pos + l_length]) {
+      ++l_length;
+    }
+    putToken(f_dst, f_src + l_anchor, l_pos - l_anchor, l_length, l_pos - l_candidate);
+    l_pos += l_length;
+    l_anchor = l_pos;
+  }
+  putToken(f_dst, f_src + l_anchor, f_size - l_anchor, 0, 0);
+}
+
+bool ghls::decompressBlock(const uint8_t* f_src, size_t f_size, uint8_t* f_dst,
+                           size_t f_rawSize) {
+  const uint8_t* l_pos = f_src;
+  const uint8_t* l_end = f_src + f_size;
+  size_t l_out = 0;
+  while (l_pos < l_end) {
+    uint8_t l_token = *l_pos++;
+    size_t l_literals = l_token >> 4;
+    if (!getLength(l_pos, l_end, l_literals) || size_t(l_end - l_pos) < l_literals ||
+        f_rawSize - l_out < l_literals) {
+      return false;
+    }
+    std::memcpy(f_dst + l_out, l_pos, l_literals);
+    l_pos += l_literals;
+    l_out += l_literals;
+    if (l_pos == l_end) {
+      break;
+    }
+    if (l_end - l_pos < 2) {
+      return false;
+    }
+    size_t l_offset = l_pos[0] | (size_t(l_pos[1]) << 8);
+    l_pos += 2;
+    size_t l_match = l_token & 15;
+    if (!getLength(l_pos, l_end, l_match)) {
+      return false;
+    }
+    l_match += kMinMatch;
+    if (l_offset == 0 || l_offset > l_out || f_rawSize - l_out < l_match) {
+      return false;
+    }
+    // Byte by byte, matches may overlap their own output
+    for (size_t l_idx = 0; l_idx < l_match; ++l_idx, ++l_out) {
+      f_dst[l_out] = f_dst[l_out - l_offset];
+    }
+  }
+  return l_out == f_rawSize;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "simTime.hpp"
+
+namespace ghls {
+
+// Small LZ77 block codec used for waveform and snapshot blocks. The format is
+// a sequence of tokens: a byte holding the literal count (high nibble) and the
+// match length minus four (low nibble), optional length extension bytes, the
+// literals, then a little-endian 16-bit match offset. The final token carries
+// literals only.
+
+// Appends the compressed form of [f_src, f_src + f_size) to f_dst
+void compressBlock(const uint8_t* f_src, size_t f_size, std::vector<uint8_t>& f_dst);
+
+// Decompresses into f_dst, which must hold exactly f_rawSize bytes. Returns
+// false on malformed input.
+bool decompressBlock(const uint8_t* f_src, size_t f_size, uint8_t* f_dst, size_t f_rawSize);
+
+// No compressed byte decodes to more than this many bytes, so a raw size
+// beyond kMaxBlockExpansion times the packed size marks a corrupt block
+constexpr size_t kMaxBlockExpansion = 255;
+
+// LEB128 variable length integers shared by the waveform and snapshot encoders
+inline void putVarint(std::vector<uint8_t>& f_out, uint64_t f_value) {
+  while (f_value >= 0x80) {
+    f_out.push_back(static_cast<uint8_t>(f_value | 0x80));
+    f_value >>= 7;
+  }
+  f_out.push_back(static_cast<uint8_t>(f_value));
+}
+
+// Reads a varint from [f_pos, f_end), advancing f_pos. Returns false if truncated.
+inline bool getVarint(const uint8_t*& f_pos, const uint8_t* f_end, uint64_t& f_value) {
+  f_value = 0;
+  for (unsigned l_shift = 0; f_pos < f_end && l_shift < 64; l_shift += 7) {
+    uint8_t l_byte = *f_pos++;
+    f_value |= uint64_t(l_byte & 0x7f) << l_shift;
+    if ((l_byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Varints for tick counts, which are wider than 64 bits in GHLS_WIDE_SIMTIME
+// builds. Values below 2^64 encode exactly as putVarint() writes them.
+inline void putTicks(std::vector<uint8_t>& f_out, SimTick f_ticks) {
+  while (f_ticks >= 0x80) {
+    f_out.push_back(static_cast<uint8_t>(f_ticks | 0x80));
+    f_ticks >>= 7;
+  }
+  f_out.push_back(static_cast<uint8_t>(f_ticks));
+}
+
+inline bool getTicks(const uint8_t*& f_pos, const uint8_t* f_end, SimTick& f_ticks) {
+  f_ticks = 0;
+  for (unsigned l_shift = 0; f_pos < f_end && l_shift < sizeof(SimTick) * 8; l_shift += 7) {
+    uint8_t l_byte = *f_pos++;
+    f_ticks |= SimTick(l_byte & 0x7f) << l_shift;
+    if ((l_byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Raw bytes in host order, for snapshot sections that are only read back by
+// the same build
+inline void putBytes(std::vector<uint8_t>& f_out, const void* f_data, size_t f_size) {
+  const uint8_t* l_data = static_cast<const uint8_t*>(f_data);
+  f_out.insert(f_out.end(), l_data, l_data + f_size);
+}
+
+// Copies f_size bytes from [f_pos, f_end), advancing f_pos. Returns false if truncated.
+inline bool getBytes(const uint8_t*& f_pos, const uint8_t* f_end, void* f_data, size_t f_size) {
+  if (size_t(f_end - f_pos) < f_size) {
+    return false;
+  }
+  std::memcpy(f_data, f_pos, f_size);
+  f_pos += f_size;
+  return true;
+}
+
+}  // namespace ghls
@@ -0,0 +1,395 @@
+#include "checkpoint.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "blockCodec.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'H', 'L', 'S', 'C', 'K', 'P', '1'};
+constexpr uint32_t kNoContext = 0;
+
+// A section is its name, raw size, packed size and the packed bytes
+void putSection(std::vector<uint8_t>& f_out, const std::string& f_name,
+                const std::vector<uint8_t>& f_raw) {
+  ghls::putVarint(f_out, f_name.size());
+  ghls::putBytes(f_out, f_name.data(), f_name.size());
+  ghls::putVarint(f_out, f_raw.size());
+  std::vector<uint8_t> l_packed;
+  ghls::compressBlock(f_raw.data(), f_raw.size(), l_packed);
+  ghls::putVarint(f_out, l_packed.size());
+  ghls::putBytes(f_out, l_packed.data(), l_packed.size());
+}
+
+bool getSection(const uint8_t*& f_pos, const uint8_t* f_end, std::string& f_name,
+                std::vector<uint8_t>& f_raw) {
+  uint64_t l_nameSize, l_rawSize, l_packedSize;
+  if (!ghls::getVarint(f_pos, f_end, l_nameSize) || size_t(f_end - f_pos) < l_nameSize) {
+    return false;
+  }
+  f_name.assign(reinterpret_cast<const char*>(f_pos), l_nameSize);
+  f_pos += l_nameSize;
+  if (!ghls::getVarint(f_pos, f_end, l_rawSize) || !ghls::getVarint(f_pos, f_end, l_packedSize) ||
+      size_t(f_end - f_pos) < l_packedSize ||
+      l_rawSize > l_packedSize * ghls::kMaxBlockExpansion) {
+    return false;
+  }
+  f_raw.resize(l_rawSize);
+  if (!ghls::decompressBlock(f_pos, l_packedSize, f_raw.data(), l_rawSize)) {
+    return false;
+  }
+  f_pos += l_packedSize;
+  return true;
+}
+
+}  // namespace
+
+ghls::Checkpointer::Checkpointer(Scheduler& f_sched)
+    : c_sched(f_sched),
+      c_child(0),
+      c_childPeriodic(false),
+      c_keep(0),
+      c_async(false),
+      c_saved(0),
+      c_failed(0) {}
+
+ghls::Checkpointer::~Checkpointer() { wait(); }
+
+void ghls::Checkpointer::addEvent(const std::string& f_name, EventFn f_fn) {
+  assert(c_events.count(f_name) == 0 && "event name registered twice");
+  c_eventIds.emplace(f_fn, static_cast<uint32_t>(c_eventNames.size()));
+  c_eventNames.push_back(f_name);
+  c_events.emplace(f_name, f_fn);
+}
+
+void ghls::Checkpointer::addContext(const std::string& f_name, void* f_ctx) {
+  assert(c_contexts.count(f_name) == 0 && "context name registered twice");
+  // Id 0 stands for a null context
+  c_contextIds.emplace(f_ctx, static_cast<uint32_t>(c_contextNames.size() + 1));
+  c_contextNames.push_back(f_name);
+  c_contexts.emplace(f_name, f_ctx);
+}
+
+void ghls::Checkpointer::addState(const std::string& f_name, void* f_ctx, SaveFn f_save,
+                                  RestoreFn f_restore) {
+  c_states.push_back({f_name, f_ctx, f_save, f_restore});
+}
+
+bool ghls::Checkpointer::save(const std::string& f_path) {
+  bool l_ok = write(f_path);
+  if (l_ok) {
+    ++c_saved;
+  } else {
+    ++c_failed;
+  }
+  return l_ok;
+}
+
+bool ghls::Checkpointer::saveAsync(const std::string& f_path) {
+  wait();
+  std::fflush(nullptr);
+  pid_t l_pid = ::fork();
+  if (l_pid < 0) {
+    return false;
+  }
+  if (l_pid == 0) {
+    ::_exit(write(f_path) ? 0 : 1);
+  }
+  c_child = l_pid;
+  c_childPath = f_path;
+  return true;
+}
+
+bool ghls::Checkpointer::wait() {
+  if (c_child <= 0) {
+    return true;
+  }
+  int l_status = 0;
+  pid_t l_pid;
+  do {
+    l_pid = ::waitpid(c_child, &l_status, 0);
+  } while (l_pid < 0 && errno == EINTR);
+  c_child = 0;
+  bool l_periodic = c_childPeriodic;
+  c_childPeriodic = false;
+  bool l_ok = l_pid > 0 && WIFEXITED(l_status) && WEXITSTATUS(l_status) == 0;
+  if (l_ok) {
+    ++c_saved;
+  } else {
+    ++c_failed;
+  }
+  if (l_periodic) {
+    keep(l_ok, c_childPath);
+  }
+  return l_ok;
+}
+
+bool ghls::Checkpointer::write(const std::string& f_path) const {
+  const SimTick l_now = c_sched.now().ticks();
+  std::vector<uint8_t> l_meta;
+  putTicks(l_meta, l_now);
+  putVarint(l_meta, c_eventNames.size());
+  for (const std::string& l_name : c_eventNames) {
+    putVarint(l_meta, l_name.size());
+    putBytes(l_meta, l_name.data(), l_name.size());
+  }
+  putVarint(l_meta, c_contextNames.size());
+  for (const std::string& l_name : c_contextNames) {
+    putVarint(l_meta, l_name.size());
+    putBytes(l_meta, l_name.data(), l_name.size());
+  }
+  std::vector<Scheduler::PendingEvent> l_events = c_sched.pendingEvents();
+  putVarint(l_meta, l_events.size());
+  for (const Scheduler::PendingEvent& l_event : l_events) {
+    auto l_fn = c_eventIds.find(l_event.fn);
+    auto l_ctx = c_contextIds.find(l_event.ctx);
+    if (l_fn == c_eventIds.end() || (l_event.ctx != nullptr && l_ctx == c_contextIds.end())) {
+      return false;
+    }
+    putTicks(l_meta, l_event.time.ticks() - l_now);
+    putVarint(l_meta, l_fn->second);
+    putVarint(l_meta, l_event.ctx == nullptr ? kNoContext : l_ctx->second);
+    putVarint(l_meta, l_event.payload != nullptr ? 1 : 0);
+    if (l_event.payload != nullptr) {
+      putBytes(l_meta, l_event.payload, Scheduler::kMaxPayload);
+    } else {
+      putVarint(l_meta, l_event.arg);
+    }
+  }
+
+  std::vector<uint8_t> l_file(kMagic, kMagic + sizeof(kMagic));
+  putVarint(l_file, c_states.size());
+  putSection(l_file, "", l_meta);
+  std::vector<uint8_t> l_raw;
+  for (const State& l_state : c_states) {
+    l_raw.clear();
+    l_state.save(l_state.ctx, l_raw);
+    putSection(l_file, l_state.name, l_raw);
+  }
+
+  std::string l_tmp = f_path + ".tmp";
+  std::FILE* l_out = std::fopen(l_tmp.c_str(), "wb");
+  if (l_out == nullptr) {
+    return false;
+  }
+  bool l_ok = std::fwrite(l_file.data(), 1, l_file.size(), l_out) == l_file.size();
+  l_ok = std::fclose(l_out) == 0 && l_ok;
+  if (!l_ok || std::rename(l_tmp.c_str(), f_path.c_str()) != 0) {
+    std::remove(l_tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool ghls::Checkpointer::restore(const std::string& f_path) {
+  int l_fd = ::open(f_path.c_str(), O_RDONLY);
+  if (l_fd < 0) {
+    return false;
+  }
+  struct stat l_stat;
+  void* l_map = MAP_FAILED;
+  if (::fstat(l_fd, &l_stat) == 0 && size_t(l_stat.st_size) >= sizeof(kMagic)) {
+    l_map = ::mmap(nullptr, l_stat.st_size, PROT_READ, MAP_PRIVATE, l_fd, 0);
+  }
+  ::close(l_fd);
+  if (l_map == MAP_FAILED) {
+    return false;
+  }
+  // The file is read once front to back
+  ::madvise(l_map, l_stat.st_size, MADV_SEQUENTIAL);
+  const uint8_t* l_pos = static_cast<const uint8_t*>(l_map);
+  const uint8_t* l_end = l_pos + l_stat.st_size;
+
+  struct SavedEvent {
+    SimTick time;
+    EventFn fn;
+    void* ctx;
+    uint64_t arg;
+    uint8_t payload[Scheduler::kMaxPayload];
+    bool hasPayload;
+  };
+  std::vector<SavedEvent> l_events;
+  std::vector<std::vector<uint8_t>> l_states(c_states.size());
+  SimTick l_now = 0;
+  auto l_parse = [&]() {
+    uint64_t l_count;
+    std::string l_name;
+    std::vector<uint8_t> l_meta;
+    if (std::memcmp(l_pos, kMagic, sizeof(kMagic)) != 0) {
+      return false;
+    }
+    l_pos += sizeof(kMagic);
+    if (!getVarint(l_pos, l_end, l_count) || l_count != c_states.size() ||
+        !getSection(l_pos, l_end, l_name, l_meta)) {
+      return false;
+    }
+    // Saved names are mapped to what this process registered under them
+    const uint8_t* l_metaPos = l_meta.data();
+    const uint8_t* l_metaEnd = l_meta.data() + l_meta.size();
+    auto l_names = [&](std::vector<std::string>& f_names) {
+      uint64_t l_size;
+      if (!getVarint(l_metaPos, l_metaEnd, l_size)) {
+        return false;
+      }
+      f_names.resize(l_size);
+      for (std::string& l_saved : f_names) {
+        uint64_t l_length;
+        if (!getVarint(l_metaPos, l_metaEnd, l_length) ||
+            size_t(l_metaEnd - l_metaPos) < l_length) {
+          return false;
+        }
+        l_saved.assign(reinterpret_cast<const char*>(l_metaPos), l_length);
+        l_metaPos += l_length;
+      }
+      return true;
+    };
+    std::vector<std::string> l_eventNames, l_contextNames;
+    uint64_t l_eventCount;
+    if (!getTicks(l_metaPos, l_metaEnd, l_now) || !l_names(l_eventNames) ||
+        !l_names(l_contextNames) || !getVarint(l_metaPos, l_metaEnd, l_eventCount)) {
+      return false;
+    }
+    l_events.reserve(l_eventCount);
+    for (uint64_t l_idx = 0; l_idx < l_eventCount; ++l_idx) {
+      SavedEvent l_event;
+      SimTick l_delay;
+      uint64_t l_fn, l_ctx, l_hasPayload;
+      if (!getTicks(l_metaPos, l_metaEnd, l_delay) ||
+          !getVarint(l_metaPos, l_metaEnd, l_fn) || !getVarint(l_metaPos, l_metaEnd, l_ctx) ||
+          !getVarint(l_metaPos, l_metaEnd, l_hasPayload) || l_fn >= l_eventNames.size() ||
+          l_ctx > l_contextNames.size()) {
+        return false;
+      }
+      auto l_fnIt = c_events.find(l_eventNames[l_fn]);
+      if (l_fnIt == c_events.end()) {
+        return false;
+      }
+      l_event.time = l_now + l_delay;
+      l_event.fn = l_fnIt->second;
+      l_event.ctx = nullptr;
+      if (l_ctx != kNoContext) {
+        auto l_ctxIt = c_contexts.find(l_contextNames[l_ctx - 1]);
+        if (l_ctxIt == c_contexts.end()) {
+          return false;
+        }
+        l_event.ctx = l_ctxIt->second;
+      }
+      l_event.hasPayload = l_hasPayload != 0;
+      l_event.arg = 0;
+      if (l_event.hasPayload
+              ? !getBytes(l_metaPos, l_metaEnd, l_event.payload, sizeof(l_event.payload))
+              : !getVarint(l_metaPos, l_metaEnd, l_event.arg)) {
+        return false;
+      }
+      l_events.push_back(l_event);
+    }
+    // States are matched by name, in any order
+    std::vector<uint8_t> l_seen(c_states.size(), 0);
+    for (uint64_t l_idx = 0; l_idx < l_count; ++l_idx) {
+      std::vector<uint8_t> l_raw;
+      if (!getSection(l_pos, l_end, l_name, l_raw)) {
+        return false;
+      }
+      size_t l_state = 0;
+      while (l_state < c_states.size() && (l_seen[l_state] || c_states[l_state].name != l_name)) {
+        ++l_state;
+      }
+      if (l_state == c_states.size()) {
+        return false;
+      }
+      l_seen[l_state] = 1;
+      l_states[l_state] = std::move(l_raw);
+    }
+    return l_pos == l_end;
+  };
+  bool l_ok = l_parse();
+  ::munmap(l_map, l_stat.st_size);
+  if (!l_ok) {
+    return false;
+  }
+
+  for (size_t l_idx = 0; l_idx < c_states.size(); ++l_idx) {
+    const State& l_state = c_states[l_idx];
+    if (!l_state.restore(l_state.ctx, l_states[l_idx].data(), l_states[l_idx].size())) {
+      return false;
+    }
+  }
+  c_sched.reset(SimTime::fromTicks(l_now));
+  for (const SavedEvent& l_event : l_events) {
+    SimTime l_delay = SimTime::fromTicks(l_event.time - l_now);
+    if (l_event.hasPayload) {
+      void* l_payload = c_sched.schedulePayload(l_delay, l_event.fn, l_event.ctx,
+                                                sizeof(l_event.payload));
+      std::memcpy(l_payload, l_event.payload, sizeof(l_event.payload));
+    } else {
+      c_sched.schedule(l_delay, l_event.fn, l_event.ctx, l_event.arg);
+    }
+  }
+  if (c_interval.ticks() != 0) {
+    c_nextPeriodic = SimTime::fromTicks((l_now / c_interval.ticks() + 1) * c_interval.ticks());
+  }
+  return true;
+}
+
+void ghls::Checkpointer::setPeriodic(SimTime f_interval, const std::string& f_dir, size_t f_keep,
+                                     bool f_async) {
+  assert(f_keep > 0 && "periodic checkpoints need room for at least one snapshot");
+  c_interval = f_interval;
+  c_dir = f_dir;
+  c_keep = f_keep;
+  c_async = f_async;
+  SimTick l_now = c_sched.now().ticks();
+  c_nextPeriodic = f_interval.ticks() == 0
+                       ? SimTime()
+                       : SimTime::fromTicks((l_now / f_interval.ticks() + 1) * f_interval.ticks());
+}
+
+void ghls::Checkpointer::runUntil(SimTime f_end) {
+  while (c_interval.ticks() != 0 && c_nextPeriodic <= f_end) {
+    c_sched.runUntil(c_nextPeriodic);
+    if (c_sched.now() < c_nextPeriodic) {
+      // stop() was called
+      return;
+    }
+    std::string l_path = periodicPath(c_nextPeriodic);
+    if (!c_async) {
+      keep(save(l_path), l_path);
+    } else if (saveAsync(l_path)) {
+      c_childPeriodic = true;
+    } else {
+      ++c_failed;
+    }
+    c_nextPeriodic += c_interval;
+  }
+  c_sched.runUntil(f_end);
+}
+
+void ghls::Checkpointer::keep(bool f_ok, const std::string& f_path) {
+  if (!f_ok) {
+    return;
+  }
+  c_kept.push_back(f_path);
+  while (c_kept.size() > c_keep) {
+    std::remove(c_kept.front().c_str());
+    c_kept.pop_front();
+  }
+}
+
+std::string ghls::Checkpointer::periodicPath(SimTime f_time) const {
+  // Zero padded so the files sort by time
+  char l_digits[kSimTimeStrMax];
+  char* l_end = formatTicks(l_digits, l_digits + sizeof(l_digits), f_time.ticks());
+  size_t l_width = GHLS_WIDE_SIMTIME ? 39 : 20;
+  size_t l_size = l_end - l_digits;
+  return c_dir + "/checkpoint_" + std::string(l_width - l_size, '0') +
+         std::string(l_digits, l_end) + ".ghck";
+}
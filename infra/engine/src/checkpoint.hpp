@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "scheduler.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+// Checkpoint/restore of a simulation: the current time, the queued events and
+// the state of every registered component go into one binary snapshot.
+//
+// Function pointers and object addresses do not survive a restart, so event
+// callbacks and contexts are registered under stable names. A new process
+// builds the same design, registers the same names and restores; events whose
+// callback or context was not registered make save() fail. Component state
+// is saved through save/restore functions and written as compressed blocks.
+// The delta hook and scheduler statistics are not part of a snapshot.
+//
+// Snapshots are taken between timesteps. saveAsync() forks, so the child
+// writes the copy-on-write image of the process while the simulation goes
+// on; only the calling thread exists in the child, so save functions must not
+// depend on locks held by other threads.
+class Checkpointer {
+ public:
+  using SaveFn = void (*)(const void* f_ctx, std::vector<uint8_t>& f_out);
+  // Returns false if the data does not match the component
+  using RestoreFn = bool (*)(void* f_ctx, const uint8_t* f_data, size_t f_size);
+
+  explicit Checkpointer(Scheduler& f_sched);
+  // Waits for a background save still running
+  ~Checkpointer();
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+  void addEvent(const std::string& f_name, EventFn f_fn);
+  void addContext(const std::string& f_name, void* f_ctx);
+  void addState(const std::string& f_name, void* f_ctx, SaveFn f_save, RestoreFn f_restore);
+  // State of an object with save(std::vector<uint8_t>&) const and
+  // bool restore(const uint8_t*, size_t) members
+  template <typename T>
+  void addState(const std::string& f_name, T& f_obj) {
+    addState(
+        f_name, &f_obj,
+        [](const void* f_ctx, std::vector<uint8_t>& f_out) {
+          static_cast<const T*>(f_ctx)->save(f_out);
+        },
+        [](void* f_ctx, const uint8_t* f_data, size_t f_size) {
+          return static_cast<T*>(f_ctx)->restore(f_data, f_size);
+        });
+  }
+
+  // Writes a snapshot of the current state. The file is written next to
+  // f_path and renamed into place, so a crash never leaves a partial one.
+  bool save(const std::string& f_path);
+  // Forks a child that writes the snapshot and returns at once. Returns false
+  // if the fork failed. Only one background save runs at a time; a second
+  // call waits for the first.
+  bool saveAsync(const std::string& f_path);
+  // Waits for the background save, if any. Returns false if it failed.
+  bool wait();
+  bool busy() const noexcept { return c_child > 0; }
+
+  // Loads a snapshot through a read-only mapping: resets the scheduler to
+  // the saved time, re-queues the saved events and restores every state.
+  // Nothing is modified if the file is malformed or its names do not match;
+  // if a component rejects its data the components before it are restored.
+  bool restore(const std::string& f_path);
+
+  // Takes a snapshot in f_dir every f_interval of simulation time while
+  // runUntil() runs, keeping only the f_keep most recent ones on disk
+  void setPeriodic(SimTime f_interval, const std::string& f_dir, size_t f_keep,
+                   bool f_async = true);
+  // Scheduler::runUntil() with the periodic snapshots taken on the way.
+  // Each snapshot holds the state after all events at its time have run.
+  void runUntil(SimTime f_end);
+  // Periodic snapshots currently on disk, oldest first
+  const std::deque<std::string>& kept() const noexcept { return c_kept; }
+
+  uint64_t saved() const noexcept { return c_saved; }
+  uint64_t failed() const noexcept { return c_failed; }
+
+ private:
+  struct State {
+    std::string name;
+    void* ctx;
+    SaveFn save;
+    RestoreFn restore;
+  };
+
+  bool write(const std::string& f_path) const;
+  // Adds a periodic snapshot to the kept set, deleting the oldest beyond c_keep
+  void keep(bool f_ok, const std::string& f_path);
+  std::string periodicPath(SimTime f_time) const;
+
+  Scheduler& c_sched;
+  std::vector<std::string> c_eventNames;
+  std::unordered_map<EventFn, uint32_t> c_eventIds;
+  std::unordered_map<std::string, EventFn> c_events;
+  std::vector<std::string> c_contextNames;
+  std::unordered_map<void*, uint32_t> c_contextIds;
+  std::unordered_map<std::string, void*> c_contexts;
+  std::vector<State> c_states;
+
+  pid_t c_child;
+  std::string c_childPath;
+  bool c_childPeriodic;
+
+  SimTime c_interval;
+  SimTime c_nextPeriodic;
+  std::string c_dir;
+  size_t c_keep;
+  bool c_async;
+  std::deque<std::string> c_kept;
+
+  uint64_t c_saved;
+  uint64_t c_failed;
+};
+
+}  // namespace ghls
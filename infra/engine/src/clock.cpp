@@ -0,0 +1,136 @@
+#include "clock.hpp"
+
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+ghls::Clock::Clock(SimTime f_period, SimTime f_highTime, SimTime f_phase)
+    : c_period(f_period),
+      c_highTime(f_highTime),
+      c_phase(f_phase),
+      c_nextRise(f_phase),
+      c_cycle(0),
+      c_nextRising(true) {
+  assert(SimTime() < f_highTime && f_highTime < f_period && "invalid clock duty cycle");
+}
+
+ghls::ClockEdge ghls::Clock::peekEdge() const noexcept {
+  if (c_nextRising) {
+    return {c_nextRise, c_cycle, true};
+  }
+  return {c_nextRise + c_highTime, c_cycle, false};
+}
+
+ghls::ClockEdge ghls::Clock::nextEdge() noexcept {
+  ClockEdge l_edge = peekEdge();
+  if (!c_nextRising) {
+    c_nextRise += c_period;
+    ++c_cycle;
+  }
+  c_nextRising = !c_nextRising;
+  return l_edge;
+}
+
+void ghls::Clock::resetTo(SimTime f_time) noexcept {
+  if (f_time <= c_phase) {
+    c_cycle = 0;
+  } else {
+    // One division on reset; edge generation itself never multiplies
+    c_cycle = static_cast<uint64_t>((f_time - c_phase).ticks() / c_period.ticks());
+  }
+  c_nextRise = risingEdge(c_cycle);
+  c_nextRising = true;
+  if (c_nextRise < f_time) {
+    if (c_nextRise + c_highTime >= f_time) {
+      c_nextRising = false;
+    } else {
+      c_nextRise += c_period;
+      ++c_cycle;
+    }
+  }
+}
+
+std::pair<ghls::SimTick, ghls::SimTick> ghls::periodRatio(const Clock& f_lhs,
+                                                          const Clock& f_rhs) noexcept {
+  SimTick l_lhs = f_lhs.period().ticks();
+  SimTick l_rhs = f_rhs.period().ticks();
+  SimTick l_gcd = std::gcd(l_lhs, l_rhs);
+  return {l_lhs / l_gcd, l_rhs / l_gcd};
+}
+
+size_t ghls::ClockSet::add(const Clock& f_clock) {
+  c_clocks.push_back(f_clock);
+  c_heap.push_back({f_clock.peekEdge().time.ticks(), static_cast<uint32_t>(c_clocks.size() - 1)});
+  siftUp(c_heap.size() - 1);
+  return c_clocks.size() - 1;
+}
+
+ghls::DomainEdge ghls::ClockSet::peek() const noexcept {
+  size_t l_domain = c_heap.front().domain;
+  return {l_domain, c_clocks[l_domain].peekEdge()};
+}
+
+ghls::DomainEdge ghls::ClockSet::pop() noexcept {
+  size_t l_domain = c_heap.front().domain;
+  Clock& l_clock = c_clocks[l_domain];
+  ClockEdge l_edge = l_clock.nextEdge();
+  // The popped domain only moves later, so it can only sink from the root
+  c_heap.front().time = l_clock.peekEdge().time.ticks();
+  siftDown(0);
+  return {l_domain, l_edge};
+}
+
+void ghls::ClockSet::resetTo(SimTime f_time) {
+  c_heap.clear();
+  for (size_t l_domain = 0; l_domain < c_clocks.size(); ++l_domain) {
+    c_clocks[l_domain].resetTo(f_time);
+    c_heap.push_back({c_clocks[l_domain].peekEdge().time.ticks(), static_cast<uint32_t>(l_domain)});
+    siftUp(c_heap.size() - 1);
+  }
+}
+
+std::optional<ghls::SimTime> ghls::ClockSet::hyperperiod() const noexcept {
+  SimTick l_lcm = 1;
+  for (const Clock& l_clock : c_clocks) {
+    SimTick l_period = l_clock.period().ticks();
+    SimTick l_step = l_period / std::gcd(l_lcm, l_period);
+    if (l_lcm > std::numeric_limits<SimTick>::max() / l_step) {
+      return std::nullopt;
+    }
+    l_lcm *= l_step;
+  }
+  return SimTime::fromTicks(c_clocks.empty() ? 0 : l_lcm);
+}
+
+void ghls::ClockSet::siftUp(size_t f_pos) noexcept {
+  HeapEntry l_entry = c_heap[f_pos];
+  while (f_pos > 0) {
+    size_t l_parent = (f_pos - 1) / 2;
+    if (!earlier(l_entry, c_heap[l_parent])) {
+      break;
+    }
+    c_heap[f_pos] = c_heap[l_parent];
+    f_pos = l_parent;
+  }
+  c_heap[f_pos] = l_entry;
+}
+
+void ghls::ClockSet::siftDown(size_t f_pos) noexcept {
+  HeapEntry l_entry = c_heap[f_pos];
+  const size_t l_size = c_heap.size();
+  for (;;) {
+    size_t l_child = 2 * f_pos + 1;
+    if (l_child >= l_size) {
+      break;
+    }
+    if (l_child + 1 < l_size && earlier(c_heap[l_child + 1], c_heap[l_child])) {
+      ++l_child;
+    }
+    if (!earlier(c_heap[l_child], l_entry)) {
+      break;
+    }
+    c_heap[f_pos] = c_heap[l_child];
+    f_pos = l_child;
+  }
+  c_heap[f_pos] = l_entry;
+}
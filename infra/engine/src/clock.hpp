@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "simTime.hpp"
+
+namespace ghls {
+
+struct ClockEdge {
+  SimTime time;
+  uint64_t cycle;
+  bool rising;
+};
+
+// Periodic clock. Rising edge n sits at phase + n * period and is followed by
+// a falling edge highTime later. Edges are produced incrementally with one
+// integer add per edge, so there is neither a per-edge multiply nor drift.
+class Clock {
+ public:
+  // f_highTime must be greater than zero and less than f_period
+  Clock(SimTime f_period, SimTime f_highTime, SimTime f_phase = SimTime());
+
+  SimTime period() const noexcept { return c_period; }
+  SimTime highTime() const noexcept { return c_highTime; }
+  SimTime phase() const noexcept { return c_phase; }
+
+  // Edge that nextEdge() will return
+  ClockEdge peekEdge() const noexcept;
+  // Returns the upcoming edge and advances past it
+  ClockEdge nextEdge() noexcept;
+  // Positions the generator on the first edge at or after f_time
+  void resetTo(SimTime f_time) noexcept;
+
+  // Random access to rising edge f_cycle
+  SimTime risingEdge(uint64_t f_cycle) const noexcept { return c_phase + c_period * f_cycle; }
+
+ private:
+  SimTime c_period;
+  SimTime c_highTime;
+  SimTime c_phase;
+  SimTime c_nextRise;
+  uint64_t c_cycle;
+  bool c_nextRising;
+};
+
+// Period ratio f_lhs : f_rhs reduced to lowest terms
+std::pair<SimTick, SimTick> periodRatio(const Clock& f_lhs, const Clock& f_rhs) noexcept;
+
+struct DomainEdge {
+  size_t domain;
+  ClockEdge edge;
+};
+
+// Set of clock domains merged into one edge stream. The next edge across all
+// domains is kept at the root of a binary heap, so popping it is O(log domains).
+// Simultaneous edges come out in domain order.
+class ClockSet {
+ public:
+  // Returns the domain index of the new clock
+  size_t add(const Clock& f_clock);
+
+  size_t size() const noexcept { return c_clocks.size(); }
+  bool empty() const noexcept { return c_clocks.empty(); }
+  const Clock& clock(size_t f_domain) const noexcept { return c_clocks[f_domain]; }
+
+  // Earliest upcoming edge, the set must not be empty
+  DomainEdge peek() const noexcept;
+  // Returns the earliest upcoming edge and advances that domain
+  DomainEdge pop() noexcept;
+  // Repositions every domain on its first edge at or after f_time
+  void resetTo(SimTime f_time);
+
+  // Interval after which the combined edge pattern repeats (the least common
+  // multiple of all periods), or nullopt if it does not fit in a SimTime
+  std::optional<SimTime> hyperperiod() const noexcept;
+
+ private:
+  struct HeapEntry {
+    SimTick time;
+    uint32_t domain;
+  };
+
+  static bool earlier(const HeapEntry& f_lhs, const HeapEntry& f_rhs) noexcept {
+    return f_lhs.time != f_rhs.time ? f_lhs.time < f_rhs.time : f_lhs.domain < f_rhs.domain;
+  }
+  void siftUp(size_t f_pos) noexcept;
+  void siftDown(size_t f_pos) noexcept;
+
+  std::vector<Clock> c_clocks;
+  std::vector<HeapEntry> c_heap;
+};
+
+}  // namespace ghls
@@ -0,0 +1,286 @@
+#include "compiledSim.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "blockCodec.hpp"
+#include "checkpoint.hpp"
+#include "profiler.hpp"
+
+ghls::CompiledSim::CompiledSim(const Netlist& f_netlist, Scheduler& f_sched)
+    : c_sched(f_sched),
+      c_clocks(f_sched, onClock, this),
+      c_domainFlops(f_netlist.domains()),
+      c_epoch(0),
+      c_quietEpoch(f_netlist.domains(), ~uint64_t(0)),
+      c_clocked(f_netlist.domains(), 0),
+      c_nativeEval(nullptr),
+      c_levels(0),
+      c_passes(0),
+      c_compiled(false),
+      c_dirty(false) {
+  for (NetId l_net = 0; l_net < f_netlist.nets(); ++l_net) {
+    uint32_t l_width = f_netlist.width(l_net);
+    uint64_t l_mask = l_width == 64 ? ~uint64_t(0) : (uint64_t(1) << l_width) - 1;
+    uint8_t l_init = static_cast<uint8_t>(f_netlist.init(l_net));
+    c_masks.push_back(l_mask);
+    c_values.push_back({(l_init & 1) != 0 ? l_mask : 0, (l_init & 2) != 0 ? l_mask : 0});
+  }
+  for (const Flop& l_flop : f_netlist.flops()) {
+    c_domainFlops[l_flop.domain].push_back(l_flop);
+  }
+
+  std::vector<uint32_t> l_levels;
+  std::optional<std::vector<uint32_t>> l_order = f_netlist.levelize(&l_levels);
+  if (!l_order) {
+    return;
+  }
+  c_compiled = true;
+  c_program.reserve(l_order->size());
+  for (uint32_t l_idx : *l_order) {
+    const Gate& l_gate = f_netlist.gates()[l_idx];
+    c_program.push_back({l_gate.op, l_gate.out, {l_gate.in[0], l_gate.in[1], l_gate.in[2]},
+                         c_masks[l_gate.out]});
+    c_levels = std::max(c_levels, l_levels[l_idx] + 1);
+  }
+  c_sched.setDeltaHook(onDelta, this);
+  evaluate();
+}
+
+void ghls::CompiledSim::addClock(const Clock& f_clock, uint32_t f_domain) {
+  c_clocks.add(f_clock, f_domain);
+  if (f_domain < c_clocked.size()) {
+    c_clocked[f_domain] = 1;
+  }
+}
+
+void ghls::CompiledSim::setFastForward(bool f_enable) {
+  c_clocks.setIdle(f_enable ? onIdle : nullptr);
+  if (!f_enable) {
+    c_clocks.resume();
+  }
+}
+
+bool ghls::CompiledSim::idle() const noexcept {
+  if (c_dirty) {
+    return false;
+  }
+  for (size_t l_domain = 0; l_domain < c_clocked.size(); ++l_domain) {
+    if (c_clocked[l_domain] != 0 && c_quietEpoch[l_domain] != c_epoch) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ghls::CompiledSim::setInput(NetId f_net, LogicWord f_value) {
+  LogicWord l_value = {f_value.aval & c_masks[f_net], f_value.bval & c_masks[f_net]};
+  // With writes staged, an earlier call in this delta cycle may be undone
+  if (!c_dirty && l_value == c_values[f_net]) {
+    return;
+  }
+  // Committed with the Q writes, so edges in this delta cycle still sample
+  // the old value
+  c_staged.emplace_back(f_net, l_value);
+  ++c_epoch;
+  c_clocks.resume();
+  if (!c_dirty) {
+    c_dirty = true;
+    // Makes sure a delta cycle ends, and runs the pass, at the current time
+    c_sched.scheduleDelta(onInput, this);
+  }
+}
+
+void ghls::CompiledSim::evaluate() noexcept {
+  LogicWord* l_values = c_values.data();
+  if (c_nativeEval != nullptr) {
+    c_nativeEval(l_values);
+    ++c_passes;
+    return;
+  }
+  for (const Instr& l_instr : c_program) {
+    LogicWord l_out = evalGate(l_instr.op, l_values[l_instr.in[0]], l_values[l_instr.in[1]],
+                               l_values[l_instr.in[2]]);
+    l_values[l_instr.out] = {l_out.aval & l_instr.mask, l_out.bval & l_instr.mask};
+  }
+  ++c_passes;
+}
+
+std::string ghls::CompiledSim::nativeSource() const {
+  // Same 4-state rules as evalGate(), per operation so nothing dispatches
+  static const char kPrelude[] =
+      "#include <stdint.h>\n"
+      "struct W { uint64_t aval, bval; };\n"
+      "static inline uint64_t one(W a) { return a.aval & ~a.bval; }\n"
+      "static inline uint64_t zero(W a) { return ~a.aval & ~a.bval; }\n"
+      "static inline W known(uint64_t o, uint64_t z) {\n"
+      "  uint64_t x = ~(o | z);\n"
+      "  return W{o | x, x};\n"
+      "}\n"
+      "static inline W buf(W a) { return W{a.aval | a.bval, a.bval}; }\n"
+      "static inline W inv(W a) { return W{~a.aval | a.bval, a.bval}; }\n"
+      "static inline W and2(W a, W b) { return known(one(a) & one(b), zero(a) | zero(b)); }\n"
+      "static inline W or2(W a, W b) { return known(one(a) | one(b), zero(a) & zero(b)); }\n"
+      "static inline W xor2(W a, W b) {\n"
+      "  uint64_t x = a.bval | b.bval;\n"
+      "  return W{(a.aval ^ b.aval) | x, x};\n"
+      "}\n"
+      "static inline W nand2(W a, W b) { return inv(and2(a, b)); }\n"
+      "static inline W nor2(W a, W b) { return inv(or2(a, b)); }\n"
+      "static inline W xnor2(W a, W b) { return inv(xor2(a, b)); }\n"
+      "static inline W mux2(W s, W b, W c) {\n"
+      "  uint64_t s1 = one(s), s0 = zero(s), sx = ~(s1 | s0);\n"
+      "  W d0 = buf(b), d1 = buf(c);\n"
+      "  uint64_t agree = ~(d0.aval ^ d1.aval) & ~d0.bval & ~d1.bval;\n"
+      "  return W{(s1 & d1.aval) | (s0 & d0.aval) | (sx & (~agree | d0.aval)),\n"
+      "           (s1 & d1.bval) | (s0 & d0.bval) | (sx & ~agree)};\n"
+      "}\n"
+      "static inline W mask(W a, uint64_t m) { return W{a.aval & m, a.bval & m}; }\n";
+  static const char* const kNames[] = {"buf",  "inv",  "and2",  "or2", "xor2",
+                                       "nand2", "nor2", "xnor2", "mux2"};
+  // The compiler slows down sharply on one huge function, so the pass is cut
+  // into small blocks called in order
+  constexpr size_t kBlock = 64;
+  std::string l_src(kPrelude);
+  l_src.reserve(l_src.size() + c_program.size() * 64);
+  char l_line[160];
+  for (size_t l_idx = 0; l_idx < c_program.size(); ++l_idx) {
+    if (l_idx % kBlock == 0) {
+      std::snprintf(l_line, sizeof(l_line),
+                    "%sstatic void __attribute__((noinline)) b%zu(W* v) {\n",
+                    l_idx == 0 ? "" : "}\n", l_idx / kBlock);
+      l_src += l_line;
+    }
+    const Instr& l_instr = c_program[l_idx];
+    unsigned l_arity = gateArity(l_instr.op);
+    int l_len = std::snprintf(l_line, sizeof(l_line), "  v[%u] = mask(%s(v[%u]", l_instr.out,
+                              kNames[static_cast<unsigned>(l_instr.op)], l_instr.in[0]);
+    for (unsigned l_arg = 1; l_arg < l_arity; ++l_arg) {
+      l_len += std::snprintf(l_line + l_len, sizeof(l_line) - l_len, ", v[%u]",
+                             l_instr.in[l_arg]);
+    }
+    std::snprintf(l_line + l_len, sizeof(l_line) - l_len, "), 0x%llxull);\n",
+                  static_cast<unsigned long long>(l_instr.mask));
+    l_src += l_line;
+  }
+  l_src += c_program.empty() ? "" : "}\n";
+  l_src += "extern \"C\" void ghls_eval(W* v) {\n";
+  for (size_t l_block = 0; l_block * kBlock < c_program.size(); ++l_block) {
+    std::snprintf(l_line, sizeof(l_line), "  b%zu(v);\n", l_block);
+    l_src += l_line;
+  }
+  l_src += "}\n";
+  return l_src;
+}
+
+bool ghls::CompiledSim::useNative(const NativeOptions& f_options, std::string* f_error) {
+  if (!c_compiled) {
+    if (f_error != nullptr) {
+      *f_error = "netlist has a combinational loop";
+    }
+    return false;
+  }
+  std::unique_ptr<NativeModule> l_module = NativeModule::load(nativeSource(), f_options, f_error);
+  if (!l_module) {
+    return false;
+  }
+  c_native = std::move(l_module);
+  c_nativeEval = c_native->eval();
+  return true;
+}
+
+void ghls::CompiledSim::checkpoint(Checkpointer& f_cp, const std::string& f_name) {
+  c_clocks.checkpoint(f_cp, f_name + ".clocks");
+  f_cp.addEvent(f_name + ".input", onInput);
+  f_cp.addContext(f_name, this);
+  f_cp.addState(f_name, *this);
+}
+
+void ghls::CompiledSim::save(std::vector<uint8_t>& f_out) const {
+  putVarint(f_out, c_values.size());
+  putVarint(f_out, c_dirty ? 1 : 0);
+  putBytes(f_out, c_values.data(), c_values.size() * sizeof(LogicWord));
+  // Inputs driven since the last delta cycle
+  putVarint(f_out, c_staged.size());
+  for (const std::pair<NetId, LogicWord>& l_write : c_staged) {
+    putVarint(f_out, l_write.first);
+    putBytes(f_out, &l_write.second, sizeof(LogicWord));
+  }
+}
+
+bool ghls::CompiledSim::restore(const uint8_t* f_data, size_t f_size) {
+  const uint8_t* l_pos = f_data;
+  const uint8_t* l_end = f_data + f_size;
+  uint64_t l_nets, l_dirty, l_staged;
+  if (!getVarint(l_pos, l_end, l_nets) || !getVarint(l_pos, l_end, l_dirty) ||
+      l_nets != c_values.size() || size_t(l_end - l_pos) < l_nets * sizeof(LogicWord)) {
+    return false;
+  }
+  std::vector<LogicWord> l_values(l_nets);
+  getBytes(l_pos, l_end, l_values.data(), l_nets * sizeof(LogicWord));
+  std::vector<std::pair<NetId, LogicWord>> l_writes;
+  if (!getVarint(l_pos, l_end, l_staged)) {
+    return false;
+  }
+  for (uint64_t l_idx = 0; l_idx < l_staged; ++l_idx) {
+    uint64_t l_net;
+    LogicWord l_value;
+    if (!getVarint(l_pos, l_end, l_net) || l_net >= l_nets ||
+        !getBytes(l_pos, l_end, &l_value, sizeof(LogicWord))) {
+      return false;
+    }
+    l_writes.emplace_back(static_cast<NetId>(l_net), l_value);
+  }
+  if (l_pos != l_end) {
+    return false;
+  }
+  c_values = std::move(l_values);
+  c_staged = std::move(l_writes);
+  c_dirty = l_dirty != 0;
+  // Quiet edges seen before describe another state
+  ++c_epoch;
+  return true;
+}
+
+void ghls::CompiledSim::nameEvents(Profiler& f_profiler, const std::string& f_name) {
+  c_clocks.nameEvents(f_profiler, f_name + ".clock");
+  // The pass itself runs in the delta hook, outside any event
+  f_profiler.name(onInput, this, f_name + ".input");
+}
+
+void ghls::CompiledSim::onDelta(void* f_ctx) {
+  CompiledSim* l_sim = static_cast<CompiledSim*>(f_ctx);
+  if (l_sim->c_dirty) {
+    l_sim->c_dirty = false;
+    for (const std::pair<NetId, LogicWord>& l_write : l_sim->c_staged) {
+      l_sim->c_values[l_write.first] = l_write.second;
+    }
+    l_sim->c_staged.clear();
+    l_sim->evaluate();
+  }
+}
+
+void ghls::CompiledSim::onClock(void* f_ctx, uint32_t f_domain) {
+  CompiledSim* l_sim = static_cast<CompiledSim*>(f_ctx);
+  if (f_domain >= l_sim->c_domainFlops.size()) {
+    return;
+  }
+  // An edge only proves the design quiet if it sampled settled D values
+  bool l_settled = !l_sim->c_dirty;
+  // Q writes wait for the end of the delta cycle, so flop chains shift
+  // correctly within and across domains
+  bool l_changed = false;
+  for (const Flop& l_flop : l_sim->c_domainFlops[f_domain]) {
+    const LogicWord& l_d = l_sim->c_values[l_flop.d];
+    if (l_d != l_sim->c_values[l_flop.q]) {
+      l_sim->c_staged.emplace_back(l_flop.q, l_d);
+      l_changed = true;
+    }
+  }
+  if (l_changed) {
+    ++l_sim->c_epoch;
+    l_sim->c_dirty = true;
+  } else if (l_settled) {
+    l_sim->c_quietEpoch[f_domain] = l_sim->c_epoch;
+  }
+}
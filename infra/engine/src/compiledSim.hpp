@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clock.hpp"
+#include "nativeModule.hpp"
+#include "netlist.hpp"
+#include "scheduler.hpp"
+
+namespace ghls {
+
+class Checkpointer;
+class Profiler;
+
+// Compiled-mode simulation of a Netlist. The combinational gates are
+// levelized once into a flat instruction array and evaluated in one linear
+// pass whenever a flop or input changed, so every gate runs at most once per
+// delta cycle no matter how deep its cone is. The scheduler only carries clock
+// edges and input (asynchronous) events; the pass runs at the end of the
+// delta cycle in which they happened.
+//
+// With fast-forward on, a clock edge that changes no flop while nothing else
+// changed since every clocked domain's previous edge leaves the design idle:
+// the clocks are parked, and the scheduler skips straight to the next other
+// event. The next input change puts the clocks back on their edge grid.
+//
+// useNative() replaces the interpreted pass with the same program translated
+// to straight-line C++ and compiled to native code, one assignment per gate
+// with its operand nets and mask as constants.
+class CompiledSim {
+ public:
+  CompiledSim(const Netlist& f_netlist, Scheduler& f_sched);
+  CompiledSim(const CompiledSim&) = delete;
+  CompiledSim& operator=(const CompiledSim&) = delete;
+
+  // False if the netlist has a combinational loop and cannot be levelized
+  bool compiled() const noexcept { return c_compiled; }
+
+  void addClock(const Clock& f_clock, uint32_t f_domain);
+  // Drives a primary input. As in EventSim the value is committed, and the
+  // pass runs, at the end of the current delta cycle (or the next timestep
+  // when called outside one), so edges in the same delta sample the old value.
+  void setInput(NetId f_net, LogicWord f_value);
+
+  // Off by default
+  void setFastForward(bool f_enable);
+  bool idle() const noexcept;
+  // Simulated time skipped with every clock parked, how often that happened
+  // and the rising edges not fired (see ClockDriver)
+  SimTime skippedTime() const noexcept { return c_clocks.skippedTime(); }
+  uint64_t fastForwards() const noexcept { return c_clocks.fastForwards(); }
+  uint64_t skippedEdges() const noexcept { return c_clocks.skippedEdges(); }
+
+  // Evaluates the whole program once
+  void evaluate() noexcept;
+
+  // Source of the program for NativeModule; deterministic, so equal designs
+  // hash to the same cached module
+  std::string nativeSource() const;
+  // Compiles (or fetches from the cache) and switches evaluate() to the
+  // native pass. On failure the interpreted pass stays and f_error says why.
+  bool useNative(const NativeOptions& f_options = {}, std::string* f_error = nullptr);
+  const NativeModule* native() const noexcept { return c_native.get(); }
+
+  LogicWord value(NetId f_net) const noexcept { return c_values[f_net]; }
+  size_t instructions() const noexcept { return c_program.size(); }
+  // Depth of the deepest combinational cone
+  uint32_t levels() const noexcept { return c_levels; }
+  uint64_t passes() const noexcept { return c_passes; }
+  uint64_t gateEvaluations() const noexcept { return c_passes * c_program.size(); }
+
+  // Registers net values and events under f_name, clocks included
+  void checkpoint(Checkpointer& f_cp, const std::string& f_name);
+  void save(std::vector<uint8_t>& f_out) const;
+  bool restore(const uint8_t* f_data, size_t f_size);
+
+  // Shows clock edges and input passes as f_name.clock and f_name.input in
+  // profiles
+  void nameEvents(Profiler& f_profiler, const std::string& f_name);
+
+ private:
+  struct Instr {
+    GateOp op;
+    NetId out;
+    NetId in[3];
+    uint64_t mask;
+  };
+
+  static void onDelta(void* f_ctx);
+  static void onClock(void* f_ctx, uint32_t f_domain);
+  static void onInput(void*, uint64_t) {}
+  static bool onIdle(void* f_ctx) { return static_cast<const CompiledSim*>(f_ctx)->idle(); }
+
+  Scheduler& c_sched;
+  ClockDriver c_clocks;
+  std::vector<Instr> c_program;
+  std::vector<LogicWord> c_values;
+  std::vector<uint64_t> c_masks;
+  std::vector<std::vector<Flop>> c_domainFlops;
+  // Input and Q writes of this delta cycle, applied before the pass so every
+  // edge at the same time samples the committed values, as in EventSim
+  std::vector<std::pair<NetId, LogicWord>> c_staged;
+  // Bumped by every flop or input change; c_quietEpoch[d] is the epoch in
+  // which domain d last had an edge that changed nothing
+  uint64_t c_epoch;
+  std::vector<uint64_t> c_quietEpoch;
+  std::vector<uint8_t> c_clocked;
+  std::unique_ptr<NativeModule> c_native;
+  NativeModule::EvalFn c_nativeEval;
+  uint32_t c_levels;
+  uint64_t c_passes;
+  bool c_compiled;
+  bool c_dirty;
+};
+
+}  // namespace ghls
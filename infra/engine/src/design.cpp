@@ -0,0 +1,286 @@
+#include "design.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+
+namespace {
+
+constexpr struct {
+  const char* name;
+  ghls::GateOp op;
+} kGateOps[] = {{"buf", ghls::GateOp::buf},     {"inv", ghls::GateOp::inv},
+                {"and2", ghls::GateOp::and2},   {"or2", ghls::GateOp::or2},
+                {"xor2", ghls::GateOp::xor2},   {"nand2", ghls::GateOp::nand2},
+                {"nor2", ghls::GateOp::nor2},   {"xnor2", ghls::GateOp::xnor2},
+                {"mux2", ghls::GateOp::mux2}};
+
+std::vector<std::string> split(const std::string& f_line) {
+  std::vector<std::string> l_out;
+  size_t l_pos = 0;
+  while ((l_pos = f_line.find_first_not_of(" \t\r", l_pos)) != std::string::npos) {
+    size_t l_end = f_line.find_first_of(" \t\r", l_pos);
+    l_out.push_back(f_line.substr(l_pos, l_end - l_pos));
+    l_pos = l_end;
+  }
+  return l_out;
+}
+
+bool parseUnsigned(const std::string& f_text, uint64_t& f_out) {
+  int l_base = 10;
+  size_t l_skip = 0;
+  if (f_text.size() > 2 && f_text[0] == '0' && (f_text[1] == 'x' || f_text[1] == 'X')) {
+    l_base = 16;
+    l_skip = 2;
+  }
+  const char* l_end = f_text.data() + f_text.size();
+  std::from_chars_result l_res = std::from_chars(f_text.data() + l_skip, l_end, f_out, l_base);
+  return l_res.ec == std::errc() && l_res.ptr == l_end;
+}
+
+class Parser {
+ public:
+  Parser(ghls::Design& f_design, std::string* f_error) : c_design(f_design), c_error(f_error) {}
+
+  bool statement(const std::vector<std::string>& f_words, size_t f_line) {
+    c_line = f_line;
+    const std::string& l_kind = f_words[0];
+    if (l_kind == "net") {
+      return net(f_words);
+    }
+    if (l_kind == "gate") {
+      return gate(f_words);
+    }
+    if (l_kind == "flop") {
+      return flop(f_words);
+    }
+    if (l_kind == "clock") {
+      return clock(f_words);
+    }
+    if (l_kind == "input") {
+      return input(f_words);
+    }
+    if (l_kind == "watch") {
+      return watch(f_words);
+    }
+    return fail("unknown statement '" + l_kind + "'");
+  }
+
+ private:
+  bool fail(const std::string& f_what) {
+    if (c_error != nullptr) {
+      *c_error = "line " + std::to_string(c_line) + ": " + f_what;
+    }
+    return false;
+  }
+
+  bool arity(const std::vector<std::string>& f_words, size_t f_min, size_t f_max) {
+    if (f_words.size() < f_min || f_words.size() > f_max) {
+      return fail("wrong number of operands for '" + f_words[0] + "'");
+    }
+    return true;
+  }
+
+  bool lookup(const std::string& f_name, ghls::NetId& f_net) {
+    std::optional<ghls::NetId> l_net = c_design.find(f_name);
+    if (!l_net) {
+      return fail("undeclared net '" + f_name + "'");
+    }
+    f_net = *l_net;
+    return true;
+  }
+
+  bool time(const std::string& f_text, ghls::SimTime& f_out) {
+    std::optional<ghls::SimTime> l_time = ghls::parseSimTime(f_text);
+    if (!l_time) {
+      return fail("bad time '" + f_text + "'");
+    }
+    f_out = *l_time;
+    return true;
+  }
+
+  bool net(const std::vector<std::string>& f_words) {
+    if (!arity(f_words, 2, 4)) {
+      return false;
+    }
+    uint64_t l_width = 1;
+    if (f_words.size() > 2 && (!parseUnsigned(f_words[2], l_width) || l_width == 0 ||
+                               l_width > 64)) {
+      return fail("net width must be 1 to 64");
+    }
+    ghls::Logic l_init = ghls::Logic::x;
+    if (f_words.size() > 3) {
+      static const char kCodes[] = "01zx";
+      const std::string& l_code = f_words[3];
+      if (l_code.size() != 1 || std::string(kCodes).find(l_code[0]) == std::string::npos) {
+        return fail("initial value must be 0, 1, x or z");
+      }
+      l_init = static_cast<ghls::Logic>(std::string(kCodes).find(l_code[0]));
+    }
+    if (c_design.ids.count(f_words[1]) != 0) {
+      return fail("net '" + f_words[1] + "' declared twice");
+    }
+    ghls::NetId l_net = c_design.netlist.addNet(static_cast<uint32_t>(l_width), l_init);
+    c_design.ids.emplace(f_words[1], l_net);
+    c_design.names.push_back(f_words[1]);
+    return true;
+  }
+
+  bool gate(const std::vector<std::string>& f_words) {
+    if (f_words.size() < 2) {
+      return fail("gate needs an operation");
+    }
+    const auto* l_op =
+        std::find_if(std::begin(kGateOps), std::end(kGateOps),
+                     [&](const auto& f_entry) { return f_words[1] == f_entry.name; });
+    if (l_op == std::end(kGateOps)) {
+      return fail("unknown gate '" + f_words[1] + "'");
+    }
+    size_t l_inputs = ghls::gateArity(l_op->op);
+    if (f_words.size() != 3 + l_inputs) {
+      return fail("wrong number of operands for '" + f_words[1] + "'");
+    }
+    ghls::NetId l_nets[4] = {0, 0, 0, 0};
+    for (size_t l_idx = 0; l_idx <= l_inputs; ++l_idx) {
+      if (!lookup(f_words[2 + l_idx], l_nets[l_idx])) {
+        return false;
+      }
+    }
+    for (size_t l_idx = 1; l_idx <= l_inputs; ++l_idx) {
+      if (c_design.netlist.width(l_nets[l_idx]) != c_design.netlist.width(l_nets[0])) {
+        return fail("operand '" + f_words[2 + l_idx] + "' is not as wide as the output");
+      }
+    }
+    c_design.netlist.addGate(l_op->op, l_nets[0], l_nets[1], l_nets[2], l_nets[3]);
+    return true;
+  }
+
+  bool flop(const std::vector<std::string>& f_words) {
+    ghls::NetId l_d = 0, l_q = 0;
+    uint64_t l_domain = 0;
+    if (!arity(f_words, 3, 4) || !lookup(f_words[1], l_d) || !lookup(f_words[2], l_q)) {
+      return false;
+    }
+    if (f_words.size() > 3 && (!parseUnsigned(f_words[3], l_domain) || l_domain > UINT32_MAX)) {
+      return fail("bad clock domain '" + f_words[3] + "'");
+    }
+    if (c_design.netlist.width(l_d) != c_design.netlist.width(l_q)) {
+      return fail("flop d and q differ in width");
+    }
+    c_design.netlist.addFlop(l_d, l_q, static_cast<uint32_t>(l_domain));
+    return true;
+  }
+
+  bool clock(const std::vector<std::string>& f_words) {
+    uint64_t l_domain;
+    ghls::SimTime l_period, l_high, l_phase;
+    if (!arity(f_words, 3, 5)) {
+      return false;
+    }
+    if (!parseUnsigned(f_words[1], l_domain) || l_domain > UINT32_MAX) {
+      return fail("bad clock domain '" + f_words[1] + "'");
+    }
+    if (!time(f_words[2], l_period)) {
+      return false;
+    }
+    l_high = ghls::SimTime::fromTicks(l_period.ticks() / 2);
+    if ((f_words.size() > 3 && !time(f_words[3], l_high)) ||
+        (f_words.size() > 4 && !time(f_words[4], l_phase))) {
+      return false;
+    }
+    if (!(ghls::SimTime() < l_high && l_high < l_period)) {
+      return fail("clock high time must lie strictly within the period");
+    }
+    c_design.clocks.push_back({ghls::Clock(l_period, l_high, l_phase),
+                               static_cast<uint32_t>(l_domain)});
+    return true;
+  }
+
+  bool input(const std::vector<std::string>& f_words) {
+    ghls::Stimulus l_entry;
+    if (!arity(f_words, 4, 4) || !time(f_words[1], l_entry.at) ||
+        !lookup(f_words[2], l_entry.net)) {
+      return false;
+    }
+    const std::string& l_value = f_words[3];
+    uint32_t l_width = c_design.netlist.width(l_entry.net);
+    uint64_t l_mask = l_width == 64 ? ~uint64_t(0) : (uint64_t(1) << l_width) - 1;
+    if (l_value == "x" || l_value == "z") {
+      l_entry.value = {l_value == "x" ? l_mask : 0, l_mask};
+    } else {
+      uint64_t l_bits;
+      if (!parseUnsigned(l_value, l_bits) || (l_bits & ~l_mask) != 0) {
+        return fail("value '" + l_value + "' does not fit the net");
+      }
+      l_entry.value = {l_bits, 0};
+    }
+    c_design.stimulus.push_back(l_entry);
+    return true;
+  }
+
+  bool watch(const std::vector<std::string>& f_words) {
+    if (!arity(f_words, 2, f_words.size())) {
+      return false;
+    }
+    for (size_t l_idx = 1; l_idx < f_words.size(); ++l_idx) {
+      ghls::NetId l_net;
+      if (!lookup(f_words[l_idx], l_net)) {
+        return false;
+      }
+      c_design.watched.push_back(l_net);
+    }
+    return true;
+  }
+
+  ghls::Design& c_design;
+  std::string* c_error;
+  size_t c_line = 0;
+};
+
+}  // namespace
+
+std::optional<ghls::NetId> ghls::Design::find(const std::string& f_name) const {
+  auto l_it = ids.find(f_name);
+  if (l_it == ids.end()) {
+    return std::nullopt;
+  }
+  return l_it->second;
+}
+
+bool ghls::parseDesign(const std::string& f_text, Design& f_out, std::string* f_error) {
+  Parser l_parser(f_out, f_error);
+  size_t l_pos = 0;
+  for (size_t l_line = 1; l_pos < f_text.size(); ++l_line) {
+    size_t l_end = f_text.find('\n', l_pos);
+    l_end = l_end == std::string::npos ? f_text.size() : l_end;
+    std::string l_content = f_text.substr(l_pos, l_end - l_pos);
+    l_content.erase(std::min(l_content.size(), l_content.find('#')));
+    std::vector<std::string> l_words = split(l_content);
+    if (!l_words.empty() && !l_parser.statement(l_words, l_line)) {
+      return false;
+    }
+    l_pos = l_end + 1;
+  }
+  std::stable_sort(
+      f_out.stimulus.begin(), f_out.stimulus.end(),
+      [](const Stimulus& f_lhs, const Stimulus& f_rhs) { return f_lhs.at < f_rhs.at; });
+  return true;
+}
+
+bool ghls::loadDesign(const std::string& f_path, Design& f_out, std::string* f_error) {
+  std::FILE* l_in = std::fopen(f_path.c_str(), "rb");
+  if (l_in == nullptr) {
+    if (f_error != nullptr) {
+      *f_error = "cannot open " + f_path;
+    }
+    return false;
+  }
+  std::string l_text;
+  char l_buf[65536];
+  size_t l_read;
+  while ((l_read = std::fread(l_buf, 1, sizeof(l_buf), l_in)) != 0) {
+    l_text.append(l_buf, l_read);
+  }
+  std::fclose(l_in);
+  return parseDesign(l_text, f_out, f_error);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "clock.hpp"
+#include "netlist.hpp"
+#include "resim.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+struct DesignClock {
+  Clock clock;
+  uint32_t domain;
+};
+
+// Netlist, clocks and stimulus read from a text description, one statement
+// per line, '#' starting a comment:
+//
+//   net <name> [width] [0|1|x|z]          width 1 and x by default
+//   gate <op> <out> <in>...               op as in GateOp, e.g. and2 or mux2
+//   flop <d> <q> [domain]                 domain 0 by default
+//   clock <domain> <period> [high] [phase]  high half the period by default
+//   input <time> <net> <value>            value decimal, 0x hex, x or z
+//   watch <net>...
+//
+// Nets are declared before use. Times take a unit, e.g. 10ns or 2.5us.
+struct Design {
+  Netlist netlist;
+  // Indexed by NetId
+  std::vector<std::string> names;
+  std::vector<DesignClock> clocks;
+  // In time order, equal times in file order
+  std::vector<Stimulus> stimulus;
+  std::vector<NetId> watched;
+  std::unordered_map<std::string, NetId> ids;
+
+  std::optional<NetId> find(const std::string& f_name) const;
+};
+
+// false on the first malformed statement; f_error gets "line <n>: <reason>"
+bool parseDesign(const std::string& f_text, Design& f_out, std::string* f_error = nullptr);
+bool loadDesign(const std::string& f_path, Design& f_out, std::string* f_error = nullptr);
+
+}  // namespace ghls
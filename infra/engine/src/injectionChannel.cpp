@@ -0,0 +1,110 @@
+#include "injectionChannel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace {
+
+// Failed attempts a blocked producer spins before yielding its time slice
+constexpr int kSpinLimit = 64;
+
+}  // namespace
+
+ghls::InjectionChannel::InjectionChannel(Scheduler& f_sched, size_t f_capacity)
+    : c_sched(f_sched), c_tail(0), c_stalls(0), c_head(0), c_drained(0), c_late(0) {
+  uint64_t l_capacity = 2;
+  while (l_capacity < f_capacity) {
+    l_capacity *= 2;
+  }
+  c_mask = l_capacity - 1;
+  c_slots.reset(new Slot[l_capacity]);
+  // A slot is free for position p while its sequence is p, and holds the
+  // event of position p once the sequence is p + 1
+  for (uint64_t l_idx = 0; l_idx < l_capacity; ++l_idx) {
+    c_slots[l_idx].seq.store(l_idx, std::memory_order_relaxed);
+  }
+  c_sched.addStepHook(onStep, this);
+}
+
+ghls::InjectionChannel::~InjectionChannel() { c_sched.removeStepHook(onStep, this); }
+
+bool ghls::InjectionChannel::tryPost(const Injection* f_events, size_t f_count) noexcept {
+  assert(f_count <= capacity() && "batch larger than the channel");
+  if (f_count == 0) {
+    return true;
+  }
+  uint64_t l_pos = c_tail.load(std::memory_order_relaxed);
+  for (;;) {
+    // The consumer frees slots in order, so the last slot of the batch being
+    // free means the whole range is
+    uint64_t l_last = l_pos + f_count - 1;
+    uint64_t l_seq = c_slots[l_last & c_mask].seq.load(std::memory_order_acquire);
+    int64_t l_diff = static_cast<int64_t>(l_seq - l_last);
+    if (l_diff == 0) {
+      if (c_tail.compare_exchange_weak(l_pos, l_pos + f_count, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (l_diff < 0) {
+      return false;
+    } else {
+      l_pos = c_tail.load(std::memory_order_relaxed);
+    }
+  }
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    Slot& l_slot = c_slots[(l_pos + l_idx) & c_mask];
+    l_slot.event = f_events[l_idx];
+    l_slot.seq.store(l_pos + l_idx + 1, std::memory_order_release);
+  }
+  return true;
+}
+
+void ghls::InjectionChannel::post(const Injection* f_events, size_t f_count) noexcept {
+  while (f_count > 0) {
+    size_t l_chunk = std::min<size_t>(f_count, capacity());
+    int l_spins = 0;
+    bool l_stalled = false;
+    while (!tryPost(f_events, l_chunk)) {
+      if (!l_stalled) {
+        l_stalled = true;
+        c_stalls.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (++l_spins > kSpinLimit) {
+        std::this_thread::yield();
+      }
+    }
+    f_events += l_chunk;
+    f_count -= l_chunk;
+  }
+}
+
+size_t ghls::InjectionChannel::drain() {
+  size_t l_count = 0;
+  const SimTime l_now = c_sched.now();
+  uint64_t l_head = c_head.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& l_slot = c_slots[l_head & c_mask];
+    if (l_slot.seq.load(std::memory_order_acquire) != l_head + 1) {
+      break;
+    }
+    Injection l_event = l_slot.event;
+    l_slot.seq.store(l_head + capacity(), std::memory_order_release);
+    c_head.store(++l_head, std::memory_order_relaxed);
+    if (l_event.time < l_now) {
+      l_event.time = l_now;
+      ++c_late;
+    }
+    c_sched.scheduleAt(l_event.time, l_event.fn, l_event.ctx, l_event.arg);
+    ++l_count;
+  }
+  c_drained += l_count;
+  return l_count;
+}
+
+size_t ghls::InjectionChannel::pending() const noexcept {
+  uint64_t l_head = c_head.load(std::memory_order_relaxed);
+  uint64_t l_tail = c_tail.load(std::memory_order_relaxed);
+  return l_tail > l_head ? static_cast<size_t>(l_tail - l_head) : 0;
+}
+
+void ghls::InjectionChannel::onStep(void* f_ctx) { static_cast<InjectionChannel*>(f_ctx)->drain(); }
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "scheduler.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+// Event posted from outside the simulation thread, at an absolute time
+struct Injection {
+  SimTime time;
+  EventFn fn;
+  void* ctx;
+  uint64_t arg;
+};
+
+// Bounded lock-free multi-producer single-consumer channel through which
+// testbench, reference-model or co-simulation threads post events into a
+// Scheduler. Producers claim slots with one compare-and-swap on the tail
+// (one per batch, not per event) and publish each slot through its sequence
+// number; nothing blocks the simulation thread.
+//
+// The channel adds itself to the scheduler's step hooks and drains at
+// every timestep boundary. Events from one producer are queued in the order
+// posted; the interleaving between producers is the order in which their
+// slots were claimed. Events whose time has already passed fire at the
+// current time and are counted by late().
+class InjectionChannel {
+ public:
+  // Capacity is rounded up to a power of two
+  explicit InjectionChannel(Scheduler& f_sched, size_t f_capacity = 4096);
+  ~InjectionChannel();
+  InjectionChannel(const InjectionChannel&) = delete;
+  InjectionChannel& operator=(const InjectionChannel&) = delete;
+
+  size_t capacity() const noexcept { return c_mask + 1; }
+
+  // Producer side, callable from any thread. The try forms return false
+  // without posting anything when the channel lacks room; a batch is
+  // posted whole or not at all and must fit the capacity.
+  bool tryPost(const Injection& f_event) noexcept { return tryPost(&f_event, 1); }
+  bool tryPost(const Injection* f_events, size_t f_count) noexcept;
+  // Waits for room (backpressure) instead of failing; batches larger than
+  // the capacity are posted in pieces
+  void post(const Injection& f_event) noexcept { post(&f_event, 1); }
+  void post(const Injection* f_events, size_t f_count) noexcept;
+
+  // Consumer side, on the simulation thread: moves every published event
+  // into the scheduler. Called automatically at timestep boundaries.
+  size_t drain();
+
+  // Approximate number of events waiting to be drained
+  size_t pending() const noexcept;
+  uint64_t drained() const noexcept { return c_drained; }
+  uint64_t late() const noexcept { return c_late; }
+  // Times a producer found the channel full and had to wait
+  uint64_t stalls() const noexcept { return c_stalls.load(std::memory_order_relaxed); }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> seq;
+    Injection event;
+  };
+
+  static void onStep(void* f_ctx);
+
+  Scheduler& c_sched;
+  std::unique_ptr<Slot[]> c_slots;
+  uint64_t c_mask;
+  alignas(64) std::atomic<uint64_t> c_tail;
+  std::atomic<uint64_t> c_stalls;
+  alignas(64) std::atomic<uint64_t> c_head;
+  uint64_t c_drained;
+  uint64_t c_late;
+};
+
+}  // namespace ghls
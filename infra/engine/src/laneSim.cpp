@@ -0,0 +1,186 @@
+#include "laneSim.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// The operation is fixed per instruction, so the word loop is branch-free
+template <ghls::GateOp kOp>
+void evalSlices(ghls::LogicWord* f_out, const ghls::LogicWord* f_a, const ghls::LogicWord* f_b,
+                const ghls::LogicWord* f_c, size_t f_words) noexcept {
+  for (size_t l_word = 0; l_word < f_words; ++l_word) {
+    f_out[l_word] = ghls::evalGate(kOp, f_a[l_word], f_b[l_word], f_c[l_word]);
+  }
+}
+
+}  // namespace
+
+ghls::LaneSim::LaneSim(const Netlist& f_netlist, Scheduler& f_sched, size_t f_lanes)
+    : c_sched(f_sched),
+      c_clocks(f_sched, onClock, this),
+      c_words(f_lanes / 64),
+      c_gates(f_netlist.gates().size()),
+      c_domainSlices(f_netlist.domains()),
+      c_passes(0),
+      c_compiled(false),
+      c_dirty(false) {
+  assert(f_lanes > 0 && f_lanes % 64 == 0 && "lanes come in words of 64");
+  uint32_t l_slices = 0;
+  for (NetId l_net = 0; l_net < f_netlist.nets(); ++l_net) {
+    c_offsets.push_back(l_slices);
+    c_widths.push_back(f_netlist.width(l_net));
+    l_slices += f_netlist.width(l_net);
+  }
+  c_values.reserve(size_t(l_slices) * c_words);
+  for (NetId l_net = 0; l_net < f_netlist.nets(); ++l_net) {
+    uint8_t l_init = static_cast<uint8_t>(f_netlist.init(l_net));
+    LogicWord l_word{(l_init & 1) != 0 ? ~uint64_t(0) : 0, (l_init & 2) != 0 ? ~uint64_t(0) : 0};
+    c_values.insert(c_values.end(), size_t(c_widths[l_net]) * c_words, l_word);
+  }
+  for (const Flop& l_flop : f_netlist.flops()) {
+    for (uint32_t l_bit = 0; l_bit < c_widths[l_flop.d]; ++l_bit) {
+      c_domainSlices[l_flop.domain].emplace_back(c_offsets[l_flop.d] + l_bit,
+                                                 c_offsets[l_flop.q] + l_bit);
+    }
+  }
+
+  std::optional<std::vector<uint32_t>> l_order = f_netlist.levelize();
+  if (!l_order) {
+    return;
+  }
+  c_compiled = true;
+  for (uint32_t l_idx : *l_order) {
+    const Gate& l_gate = f_netlist.gates()[l_idx];
+    for (uint32_t l_bit = 0; l_bit < c_widths[l_gate.out]; ++l_bit) {
+      c_program.push_back({l_gate.op,
+                           c_offsets[l_gate.out] + l_bit,
+                           {c_offsets[l_gate.in[0]] + l_bit, c_offsets[l_gate.in[1]] + l_bit,
+                            c_offsets[l_gate.in[2]] + l_bit}});
+    }
+  }
+  c_sched.setDeltaHook(onDelta, this);
+  evaluate();
+}
+
+void ghls::LaneSim::setInput(NetId f_net, size_t f_lane, LogicWord f_value) {
+  assert(f_lane < lanes());
+  uint64_t l_lane = uint64_t(1) << (f_lane % 64);
+  for (uint32_t l_bit = 0; l_bit < c_widths[f_net]; ++l_bit) {
+    stage((c_offsets[f_net] + l_bit) * c_words + f_lane / 64, l_lane,
+          {(f_value.aval >> l_bit & 1) != 0 ? l_lane : 0,
+           (f_value.bval >> l_bit & 1) != 0 ? l_lane : 0});
+  }
+}
+
+void ghls::LaneSim::setInput(NetId f_net, LogicWord f_value) {
+  for (uint32_t l_bit = 0; l_bit < c_widths[f_net]; ++l_bit) {
+    LogicWord l_lanes{(f_value.aval >> l_bit & 1) != 0 ? ~uint64_t(0) : 0,
+                      (f_value.bval >> l_bit & 1) != 0 ? ~uint64_t(0) : 0};
+    for (size_t l_word = 0; l_word < c_words; ++l_word) {
+      stage((c_offsets[f_net] + l_bit) * c_words + l_word, ~uint64_t(0), l_lanes);
+    }
+  }
+}
+
+void ghls::LaneSim::setLanes(NetId f_net, uint32_t f_bit, size_t f_word, LogicWord f_lanes) {
+  assert(f_bit < c_widths[f_net] && f_word < c_words);
+  stage((c_offsets[f_net] + f_bit) * c_words + f_word, ~uint64_t(0), f_lanes);
+}
+
+ghls::LogicWord ghls::LaneSim::value(NetId f_net, size_t f_lane) const noexcept {
+  LogicWord l_value{0, 0};
+  for (uint32_t l_bit = 0; l_bit < c_widths[f_net]; ++l_bit) {
+    const LogicWord& l_word = c_values[(c_offsets[f_net] + l_bit) * c_words + f_lane / 64];
+    l_value.aval |= (l_word.aval >> (f_lane % 64) & 1) << l_bit;
+    l_value.bval |= (l_word.bval >> (f_lane % 64) & 1) << l_bit;
+  }
+  return l_value;
+}
+
+void ghls::LaneSim::evaluate() noexcept {
+  LogicWord* l_values = c_values.data();
+  const size_t l_words = c_words;
+  for (const Instr& l_instr : c_program) {
+    LogicWord* l_out = l_values + l_instr.out * l_words;
+    const LogicWord* l_a = l_values + l_instr.in[0] * l_words;
+    const LogicWord* l_b = l_values + l_instr.in[1] * l_words;
+    const LogicWord* l_c = l_values + l_instr.in[2] * l_words;
+    switch (l_instr.op) {
+      case GateOp::buf:
+        evalSlices<GateOp::buf>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::inv:
+        evalSlices<GateOp::inv>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::and2:
+        evalSlices<GateOp::and2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::or2:
+        evalSlices<GateOp::or2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::xor2:
+        evalSlices<GateOp::xor2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::nand2:
+        evalSlices<GateOp::nand2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::nor2:
+        evalSlices<GateOp::nor2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::xnor2:
+        evalSlices<GateOp::xnor2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+      case GateOp::mux2:
+        evalSlices<GateOp::mux2>(l_out, l_a, l_b, l_c, l_words);
+        break;
+    }
+  }
+  ++c_passes;
+}
+
+void ghls::LaneSim::stage(size_t f_word, uint64_t f_mask, LogicWord f_value) {
+  c_inputWrites.push_back({f_word, f_mask, f_value});
+  if (!c_dirty) {
+    c_dirty = true;
+    c_sched.scheduleDelta(onInput, this);
+  }
+}
+
+void ghls::LaneSim::onDelta(void* f_ctx) {
+  LaneSim* l_sim = static_cast<LaneSim*>(f_ctx);
+  if (l_sim->c_dirty) {
+    l_sim->c_dirty = false;
+    const size_t l_words = l_sim->c_words;
+    for (size_t l_idx = 0; l_idx < l_sim->c_sampledQ.size(); ++l_idx) {
+      std::copy_n(&l_sim->c_sampled[l_idx * l_words], l_words,
+                  &l_sim->c_values[l_sim->c_sampledQ[l_idx] * l_words]);
+    }
+    l_sim->c_sampled.clear();
+    l_sim->c_sampledQ.clear();
+    for (const LaneWrite& l_write : l_sim->c_inputWrites) {
+      LogicWord& l_word = l_sim->c_values[l_write.word];
+      l_word.aval = (l_word.aval & ~l_write.mask) | (l_write.value.aval & l_write.mask);
+      l_word.bval = (l_word.bval & ~l_write.mask) | (l_write.value.bval & l_write.mask);
+    }
+    l_sim->c_inputWrites.clear();
+    l_sim->evaluate();
+  }
+}
+
+void ghls::LaneSim::onClock(void* f_ctx, uint32_t f_domain) {
+  LaneSim* l_sim = static_cast<LaneSim*>(f_ctx);
+  if (f_domain >= l_sim->c_domainSlices.size()) {
+    return;
+  }
+  const auto& l_slices = l_sim->c_domainSlices[f_domain];
+  const size_t l_words = l_sim->c_words;
+  // Q slices are written at the end of the delta cycle, so flop chains shift
+  // correctly within and across domains
+  for (const std::pair<uint32_t, uint32_t>& l_slice : l_slices) {
+    l_sim->c_sampled.insert(l_sim->c_sampled.end(), &l_sim->c_values[l_slice.first * l_words],
+                            &l_sim->c_values[l_slice.first * l_words] + l_words);
+    l_sim->c_sampledQ.push_back(l_slice.second);
+  }
+  l_sim->c_dirty = true;
+}
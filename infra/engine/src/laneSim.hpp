@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "clock.hpp"
+#include "netlist.hpp"
+#include "scheduler.hpp"
+
+namespace ghls {
+
+// Bit-parallel multi-stimulus simulation of a Netlist. Every net bit is a
+// slice of lanes() independent instances, 64 per machine word, evaluated
+// together by the levelized program of CompiledSim. All lanes share one
+// timeline and clocks; only stimulus and state differ per lane. Lane counts
+// above 64 add words per slice, which the compiler vectorizes.
+class LaneSim {
+ public:
+  LaneSim(const Netlist& f_netlist, Scheduler& f_sched, size_t f_lanes = 64);
+  LaneSim(const LaneSim&) = delete;
+  LaneSim& operator=(const LaneSim&) = delete;
+
+  // False if the netlist has a combinational loop and cannot be levelized
+  bool compiled() const noexcept { return c_compiled; }
+  size_t lanes() const noexcept { return c_words * 64; }
+
+  void addClock(const Clock& f_clock, uint32_t f_domain) { c_clocks.add(f_clock, f_domain); }
+
+  // Drives a primary input in one lane, or in every lane. As with
+  // CompiledSim the value is committed, and the pass runs, at the end of the
+  // current delta cycle.
+  void setInput(NetId f_net, size_t f_lane, LogicWord f_value);
+  void setInput(NetId f_net, LogicWord f_value);
+  // Drives bit f_bit of a primary input in lanes 64 * f_word to 64 * f_word + 63
+  void setLanes(NetId f_net, uint32_t f_bit, size_t f_word, LogicWord f_lanes);
+
+  LogicWord value(NetId f_net, size_t f_lane) const noexcept;
+  LogicWord lanesOf(NetId f_net, uint32_t f_bit, size_t f_word) const noexcept {
+    return c_values[(c_offsets[f_net] + f_bit) * c_words + f_word];
+  }
+
+  // Evaluates the whole program once in every lane
+  void evaluate() noexcept;
+
+  size_t instructions() const noexcept { return c_program.size(); }
+  uint64_t passes() const noexcept { return c_passes; }
+  // Gate evaluations summed over all lanes
+  uint64_t gateEvaluations() const noexcept { return c_passes * c_gates * lanes(); }
+
+ private:
+  // One gate on one bit slice
+  struct Instr {
+    GateOp op;
+    uint32_t out;
+    uint32_t in[3];
+  };
+  // Input write to the lanes in mask of one word of c_values
+  struct LaneWrite {
+    size_t word;
+    uint64_t mask;
+    LogicWord value;
+  };
+
+  static void onDelta(void* f_ctx);
+  static void onClock(void* f_ctx, uint32_t f_domain);
+  static void onInput(void*, uint64_t) {}
+  void stage(size_t f_word, uint64_t f_mask, LogicWord f_value);
+
+  Scheduler& c_sched;
+  ClockDriver c_clocks;
+  size_t c_words;
+  size_t c_gates;
+  std::vector<uint32_t> c_offsets;
+  std::vector<uint32_t> c_widths;
+  std::vector<Instr> c_program;
+  std::vector<LogicWord> c_values;
+  // Per domain, the (d, q) slice pairs of its flops
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> c_domainSlices;
+  // D slices sampled by this delta cycle's edges and the Q slices they go
+  // to, applied before the pass so every domain with an edge at the same
+  // time samples pre-edge values
+  std::vector<LogicWord> c_sampled;
+  std::vector<uint32_t> c_sampledQ;
+  // Input writes of this delta cycle, in call order
+  std::vector<LaneWrite> c_inputWrites;
+  uint64_t c_passes;
+  bool c_compiled;
+  bool c_dirty;
+};
+
+}  // namespace ghls
@@ -1,9 +1,397 @@
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include <sys/resource.h>
+
+#include "compiledSim.hpp"
+#include "design.hpp"
+#include "profiler.hpp"
+#include "scheduler.hpp"
 #include "simTime.hpp"
+#include "waveWriter.hpp"
+
+// Command-line driver: simulates a design description (see design.hpp) up to
+// a given time with the compiled engine and reports throughput, for people
+// and, as JSON, for CI trend tracking.
+
+namespace {
+
+constexpr const char* kUsage =
+    "usage: simTime_main <design> --until <time> [options]\n"
+    "  --until <time>        simulated end time with unit, e.g. 100us\n"
+    "  --replicas <n>        run n independent copies on n threads (default 1, 0 = all cores)\n"
+    "  --native              compile the design to native code\n"
+    "  --fast-forward        skip clock edges while the design is idle\n"
+    "  --wave <path>         dump watched nets (all nets without watch lines)\n"
+    "  --wave-format <fmt>   vcd (default) or binary\n"
+    "  --profile <path>      write a folded-stack profile and print the summary\n"
+    "  --json <path>         write the statistics as JSON, '-' for stdout\n";
+
+struct Options {
+  std::string design;
+  ghls::SimTime until;
+  bool untilSet = false;
+  unsigned replicas = 1;
+  bool native = false;
+  bool fastForward = false;
+  std::string wave;
+  ghls::WaveFormat waveFormat = ghls::WaveFormat::vcd;
+  std::string profile;
+  std::string json;
+};
+
+bool usageError(const std::string& f_what) {
+  std::fprintf(stderr, "simTime_main: %s\n%s", f_what.c_str(), kUsage);
+  return false;
+}
+
+bool parseOptions(int f_argc, char** f_argv, Options& f_out) {
+  for (int l_idx = 1; l_idx < f_argc; ++l_idx) {
+    std::string l_arg = f_argv[l_idx];
+    bool l_hasValue = l_idx + 1 < f_argc;
+    auto l_value = [&]() { return std::string(f_argv[++l_idx]); };
+    if (l_arg == "--native") {
+      f_out.native = true;
+    } else if (l_arg == "--fast-forward") {
+      f_out.fastForward = true;
+    } else if (l_arg == "--until" && l_hasValue) {
+      std::string l_text = l_value();
+      std::optional<ghls::SimTime> l_time = ghls::parseSimTime(l_text);
+      if (!l_time) {
+        return usageError("bad time '" + l_text + "'");
+      }
+      f_out.until = *l_time;
+      f_out.untilSet = true;
+    } else if (l_arg == "--replicas" && l_hasValue) {
+      char* l_end;
+      std::string l_text = l_value();
+      unsigned long l_replicas = std::strtoul(l_text.c_str(), &l_end, 10);
+      if (l_text.empty() || *l_end != '\0' || l_replicas > 4096) {
+        return usageError("bad replica count '" + l_text + "'");
+      }
+      f_out.replicas = l_replicas != 0 ? static_cast<unsigned>(l_replicas)
+                                       : std::max(1u, std::thread::hardware_concurrency());
+    } else if (l_arg == "--wave" && l_hasValue) {
+      f_out.wave = l_value();
+    } else if (l_arg == "--wave-format" && l_hasValue) {
+      std::string l_format = l_value();
+      if (l_format != "vcd" && l_format != "binary") {
+        return usageError("unknown wave format '" + l_format + "'");
+      }
+      f_out.waveFormat = l_format == "vcd" ? ghls::WaveFormat::vcd : ghls::WaveFormat::binary;
+    } else if (l_arg == "--profile" && l_hasValue) {
+      f_out.profile = l_value();
+    } else if (l_arg == "--json" && l_hasValue) {
+      f_out.json = l_value();
+    } else if (l_arg == "--help" || l_arg == "-h") {
+      std::fputs(kUsage, stdout);
+      std::exit(0);
+    } else if (l_arg.compare(0, 2, "--") != 0 && f_out.design.empty()) {
+      f_out.design = l_arg;
+    } else {
+      return usageError("unexpected argument '" + l_arg + "'");
+    }
+  }
+  if (f_out.design.empty() || !f_out.untilSet) {
+    return usageError("a design and --until are required");
+  }
+  return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point f_start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - f_start).count();
+}
+
+// Largest resident set of the process so far
+uint64_t peakRssBytes() {
+  struct rusage l_usage;
+  if (::getrusage(RUSAGE_SELF, &l_usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast<uint64_t>(l_usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(l_usage.ru_maxrss) * 1024;
+#endif
+}
+
+// One copy of the design with its own scheduler; the netlist is shared
+struct Replica {
+  explicit Replica(const ghls::Design& f_design) : design(f_design), sim(f_design.netlist, sched) {}
+
+  static void onStimulus(void* f_ctx, uint64_t f_first) {
+    Replica* l_replica = static_cast<Replica*>(f_ctx);
+    const std::vector<ghls::Stimulus>& l_list = l_replica->design.stimulus;
+    size_t l_idx = f_first;
+    for (; l_idx < l_list.size() && l_list[l_idx].at == l_list[f_first].at; ++l_idx) {
+      l_replica->sim.setInput(l_list[l_idx].net, l_list[l_idx].value);
+    }
+    // Only the next stimulus time is queued at any moment
+    if (l_idx < l_list.size()) {
+      l_replica->sched.scheduleAt(l_list[l_idx].at, onStimulus, l_replica, l_idx);
+    }
+  }
+
+  static void onStep(void* f_ctx) {
+    Replica* l_replica = static_cast<Replica*>(f_ctx);
+    ghls::SimTime l_now = l_replica->sched.now();
+    for (size_t l_idx = 0; l_idx < l_replica->dumped.size(); ++l_idx) {
+      ghls::LogicWord l_value = l_replica->sim.value(l_replica->dumped[l_idx]);
+      if (l_value != l_replica->lastSeen[l_idx]) {
+        l_replica->lastSeen[l_idx] = l_value;
+        l_replica->wave->change(l_now, l_replica->signals[l_idx], l_value);
+      }
+    }
+  }
+
+  // Dumps the current values and then every change seen between timesteps
+  void dumpTo(ghls::WaveWriter& f_wave, const std::vector<ghls::NetId>& f_nets) {
+    wave = &f_wave;
+    dumped = f_nets;
+    for (ghls::NetId l_net : f_nets) {
+      signals.push_back(f_wave.declare(design.names[l_net], design.netlist.width(l_net)));
+      lastSeen.push_back(sim.value(l_net));
+    }
+    for (size_t l_idx = 0; l_idx < f_nets.size(); ++l_idx) {
+      f_wave.change(sched.now(), signals[l_idx], lastSeen[l_idx]);
+    }
+    sched.addStepHook(onStep, this);
+  }
+
+  void run(ghls::SimTime f_until) {
+    if (!design.stimulus.empty()) {
+      sched.scheduleAt(design.stimulus.front().at, onStimulus, this, 0);
+    }
+    sched.runUntil(f_until);
+  }
+
+  const ghls::Design& design;
+  ghls::Scheduler sched;
+  ghls::CompiledSim sim;
+  ghls::WaveWriter* wave = nullptr;
+  std::vector<ghls::NetId> dumped;
+  std::vector<ghls::WaveSignal> signals;
+  std::vector<ghls::LogicWord> lastSeen;
+};
+
+struct Phases {
+  double load = 0.0;
+  double build = 0.0;
+  double simulate = 0.0;
+  double finish = 0.0;
+};
+
+std::string rateString(ghls::SimTime f_until, double f_seconds) {
+  double l_ticks = f_seconds > 0.0 ? static_cast<double>(f_until.ticks()) / f_seconds : 0.0;
+  ghls::SimTime l_rate = ghls::SimTime::fromTicks(static_cast<ghls::SimTick>(l_ticks));
+  return ghls::conv2str(l_rate, ghls::bestUnit(l_rate)) + "/s";
+}
+
+// Tick counts may exceed 64 bits in wide builds, so they are formatted as text
+std::string ticksString(ghls::SimTime f_time) {
+  char l_buf[ghls::kSimTimeStrMax];
+  return std::string(l_buf, ghls::formatTicks(l_buf, l_buf + sizeof(l_buf), f_time.ticks()));
+}
+
+void writeJson(std::FILE* f_out, const Options& f_options, const ghls::Design& f_design,
+               const std::vector<std::unique_ptr<Replica>>& f_replicas, const Phases& f_phases,
+               uint64_t f_rss) {
+  const ghls::CompiledSim& l_sim = f_replicas.front()->sim;
+  uint64_t l_events = 0, l_steps = 0, l_deltas = 0, l_passes = 0, l_gateEvals = 0;
+  for (const auto& l_replica : f_replicas) {
+    l_events += l_replica->sched.eventsExecuted();
+    l_steps += l_replica->sched.timeSteps();
+    l_deltas += l_replica->sched.deltaCycles();
+    l_passes += l_replica->sim.passes();
+    l_gateEvals += l_replica->sim.gateEvaluations();
+  }
+  // Replicas run the same design side by side, so throughput is per copy
+  double l_wall = f_phases.simulate > 0.0 ? f_phases.simulate : 1e-9;
+  double l_perCopy = l_wall * static_cast<double>(f_replicas.size());
+  std::fprintf(f_out, "{\n");
+  std::fprintf(f_out, "  \"design\": {\"path\": \"");
+  for (char l_ch : f_options.design) {
+    if (l_ch == '"' || l_ch == '\\') {
+      std::fputc('\\', f_out);
+    }
+    std::fputc(l_ch, f_out);
+  }
+  std::fprintf(f_out, "\", \"nets\": %zu, \"gates\": %zu, \"flops\": %zu, \"clocks\": %zu,",
+               f_design.netlist.nets(), f_design.netlist.gates().size(),
+               f_design.netlist.flops().size(), f_design.clocks.size());
+  std::fprintf(f_out, " \"stimulus\": %zu, \"levels\": %u},\n", f_design.stimulus.size(),
+               l_sim.levels());
+  std::fprintf(f_out,
+               "  \"config\": {\"replicas\": %zu, \"native\": %s, \"fast_forward\": %s,"
+               " \"wave\": %s, \"profile\": %s},\n",
+               f_replicas.size(), l_sim.native() != nullptr ? "true" : "false",
+               f_options.fastForward ? "true" : "false", f_options.wave.empty() ? "false" : "true",
+               f_options.profile.empty() ? "false" : "true");
+  std::fprintf(f_out, "  \"sim_time_fs\": %s,\n", ticksString(f_options.until).c_str());
+  std::fprintf(f_out,
+               "  \"phases_s\": {\"load\": %.6f, \"build\": %.6f, \"simulate\": %.6f,"
+               " \"finish\": %.6f},\n",
+               f_phases.load, f_phases.build, f_phases.simulate, f_phases.finish);
+  std::fprintf(f_out,
+               "  \"throughput\": {\"sim_seconds_per_wall_second\": %.9g,"
+               " \"events_per_second\": %.6g, \"gate_evals_per_second\": %.6g},\n",
+               f_options.until.simTimeInSec() / l_wall, static_cast<double>(l_events) / l_perCopy,
+               static_cast<double>(l_gateEvals) / l_perCopy);
+  std::fprintf(f_out,
+               "  \"counts\": {\"events\": %llu, \"time_steps\": %llu, \"delta_cycles\": %llu,"
+               " \"passes\": %llu, \"gate_evals\": %llu},\n",
+               static_cast<unsigned long long>(l_events), static_cast<unsigned long long>(l_steps),
+               static_cast<unsigned long long>(l_deltas),
+               static_cast<unsigned long long>(l_passes),
+               static_cast<unsigned long long>(l_gateEvals));
+  std::fprintf(f_out,
+               "  \"fast_forward\": {\"skipped_fs\": %s, \"skipped_edges\": %llu,"
+               " \"fast_forwards\": %llu},\n",
+               ticksString(l_sim.skippedTime()).c_str(),
+               static_cast<unsigned long long>(l_sim.skippedEdges()),
+               static_cast<unsigned long long>(l_sim.fastForwards()));
+  std::fprintf(f_out, "  \"peak_rss_bytes\": %llu\n}\n", static_cast<unsigned long long>(f_rss));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options l_options;
+  if (!parseOptions(argc, argv, l_options)) {
+    return 2;
+  }
+  Phases l_phases;
+
+  auto l_start = std::chrono::steady_clock::now();
+  ghls::Design l_design;
+  std::string l_error;
+  if (!ghls::loadDesign(l_options.design, l_design, &l_error)) {
+    std::fprintf(stderr, "simTime_main: %s: %s\n", l_options.design.c_str(), l_error.c_str());
+    return 1;
+  }
+  l_phases.load = secondsSince(l_start);
+
+  // Build: levelize every copy and compile the native pass once; the other
+  // copies load it from the cache
+  l_start = std::chrono::steady_clock::now();
+  std::vector<std::unique_ptr<Replica>> l_replicas;
+  for (unsigned l_idx = 0; l_idx < l_options.replicas; ++l_idx) {
+    l_replicas.push_back(std::make_unique<Replica>(l_design));
+    Replica& l_replica = *l_replicas.back();
+    if (!l_replica.sim.compiled()) {
+      std::fprintf(stderr, "simTime_main: the design has a combinational loop\n");
+      return 1;
+    }
+    for (const ghls::DesignClock& l_clock : l_design.clocks) {
+      l_replica.sim.addClock(l_clock.clock, l_clock.domain);
+    }
+    l_replica.sim.setFastForward(l_options.fastForward);
+    if (l_options.native && !l_replica.sim.useNative({}, &l_error)) {
+      std::fprintf(stderr, "simTime_main: native compile failed: %s\n", l_error.c_str());
+      return 1;
+    }
+  }
+  Replica& l_first = *l_replicas.front();
+  ghls::WaveWriter l_wave;
+  if (!l_options.wave.empty()) {
+    if (!l_wave.open(l_options.wave, l_options.waveFormat)) {
+      std::fprintf(stderr, "simTime_main: cannot write %s\n", l_options.wave.c_str());
+      return 1;
+    }
+    std::vector<ghls::NetId> l_nets = l_design.watched;
+    if (l_nets.empty()) {
+      l_nets.resize(l_design.netlist.nets());
+      std::iota(l_nets.begin(), l_nets.end(), ghls::NetId(0));
+    }
+    l_first.dumpTo(l_wave, l_nets);
+  }
+  ghls::Profiler l_profiler(l_first.sched);
+  if (!l_options.profile.empty()) {
+    l_profiler.name(Replica::onStimulus, "stimulus");
+    l_first.sim.nameEvents(l_profiler, "sim");
+    l_profiler.enable();
+  }
+  l_phases.build = secondsSince(l_start);
+
+  // Simulate: copies beyond the first run on their own threads
+  l_start = std::chrono::steady_clock::now();
+  std::vector<std::thread> l_threads;
+  for (size_t l_idx = 1; l_idx < l_replicas.size(); ++l_idx) {
+    l_threads.emplace_back([&, l_idx]() { l_replicas[l_idx]->run(l_options.until); });
+  }
+  l_first.run(l_options.until);
+  for (std::thread& l_thread : l_threads) {
+    l_thread.join();
+  }
+  l_phases.simulate = secondsSince(l_start);
+
+  // Finish: drain the waveform writer and write the reports
+  l_start = std::chrono::steady_clock::now();
+  l_profiler.disable();
+  bool l_ok = true;
+  if (l_wave.isOpen()) {
+    l_wave.close();
+  }
+  if (!l_options.profile.empty()) {
+    if (!l_profiler.writeFolded(l_options.profile)) {
+      std::fprintf(stderr, "simTime_main: cannot write %s\n", l_options.profile.c_str());
+      l_ok = false;
+    }
+    l_profiler.writeSummary(stderr);
+  }
+  l_phases.finish = secondsSince(l_start);
+  uint64_t l_rss = peakRssBytes();
+
+  uint64_t l_events = 0;
+  for (const auto& l_replica : l_replicas) {
+    l_events += l_replica->sched.eventsExecuted();
+  }
+  double l_wall = l_phases.simulate > 0.0 ? l_phases.simulate : 1e-9;
+  double l_perCopy = l_wall * static_cast<double>(l_replicas.size());
+  // With the JSON on stdout the summary moves to stderr
+  std::FILE* l_report = l_options.json == "-" ? stderr : stdout;
+  std::fprintf(l_report, "design      %s: %zu nets, %zu gates, %zu flops, %u levels\n",
+               l_options.design.c_str(), l_design.netlist.nets(), l_design.netlist.gates().size(),
+               l_design.netlist.flops().size(), l_first.sim.levels());
+  std::fprintf(l_report, "simulated   %s x %zu in %.3f s: %s per copy\n",
+               ghls::conv2str(l_options.until, ghls::bestUnit(l_options.until)).c_str(),
+               l_replicas.size(), l_phases.simulate,
+               rateString(l_options.until, l_phases.simulate).c_str());
+  std::fprintf(l_report, "events      %llu, %.3g/s per copy\n",
+               static_cast<unsigned long long>(l_events),
+               static_cast<double>(l_events) / l_perCopy);
+  if (l_options.fastForward) {
+    ghls::SimTime l_skipped = l_first.sim.skippedTime();
+    std::fprintf(l_report, "skipped     %s in %llu fast-forwards\n",
+                 ghls::conv2str(l_skipped, ghls::bestUnit(l_skipped)).c_str(),
+                 static_cast<unsigned long long>(l_first.sim.fastForwards()));
+  }
+  if (!l_options.wave.empty()) {
+    std::fprintf(l_report, "wave        %s, %llu bytes\n", l_options.wave.c_str(),
+                 static_cast<unsigned long long>(l_wave.bytesWritten()));
+  }
+  std::fprintf(l_report, "phases      load %.3f s, build %.3f s, simulate %.3f s, finish %.3f s\n",
+               l_phases.load, l_phases.build, l_phases.simulate, l_phases.finish);
+  std::fprintf(l_report, "peak rss    %.1f MiB\n", static_cast<double>(l_rss) / (1024.0 * 1024.0));
 
-int main() {
-  ghls::SimTime t;
-  std::cout << "SimTime: " << ghls::conv2str(t) << std::endl;
-  return 0;
+  if (!l_options.json.empty()) {
+    std::FILE* l_out = l_options.json == "-" ? stdout : std::fopen(l_options.json.c_str(), "w");
+    if (l_out == nullptr) {
+      std::fprintf(stderr, "simTime_main: cannot write %s\n", l_options.json.c_str());
+      return 1;
+    }
+    writeJson(l_out, l_options, l_design, l_replicas, l_phases, l_rss);
+    if (l_out != stdout) {
+      l_ok = std::fclose(l_out) == 0 && l_ok;
+    }
+  }
+  return l_ok ? 0 : 1;
 }
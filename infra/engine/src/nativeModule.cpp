@@ -0,0 +1,179 @@
+#include "nativeModule.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// The generated code sees values as plain pairs of 64-bit words
+static_assert(std::is_standard_layout<ghls::LogicWord>::value &&
+                  sizeof(ghls::LogicWord) == 2 * sizeof(uint64_t),
+              "LogicWord must stay two packed uint64_t for native modules");
+
+void fail(std::string* f_error, const std::string& f_what) {
+  if (f_error != nullptr) {
+    *f_error = f_what;
+  }
+}
+
+std::string quote(const std::string& f_arg) {
+  std::string l_out = "'";
+  for (char l_ch : f_arg) {
+    l_out += l_ch == '\'' ? std::string("'\\''") : std::string(1, l_ch);
+  }
+  return l_out + "'";
+}
+
+bool writeFile(const std::string& f_path, const std::string& f_data) {
+  std::FILE* l_out = std::fopen(f_path.c_str(), "wb");
+  if (l_out == nullptr) {
+    return false;
+  }
+  bool l_ok = std::fwrite(f_data.data(), 1, f_data.size(), l_out) == f_data.size();
+  return std::fclose(l_out) == 0 && l_ok;
+}
+
+// Whether the file is ours alone: owned by the effective user and writable by
+// nobody else. Callers lstat, so symbolic links never qualify.
+bool trusted(const struct stat& f_stat) {
+  return f_stat.st_uid == ::geteuid() && (f_stat.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// Creates f_dir (mode 0700) unless it exists, then checks it is a directory
+// only we can write to
+bool prepareDir(const std::string& f_dir, std::string* f_error) {
+  if (::mkdir(f_dir.c_str(), 0700) != 0 && errno != EEXIST) {
+    fail(f_error, "cannot create cache directory " + f_dir);
+    return false;
+  }
+  struct stat l_stat;
+  if (::lstat(f_dir.c_str(), &l_stat) != 0 || !S_ISDIR(l_stat.st_mode) || !trusted(l_stat)) {
+    fail(f_error, "cache directory " + f_dir + " is not a private directory of this user");
+    return false;
+  }
+  return true;
+}
+
+std::string defaultCacheDir() {
+  const char* l_env = std::getenv("GHLS_NATIVE_CACHE");
+  if (l_env != nullptr && *l_env != '\0') {
+    return l_env;
+  }
+  std::string l_base;
+  if ((l_env = std::getenv("XDG_CACHE_HOME")) != nullptr && *l_env != '\0') {
+    l_base = l_env;
+  } else if ((l_env = std::getenv("HOME")) != nullptr && *l_env != '\0') {
+    l_base = std::string(l_env) + "/.cache";
+    // The usual parent; its ownership is the user's business
+    ::mkdir(l_base.c_str(), 0700);
+  } else {
+    return {};
+  }
+  return l_base + "/ghls-native";
+}
+
+// Runs f_command, collecting its output; true if it exited with 0
+bool run(const std::string& f_command, std::string& f_output) {
+  std::FILE* l_pipe = ::popen((f_command + " 2>&1").c_str(), "r");
+  if (l_pipe == nullptr) {
+    return false;
+  }
+  char l_buf[4096];
+  size_t l_read;
+  while ((l_read = std::fread(l_buf, 1, sizeof(l_buf), l_pipe)) != 0) {
+    f_output.append(l_buf, l_read);
+  }
+  return ::pclose(l_pipe) == 0;
+}
+
+}  // namespace
+
+uint64_t ghls::NativeModule::hashOf(const std::string& f_source,
+                                    const NativeOptions& f_options) noexcept {
+  uint64_t l_hash = 0xcbf29ce484222325ULL;
+  auto l_add = [&l_hash](const std::string& f_part) {
+    for (char l_ch : f_part) {
+      l_hash = (l_hash ^ static_cast<uint8_t>(l_ch)) * 0x100000001b3ULL;
+    }
+    // Separator so moving text between the parts changes the hash
+    l_hash = (l_hash ^ 0xff) * 0x100000001b3ULL;
+  };
+  l_add(f_source);
+  l_add(f_options.compiler);
+  l_add(f_options.flags);
+  return l_hash;
+}
+
+std::unique_ptr<ghls::NativeModule> ghls::NativeModule::load(const std::string& f_source,
+                                                            const NativeOptions& f_options,
+                                                            std::string* f_error) {
+  std::string l_dir = f_options.cacheDir.empty() ? defaultCacheDir() : f_options.cacheDir;
+  if (l_dir.empty()) {
+    fail(f_error, "no cache directory: set GHLS_NATIVE_CACHE, XDG_CACHE_HOME or HOME");
+    return nullptr;
+  }
+  if (!prepareDir(l_dir, f_error)) {
+    return nullptr;
+  }
+
+  uint64_t l_hash = hashOf(f_source, f_options);
+  char l_hex[17];
+  std::snprintf(l_hex, sizeof(l_hex), "%016llx", static_cast<unsigned long long>(l_hash));
+  std::string l_path = l_dir + "/ghls_" + l_hex + ".so";
+
+  struct stat l_stat;
+  bool l_cached = ::lstat(l_path.c_str(), &l_stat) == 0;
+  if (!l_cached) {
+    // Built under a per-process name and renamed into place, so concurrent
+    // runs of the same design never load a half-written object
+    std::string l_stem = l_path + "." + std::to_string(::getpid());
+    std::string l_src = l_stem + ".cpp";
+    std::string l_obj = l_stem + ".so";
+    if (!writeFile(l_src, f_source)) {
+      fail(f_error, "cannot write " + l_src);
+      return nullptr;
+    }
+    std::string l_output;
+    bool l_ok = run(f_options.compiler + " " + f_options.flags + " -shared -fPIC -o " +
+                        quote(l_obj) + " " + quote(l_src),
+                    l_output);
+    std::remove(l_src.c_str());
+    // A permissive umask must not make the object fail the check below
+    if (!l_ok || ::chmod(l_obj.c_str(), 0700) != 0 ||
+        std::rename(l_obj.c_str(), l_path.c_str()) != 0) {
+      std::remove(l_obj.c_str());
+      fail(f_error, "compiling native module failed: " + l_output);
+      return nullptr;
+    }
+    if (::lstat(l_path.c_str(), &l_stat) != 0) {
+      fail(f_error, "cannot stat " + l_path);
+      return nullptr;
+    }
+  }
+  if (!S_ISREG(l_stat.st_mode) || !trusted(l_stat)) {
+    fail(f_error, "refusing to load " + l_path + ": not a private file of this user");
+    return nullptr;
+  }
+
+  void* l_handle = ::dlopen(l_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (l_handle == nullptr) {
+    fail(f_error, ::dlerror());
+    return nullptr;
+  }
+  void* l_sym = ::dlsym(l_handle, "ghls_eval");
+  if (l_sym == nullptr) {
+    fail(f_error, ::dlerror());
+    ::dlclose(l_handle);
+    return nullptr;
+  }
+  return std::unique_ptr<NativeModule>(new NativeModule(
+      l_handle, reinterpret_cast<EvalFn>(l_sym), l_hash, std::move(l_path), l_cached));
+}
+
+ghls::NativeModule::~NativeModule() { ::dlclose(c_handle); }
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "netStore.hpp"
+
+namespace ghls {
+
+struct NativeOptions {
+  std::string compiler = "c++";
+  std::string flags = "-O2";
+  // Where compiled modules are kept; empty means $GHLS_NATIVE_CACHE, or
+  // ghls-native under $XDG_CACHE_HOME (~/.cache) when that is not set. The
+  // directory and its objects must belong to the user and not be writable
+  // by group or others, or nothing is loaded from it.
+  std::string cacheDir;
+};
+
+// Generated C++ source compiled with the system compiler into a shared object
+// and loaded with dlopen. The object is cached under the hash of the source,
+// compiler and flags, so loading an unchanged design again skips the compile.
+// The source must define
+//
+//   extern "C" void ghls_eval(ghls_word* values);
+//
+// where ghls_word has the layout of LogicWord.
+class NativeModule {
+ public:
+  using EvalFn = void (*)(LogicWord* f_values);
+
+  // nullptr if the compiler failed or the object could not be loaded; the
+  // reason goes to f_error
+  static std::unique_ptr<NativeModule> load(const std::string& f_source,
+                                            const NativeOptions& f_options = {},
+                                            std::string* f_error = nullptr);
+  ~NativeModule();
+  NativeModule(const NativeModule&) = delete;
+  NativeModule& operator=(const NativeModule&) = delete;
+
+  EvalFn eval() const noexcept { return c_eval; }
+  uint64_t hash() const noexcept { return c_hash; }
+  const std::string& path() const noexcept { return c_path; }
+  // True if the object was already in the cache and nothing was compiled
+  bool cached() const noexcept { return c_cached; }
+
+  // FNV-1a of everything that goes into the object
+  static uint64_t hashOf(const std::string& f_source, const NativeOptions& f_options) noexcept;
+
+ private:
+  NativeModule(void* f_handle, EvalFn f_eval, uint64_t f_hash, std::string f_path, bool f_cached)
+      : c_handle(f_handle), c_eval(f_eval), c_hash(f_hash), c_path(std::move(f_path)),
+        c_cached(f_cached) {}
+
+  void* c_handle;
+  EvalFn c_eval;
+  uint64_t c_hash;
+  std::string c_path;
+  bool c_cached;
+};
+
+}  // namespace ghls
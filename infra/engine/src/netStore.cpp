@@ -0,0 +1,148 @@
+#include "netStore.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+#include "blockCodec.hpp"
+
+ghls::NetId ghls::NetStore::addNet(uint32_t f_width, Logic f_init) {
+  assert(f_width > 0 && "nets must be at least one bit wide");
+  NetId l_net = static_cast<NetId>(c_widths.size());
+  uint32_t l_offset = static_cast<uint32_t>(c_values.size());
+  c_widths.push_back(f_width);
+  c_offsets.push_back(l_offset);
+  c_lastChange.push_back(SimTime());
+  c_dirty.push_back(0);
+
+  uint64_t l_aval = (static_cast<uint8_t>(f_init) & 1) != 0 ? ~uint64_t(0) : 0;
+  uint64_t l_bval = (static_cast<uint8_t>(f_init) & 2) != 0 ? ~uint64_t(0) : 0;
+  for (uint32_t l_word = 0; l_word < words(l_net); ++l_word) {
+    LogicWord l_value = maskTop(l_net, l_word, {l_aval, l_bval});
+    c_values.push_back(l_value);
+    c_pending.push_back(l_value);
+  }
+  return l_net;
+}
+
+ghls::Logic ghls::NetStore::bit(NetId f_net, uint32_t f_bit) const noexcept {
+  LogicWord l_word = word(f_net, f_bit / 64);
+  unsigned l_shift = f_bit % 64;
+  return static_cast<Logic>(((l_word.aval >> l_shift) & 1) | (((l_word.bval >> l_shift) & 1) << 1));
+}
+
+bool ghls::NetStore::isKnown(NetId f_net) const noexcept {
+  for (uint32_t l_word = 0; l_word < words(f_net); ++l_word) {
+    if (word(f_net, l_word).bval != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string ghls::NetStore::toString(NetId f_net) const {
+  static const char kChars[] = {'0', '1', 'z', 'x'};
+  std::string l_str(c_widths[f_net], '0');
+  for (uint32_t l_bit = 0; l_bit < c_widths[f_net]; ++l_bit) {
+    l_str[c_widths[f_net] - 1 - l_bit] = kChars[static_cast<uint8_t>(bit(f_net, l_bit))];
+  }
+  return l_str;
+}
+
+void ghls::NetStore::write(NetId f_net, uint32_t f_word, LogicWord f_value) noexcept {
+  c_pending[c_offsets[f_net] + f_word] = maskTop(f_net, f_word, f_value);
+  markDirty(f_net);
+}
+
+void ghls::NetStore::writeBit(NetId f_net, uint32_t f_bit, Logic f_value) noexcept {
+  LogicWord& l_word = c_pending[c_offsets[f_net] + f_bit / 64];
+  uint64_t l_mask = uint64_t(1) << (f_bit % 64);
+  uint8_t l_code = static_cast<uint8_t>(f_value);
+  l_word.aval = (l_word.aval & ~l_mask) | ((l_code & 1) != 0 ? l_mask : 0);
+  l_word.bval = (l_word.bval & ~l_mask) | ((l_code & 2) != 0 ? l_mask : 0);
+  markDirty(f_net);
+}
+
+void ghls::NetStore::writeValue(NetId f_net, uint64_t f_value) noexcept {
+  write(f_net, 0, {f_value, 0});
+  for (uint32_t l_word = 1; l_word < words(f_net); ++l_word) {
+    write(f_net, l_word, {0, 0});
+  }
+}
+
+size_t ghls::NetStore::commit(SimTime f_now) {
+  c_changed.clear();
+  for (NetId l_net : c_dirtyList) {
+    c_dirty[l_net] = 0;
+    uint32_t l_begin = c_offsets[l_net];
+    uint32_t l_end = l_begin + words(l_net);
+    bool l_changed = false;
+    for (uint32_t l_idx = l_begin; l_idx < l_end; ++l_idx) {
+      if (c_values[l_idx] != c_pending[l_idx]) {
+        c_values[l_idx] = c_pending[l_idx];
+        l_changed = true;
+      }
+    }
+    if (l_changed) {
+      c_lastChange[l_net] = f_now;
+      c_changed.push_back(l_net);
+    }
+  }
+  c_dirtyList.clear();
+  return c_changed.size();
+}
+
+void ghls::NetStore::save(std::vector<uint8_t>& f_out) const {
+  static_assert(std::is_trivially_copyable<SimTime>::value, "change times are saved as bytes");
+  putVarint(f_out, size());
+  putVarint(f_out, c_values.size());
+  putVarint(f_out, c_dirtyList.size());
+  putBytes(f_out, c_values.data(), c_values.size() * sizeof(LogicWord));
+  putBytes(f_out, c_pending.data(), c_pending.size() * sizeof(LogicWord));
+  putBytes(f_out, c_lastChange.data(), c_lastChange.size() * sizeof(SimTime));
+  putBytes(f_out, c_dirtyList.data(), c_dirtyList.size() * sizeof(NetId));
+}
+
+bool ghls::NetStore::restore(const uint8_t* f_data, size_t f_size) {
+  const uint8_t* l_pos = f_data;
+  const uint8_t* l_end = f_data + f_size;
+  uint64_t l_nets, l_words, l_dirty;
+  if (!getVarint(l_pos, l_end, l_nets) || !getVarint(l_pos, l_end, l_words) ||
+      !getVarint(l_pos, l_end, l_dirty) || l_nets != size() || l_words != c_values.size() ||
+      l_dirty > size()) {
+    return false;
+  }
+  size_t l_bytes = 2 * l_words * sizeof(LogicWord) + l_nets * sizeof(SimTime) +
+                   l_dirty * sizeof(NetId);
+  if (size_t(l_end - l_pos) != l_bytes) {
+    return false;
+  }
+  std::vector<NetId> l_dirtyList(l_dirty);
+  const uint8_t* l_list = l_pos + l_bytes - l_dirty * sizeof(NetId);
+  getBytes(l_list, l_end, l_dirtyList.data(), l_dirty * sizeof(NetId));
+  for (NetId l_net : l_dirtyList) {
+    if (l_net >= size()) {
+      return false;
+    }
+  }
+  getBytes(l_pos, l_end, c_values.data(), l_words * sizeof(LogicWord));
+  getBytes(l_pos, l_end, c_pending.data(), l_words * sizeof(LogicWord));
+  getBytes(l_pos, l_end, c_lastChange.data(), l_nets * sizeof(SimTime));
+  std::fill(c_dirty.begin(), c_dirty.end(), 0);
+  c_dirtyList.clear();
+  for (NetId l_net : l_dirtyList) {
+    markDirty(l_net);
+  }
+  c_changed.clear();
+  return true;
+}
+
+ghls::LogicWord ghls::NetStore::maskTop(NetId f_net, uint32_t f_word,
+                                        LogicWord f_value) const noexcept {
+  uint32_t l_bits = c_widths[f_net] - f_word * 64;
+  if (l_bits >= 64) {
+    return f_value;
+  }
+  uint64_t l_mask = (uint64_t(1) << l_bits) - 1;
+  return {f_value.aval & l_mask, f_value.bval & l_mask};
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simTime.hpp"
+
+namespace ghls {
+
+// 4-state logic value, encoded as aval | (bval << 1) like the Verilog VPI
+enum class Logic : uint8_t { zero = 0, one = 1, z = 2, x = 3 };
+
+// 64 bits of 4-state logic held as two bit planes
+struct LogicWord {
+  uint64_t aval;
+  uint64_t bval;
+
+  bool operator==(const LogicWord& f_rhs) const noexcept {
+    return aval == f_rhs.aval && bval == f_rhs.bval;
+  }
+  bool operator!=(const LogicWord& f_rhs) const noexcept { return !(*this == f_rhs); }
+};
+
+// Dense handle of a net in a NetStore
+using NetId = uint32_t;
+
+// Database of 1- to N-bit 4-state nets laid out as a structure of arrays:
+// current values, pending values and last-change times each live in their
+// own contiguous array, indexed by NetId (per net) or by word offset (per
+// 64-bit slice). Writes go to the pending array and become visible in one
+// bulk commit at the end of the delta cycle.
+class NetStore {
+ public:
+  NetId addNet(uint32_t f_width, Logic f_init = Logic::x);
+
+  size_t size() const noexcept { return c_widths.size(); }
+  uint32_t width(NetId f_net) const noexcept { return c_widths[f_net]; }
+  uint32_t words(NetId f_net) const noexcept { return (c_widths[f_net] + 63) / 64; }
+
+  // Current (committed) value
+  Logic bit(NetId f_net, uint32_t f_bit) const noexcept;
+  LogicWord word(NetId f_net, uint32_t f_word = 0) const noexcept {
+    return c_values[c_offsets[f_net] + f_word];
+  }
+  // True when no bit of the net is X or Z
+  bool isKnown(NetId f_net) const noexcept;
+  SimTime lastChange(NetId f_net) const noexcept { return c_lastChange[f_net]; }
+  // Value MSB first as a string of 0/1/x/z characters
+  std::string toString(NetId f_net) const;
+
+  // Value that will be committed, reflecting writes made in this delta cycle
+  LogicWord pendingWord(NetId f_net, uint32_t f_word = 0) const noexcept {
+    return c_pending[c_offsets[f_net] + f_word];
+  }
+
+  void write(NetId f_net, uint32_t f_word, LogicWord f_value) noexcept;
+  void writeBit(NetId f_net, uint32_t f_bit, Logic f_value) noexcept;
+  // Two-state write of the low 64 bits, upper words are cleared to zero
+  void writeValue(NetId f_net, uint64_t f_value) noexcept;
+
+  // Publishes every pending write made since the last commit and stamps the
+  // nets that actually changed with f_now. Returns the number of changed nets.
+  size_t commit(SimTime f_now);
+  // Nets whose value changed in the last commit
+  const std::vector<NetId>& changed() const noexcept { return c_changed; }
+
+  // Appends current and pending values, change times and uncommitted writes
+  void save(std::vector<uint8_t>& f_out) const;
+  // Loads what save() wrote for a store with the same nets. Returns false,
+  // leaving the store untouched, if the snapshot does not match.
+  bool restore(const uint8_t* f_data, size_t f_size);
+
+ private:
+  void markDirty(NetId f_net) noexcept {
+    if (!c_dirty[f_net]) {
+      c_dirty[f_net] = 1;
+      c_dirtyList.push_back(f_net);
+    }
+  }
+  // Clears the bits above the net width in its top word
+  LogicWord maskTop(NetId f_net, uint32_t f_word, LogicWord f_value) const noexcept;
+
+  std::vector<uint32_t> c_widths;
+  std::vector<uint32_t> c_offsets;
+  std::vector<LogicWord> c_values;
+  std::vector<LogicWord> c_pending;
+  std::vector<SimTime> c_lastChange;
+  std::vector<uint8_t> c_dirty;
+  std::vector<NetId> c_dirtyList;
+  std::vector<NetId> c_changed;
+};
+
+}  // namespace ghls
@@ -0,0 +1,320 @@
+#include "netlist.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "blockCodec.hpp"
+#include "checkpoint.hpp"
+#include "profiler.hpp"
+
+ghls::NetId ghls::Netlist::addNet(uint32_t f_width, Logic f_init) {
+  assert(f_width > 0 && f_width <= 64 && "gate-level nets are 1 to 64 bits wide");
+  c_widths.push_back(f_width);
+  c_inits.push_back(f_init);
+  return static_cast<NetId>(c_widths.size() - 1);
+}
+
+uint32_t ghls::Netlist::addGate(GateOp f_op, NetId f_out, NetId f_a, NetId f_b, NetId f_c) {
+  Gate l_gate{f_op, f_out, {f_a, gateArity(f_op) > 1 ? f_b : f_a, gateArity(f_op) > 2 ? f_c : f_a}};
+  for (unsigned l_in = 0; l_in < gateArity(f_op); ++l_in) {
+    assert(c_widths[l_gate.in[l_in]] == c_widths[f_out] && "gate operand width mismatch");
+  }
+  c_gates.push_back(l_gate);
+  return static_cast<uint32_t>(c_gates.size() - 1);
+}
+
+uint32_t ghls::Netlist::addFlop(NetId f_d, NetId f_q, uint32_t f_domain) {
+  assert(c_widths[f_d] == c_widths[f_q] && "flop width mismatch");
+  c_flops.push_back({f_d, f_q, f_domain});
+  c_domains = std::max(c_domains, f_domain + 1);
+  return static_cast<uint32_t>(c_flops.size() - 1);
+}
+
+std::optional<std::vector<uint32_t>> ghls::Netlist::levelize(
+    std::vector<uint32_t>* f_levels) const {
+  constexpr uint32_t kNone = UINT32_MAX;
+  std::vector<uint32_t> l_driver(nets(), kNone);
+  for (uint32_t l_gate = 0; l_gate < c_gates.size(); ++l_gate) {
+    l_driver[c_gates[l_gate].out] = l_gate;
+  }
+  std::vector<uint32_t> l_offsets;
+  std::vector<uint32_t> l_readers;
+  fanout(l_offsets, l_readers);
+
+  // Kahn's algorithm, counting inputs that are driven by other gates
+  std::vector<uint32_t> l_waiting(c_gates.size(), 0);
+  std::vector<uint32_t> l_level(c_gates.size(), 0);
+  std::vector<uint32_t> l_order;
+  l_order.reserve(c_gates.size());
+  for (uint32_t l_gate = 0; l_gate < c_gates.size(); ++l_gate) {
+    const Gate& l_g = c_gates[l_gate];
+    for (unsigned l_in = 0; l_in < gateArity(l_g.op); ++l_in) {
+      l_waiting[l_gate] += l_driver[l_g.in[l_in]] != kNone ? 1 : 0;
+    }
+    if (l_waiting[l_gate] == 0) {
+      l_order.push_back(l_gate);
+    }
+  }
+  for (size_t l_next = 0; l_next < l_order.size(); ++l_next) {
+    uint32_t l_gate = l_order[l_next];
+    NetId l_out = c_gates[l_gate].out;
+    for (uint32_t l_idx = l_offsets[l_out]; l_idx < l_offsets[l_out + 1]; ++l_idx) {
+      uint32_t l_reader = l_readers[l_idx];
+      l_level[l_reader] = std::max(l_level[l_reader], l_level[l_gate] + 1);
+      if (--l_waiting[l_reader] == 0) {
+        l_order.push_back(l_reader);
+      }
+    }
+  }
+  if (l_order.size() != c_gates.size()) {
+    return std::nullopt;
+  }
+  if (f_levels != nullptr) {
+    *f_levels = std::move(l_level);
+  }
+  return l_order;
+}
+
+void ghls::Netlist::fanout(std::vector<uint32_t>& f_offsets,
+                           std::vector<uint32_t>& f_gates) const {
+  f_offsets.assign(nets() + 1, 0);
+  for (const Gate& l_gate : c_gates) {
+    for (unsigned l_in = 0; l_in < gateArity(l_gate.op); ++l_in) {
+      ++f_offsets[l_gate.in[l_in] + 1];
+    }
+  }
+  for (size_t l_net = 0; l_net < nets(); ++l_net) {
+    f_offsets[l_net + 1] += f_offsets[l_net];
+  }
+  f_gates.resize(f_offsets[nets()]);
+  std::vector<uint32_t> l_fill(f_offsets.begin(), f_offsets.end() - 1);
+  for (uint32_t l_gate = 0; l_gate < c_gates.size(); ++l_gate) {
+    const Gate& l_g = c_gates[l_gate];
+    for (unsigned l_in = 0; l_in < gateArity(l_g.op); ++l_in) {
+      f_gates[l_fill[l_g.in[l_in]]++] = l_gate;
+    }
+  }
+}
+
+void ghls::ClockDriver::add(const Clock& f_clock, uint32_t f_domain) {
+  c_drives.emplace_back(new Drive{this, f_clock, 0, f_domain, false});
+  Drive* l_drive = c_drives.back().get();
+  c_sched.scheduleAt(f_clock.risingEdge(0), onEdge, l_drive);
+}
+
+void ghls::ClockDriver::checkpoint(Checkpointer& f_cp, const std::string& f_name) {
+  f_cp.addEvent(f_name + ".edge", onEdge);
+  for (size_t l_idx = 0; l_idx < c_drives.size(); ++l_idx) {
+    f_cp.addContext(f_name + "." + std::to_string(l_idx), c_drives[l_idx].get());
+  }
+  f_cp.addState(f_name, *this);
+}
+
+void ghls::ClockDriver::resume() {
+  if (c_parked == 0) {
+    return;
+  }
+  SimTime l_now = c_sched.now();
+  if (asleep()) {
+    c_skippedTime += l_now - c_asleepSince;
+    ++c_fastForwards;
+  }
+  for (const auto& l_drive : c_drives) {
+    if (!l_drive->parked) {
+      continue;
+    }
+    // Edges up to now would have fired; the same delta already sampled
+    // unchanged flop inputs, so an edge at now is a no-op either way
+    const Clock& l_clock = l_drive->clock;
+    uint64_t l_cycle = l_drive->cycle;
+    if (l_clock.risingEdge(l_cycle) <= l_now) {
+      SimTick l_since = (l_now - l_clock.phase()).ticks();
+      l_cycle = static_cast<uint64_t>(l_since / l_clock.period().ticks()) + 1;
+    }
+    c_skippedEdges += l_cycle - l_drive->cycle;
+    l_drive->cycle = l_cycle;
+    l_drive->parked = false;
+    c_sched.scheduleAt(l_clock.risingEdge(l_cycle), onEdge, l_drive.get());
+  }
+  c_parked = 0;
+}
+
+ghls::SimTime ghls::ClockDriver::skippedTime() const noexcept {
+  return asleep() ? c_skippedTime + (c_sched.now() - c_asleepSince) : c_skippedTime;
+}
+
+void ghls::ClockDriver::park(Drive& f_drive) {
+  f_drive.parked = true;
+  if (++c_parked == c_drives.size()) {
+    c_asleepSince = c_sched.now();
+  }
+}
+
+void ghls::ClockDriver::save(std::vector<uint8_t>& f_out) const {
+  putVarint(f_out, c_drives.size());
+  for (const auto& l_drive : c_drives) {
+    putVarint(f_out, l_drive->cycle);
+  }
+  // Parked clocks have no queued edge, so the snapshot has to name them
+  if (c_parked != 0) {
+    putVarint(f_out, c_parked);
+    for (size_t l_idx = 0; l_idx < c_drives.size(); ++l_idx) {
+      if (c_drives[l_idx]->parked) {
+        putVarint(f_out, l_idx);
+      }
+    }
+  }
+}
+
+bool ghls::ClockDriver::restore(const uint8_t* f_data, size_t f_size) {
+  const uint8_t* l_pos = f_data;
+  const uint8_t* l_end = f_data + f_size;
+  uint64_t l_count;
+  if (!getVarint(l_pos, l_end, l_count) || l_count != c_drives.size()) {
+    return false;
+  }
+  std::vector<uint64_t> l_cycles(l_count);
+  for (uint64_t& l_cycle : l_cycles) {
+    if (!getVarint(l_pos, l_end, l_cycle)) {
+      return false;
+    }
+  }
+  std::vector<uint8_t> l_parked(l_count, 0);
+  uint64_t l_parkedCount = 0;
+  if (l_pos != l_end && !getVarint(l_pos, l_end, l_parkedCount)) {
+    return false;
+  }
+  for (uint64_t l_idx = 0; l_idx < l_parkedCount; ++l_idx) {
+    uint64_t l_drive;
+    if (!getVarint(l_pos, l_end, l_drive) || l_drive >= l_count) {
+      return false;
+    }
+    l_parked[l_drive] = 1;
+  }
+  if (l_pos != l_end) {
+    return false;
+  }
+  c_parked = 0;
+  for (size_t l_idx = 0; l_idx < c_drives.size(); ++l_idx) {
+    c_drives[l_idx]->cycle = l_cycles[l_idx];
+    c_drives[l_idx]->parked = false;
+    if (l_parked[l_idx] != 0) {
+      park(*c_drives[l_idx]);
+    }
+  }
+  return true;
+}
+
+void ghls::ClockDriver::nameEvents(Profiler& f_profiler, const std::string& f_name) const {
+  for (const std::unique_ptr<Drive>& l_drive : c_drives) {
+    f_profiler.name(onEdge, l_drive.get(), f_name);
+  }
+}
+
+void ghls::ClockDriver::onEdge(void* f_ctx, uint64_t) {
+  Drive* l_drive = static_cast<Drive*>(f_ctx);
+  ClockDriver* l_owner = l_drive->owner;
+  l_owner->c_fn(l_owner->c_ctx, l_drive->domain);
+  ++l_drive->cycle;
+  if (l_owner->c_idle != nullptr && l_owner->c_idle(l_owner->c_ctx)) {
+    l_owner->park(*l_drive);
+    return;
+  }
+  l_owner->c_sched.scheduleAt(l_drive->clock.risingEdge(l_drive->cycle), onEdge, l_drive);
+}
+
+ghls::EventSim::EventSim(const Netlist& f_netlist, Scheduler& f_sched)
+    : c_netlist(f_netlist),
+      c_sched(f_sched),
+      c_clocks(f_sched, onClock, this),
+      c_queued(f_netlist.gates().size(), 0),
+      c_domainFlops(f_netlist.domains()),
+      c_gateEvals(0) {
+  for (NetId l_net = 0; l_net < f_netlist.nets(); ++l_net) {
+    c_nets.addNet(f_netlist.width(l_net), f_netlist.init(l_net));
+  }
+  for (uint32_t l_flop = 0; l_flop < f_netlist.flops().size(); ++l_flop) {
+    c_domainFlops[f_netlist.flops()[l_flop].domain].push_back(l_flop);
+  }
+  f_netlist.fanout(c_fanoutOffsets, c_fanout);
+  c_sched.setDeltaHook(onDelta, this);
+  // Every gate runs once so outputs settle from the initial values
+  for (uint32_t l_gate = 0; l_gate < f_netlist.gates().size(); ++l_gate) {
+    wake(l_gate);
+  }
+}
+
+void ghls::EventSim::setInput(NetId f_net, LogicWord f_value) {
+  c_nets.write(f_net, 0, f_value);
+  // Makes sure a delta cycle ends, and commits the write, at the current time
+  c_sched.scheduleDelta(onInput, this);
+}
+
+void ghls::EventSim::checkpoint(Checkpointer& f_cp, const std::string& f_name) {
+  c_clocks.checkpoint(f_cp, f_name + ".clocks");
+  f_cp.addEvent(f_name + ".gate", onGate);
+  f_cp.addEvent(f_name + ".input", onInput);
+  f_cp.addContext(f_name, this);
+  f_cp.addState(f_name, *this);
+}
+
+void ghls::EventSim::save(std::vector<uint8_t>& f_out) const {
+  putVarint(f_out, c_queued.size());
+  putBytes(f_out, c_queued.data(), c_queued.size());
+  c_nets.save(f_out);
+}
+
+bool ghls::EventSim::restore(const uint8_t* f_data, size_t f_size) {
+  const uint8_t* l_pos = f_data;
+  const uint8_t* l_end = f_data + f_size;
+  uint64_t l_gates;
+  std::vector<uint8_t> l_queued(c_queued.size());
+  if (!getVarint(l_pos, l_end, l_gates) || l_gates != c_queued.size() ||
+      !getBytes(l_pos, l_end, l_queued.data(), l_queued.size()) ||
+      !c_nets.restore(l_pos, l_end - l_pos)) {
+    return false;
+  }
+  c_queued = std::move(l_queued);
+  return true;
+}
+
+void ghls::EventSim::onDelta(void* f_ctx) {
+  EventSim* l_sim = static_cast<EventSim*>(f_ctx);
+  l_sim->c_nets.commit(l_sim->c_sched.now());
+  for (NetId l_net : l_sim->c_nets.changed()) {
+    for (uint32_t l_idx = l_sim->c_fanoutOffsets[l_net]; l_idx < l_sim->c_fanoutOffsets[l_net + 1];
+         ++l_idx) {
+      l_sim->wake(l_sim->c_fanout[l_idx]);
+    }
+  }
+}
+
+void ghls::EventSim::onGate(void* f_ctx, uint64_t f_gate) {
+  EventSim* l_sim = static_cast<EventSim*>(f_ctx);
+  l_sim->c_queued[f_gate] = 0;
+  const Gate& l_gate = l_sim->c_netlist.gates()[f_gate];
+  const NetStore& l_nets = l_sim->c_nets;
+  l_sim->c_nets.write(l_gate.out, 0,
+                      evalGate(l_gate.op, l_nets.word(l_gate.in[0]), l_nets.word(l_gate.in[1]),
+                               l_nets.word(l_gate.in[2])));
+  ++l_sim->c_gateEvals;
+}
+
+void ghls::EventSim::onClock(void* f_ctx, uint32_t f_domain) {
+  EventSim* l_sim = static_cast<EventSim*>(f_ctx);
+  if (f_domain >= l_sim->c_domainFlops.size()) {
+    return;
+  }
+  const std::vector<Flop>& l_flops = l_sim->c_netlist.flops();
+  // Committed values are still the pre-edge ones, so flop chains shift correctly
+  for (uint32_t l_flop : l_sim->c_domainFlops[f_domain]) {
+    l_sim->c_nets.write(l_flops[l_flop].q, 0, l_sim->c_nets.word(l_flops[l_flop].d));
+  }
+}
+
+void ghls::EventSim::wake(uint32_t f_gate) {
+  if (!c_queued[f_gate]) {
+    c_queued[f_gate] = 1;
+    c_sched.scheduleDelta(onGate, this, f_gate);
+  }
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "clock.hpp"
+#include "netStore.hpp"
+#include "scheduler.hpp"
+
+namespace ghls {
+
+class Checkpointer;
+class Profiler;
+
+// Bitwise gate operations. mux2 selects in[2] where in[0] is 1 and in[1]
+// where it is 0, bit by bit.
+enum class GateOp : uint8_t { buf, inv, and2, or2, xor2, nand2, nor2, xnor2, mux2 };
+
+constexpr unsigned gateArity(GateOp f_op) noexcept {
+  return f_op == GateOp::buf || f_op == GateOp::inv ? 1 : f_op == GateOp::mux2 ? 3 : 2;
+}
+
+// Combinational gate; all operands have the width of the output
+struct Gate {
+  GateOp op;
+  NetId out;
+  NetId in[3];
+};
+
+// Rising-edge flip-flop clocked by clock domain 'domain'
+struct Flop {
+  NetId d;
+  NetId q;
+  uint32_t domain;
+};
+
+// 4-state gate evaluation on 64 bits at once. Z inputs read as X. Bits above
+// the net width are left for the caller to mask.
+inline LogicWord evalGate(GateOp f_op, LogicWord f_a, LogicWord f_b, LogicWord f_c) noexcept {
+  auto l_one = [](LogicWord f_w) { return f_w.aval & ~f_w.bval; };
+  auto l_zero = [](LogicWord f_w) { return ~f_w.aval & ~f_w.bval; };
+  auto l_known = [](uint64_t f_one, uint64_t f_zero) {
+    uint64_t l_x = ~(f_one | f_zero);
+    return LogicWord{f_one | l_x, l_x};
+  };
+  auto l_invert = [](LogicWord f_w) { return LogicWord{~f_w.aval | f_w.bval, f_w.bval}; };
+  switch (f_op) {
+    case GateOp::buf:
+      return {f_a.aval | f_a.bval, f_a.bval};
+    case GateOp::inv:
+      return l_invert(f_a);
+    case GateOp::and2:
+      return l_known(l_one(f_a) & l_one(f_b), l_zero(f_a) | l_zero(f_b));
+    case GateOp::or2:
+      return l_known(l_one(f_a) | l_one(f_b), l_zero(f_a) & l_zero(f_b));
+    case GateOp::xor2: {
+      uint64_t l_x = f_a.bval | f_b.bval;
+      return {(f_a.aval ^ f_b.aval) | l_x, l_x};
+    }
+    case GateOp::nand2:
+      return l_invert(evalGate(GateOp::and2, f_a, f_b, f_c));
+    case GateOp::nor2:
+      return l_invert(evalGate(GateOp::or2, f_a, f_b, f_c));
+    case GateOp::xnor2:
+      return l_invert(evalGate(GateOp::xor2, f_a, f_b, f_c));
+    case GateOp::mux2: {
+      uint64_t l_sel1 = l_one(f_a);
+      uint64_t l_sel0 = l_zero(f_a);
+      uint64_t l_selx = ~(l_sel1 | l_sel0);
+      LogicWord l_d0 = {f_b.aval | f_b.bval, f_b.bval};
+      LogicWord l_d1 = {f_c.aval | f_c.bval, f_c.bval};
+      // An unknown select still yields a known bit where both data bits agree
+      uint64_t l_agree = ~(l_d0.aval ^ l_d1.aval) & ~l_d0.bval & ~l_d1.bval;
+      return {(l_sel1 & l_d1.aval) | (l_sel0 & l_d0.aval) | (l_selx & (~l_agree | l_d0.aval)),
+              (l_sel1 & l_d1.bval) | (l_sel0 & l_d0.bval) | (l_selx & ~l_agree)};
+    }
+  }
+  return {~uint64_t(0), ~uint64_t(0)};
+}
+
+// Gate-level design: nets up to 64 bits wide, combinational gates and
+// rising-edge flops. Nets driven by neither are primary inputs.
+class Netlist {
+ public:
+  NetId addNet(uint32_t f_width = 1, Logic f_init = Logic::x);
+  // Unused operands of unary gates are ignored
+  uint32_t addGate(GateOp f_op, NetId f_out, NetId f_a, NetId f_b = 0, NetId f_c = 0);
+  uint32_t addFlop(NetId f_d, NetId f_q, uint32_t f_domain = 0);
+
+  size_t nets() const noexcept { return c_widths.size(); }
+  uint32_t width(NetId f_net) const noexcept { return c_widths[f_net]; }
+  Logic init(NetId f_net) const noexcept { return c_inits[f_net]; }
+  const std::vector<Gate>& gates() const noexcept { return c_gates; }
+  const std::vector<Flop>& flops() const noexcept { return c_flops; }
+  uint32_t domains() const noexcept { return c_domains; }
+
+  // Gate indices in topological order, every gate after the gates driving its
+  // inputs, with the level of each gate (its depth from inputs and flops).
+  // nullopt if the combinational logic contains a loop.
+  std::optional<std::vector<uint32_t>> levelize(std::vector<uint32_t>* f_levels = nullptr) const;
+
+  // Gates reading each net in compressed row form: the readers of net n are
+  // f_gates[f_offsets[n] .. f_offsets[n + 1])
+  void fanout(std::vector<uint32_t>& f_offsets, std::vector<uint32_t>& f_gates) const;
+
+ private:
+  std::vector<uint32_t> c_widths;
+  std::vector<Logic> c_inits;
+  std::vector<Gate> c_gates;
+  std::vector<Flop> c_flops;
+  uint32_t c_domains = 0;
+};
+
+// Schedules a callback on every rising edge of each added clock.
+//
+// With an idle test set, a clock whose edge callback leaves the owner idle
+// is parked: no further edge is queued for it. Once every clock is parked the
+// scheduler moves straight on to the next other event. resume() puts parked
+// clocks back on their own edge grid, as if every edge had fired.
+class ClockDriver {
+ public:
+  using EdgeFn = void (*)(void* f_ctx, uint32_t f_domain);
+  // True while further edges cannot change anything
+  using IdleFn = bool (*)(void* f_ctx);
+
+  ClockDriver(Scheduler& f_sched, EdgeFn f_fn, void* f_ctx)
+      : c_sched(f_sched), c_fn(f_fn), c_ctx(f_ctx) {}
+
+  void add(const Clock& f_clock, uint32_t f_domain);
+
+  // Called with the edge callback's context; null disables parking
+  void setIdle(IdleFn f_idle) noexcept { c_idle = f_idle; }
+  size_t parked() const noexcept { return c_parked; }
+  bool asleep() const noexcept { return c_parked != 0 && c_parked == c_drives.size(); }
+  // Re-queues every parked clock on its first rising edge after now()
+  void resume();
+
+  // Time spent with every clock parked (the current stretch included) and
+  // rising edges the parked clocks did not fire, counted when they resume
+  SimTime skippedTime() const noexcept;
+  uint64_t skippedEdges() const noexcept { return c_skippedEdges; }
+  uint64_t fastForwards() const noexcept { return c_fastForwards; }
+
+  // Registers the edge events and cycle counters under f_name; call it after
+  // the last add()
+  void checkpoint(Checkpointer& f_cp, const std::string& f_name);
+  void save(std::vector<uint8_t>& f_out) const;
+  bool restore(const uint8_t* f_data, size_t f_size);
+
+  // Shows edge events, the edge callback included, as f_name in profiles
+  void nameEvents(Profiler& f_profiler, const std::string& f_name) const;
+
+ private:
+  struct Drive {
+    ClockDriver* owner;
+    Clock clock;
+    // Next rising edge to fire
+    uint64_t cycle;
+    uint32_t domain;
+    bool parked;
+  };
+
+  static void onEdge(void* f_ctx, uint64_t f_arg);
+  void park(Drive& f_drive);
+
+  Scheduler& c_sched;
+  EdgeFn c_fn;
+  void* c_ctx;
+  IdleFn c_idle = nullptr;
+  std::vector<std::unique_ptr<Drive>> c_drives;
+  size_t c_parked = 0;
+  SimTime c_asleepSince;
+  SimTime c_skippedTime;
+  uint64_t c_skippedEdges = 0;
+  uint64_t c_fastForwards = 0;
+};
+
+// Reference event-driven simulation: every gate is a process woken in the
+// next delta cycle whenever one of its inputs changes, so glitches through
+// deep cones are evaluated gate by gate.
+class EventSim {
+ public:
+  EventSim(const Netlist& f_netlist, Scheduler& f_sched);
+  EventSim(const EventSim&) = delete;
+  EventSim& operator=(const EventSim&) = delete;
+
+  void addClock(const Clock& f_clock, uint32_t f_domain) { c_clocks.add(f_clock, f_domain); }
+  // Drives a primary input; the change propagates from the end of the
+  // current delta cycle (or the next timestep when called outside one)
+  void setInput(NetId f_net, LogicWord f_value);
+
+  LogicWord value(NetId f_net) const noexcept { return c_nets.word(f_net); }
+  const NetStore& nets() const noexcept { return c_nets; }
+  uint64_t gateEvaluations() const noexcept { return c_gateEvals; }
+
+  // Registers net values, queued gates and events under f_name, clocks included
+  void checkpoint(Checkpointer& f_cp, const std::string& f_name);
+  void save(std::vector<uint8_t>& f_out) const;
+  bool restore(const uint8_t* f_data, size_t f_size);
+
+ private:
+  static void onDelta(void* f_ctx);
+  static void onGate(void* f_ctx, uint64_t f_gate);
+  static void onClock(void* f_ctx, uint32_t f_domain);
+  static void onInput(void*, uint64_t) {}
+  void wake(uint32_t f_gate);
+
+  const Netlist& c_netlist;
+  Scheduler& c_sched;
+  NetStore c_nets;
+  ClockDriver c_clocks;
+  std::vector<uint32_t> c_fanoutOffsets;
+  std::vector<uint32_t> c_fanout;
+  std::vector<uint8_t> c_queued;
+  std::vector<std::vector<uint32_t>> c_domainFlops;
+  uint64_t c_gateEvals;
+};
+
+}  // namespace ghls
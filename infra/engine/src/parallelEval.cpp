@@ -0,0 +1,199 @@
+#include "parallelEval.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Chunks handed out per thread, more chunks balance better but cost more steals
+constexpr size_t kChunksPerThread = 8;
+// Spins before a worker blocks waiting for the next delta cycle
+constexpr int kSpinLimit = 4096;
+
+}  // namespace
+
+ghls::ParallelEvaluator::ParallelEvaluator(NetStore& f_nets, unsigned f_threads)
+    : c_nets(f_nets),
+      c_chunkSize(1),
+      c_chunks(0),
+      c_generation(0),
+      c_busyWorkers(0),
+      c_shutdown(false) {
+  if (f_threads == 0) {
+    f_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  c_ranges.reset(new WorkRange[f_threads]);
+  for (unsigned l_worker = 1; l_worker < f_threads; ++l_worker) {
+    c_workers.emplace_back(&ParallelEvaluator::workerLoop, this, l_worker);
+  }
+}
+
+ghls::ParallelEvaluator::~ParallelEvaluator() {
+  {
+    std::lock_guard<std::mutex> l_lock(c_mutex);
+    c_shutdown = true;
+    c_generation.fetch_add(1, std::memory_order_release);
+  }
+  c_wake.notify_all();
+  for (std::thread& l_worker : c_workers) {
+    l_worker.join();
+  }
+}
+
+ghls::ProcessId ghls::ParallelEvaluator::addProcess(ProcessFn f_fn, void* f_ctx) {
+  c_procs.push_back({f_fn, f_ctx});
+  c_isReady.push_back(0);
+  return static_cast<ProcessId>(c_procs.size() - 1);
+}
+
+void ghls::ParallelEvaluator::markReady(ProcessId f_proc) {
+  if (!c_isReady[f_proc]) {
+    c_isReady[f_proc] = 1;
+    c_ready.push_back(f_proc);
+  }
+}
+
+size_t ghls::ParallelEvaluator::runDelta(SimTime f_now) {
+  if (c_ready.empty()) {
+    return c_nets.commit(f_now);
+  }
+  // Process id order defines chunk order and therefore the write order. A
+  // dense ready set is cheaper to rebuild from the flags than to sort.
+  if (c_ready.size() > c_procs.size() / 16) {
+    c_ready.clear();
+    for (ProcessId l_proc = 0; l_proc < c_procs.size(); ++l_proc) {
+      if (c_isReady[l_proc]) {
+        c_ready.push_back(l_proc);
+      }
+    }
+  } else {
+    std::sort(c_ready.begin(), c_ready.end());
+  }
+
+  const unsigned l_threads = threads();
+  c_chunkSize = std::max<size_t>(1, c_ready.size() / (size_t(l_threads) * kChunksPerThread));
+  c_chunks = static_cast<uint32_t>((c_ready.size() + c_chunkSize - 1) / c_chunkSize);
+  if (c_chunkWrites.size() < c_chunks) {
+    c_chunkWrites.resize(c_chunks);
+  }
+  for (unsigned l_worker = 0; l_worker < l_threads; ++l_worker) {
+    uint32_t l_begin = static_cast<uint32_t>(uint64_t(c_chunks) * l_worker / l_threads);
+    uint32_t l_end = static_cast<uint32_t>(uint64_t(c_chunks) * (l_worker + 1) / l_threads);
+    c_ranges[l_worker].range.store(pack(l_begin, l_end), std::memory_order_relaxed);
+  }
+
+  if (!c_workers.empty()) {
+    c_busyWorkers.store(static_cast<unsigned>(c_workers.size()), std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> l_lock(c_mutex);
+      c_generation.fetch_add(1, std::memory_order_release);
+    }
+    c_wake.notify_all();
+  }
+  evaluateChunks(0);
+  // Barrier: every chunk is evaluated before any write becomes visible
+  while (c_busyWorkers.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+
+  for (uint32_t l_chunk = 0; l_chunk < c_chunks; ++l_chunk) {
+    for (const EvalContext::Write& l_write : c_chunkWrites[l_chunk]) {
+      if (l_write.isBit) {
+        c_nets.writeBit(l_write.net, l_write.index,
+                        static_cast<Logic>(l_write.value.aval | (l_write.value.bval << 1)));
+      } else {
+        c_nets.write(l_write.net, l_write.index, l_write.value);
+      }
+    }
+    c_chunkWrites[l_chunk].clear();
+  }
+  for (ProcessId l_proc : c_ready) {
+    c_isReady[l_proc] = 0;
+  }
+  c_ready.clear();
+  return c_nets.commit(f_now);
+}
+
+void ghls::ParallelEvaluator::workerLoop(unsigned f_worker) {
+  uint64_t l_seen = 0;
+  for (;;) {
+    int l_spins = 0;
+    while (c_generation.load(std::memory_order_acquire) == l_seen && l_spins < kSpinLimit) {
+      ++l_spins;
+      std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> l_lock(c_mutex);
+      c_wake.wait(l_lock, [this, l_seen] {
+        return c_generation.load(std::memory_order_acquire) != l_seen;
+      });
+      if (c_shutdown) {
+        return;
+      }
+      l_seen = c_generation.load(std::memory_order_acquire);
+    }
+    evaluateChunks(f_worker);
+    c_busyWorkers.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+void ghls::ParallelEvaluator::evaluateChunks(unsigned f_worker) {
+  for (;;) {
+    uint32_t l_chunk;
+    while (takeOwn(f_worker, l_chunk)) {
+      evaluateChunk(l_chunk);
+    }
+    if (!steal(f_worker)) {
+      return;
+    }
+  }
+}
+
+bool ghls::ParallelEvaluator::takeOwn(unsigned f_worker, uint32_t& f_chunk) {
+  std::atomic<uint64_t>& l_range = c_ranges[f_worker].range;
+  uint64_t l_cur = l_range.load(std::memory_order_acquire);
+  for (;;) {
+    uint32_t l_begin = static_cast<uint32_t>(l_cur >> 32);
+    uint32_t l_end = static_cast<uint32_t>(l_cur);
+    if (l_begin >= l_end) {
+      return false;
+    }
+    if (l_range.compare_exchange_weak(l_cur, pack(l_begin + 1, l_end), std::memory_order_acq_rel)) {
+      f_chunk = l_begin;
+      return true;
+    }
+  }
+}
+
+bool ghls::ParallelEvaluator::steal(unsigned f_worker) {
+  const unsigned l_threads = threads();
+  for (unsigned l_step = 1; l_step < l_threads; ++l_step) {
+    std::atomic<uint64_t>& l_victim = c_ranges[(f_worker + l_step) % l_threads].range;
+    uint64_t l_cur = l_victim.load(std::memory_order_acquire);
+    for (;;) {
+      uint32_t l_begin = static_cast<uint32_t>(l_cur >> 32);
+      uint32_t l_end = static_cast<uint32_t>(l_cur);
+      if (l_begin >= l_end) {
+        break;
+      }
+      // Take the upper half, the victim keeps working from the front
+      uint32_t l_mid = l_begin + (l_end - l_begin) / 2;
+      if (l_victim.compare_exchange_weak(l_cur, pack(l_begin, l_mid), std::memory_order_acq_rel)) {
+        // Our own range is empty, and thieves never touch an empty range
+        c_ranges[f_worker].range.store(pack(l_mid, l_end), std::memory_order_release);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void ghls::ParallelEvaluator::evaluateChunk(uint32_t f_chunk) {
+  EvalContext l_eval(&c_nets, &c_chunkWrites[f_chunk]);
+  size_t l_begin = size_t(f_chunk) * c_chunkSize;
+  size_t l_end = std::min(c_ready.size(), l_begin + c_chunkSize);
+  for (size_t l_idx = l_begin; l_idx < l_end; ++l_idx) {
+    l_eval.c_process = c_ready[l_idx];
+    const Process& l_proc = c_procs[l_eval.c_process];
+    l_proc.fn(l_proc.ctx, l_eval);
+  }
+}
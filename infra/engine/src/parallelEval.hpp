@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "netStore.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+// Dense handle of a process registered with a ParallelEvaluator
+using ProcessId = uint32_t;
+
+// Handle a process uses during evaluation: committed net values are read
+// directly, writes are buffered and applied after every process has run
+class EvalContext {
+ public:
+  const NetStore& nets() const noexcept { return *c_nets; }
+  ProcessId process() const noexcept { return c_process; }
+
+  void write(NetId f_net, uint32_t f_word, LogicWord f_value) {
+    c_writes->push_back({f_net, f_word, false, f_value});
+  }
+  void writeBit(NetId f_net, uint32_t f_bit, Logic f_value) {
+    uint64_t l_code = static_cast<uint64_t>(f_value);
+    c_writes->push_back({f_net, f_bit, true, {l_code & 1, l_code >> 1}});
+  }
+  // Two-state write of a net up to 64 bits wide
+  void writeValue(NetId f_net, uint64_t f_value) { write(f_net, 0, {f_value, 0}); }
+
+ private:
+  friend class ParallelEvaluator;
+
+  struct Write {
+    NetId net;
+    uint32_t index;
+    bool isBit;
+    LogicWord value;
+  };
+
+  EvalContext(const NetStore* f_nets, std::vector<Write>* f_writes)
+      : c_nets(f_nets), c_writes(f_writes), c_process(0) {}
+
+  const NetStore* c_nets;
+  std::vector<Write>* c_writes;
+  ProcessId c_process;
+};
+
+using ProcessFn = void (*)(void* f_ctx, EvalContext& f_eval);
+
+// Evaluates the processes that are ready in a delta cycle on a pool of
+// threads. Ready processes are split into contiguous chunks in process id
+// order; each thread owns a range of chunks and steals half of another
+// thread's remaining range once its own runs dry. All writes are buffered per
+// chunk and, after the evaluation barrier, applied to the NetStore in process
+// id order, so the result is identical for any thread count.
+class ParallelEvaluator {
+ public:
+  // f_threads includes the calling thread; 0 means one per hardware thread
+  explicit ParallelEvaluator(NetStore& f_nets, unsigned f_threads = 0);
+  ~ParallelEvaluator();
+  ParallelEvaluator(const ParallelEvaluator&) = delete;
+  ParallelEvaluator& operator=(const ParallelEvaluator&) = delete;
+
+  ProcessId addProcess(ProcessFn f_fn, void* f_ctx = nullptr);
+  size_t processes() const noexcept { return c_procs.size(); }
+  unsigned threads() const noexcept { return static_cast<unsigned>(c_workers.size()) + 1; }
+
+  // Queues f_proc for the next runDelta(), repeated calls are ignored
+  void markReady(ProcessId f_proc);
+  size_t readyCount() const noexcept { return c_ready.size(); }
+
+  // Evaluates every ready process, applies their writes and commits the
+  // NetStore at f_now. Returns the number of nets that changed.
+  size_t runDelta(SimTime f_now);
+
+ private:
+  struct Process {
+    ProcessFn fn;
+    void* ctx;
+  };
+
+  // Chunk range [begin, end) of one thread packed into a single word so the
+  // owner and thieves can both update it with one compare-and-swap
+  struct alignas(64) WorkRange {
+    std::atomic<uint64_t> range{0};
+  };
+
+  static uint64_t pack(uint32_t f_begin, uint32_t f_end) noexcept {
+    return (uint64_t(f_begin) << 32) | f_end;
+  }
+
+  void workerLoop(unsigned f_worker);
+  void evaluateChunks(unsigned f_worker);
+  bool takeOwn(unsigned f_worker, uint32_t& f_chunk);
+  bool steal(unsigned f_worker);
+  void evaluateChunk(uint32_t f_chunk);
+
+  NetStore& c_nets;
+  std::vector<Process> c_procs;
+  std::vector<uint8_t> c_isReady;
+  std::vector<ProcessId> c_ready;
+
+  std::vector<std::vector<EvalContext::Write>> c_chunkWrites;
+  size_t c_chunkSize;
+  uint32_t c_chunks;
+  std::unique_ptr<WorkRange[]> c_ranges;
+
+  std::vector<std::thread> c_workers;
+  std::mutex c_mutex;
+  std::condition_variable c_wake;
+  std::atomic<uint64_t> c_generation;
+  std::atomic<unsigned> c_busyWorkers;
+  bool c_shutdown;
+};
+
+}  // namespace ghls
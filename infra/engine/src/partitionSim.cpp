@@ -0,0 +1,206 @@
+#include "partitionSim.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// Spins before a worker blocks waiting for the next window
+constexpr int kSpinLimit = 4096;
+constexpr ghls::SimTick kNever = ~ghls::SimTick(0);
+
+}  // namespace
+
+ghls::PartitionedSim::PartitionedSim(size_t f_partitions, unsigned f_threads,
+                                     size_t f_ringCapacity)
+    : c_ringCapacity(f_ringCapacity),
+      c_channels(f_partitions * f_partitions),
+      c_lookahead(SimTime::fromTicks(kNever)),
+      c_horizon(0),
+      c_nextTimes(f_partitions, kNever),
+      c_generation(0),
+      c_busyWorkers(0),
+      c_arrived(0),
+      c_barrierPhase(0),
+      c_shutdown(false),
+      c_windows(0) {
+  assert(f_partitions > 0 && "a simulation needs at least one partition");
+  for (size_t l_idx = 0; l_idx < f_partitions; ++l_idx) {
+    c_parts.emplace_back(new Partition());
+  }
+  if (f_threads == 0) {
+    f_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  f_threads = static_cast<unsigned>(std::min<size_t>(f_threads, f_partitions));
+  for (unsigned l_worker = 1; l_worker < f_threads; ++l_worker) {
+    c_workers.emplace_back(&PartitionedSim::workerLoop, this, l_worker);
+  }
+}
+
+ghls::PartitionedSim::~PartitionedSim() {
+  {
+    std::lock_guard<std::mutex> l_lock(c_mutex);
+    c_shutdown = true;
+    c_generation.fetch_add(1, std::memory_order_release);
+  }
+  c_wake.notify_all();
+  for (std::thread& l_worker : c_workers) {
+    l_worker.join();
+  }
+}
+
+void ghls::PartitionedSim::link(uint32_t f_from, uint32_t f_to, SimTime f_minDelay) {
+  assert(f_from != f_to && f_minDelay.ticks() > 0 && "links join two partitions with a delay");
+  std::unique_ptr<Channel>& l_channel = c_channels[f_from * partitions() + f_to];
+  if (!l_channel) {
+    l_channel.reset(new Channel(c_ringCapacity));
+    l_channel->minDelay = f_minDelay.ticks();
+    // Inbound lists stay in source order so delivery order is fixed
+    std::vector<Channel*>& l_inbound = c_parts[f_to]->inbound;
+    l_inbound.clear();
+    for (size_t l_from = 0; l_from < partitions(); ++l_from) {
+      if (c_channels[l_from * partitions() + f_to]) {
+        l_inbound.push_back(c_channels[l_from * partitions() + f_to].get());
+      }
+    }
+  }
+  l_channel->minDelay = std::min(l_channel->minDelay, f_minDelay.ticks());
+  c_lookahead = std::min(c_lookahead, f_minDelay);
+}
+
+void ghls::PartitionedSim::send(uint32_t f_from, uint32_t f_to, SimTime f_delay, EventFn f_fn,
+                                void* f_ctx, uint64_t f_arg) {
+  Scheduler& l_sched = c_parts[f_from]->sched;
+  if (f_from == f_to) {
+    l_sched.schedule(f_delay, f_fn, f_ctx, f_arg);
+    return;
+  }
+  Channel* l_channel = c_channels[f_from * partitions() + f_to].get();
+  assert(l_channel != nullptr && "message over an undeclared link");
+  assert(f_delay.ticks() >= l_channel->minDelay && "message faster than its link allows");
+  Message l_msg{(l_sched.now() + f_delay).ticks(), f_fn, f_ctx, f_arg};
+  if (!l_channel->overflow.empty() || !l_channel->ring.tryPush(l_msg)) {
+    l_channel->overflow.push_back(l_msg);
+  }
+  ++l_channel->sent;
+}
+
+void ghls::PartitionedSim::runUntil(SimTime f_end) {
+  // Messages sent before the run (initial stimulus) are delivered first
+  for (size_t l_part = 0; l_part < partitions(); ++l_part) {
+    deliver(*c_parts[l_part]);
+    std::optional<SimTime> l_next = c_parts[l_part]->sched.nextEventTime();
+    c_nextTimes[l_part] = l_next ? l_next->ticks() : kNever;
+  }
+  for (;;) {
+    SimTick l_gvt = *std::min_element(c_nextTimes.begin(), c_nextTimes.end());
+    if (l_gvt == kNever || l_gvt > f_end.ticks()) {
+      break;
+    }
+    // Nothing can arrive before l_gvt + lookahead, so everything before it is safe
+    SimTick l_safe = kNever - l_gvt > c_lookahead.ticks() ? l_gvt + c_lookahead.ticks() - 1
+                                                          : kNever;
+    c_horizon = std::min(l_safe, f_end.ticks());
+    if (!c_workers.empty()) {
+      c_busyWorkers.store(static_cast<unsigned>(c_workers.size()), std::memory_order_relaxed);
+      {
+        std::lock_guard<std::mutex> l_lock(c_mutex);
+        c_generation.fetch_add(1, std::memory_order_release);
+      }
+      c_wake.notify_all();
+    }
+    runWindow(0);
+    while (c_busyWorkers.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+    ++c_windows;
+  }
+  for (const auto& l_part : c_parts) {
+    l_part->sched.runUntil(f_end);
+  }
+}
+
+uint64_t ghls::PartitionedSim::messages() const noexcept {
+  uint64_t l_total = 0;
+  for (const auto& l_channel : c_channels) {
+    l_total += l_channel ? l_channel->sent : 0;
+  }
+  return l_total;
+}
+
+uint64_t ghls::PartitionedSim::eventsExecuted() const noexcept {
+  uint64_t l_total = 0;
+  for (const auto& l_part : c_parts) {
+    l_total += l_part->sched.eventsExecuted();
+  }
+  return l_total;
+}
+
+void ghls::PartitionedSim::workerLoop(unsigned f_worker) {
+  uint64_t l_seen = 0;
+  for (;;) {
+    int l_spins = 0;
+    while (c_generation.load(std::memory_order_acquire) == l_seen && l_spins < kSpinLimit) {
+      ++l_spins;
+      std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> l_lock(c_mutex);
+      c_wake.wait(l_lock, [this, l_seen] {
+        return c_generation.load(std::memory_order_acquire) != l_seen;
+      });
+      if (c_shutdown) {
+        return;
+      }
+      l_seen = c_generation.load(std::memory_order_acquire);
+    }
+    runWindow(f_worker);
+    c_busyWorkers.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+void ghls::PartitionedSim::runWindow(unsigned f_worker) {
+  const size_t l_begin = partitions() * f_worker / threads();
+  const size_t l_end = partitions() * (f_worker + 1) / threads();
+  for (size_t l_part = l_begin; l_part < l_end; ++l_part) {
+    if (c_nextTimes[l_part] <= c_horizon) {
+      c_parts[l_part]->sched.runUntil(SimTime::fromTicks(c_horizon));
+    }
+  }
+  // Every message of the window has been sent once all threads get here
+  barrier();
+  for (size_t l_part = l_begin; l_part < l_end; ++l_part) {
+    deliver(*c_parts[l_part]);
+    std::optional<SimTime> l_next = c_parts[l_part]->sched.nextEventTime();
+    c_nextTimes[l_part] = l_next ? l_next->ticks() : kNever;
+  }
+}
+
+void ghls::PartitionedSim::barrier() {
+  if (c_workers.empty()) {
+    return;
+  }
+  uint64_t l_phase = c_barrierPhase.load(std::memory_order_acquire);
+  if (c_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == threads()) {
+    c_arrived.store(0, std::memory_order_relaxed);
+    c_barrierPhase.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  while (c_barrierPhase.load(std::memory_order_acquire) == l_phase) {
+    std::this_thread::yield();
+  }
+}
+
+void ghls::PartitionedSim::deliver(Partition& f_part) {
+  for (Channel* l_channel : f_part.inbound) {
+    Message l_msg;
+    while (l_channel->ring.tryPop(l_msg)) {
+      f_part.sched.scheduleAt(SimTime::fromTicks(l_msg.time), l_msg.fn, l_msg.ctx, l_msg.arg);
+    }
+    for (const Message& l_spilled : l_channel->overflow) {
+      f_part.sched.scheduleAt(SimTime::fromTicks(l_spilled.time), l_spilled.fn, l_spilled.ctx,
+                              l_spilled.arg);
+    }
+    l_channel->overflow.clear();
+  }
+}
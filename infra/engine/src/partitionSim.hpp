@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "scheduler.hpp"
+#include "simTime.hpp"
+#include "spscRing.hpp"
+
+namespace ghls {
+
+// Parallel discrete-event simulation over partitions of a design. Every
+// partition owns a Scheduler (its local time and event queue); partitions
+// interact only through messages sent over declared links, each with a
+// minimum delay.
+//
+// Synchronization is conservative and window based: with lookahead L, the
+// smallest link delay, no message can land before the earliest pending event
+// time T plus L, so all partitions run their events before T + L in parallel
+// without rollback. Messages travel over one lock-free SPSC ring per link
+// and are queued at the receiver at the window barrier, in link source
+// order, so results do not depend on the thread count.
+class PartitionedSim {
+ public:
+  // f_threads includes the calling thread; 0 means one per hardware thread.
+  // Partitions are spread over the threads in contiguous blocks.
+  PartitionedSim(size_t f_partitions, unsigned f_threads = 0, size_t f_ringCapacity = 4096);
+  ~PartitionedSim();
+  PartitionedSim(const PartitionedSim&) = delete;
+  PartitionedSim& operator=(const PartitionedSim&) = delete;
+
+  size_t partitions() const noexcept { return c_parts.size(); }
+  unsigned threads() const noexcept { return static_cast<unsigned>(c_workers.size()) + 1; }
+  // Local event queue of a partition, for events that stay inside it
+  Scheduler& scheduler(uint32_t f_part) noexcept { return c_parts[f_part]->sched; }
+
+  // Declares that f_from may send to f_to with at least f_minDelay, which
+  // must be non-zero. Links are set up before running.
+  void link(uint32_t f_from, uint32_t f_to, SimTime f_minDelay);
+  // Smallest delay over all links; the width of a synchronization window
+  SimTime lookahead() const noexcept { return c_lookahead; }
+
+  // Called from an event of partition f_from: fires f_fn in partition f_to
+  // f_delay after f_from's current time. f_delay must not be below the link
+  // delay.
+  void send(uint32_t f_from, uint32_t f_to, SimTime f_delay, EventFn f_fn, void* f_ctx = nullptr,
+            uint64_t f_arg = 0);
+
+  // Runs every partition to f_end
+  void runUntil(SimTime f_end);
+
+  uint64_t windows() const noexcept { return c_windows; }
+  uint64_t messages() const noexcept;
+  uint64_t eventsExecuted() const noexcept;
+
+ private:
+  struct Message {
+    SimTick time;
+    EventFn fn;
+    void* ctx;
+    uint64_t arg;
+  };
+
+  // Messages spill into the sender-owned overflow when the ring is full and
+  // keep going there until the barrier, which keeps them in send order
+  struct Channel {
+    explicit Channel(size_t f_capacity) : ring(f_capacity) {}
+    SpscRing<Message> ring;
+    std::vector<Message> overflow;
+    SimTick minDelay;
+    uint64_t sent = 0;
+  };
+
+  struct alignas(64) Partition {
+    Scheduler sched;
+    // Links into this partition, in source order
+    std::vector<Channel*> inbound;
+  };
+
+  void workerLoop(unsigned f_worker);
+  void runWindow(unsigned f_worker);
+  void barrier();
+  void deliver(Partition& f_part);
+
+  size_t c_ringCapacity;
+  std::vector<std::unique_ptr<Partition>> c_parts;
+  // c_channels[from * partitions() + to], null without a link
+  std::vector<std::unique_ptr<Channel>> c_channels;
+  SimTime c_lookahead;
+
+  // Window shared with the workers: run events up to c_horizon (inclusive)
+  SimTick c_horizon;
+  std::vector<SimTick> c_nextTimes;
+
+  std::vector<std::thread> c_workers;
+  std::mutex c_mutex;
+  std::condition_variable c_wake;
+  std::atomic<uint64_t> c_generation;
+  std::atomic<unsigned> c_busyWorkers;
+  std::atomic<unsigned> c_arrived;
+  std::atomic<uint64_t> c_barrierPhase;
+  bool c_shutdown;
+
+  uint64_t c_windows;
+};
+
+}  // namespace ghls
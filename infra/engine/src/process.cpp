@@ -0,0 +1,165 @@
+#include "process.hpp"
+
+#include <cassert>
+#include <new>
+
+void* ghls::FramePool::allocate(size_t f_size) {
+  if (f_size > kMaxPooled) {
+    return ::operator new(f_size);
+  }
+  return pool((f_size - 1) / kGranule).allocate();
+}
+
+void ghls::FramePool::deallocate(void* f_ptr, size_t f_size) noexcept {
+  if (f_size > kMaxPooled) {
+    ::operator delete(f_ptr);
+    return;
+  }
+  c_pools[(f_size - 1) / kGranule]->deallocate(f_ptr);
+}
+
+size_t ghls::FramePool::inUse() const noexcept {
+  size_t l_total = 0;
+  for (const std::unique_ptr<FixedPool>& l_pool : c_pools) {
+    l_total += l_pool ? l_pool->inUse() : 0;
+  }
+  return l_total;
+}
+
+ghls::FixedPool& ghls::FramePool::pool(size_t f_class) {
+  std::unique_ptr<FixedPool>& l_pool = c_pools[f_class];
+  if (!l_pool) {
+    // About 64 KB per chunk whatever the frame size
+    size_t l_slot = (f_class + 1) * kGranule;
+    l_pool = std::make_unique<FixedPool>(l_slot, 64 * 1024 / l_slot);
+  }
+  return *l_pool;
+}
+
+ghls::FramePool& ghls::threadFramePool() {
+  thread_local FramePool t_pool;
+  return t_pool;
+}
+
+ghls::Process::~Process() {
+  if (c_handle) {
+    c_handle.destroy();
+  }
+}
+
+ghls::Process::promise_type::~promise_type() {
+  if (group == nullptr) {
+    return;
+  }
+  if (prev != nullptr) {
+    prev->next = next;
+  } else {
+    group->c_head = next;
+  }
+  if (next != nullptr) {
+    next->prev = prev;
+  }
+  --group->c_live;
+  ++group->c_finished;
+}
+
+ghls::ProcessGroup::~ProcessGroup() {
+  while (c_head != nullptr) {
+    Process::Handle::from_promise(*c_head).destroy();
+  }
+}
+
+void ghls::ProcessGroup::spawn(Process f_process) {
+  Process::Handle l_handle = f_process.c_handle;
+  f_process.c_handle = nullptr;
+  Process::promise_type& l_promise = l_handle.promise();
+  l_promise.group = this;
+  l_promise.next = c_head;
+  if (c_head != nullptr) {
+    c_head->prev = &l_promise;
+  }
+  c_head = &l_promise;
+  ++c_live;
+  c_sched.scheduleDelta(&Process::promise_type::resume, l_handle.address());
+}
+
+ghls::Signal::Signal(Scheduler& f_sched, LogicWord f_init)
+    : c_sched(f_sched), c_value(f_init), c_pending(f_init), c_queued(false) {
+  c_waiters.prev = c_waiters.next = &c_waiters;
+}
+
+ghls::Signal::~Signal() {
+  // Leave the nodes unlinked so destroying their processes later is safe
+  while (c_waiters.next != &c_waiters) {
+    c_waiters.next->unlink();
+  }
+}
+
+void ghls::Signal::write(LogicWord f_value) {
+  c_pending = f_value;
+  if (!c_queued) {
+    c_queued = true;
+    c_sched.scheduleDelta(&Signal::onCommit, this);
+  }
+}
+
+void ghls::Signal::wait(SignalWaiter& f_waiter) noexcept {
+  assert(!f_waiter.linked() && "process already waits on a signal");
+  f_waiter.prev = c_waiters.prev;
+  f_waiter.next = &c_waiters;
+  c_waiters.prev->next = &f_waiter;
+  c_waiters.prev = &f_waiter;
+}
+
+size_t ghls::Signal::waiters() const noexcept {
+  size_t l_count = 0;
+  for (const SignalWaiter* l_node = c_waiters.next; l_node != &c_waiters; l_node = l_node->next) {
+    ++l_count;
+  }
+  return l_count;
+}
+
+bool ghls::Signal::matches(EdgeKind f_kind, Logic f_old, Logic f_new) noexcept {
+  switch (f_kind) {
+    case EdgeKind::pos:
+      return (f_old == Logic::zero && f_new != Logic::zero) ||
+             (f_old != Logic::one && f_new == Logic::one);
+    case EdgeKind::neg:
+      return (f_old == Logic::one && f_new != Logic::one) ||
+             (f_old != Logic::zero && f_new == Logic::zero);
+    default:
+      return true;
+  }
+}
+
+void ghls::Signal::onCommit(void* f_ctx, uint64_t) {
+  Signal& l_signal = *static_cast<Signal*>(f_ctx);
+  l_signal.c_queued = false;
+  if (l_signal.c_pending == l_signal.c_value) {
+    return;
+  }
+  Logic l_old = l_signal.bit(0);
+  l_signal.c_value = l_signal.c_pending;
+  l_signal.c_lastChange = l_signal.c_sched.now();
+  Logic l_new = l_signal.bit(0);
+  if (l_signal.c_waiters.next == &l_signal.c_waiters) {
+    return;
+  }
+  // Move the waiters aside first: resumed processes may wait on this signal
+  // again and must not be woken twice by the same change
+  SignalWaiter l_wake;
+  l_wake.next = l_signal.c_waiters.next;
+  l_wake.prev = l_signal.c_waiters.prev;
+  l_wake.next->prev = &l_wake;
+  l_wake.prev->next = &l_wake;
+  l_signal.c_waiters.prev = l_signal.c_waiters.next = &l_signal.c_waiters;
+  while (l_wake.next != &l_wake) {
+    SignalWaiter* l_waiter = l_wake.next;
+    l_waiter->unlink();
+    if (matches(l_waiter->kind, l_old, l_new)) {
+      l_waiter->handle.resume();
+    } else {
+      l_signal.wait(*l_waiter);
+    }
+  }
+}
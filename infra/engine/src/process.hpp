@@ -0,0 +1,247 @@
+#pragma once
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+
+#include "allocator.hpp"
+#include "netStore.hpp"
+#include "scheduler.hpp"
+#include "simTime.hpp"
+
+// Coroutine processes need C++20; they are built as the separate
+// engine_process library so the rest of the engine stays C++17.
+
+namespace ghls {
+
+// Coroutine frames of the calling thread, from size-classed FixedPools.
+// Frames larger than kMaxPooled come from operator new. Processes must be
+// created and destroyed on the same thread.
+class FramePool {
+ public:
+  static constexpr size_t kGranule = 64;
+  static constexpr size_t kMaxPooled = 1024;
+
+  void* allocate(size_t f_size);
+  void deallocate(void* f_ptr, size_t f_size) noexcept;
+
+  // Frames currently allocated from the pools
+  size_t inUse() const noexcept;
+
+ private:
+  static constexpr size_t kClasses = kMaxPooled / kGranule;
+
+  FixedPool& pool(size_t f_class);
+
+  std::array<std::unique_ptr<FixedPool>, kClasses> c_pools;
+};
+
+FramePool& threadFramePool();
+
+class ProcessGroup;
+
+// Simulation process written as a coroutine, e.g.
+//
+//   Process blink(Signal& f_led) {
+//     for (;;) {
+//       f_led.writeValue(1);
+//       co_await delay(SimTime(5.0, SimTimeUnit::ns));
+//       f_led.writeValue(0);
+//       co_await delay(SimTime(5.0, SimTimeUnit::ns));
+//     }
+//   }
+//
+// A Process does nothing until it is handed to ProcessGroup::spawn(). The
+// scheduler resumes it directly from an event; there is no thread or stack
+// per process, only the pooled coroutine frame.
+class Process {
+ public:
+  struct promise_type;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Process(Process&& f_other) noexcept : c_handle(f_other.c_handle) { f_other.c_handle = nullptr; }
+  Process& operator=(Process&&) = delete;
+  // Destroys the coroutine if it was never spawned
+  ~Process();
+
+ private:
+  friend class ProcessGroup;
+  explicit Process(Handle f_handle) noexcept : c_handle(f_handle) {}
+
+  Handle c_handle;
+};
+
+// Suspends the process for f_time. A zero delay resumes it in the next delta
+// cycle of the current timestep.
+struct Delay {
+  SimTime time;
+};
+inline Delay delay(SimTime f_time) noexcept { return {f_time}; }
+
+class Signal;
+
+enum class EdgeKind : uint8_t { any, pos, neg };
+
+// Suspends the process until the signal changes (edge) or bit 0 rises
+// (posedge) or falls (negedge) with Verilog semantics, so 0->x counts as a
+// rising and x->0 as a falling edge
+struct SignalEdge {
+  Signal* signal;
+  EdgeKind kind;
+};
+inline SignalEdge edge(Signal& f_signal) noexcept { return {&f_signal, EdgeKind::any}; }
+inline SignalEdge posedge(Signal& f_signal) noexcept { return {&f_signal, EdgeKind::pos}; }
+inline SignalEdge negedge(Signal& f_signal) noexcept { return {&f_signal, EdgeKind::neg}; }
+
+// Process waiting on a signal. The node lives in the coroutine frame for as
+// long as the process is suspended, so waiting allocates nothing.
+struct SignalWaiter {
+  SignalWaiter* prev = nullptr;
+  SignalWaiter* next = nullptr;
+  std::coroutine_handle<> handle;
+  EdgeKind kind = EdgeKind::any;
+
+  bool linked() const noexcept { return next != nullptr; }
+  void unlink() noexcept {
+    prev->next = next;
+    next->prev = prev;
+    prev = next = nullptr;
+  }
+};
+
+// Up to 64-bit 4-state value that processes write and wait on. Writes are
+// committed together in the next delta cycle, like a VHDL signal, and the
+// waiting processes whose edge matches are resumed from that commit.
+class Signal {
+ public:
+  // Starts all x
+  explicit Signal(Scheduler& f_sched, LogicWord f_init = {~uint64_t(0), ~uint64_t(0)});
+  Signal(const Signal&) = delete;
+  Signal& operator=(const Signal&) = delete;
+  // Waiting processes must have been destroyed or resumed
+  ~Signal();
+
+  LogicWord value() const noexcept { return c_value; }
+  Logic bit(uint32_t f_bit) const noexcept {
+    return static_cast<Logic>(((c_value.aval >> f_bit) & 1) | (((c_value.bval >> f_bit) & 1) << 1));
+  }
+  SimTime lastChange() const noexcept { return c_lastChange; }
+
+  // The last write in a delta cycle wins
+  void write(LogicWord f_value);
+  void writeValue(uint64_t f_value) { write({f_value, 0}); }
+
+  void wait(SignalWaiter& f_waiter) noexcept;
+  size_t waiters() const noexcept;
+
+ private:
+  static void onCommit(void* f_ctx, uint64_t f_arg);
+  static bool matches(EdgeKind f_kind, Logic f_old, Logic f_new) noexcept;
+
+  Scheduler& c_sched;
+  LogicWord c_value;
+  LogicWord c_pending;
+  SimTime c_lastChange;
+  bool c_queued;
+  // Circular list with c_waiters as the sentinel
+  SignalWaiter c_waiters;
+};
+
+// Owns spawned processes. Finished processes release their frame at once;
+// the ones still suspended when the group is destroyed are destroyed with it.
+// Their resume events stay queued in the scheduler, so a group must not be
+// destroyed while the scheduler can still run it (reset() the scheduler or
+// destroy it first). Coroutine resume events are not checkpointable.
+class ProcessGroup {
+ public:
+  explicit ProcessGroup(Scheduler& f_sched) : c_sched(f_sched) {}
+  ~ProcessGroup();
+  ProcessGroup(const ProcessGroup&) = delete;
+  ProcessGroup& operator=(const ProcessGroup&) = delete;
+
+  // Starts f_process in the next delta cycle (or the next timestep when
+  // called outside one)
+  void spawn(Process f_process);
+
+  Scheduler& scheduler() const noexcept { return c_sched; }
+  size_t live() const noexcept { return c_live; }
+  uint64_t finished() const noexcept { return c_finished; }
+
+ private:
+  friend struct Process::promise_type;
+
+  Scheduler& c_sched;
+  Process::promise_type* c_head = nullptr;
+  size_t c_live = 0;
+  uint64_t c_finished = 0;
+};
+
+struct Process::promise_type {
+  ProcessGroup* group = nullptr;
+  promise_type* prev = nullptr;
+  promise_type* next = nullptr;
+
+  static void* operator new(size_t f_size) { return threadFramePool().allocate(f_size); }
+  static void operator delete(void* f_ptr, size_t f_size) noexcept {
+    threadFramePool().deallocate(f_ptr, f_size);
+  }
+
+  // Leaves the group when the frame goes away, finished or destroyed
+  ~promise_type();
+
+  Process get_return_object() noexcept { return Process(Handle::from_promise(*this)); }
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  std::suspend_never final_suspend() noexcept { return {}; }
+  void return_void() noexcept {}
+  // Simulation code does not throw
+  void unhandled_exception() noexcept { std::terminate(); }
+
+  // Event callback resuming the coroutine whose frame address is f_ctx
+  static void resume(void* f_ctx, uint64_t) {
+    std::coroutine_handle<>::from_address(f_ctx).resume();
+  }
+
+  struct DelayAwaiter {
+    Scheduler& sched;
+    SimTime time;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> f_handle) {
+      sched.schedule(time, &promise_type::resume, f_handle.address());
+    }
+    void await_resume() const noexcept {}
+  };
+
+  struct EdgeAwaiter {
+    Signal* signal;
+    SignalWaiter waiter;
+
+    EdgeAwaiter(Signal* f_signal, EdgeKind f_kind) noexcept : signal(f_signal) {
+      waiter.kind = f_kind;
+    }
+    EdgeAwaiter(const EdgeAwaiter&) = delete;
+    EdgeAwaiter& operator=(const EdgeAwaiter&) = delete;
+    // A process destroyed while waiting leaves the signal's list
+    ~EdgeAwaiter() {
+      if (waiter.linked()) {
+        waiter.unlink();
+      }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> f_handle) noexcept {
+      waiter.handle = f_handle;
+      signal->wait(waiter);
+    }
+    void await_resume() const noexcept {}
+  };
+
+  DelayAwaiter await_transform(Delay f_delay) noexcept {
+    return {group->scheduler(), f_delay.time};
+  }
+  EdgeAwaiter await_transform(SignalEdge f_edge) noexcept { return {f_edge.signal, f_edge.kind}; }
+};
+
+}  // namespace ghls
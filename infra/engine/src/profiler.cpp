@@ -0,0 +1,215 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <map>
+
+namespace {
+
+// Folded stack frames are separated by ';' and end at the first space
+std::string frameName(const std::string& f_name) {
+  std::string l_frame = f_name;
+  std::replace_if(
+      l_frame.begin(), l_frame.end(), [](char f_c) { return f_c == ';' || f_c == ' '; }, '_');
+  return l_frame;
+}
+
+void printHistogram(std::FILE* f_out, const char* f_title, const ghls::Histogram& f_hist) {
+  std::fprintf(f_out, "%-16s %12" PRIu64 " %12.2f %10" PRIu64 " %10" PRIu64 " %12" PRIu64 "\n",
+               f_title, f_hist.count(), f_hist.mean(), f_hist.quantile(0.5),
+               f_hist.quantile(0.99), f_hist.max());
+}
+
+}  // namespace
+
+uint64_t ghls::Histogram::quantile(double f_fraction) const noexcept {
+  if (c_count == 0) {
+    return 0;
+  }
+  uint64_t l_rank = static_cast<uint64_t>(f_fraction * double(c_count - 1)) + 1;
+  uint64_t l_seen = 0;
+  for (unsigned l_bucket = 0; l_bucket < kBuckets; ++l_bucket) {
+    l_seen += c_buckets[l_bucket];
+    if (l_seen >= l_rank) {
+      uint64_t l_upper = l_bucket == 0 ? 0 : l_bucket == 64 ? ~uint64_t(0)
+                                                            : (uint64_t(1) << l_bucket) - 1;
+      return std::min(l_upper, c_max);
+    }
+  }
+  return c_max;
+}
+
+ghls::Profiler::Profiler(Scheduler& f_sched)
+    : c_sched(f_sched),
+      c_enabled(false),
+      c_lastKey{nullptr, nullptr},
+      c_last(nullptr),
+      c_enabledCycles(0),
+      c_enabledTime(0),
+      c_startCycles(0),
+      c_exitReport(false) {}
+
+ghls::Profiler::~Profiler() {
+  disable();
+  if (!c_exitReport) {
+    return;
+  }
+  if (!c_exitFolded.empty()) {
+    writeFolded(c_exitFolded);
+  }
+  if (c_exitSummary.empty()) {
+    writeSummary(stderr);
+  } else if (std::FILE* l_out = std::fopen(c_exitSummary.c_str(), "w")) {
+    writeSummary(l_out);
+    std::fclose(l_out);
+  }
+}
+
+void ghls::Profiler::enable() {
+  if (c_enabled) {
+    return;
+  }
+  c_enabled = true;
+  c_startTime = std::chrono::steady_clock::now();
+  c_startCycles = readCycleCounter();
+  c_sched.setProfiler(this);
+}
+
+void ghls::Profiler::disable() {
+  if (!c_enabled) {
+    return;
+  }
+  accumulateClock();
+  c_enabled = false;
+  if (c_sched.profiler() == this) {
+    c_sched.setProfiler(nullptr);
+  }
+}
+
+void ghls::Profiler::reset() {
+  c_processes.clear();
+  c_last = nullptr;
+  c_eventsPerStep.reset();
+  c_deltaDepth.reset();
+  c_queueOccupancy.reset();
+  c_stepCycles.reset();
+  c_enabledCycles = 0;
+  c_enabledTime = std::chrono::nanoseconds(0);
+  if (c_enabled) {
+    c_startTime = std::chrono::steady_clock::now();
+    c_startCycles = readCycleCounter();
+  }
+}
+
+void ghls::Profiler::name(EventFn f_fn, const std::string& f_name) { c_fnNames[f_fn] = f_name; }
+
+void ghls::Profiler::name(EventFn f_fn, void* f_ctx, const std::string& f_name) {
+  c_names[Key{f_fn, f_ctx}] = f_name;
+}
+
+std::vector<ghls::Profiler::ProcessStats> ghls::Profiler::processes() const {
+  std::map<std::string, ProcessStats> l_merged;
+  for (const auto& l_entry : c_processes) {
+    std::string l_name = nameOf(l_entry.first);
+    ProcessStats& l_stats = l_merged[l_name];
+    l_stats.name = l_name;
+    l_stats.events += l_entry.second.events;
+    l_stats.cycles += l_entry.second.cycles;
+    l_stats.maxCycles = std::max(l_stats.maxCycles, l_entry.second.maxCycles);
+  }
+  std::vector<ProcessStats> l_stats;
+  l_stats.reserve(l_merged.size());
+  for (auto& l_entry : l_merged) {
+    l_stats.push_back(std::move(l_entry.second));
+  }
+  std::stable_sort(l_stats.begin(), l_stats.end(),
+                   [](const ProcessStats& f_lhs, const ProcessStats& f_rhs) {
+                     return f_lhs.cycles > f_rhs.cycles;
+                   });
+  return l_stats;
+}
+
+double ghls::Profiler::cyclesPerSecond() const {
+  uint64_t l_cycles = c_enabledCycles;
+  std::chrono::nanoseconds l_time = c_enabledTime;
+  if (c_enabled) {
+    l_cycles += readCycleCounter() - c_startCycles;
+    l_time += std::chrono::steady_clock::now() - c_startTime;
+  }
+  if (l_time.count() <= 0) {
+    return 0.0;
+  }
+  return double(l_cycles) * 1e9 / double(l_time.count());
+}
+
+bool ghls::Profiler::writeFolded(const std::string& f_path) const {
+  std::FILE* l_out = std::fopen(f_path.c_str(), "w");
+  if (l_out == nullptr) {
+    return false;
+  }
+  uint64_t l_inProcesses = 0;
+  for (const ProcessStats& l_stats : processes()) {
+    std::fprintf(l_out, "ghls;%s %" PRIu64 "\n", frameName(l_stats.name).c_str(),
+                 l_stats.cycles);
+    l_inProcesses += l_stats.cycles;
+  }
+  // Queue maintenance, hooks and delta bookkeeping inside timesteps
+  if (c_stepCycles.sum() > l_inProcesses) {
+    std::fprintf(l_out, "ghls;[scheduler] %" PRIu64 "\n", c_stepCycles.sum() - l_inProcesses);
+  }
+  return std::fclose(l_out) == 0;
+}
+
+void ghls::Profiler::writeSummary(std::FILE* f_out) const {
+  double l_rate = cyclesPerSecond();
+  double l_toMs = l_rate > 0 ? 1e3 / l_rate : 0.0;
+  std::vector<ProcessStats> l_processes = processes();
+  uint64_t l_total = 0;
+  for (const ProcessStats& l_stats : l_processes) {
+    l_total += l_stats.cycles;
+  }
+
+  std::fprintf(f_out, "%-40s %12s %12s %7s %12s %12s\n", "process", "events", "ms", "%",
+               "cyc/event", "max cyc");
+  for (const ProcessStats& l_stats : l_processes) {
+    std::fprintf(f_out, "%-40s %12" PRIu64 " %12.3f %6.2f%% %12.1f %12" PRIu64 "\n",
+                 l_stats.name.c_str(), l_stats.events, double(l_stats.cycles) * l_toMs,
+                 l_total == 0 ? 0.0 : 100.0 * double(l_stats.cycles) / double(l_total),
+                 double(l_stats.cycles) / double(l_stats.events), l_stats.maxCycles);
+  }
+  std::fprintf(f_out, "\n%-16s %12s %12s %10s %10s %12s\n", "per timestep", "samples", "mean",
+               "p50", "p99", "max");
+  printHistogram(f_out, "events", c_eventsPerStep);
+  printHistogram(f_out, "delta depth", c_deltaDepth);
+  printHistogram(f_out, "queued", c_queueOccupancy);
+  printHistogram(f_out, "cycles", c_stepCycles);
+  std::fprintf(f_out, "\ncycle counter %.3f GHz, %.3f ms in timesteps, %.3f ms in processes\n",
+               l_rate * 1e-9, double(c_stepCycles.sum()) * l_toMs, double(l_total) * l_toMs);
+}
+
+void ghls::Profiler::reportAtExit(const std::string& f_foldedPath,
+                                  const std::string& f_summaryPath) {
+  c_exitReport = true;
+  c_exitFolded = f_foldedPath;
+  c_exitSummary = f_summaryPath;
+}
+
+std::string ghls::Profiler::nameOf(const Key& f_key) const {
+  auto l_named = c_names.find(f_key);
+  if (l_named != c_names.end()) {
+    return l_named->second;
+  }
+  auto l_fnNamed = c_fnNames.find(f_key.fn);
+  if (l_fnNamed != c_fnNames.end()) {
+    return l_fnNamed->second;
+  }
+  char l_buf[32];
+  std::snprintf(l_buf, sizeof(l_buf), "fn@%p", reinterpret_cast<void*>(f_key.fn));
+  return l_buf;
+}
+
+void ghls::Profiler::accumulateClock() {
+  c_enabledCycles += readCycleCounter() - c_startCycles;
+  c_enabledTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - c_startTime);
+}
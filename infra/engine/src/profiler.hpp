@@ -0,0 +1,176 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "scheduler.hpp"
+
+namespace ghls {
+
+// Cheapest monotonic counter available: the TSC on x86, nanoseconds elsewhere
+inline uint64_t readCycleCounter() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#endif
+}
+
+// Histogram with power-of-two buckets: bucket 0 counts zeros, bucket b
+// counts values in [2^(b-1), 2^b)
+class Histogram {
+ public:
+  static constexpr unsigned kBuckets = 65;
+
+  void add(uint64_t f_value) noexcept {
+    unsigned l_bucket = f_value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(f_value));
+    ++c_buckets[l_bucket];
+    ++c_count;
+    c_sum += f_value;
+    c_max = f_value > c_max ? f_value : c_max;
+  }
+
+  uint64_t count() const noexcept { return c_count; }
+  uint64_t sum() const noexcept { return c_sum; }
+  uint64_t max() const noexcept { return c_max; }
+  uint64_t bucket(unsigned f_bucket) const noexcept { return c_buckets[f_bucket]; }
+  double mean() const noexcept { return c_count == 0 ? 0.0 : double(c_sum) / c_count; }
+  // Upper bound of the bucket holding the f_fraction quantile
+  uint64_t quantile(double f_fraction) const noexcept;
+  void reset() noexcept { *this = Histogram(); }
+
+ private:
+  std::array<uint64_t, kBuckets> c_buckets{};
+  uint64_t c_count = 0;
+  uint64_t c_sum = 0;
+  uint64_t c_max = 0;
+};
+
+// Hot-path profiler for a Scheduler. While enabled it times every event
+// callback with the cycle counter, keyed by process (callback and context),
+// and records per timestep the events executed, the delta-cycle depth, the
+// queue occupancy and the step duration. When it is disabled the scheduler
+// pays one branch per delta cycle.
+//
+// Reports are a folded-stack file for flame graph tools (flamegraph.pl,
+// speedscope, inferno) and a summary table; both can be written at exit.
+class Profiler {
+ public:
+  struct ProcessStats {
+    std::string name;
+    uint64_t events;
+    uint64_t cycles;
+    uint64_t maxCycles;
+  };
+
+  explicit Profiler(Scheduler& f_sched);
+  // Detaches from the scheduler and writes the exit reports, if requested
+  ~Profiler();
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  void enable();
+  void disable();
+  bool enabled() const noexcept { return c_enabled; }
+  // Clears everything recorded so far
+  void reset();
+
+  // Names shown in reports, for every context of a callback or for one.
+  // Unnamed processes show up by address.
+  void name(EventFn f_fn, const std::string& f_name);
+  void name(EventFn f_fn, void* f_ctx, const std::string& f_name);
+
+  // Called by the scheduler
+  void recordEvent(EventFn f_fn, void* f_ctx, uint64_t f_cycles) {
+    // Runs of events from one process skip the hash lookup; map nodes are stable
+    if (f_fn != c_lastKey.fn || f_ctx != c_lastKey.ctx || c_last == nullptr) {
+      c_lastKey = Key{f_fn, f_ctx};
+      c_last = &c_processes[c_lastKey];
+    }
+    Counters& l_counters = *c_last;
+    ++l_counters.events;
+    l_counters.cycles += f_cycles;
+    l_counters.maxCycles = f_cycles > l_counters.maxCycles ? f_cycles : l_counters.maxCycles;
+  }
+  void recordStep(uint64_t f_events, uint32_t f_deltas, size_t f_pending, uint64_t f_cycles) {
+    c_eventsPerStep.add(f_events);
+    c_deltaDepth.add(f_deltas);
+    c_queueOccupancy.add(f_pending);
+    c_stepCycles.add(f_cycles);
+  }
+
+  // Processes merged by name, most expensive first
+  std::vector<ProcessStats> processes() const;
+  const Histogram& eventsPerStep() const noexcept { return c_eventsPerStep; }
+  const Histogram& deltaDepth() const noexcept { return c_deltaDepth; }
+  // Pending events at the start of each timestep
+  const Histogram& queueOccupancy() const noexcept { return c_queueOccupancy; }
+  const Histogram& stepCycles() const noexcept { return c_stepCycles; }
+  // Cycle counter rate measured over the enabled time
+  double cyclesPerSecond() const;
+
+  // One "ghls;<process> <cycles>" line per process, plus the scheduler's own
+  // time outside callbacks
+  bool writeFolded(const std::string& f_path) const;
+  void writeSummary(std::FILE* f_out) const;
+  // Reports written when the profiler is destroyed; an empty summary path
+  // means stderr, an empty folded path skips that report
+  void reportAtExit(const std::string& f_foldedPath, const std::string& f_summaryPath = "");
+
+ private:
+  struct Key {
+    EventFn fn;
+    void* ctx;
+    bool operator==(const Key& f_rhs) const noexcept {
+      return fn == f_rhs.fn && ctx == f_rhs.ctx;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key& f_key) const noexcept {
+      uint64_t l_hash = reinterpret_cast<uintptr_t>(f_key.fn) * 0x9e3779b97f4a7c15ULL;
+      return static_cast<size_t>(l_hash ^ (reinterpret_cast<uintptr_t>(f_key.ctx) >> 4));
+    }
+  };
+  struct Counters {
+    uint64_t events = 0;
+    uint64_t cycles = 0;
+    uint64_t maxCycles = 0;
+  };
+
+  std::string nameOf(const Key& f_key) const;
+  void accumulateClock();
+
+  Scheduler& c_sched;
+  bool c_enabled;
+  std::unordered_map<Key, Counters, KeyHash> c_processes;
+  Key c_lastKey;
+  Counters* c_last;
+  std::unordered_map<EventFn, std::string> c_fnNames;
+  std::unordered_map<Key, std::string, KeyHash> c_names;
+  Histogram c_eventsPerStep;
+  Histogram c_deltaDepth;
+  Histogram c_queueOccupancy;
+  Histogram c_stepCycles;
+
+  // Cycle counter against wall time over the enabled periods
+  uint64_t c_enabledCycles;
+  std::chrono::nanoseconds c_enabledTime;
+  uint64_t c_startCycles;
+  std::chrono::steady_clock::time_point c_startTime;
+
+  bool c_exitReport;
+  std::string c_exitFolded;
+  std::string c_exitSummary;
+};
+
+}  // namespace ghls
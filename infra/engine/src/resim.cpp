@@ -0,0 +1,295 @@
+#include "resim.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <iterator>
+
+namespace {
+
+bool readFile(const std::string& f_path, std::vector<uint8_t>& f_out) {
+  std::FILE* l_in = std::fopen(f_path.c_str(), "rb");
+  if (l_in == nullptr) {
+    return false;
+  }
+  uint8_t l_buf[1 << 16];
+  size_t l_read;
+  while ((l_read = std::fread(l_buf, 1, sizeof(l_buf), l_in)) != 0) {
+    f_out.insert(f_out.end(), l_buf, l_buf + l_read);
+  }
+  std::fclose(l_in);
+  return true;
+}
+
+bool sameFile(const std::string& f_lhs, const std::string& f_rhs) {
+  std::vector<uint8_t> l_lhs, l_rhs;
+  return readFile(f_lhs, l_lhs) && readFile(f_rhs, l_rhs) && l_lhs == l_rhs;
+}
+
+bool sameStimulus(const ghls::Stimulus& f_lhs, const ghls::Stimulus& f_rhs) {
+  return f_lhs.at == f_rhs.at && f_lhs.net == f_rhs.net && f_lhs.value == f_rhs.value;
+}
+
+}  // namespace
+
+ghls::Resim::Resim(const Netlist& f_netlist, SimTime f_window, const std::string& f_dir)
+    : c_netlist(f_netlist),
+      c_sim(f_netlist, c_sched),
+      c_cp(c_sched),
+      c_window(f_window),
+      c_dir(f_dir),
+      c_current(nullptr),
+      c_simulated(0),
+      c_reused(0) {
+  assert(f_window.ticks() != 0 && "re-simulation windows must not be empty");
+  assert(c_sim.compiled() && "re-simulation needs a netlist without combinational loops");
+  c_sched.addStepHook(onStep, this);
+}
+
+void ghls::Resim::addClock(const Clock& f_clock, uint32_t f_domain) {
+  assert(c_windows.empty() && "clocks are fixed once the design ran");
+  c_sim.addClock(f_clock, f_domain);
+}
+
+void ghls::Resim::watch(NetId f_net) {
+  assert(c_windows.empty() && "watched nets are fixed once the design ran");
+  c_watched.push_back(f_net);
+}
+
+void ghls::Resim::setStimulus(std::vector<Stimulus> f_stimulus) {
+  std::stable_sort(
+      f_stimulus.begin(), f_stimulus.end(),
+      [](const Stimulus& f_lhs, const Stimulus& f_rhs) { return f_lhs.at < f_rhs.at; });
+  c_stimulus = std::move(f_stimulus);
+}
+
+bool ghls::Resim::run(SimTime f_end) {
+  assert(c_windows.empty() && "run() starts from time zero; later edits go through rerun()");
+  // Registered only now, the clock events exist once every clock is added
+  c_sim.checkpoint(c_cp, "sim");
+  c_end = f_end;
+  c_windows.resize(std::max<SimTick>(1, (f_end.ticks() + c_window.ticks() - 1) / c_window.ticks()));
+  c_recorded = c_stimulus;
+  c_cone.assign(c_netlist.nets(), 0);
+  c_tracing.assign(c_netlist.nets(), 0);
+  for (NetId l_net : c_watched) {
+    c_tracing[l_net] = 1;
+  }
+  c_resumedFrom = SimTime();
+  c_reused = 0;
+
+  // Tracing starts from the state in the first snapshot, after the clock
+  // edges at time zero
+  c_sched.runUntil(SimTime());
+  c_lastSeen.resize(c_netlist.nets());
+  for (NetId l_net : c_watched) {
+    c_lastSeen[l_net] = c_sim.value(l_net);
+  }
+  bool l_ok = c_cp.save(snapshotPath(0));
+  for (size_t l_window = 0; l_window < c_windows.size(); ++l_window) {
+    simulate(l_window);
+    l_ok = c_cp.save(snapshotPath(l_window + 1)) && l_ok;
+  }
+  c_simulated = c_windows.size();
+  return l_ok;
+}
+
+bool ghls::Resim::rerun() {
+  assert(!c_windows.empty() && "rerun() needs a recorded run");
+  const size_t l_count = c_windows.size();
+  // l_sameFrom[w]: the stimulus of windows w and later is unchanged
+  std::vector<uint8_t> l_sameFrom(l_count + 1, 1);
+  for (size_t l_window = l_count; l_window-- > 0;) {
+    l_sameFrom[l_window] = l_sameFrom[l_window + 1] && sameWindow(l_window);
+  }
+  size_t l_first = 0;
+  while (l_first < l_count && sameWindow(l_first)) {
+    ++l_first;
+  }
+  c_simulated = 0;
+  c_reused = l_count;
+  c_cone.assign(c_netlist.nets(), 0);
+  if (l_first == l_count) {
+    c_resumedFrom = c_end;
+    c_recorded = c_stimulus;
+    return true;
+  }
+
+  // Inputs whose sequence of drives differs in some edited window
+  std::vector<NetId> l_changed;
+  for (size_t l_window = l_first; l_window < l_count; ++l_window) {
+    if (sameWindow(l_window)) {
+      continue;
+    }
+    size_t l_oldBegin = stimulusBegin(c_recorded, l_window);
+    size_t l_oldEnd = stimulusBegin(c_recorded, l_window + 1);
+    size_t l_newBegin = stimulusBegin(c_stimulus, l_window);
+    size_t l_newEnd = stimulusBegin(c_stimulus, l_window + 1);
+    std::vector<NetId> l_nets;
+    for (size_t l_idx = l_oldBegin; l_idx < l_oldEnd; ++l_idx) {
+      l_nets.push_back(c_recorded[l_idx].net);
+    }
+    for (size_t l_idx = l_newBegin; l_idx < l_newEnd; ++l_idx) {
+      l_nets.push_back(c_stimulus[l_idx].net);
+    }
+    for (NetId l_net : l_nets) {
+      auto l_drives = [l_net](const std::vector<Stimulus>& f_list, size_t f_begin, size_t f_end) {
+        std::vector<Stimulus> l_out;
+        std::copy_if(f_list.begin() + f_begin, f_list.begin() + f_end, std::back_inserter(l_out),
+                     [l_net](const Stimulus& f_entry) { return f_entry.net == l_net; });
+        return l_out;
+      };
+      std::vector<Stimulus> l_old = l_drives(c_recorded, l_oldBegin, l_oldEnd);
+      std::vector<Stimulus> l_new = l_drives(c_stimulus, l_newBegin, l_newEnd);
+      if (!std::equal(l_old.begin(), l_old.end(), l_new.begin(), l_new.end(), sameStimulus)) {
+        l_changed.push_back(l_net);
+      }
+    }
+  }
+  markCone(l_changed);
+
+  if (!c_cp.restore(snapshotPath(l_first))) {
+    return false;
+  }
+  c_resumedFrom = boundary(l_first);
+  for (NetId l_net : c_watched) {
+    c_tracing[l_net] = c_cone[l_net];
+    c_lastSeen[l_net] = c_sim.value(l_net);
+  }
+
+  bool l_ok = true;
+  for (size_t l_window = l_first; l_window < l_count; ++l_window) {
+    // Watched nets outside the cone keep what the previous run recorded
+    std::vector<NetChange>& l_changes = c_windows[l_window].changes;
+    l_changes.erase(std::remove_if(l_changes.begin(), l_changes.end(),
+                                   [this](const NetChange& f_change) {
+                                     return c_cone[f_change.net] != 0;
+                                   }),
+                    l_changes.end());
+    simulate(l_window);
+    ++c_simulated;
+    --c_reused;
+
+    std::string l_path = snapshotPath(l_window + 1);
+    if (l_window + 1 < l_count && l_sameFrom[l_window + 1]) {
+      std::string l_fresh = l_path + ".new";
+      if (c_cp.save(l_fresh) && sameFile(l_fresh, l_path)) {
+        // Same state and same stimulus from here on: the rest of the recorded
+        // run, snapshots included, is what simulating would produce again
+        std::remove(l_fresh.c_str());
+        l_ok = c_cp.restore(snapshotPath(l_count));
+        break;
+      }
+      l_ok = std::rename(l_fresh.c_str(), l_path.c_str()) == 0 && l_ok;
+    } else {
+      l_ok = c_cp.save(l_path) && l_ok;
+    }
+  }
+  for (NetId l_net : c_watched) {
+    c_tracing[l_net] = 1;
+  }
+  c_recorded = c_stimulus;
+  return l_ok;
+}
+
+std::vector<ghls::NetChange> ghls::Resim::trace() const {
+  std::vector<NetChange> l_out;
+  for (const Window& l_window : c_windows) {
+    l_out.insert(l_out.end(), l_window.changes.begin(), l_window.changes.end());
+  }
+  return l_out;
+}
+
+void ghls::Resim::onStep(void* f_ctx) {
+  Resim* l_resim = static_cast<Resim*>(f_ctx);
+  if (l_resim->c_current == nullptr) {
+    return;
+  }
+  SimTime l_now = l_resim->c_sched.now();
+  for (NetId l_net : l_resim->c_watched) {
+    LogicWord l_value = l_resim->c_sim.value(l_net);
+    if (l_resim->c_tracing[l_net] != 0 && l_value != l_resim->c_lastSeen[l_net]) {
+      l_resim->c_lastSeen[l_net] = l_value;
+      l_resim->c_current->changes.push_back({l_now, l_net, l_value});
+    }
+  }
+}
+
+std::string ghls::Resim::snapshotPath(size_t f_boundary) const {
+  return c_dir + "/window_" + std::to_string(f_boundary) + ".ghck";
+}
+
+ghls::SimTime ghls::Resim::boundary(size_t f_boundary) const {
+  SimTime l_time = c_window * f_boundary;
+  return f_boundary >= c_windows.size() || c_end < l_time ? c_end : l_time;
+}
+
+size_t ghls::Resim::stimulusBegin(const std::vector<Stimulus>& f_list, size_t f_window) const {
+  SimTime l_from = boundary(f_window);
+  return std::lower_bound(f_list.begin(), f_list.end(), l_from,
+                          [](const Stimulus& f_entry, SimTime f_time) {
+                            return f_entry.at < f_time;
+                          }) -
+         f_list.begin();
+}
+
+bool ghls::Resim::sameWindow(size_t f_window) const {
+  size_t l_oldBegin = stimulusBegin(c_recorded, f_window);
+  size_t l_newBegin = stimulusBegin(c_stimulus, f_window);
+  return std::equal(c_recorded.begin() + l_oldBegin,
+                    c_recorded.begin() + stimulusBegin(c_recorded, f_window + 1),
+                    c_stimulus.begin() + l_newBegin,
+                    c_stimulus.begin() + stimulusBegin(c_stimulus, f_window + 1), sameStimulus);
+}
+
+void ghls::Resim::simulate(size_t f_window) {
+  Window& l_window = c_windows[f_window];
+  c_current = &l_window;
+  l_window.reads.clear();
+  size_t l_end = stimulusBegin(c_stimulus, f_window + 1);
+  for (size_t l_idx = stimulusBegin(c_stimulus, f_window); l_idx < l_end; ++l_idx) {
+    const Stimulus& l_entry = c_stimulus[l_idx];
+    c_sched.runUntil(l_entry.at);
+    c_sim.setInput(l_entry.net, l_entry.value);
+    l_window.reads.push_back(l_entry.net);
+  }
+  c_sched.runUntil(boundary(f_window + 1));
+  c_current = nullptr;
+  std::sort(l_window.reads.begin(), l_window.reads.end());
+  l_window.reads.erase(std::unique(l_window.reads.begin(), l_window.reads.end()),
+                       l_window.reads.end());
+  // Canonical order, so merged and freshly traced windows compare equal
+  std::stable_sort(l_window.changes.begin(), l_window.changes.end(),
+                   [](const NetChange& f_lhs, const NetChange& f_rhs) {
+                     return f_lhs.at < f_rhs.at || (f_lhs.at == f_rhs.at && f_lhs.net < f_rhs.net);
+                   });
+}
+
+void ghls::Resim::markCone(const std::vector<NetId>& f_inputs) {
+  std::vector<uint32_t> l_offsets, l_gates;
+  c_netlist.fanout(l_offsets, l_gates);
+  std::vector<std::vector<NetId>> l_flopQs(c_netlist.nets());
+  for (const Flop& l_flop : c_netlist.flops()) {
+    l_flopQs[l_flop.d].push_back(l_flop.q);
+  }
+  std::vector<NetId> l_work;
+  auto l_reach = [&](NetId f_net) {
+    if (c_cone[f_net] == 0) {
+      c_cone[f_net] = 1;
+      l_work.push_back(f_net);
+    }
+  };
+  for (NetId l_net : f_inputs) {
+    l_reach(l_net);
+  }
+  while (!l_work.empty()) {
+    NetId l_net = l_work.back();
+    l_work.pop_back();
+    for (uint32_t l_idx = l_offsets[l_net]; l_idx < l_offsets[l_net + 1]; ++l_idx) {
+      l_reach(c_netlist.gates()[l_gates[l_idx]].out);
+    }
+    for (NetId l_q : l_flopQs[l_net]) {
+      l_reach(l_q);
+    }
+  }
+}
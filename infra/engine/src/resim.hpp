@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "checkpoint.hpp"
+#include "clock.hpp"
+#include "compiledSim.hpp"
+#include "netlist.hpp"
+#include "scheduler.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+// Primary input driven to f_value at time 'at'
+struct Stimulus {
+  SimTime at;
+  NetId net;
+  LogicWord value;
+};
+
+// Value of a watched net from time 'at' on
+struct NetChange {
+  SimTime at;
+  NetId net;
+  LogicWord value;
+};
+
+// Incremental re-simulation of a design under editable stimulus.
+//
+// run() splits simulated time into windows of f_window and snapshots the
+// design at every window boundary, recording per window which inputs the
+// stimulus drove and how the watched nets changed. After setStimulus() with
+// an edited list, rerun() restores the snapshot of the window holding the
+// earliest edit and simulates forward from there. Only watched nets in the
+// fan-out cone of the edited inputs are traced again; the others keep their
+// recorded changes. As soon as a boundary snapshot is identical to the one
+// of the previous run and the remaining stimulus is unchanged, the rest of
+// the recorded run is reused and the design jumps to the saved end state.
+//
+// A stimulus at a boundary belongs to the window it starts, so snapshots
+// hold the state after the clock edges at that time but before its inputs.
+class Resim {
+ public:
+  // Snapshots go to f_dir, which must exist
+  Resim(const Netlist& f_netlist, SimTime f_window, const std::string& f_dir);
+  Resim(const Resim&) = delete;
+  Resim& operator=(const Resim&) = delete;
+
+  // Clocks and watched nets are fixed before the first run()
+  void addClock(const Clock& f_clock, uint32_t f_domain);
+  void watch(NetId f_net);
+
+  // Replaces the stimulus; entries are applied in time order, equal times in
+  // list order. Entries at or after the end time are ignored.
+  void setStimulus(std::vector<Stimulus> f_stimulus);
+  const std::vector<Stimulus>& stimulus() const noexcept { return c_stimulus; }
+
+  // Simulates the whole stimulus from time zero up to f_end
+  bool run(SimTime f_end);
+  // Brings the recorded run up to date with the current stimulus, reusing
+  // as much of it as possible. Needs a previous run().
+  bool rerun();
+
+  const CompiledSim& sim() const noexcept { return c_sim; }
+  SimTime now() const noexcept { return c_sched.now(); }
+  size_t windows() const noexcept { return c_windows.size(); }
+  // Inputs the stimulus drove in window f_window, ascending
+  const std::vector<NetId>& inputsRead(size_t f_window) const { return c_windows[f_window].reads; }
+  // Every change of a watched net after the time zero snapshot, in time
+  // order (nets ascending within a timestep)
+  std::vector<NetChange> trace() const;
+
+  // Nets the last rerun() could affect, indexed by NetId
+  const std::vector<uint8_t>& cone() const noexcept { return c_cone; }
+  // Where the last run() or rerun() started simulating, and how many windows
+  // it simulated and took over from the previous run
+  SimTime resumedFrom() const noexcept { return c_resumedFrom; }
+  size_t windowsSimulated() const noexcept { return c_simulated; }
+  size_t windowsReused() const noexcept { return c_reused; }
+
+ private:
+  struct Window {
+    std::vector<NetId> reads;
+    std::vector<NetChange> changes;
+  };
+
+  static void onStep(void* f_ctx);
+
+  std::string snapshotPath(size_t f_boundary) const;
+  SimTime boundary(size_t f_boundary) const;
+  // Range of c_stimulus entries belonging to window f_window
+  size_t stimulusBegin(const std::vector<Stimulus>& f_list, size_t f_window) const;
+  bool sameWindow(size_t f_window) const;
+  // Runs one window, applying its stimulus and tracing the nets in c_tracing
+  void simulate(size_t f_window);
+  void markCone(const std::vector<NetId>& f_inputs);
+
+  const Netlist& c_netlist;
+  Scheduler c_sched;
+  CompiledSim c_sim;
+  Checkpointer c_cp;
+  SimTime c_window;
+  std::string c_dir;
+  SimTime c_end;
+
+  std::vector<Stimulus> c_stimulus;
+  // Stimulus of the recorded run
+  std::vector<Stimulus> c_recorded;
+  std::vector<Window> c_windows;
+  std::vector<NetId> c_watched;
+  std::vector<uint8_t> c_tracing;
+  std::vector<LogicWord> c_lastSeen;
+  Window* c_current;
+
+  std::vector<uint8_t> c_cone;
+  SimTime c_resumedFrom;
+  size_t c_simulated;
+  size_t c_reused;
+};
+
+}  // namespace ghls
@@ -0,0 +1,401 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "profiler.hpp"
+
+namespace {
+
+unsigned countTrailingZeros(uint64_t f_value) noexcept {
+#if defined(_MSC_VER)
+  unsigned long l_index;
+  _BitScanForward64(&l_index, f_value);
+  return static_cast<unsigned>(l_index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(f_value));
+#endif
+}
+
+unsigned highestSetBit(uint64_t f_value) noexcept {
+#if defined(_MSC_VER)
+  unsigned long l_index;
+  _BitScanReverse64(&l_index, f_value);
+  return static_cast<unsigned>(l_index);
+#else
+  return 63u - static_cast<unsigned>(__builtin_clzll(f_value));
+#endif
+}
+
+// Heap ordering so the earliest (time, sequence) pair sits at the front
+struct LaterEvent {
+  template <typename T>
+  bool operator()(const T* f_lhs, const T* f_rhs) const noexcept {
+    return f_lhs->c_time != f_rhs->c_time ? f_lhs->c_time > f_rhs->c_time
+                                          : f_lhs->c_seq > f_rhs->c_seq;
+  }
+};
+
+}  // namespace
+
+ghls::Scheduler::Scheduler()
+    : c_wheel(),
+      c_occupied(),
+      c_events(sizeof(Event)),
+      c_payloads(kMaxPayload),
+      c_now(0),
+      c_cursor(0),
+      c_seq(0),
+      c_delta(0),
+      c_pending(0),
+      c_inStep(false),
+      c_stopped(false),
+      c_deltaHook(nullptr),
+      c_deltaHookCtx(nullptr),
+      c_profiler(nullptr),
+      c_eventsExecuted(0),
+      c_deltaCycles(0),
+      c_timeSteps(0) {}
+
+ghls::Scheduler::~Scheduler() = default;
+
+void ghls::Scheduler::schedule(SimTime f_delay, EventFn f_fn, void* f_ctx, uint64_t f_arg) {
+  scheduleAt(SimTime::fromTicks(detail::addTicks(c_now, f_delay.ticks())), f_fn, f_ctx, f_arg);
+}
+
+void ghls::Scheduler::scheduleAt(SimTime f_time, EventFn f_fn, void* f_ctx, uint64_t f_arg) {
+  assert(f_time.ticks() >= c_now && "event scheduled in the past");
+  enqueue(f_time.ticks(), f_fn, f_ctx, f_arg, false);
+}
+
+void ghls::Scheduler::scheduleDelta(EventFn f_fn, void* f_ctx, uint64_t f_arg) {
+  enqueue(c_now, f_fn, f_ctx, f_arg, false);
+}
+
+void* ghls::Scheduler::schedulePayload(SimTime f_delay, EventFn f_fn, void* f_ctx,
+                                       size_t f_size) {
+  assert(f_size <= kMaxPayload && "payload does not fit a pool slot");
+  (void)f_size;
+  void* l_payload = c_payloads.allocate();
+  enqueue(detail::addTicks(c_now, f_delay.ticks()), f_fn, f_ctx,
+          reinterpret_cast<uintptr_t>(l_payload), true);
+  return l_payload;
+}
+
+void ghls::Scheduler::setDeltaHook(DeltaHook f_hook, void* f_ctx) noexcept {
+  c_deltaHook = f_hook;
+  c_deltaHookCtx = f_ctx;
+}
+
+void ghls::Scheduler::addStepHook(StepHook f_hook, void* f_ctx) {
+  c_stepHooks.emplace_back(f_hook, f_ctx);
+}
+
+void ghls::Scheduler::removeStepHook(StepHook f_hook, void* f_ctx) noexcept {
+  auto l_it = std::find(c_stepHooks.begin(), c_stepHooks.end(), std::make_pair(f_hook, f_ctx));
+  if (l_it != c_stepHooks.end()) {
+    c_stepHooks.erase(l_it);
+  }
+}
+
+void ghls::Scheduler::runStepHooks() {
+  for (const std::pair<StepHook, void*>& l_hook : c_stepHooks) {
+    l_hook.first(l_hook.second);
+  }
+}
+
+bool ghls::Scheduler::step() {
+  runStepHooks();
+  return runStep();
+}
+
+bool ghls::Scheduler::runStep() {
+  EventList l_due;
+  if (!advance(l_due)) {
+    return false;
+  }
+  c_stepArena.reset();
+  c_inStep = true;
+  c_delta = 0;
+  ++c_timeSteps;
+  // Sampled once so attaching or detaching from a callback keeps the step consistent
+  Profiler* l_profiler = c_profiler;
+  uint64_t l_startCycles = 0;
+  uint64_t l_startEvents = c_eventsExecuted;
+  size_t l_startPending = c_pending;
+  if (l_profiler != nullptr) {
+    l_startCycles = readCycleCounter();
+  }
+  for (;;) {
+    if (l_profiler == nullptr) {
+      runList<false>(l_due, nullptr);
+    } else {
+      runList<true>(l_due, l_profiler);
+    }
+    ++c_deltaCycles;
+    if (c_deltaHook != nullptr) {
+      c_deltaHook(c_deltaHookCtx);
+    }
+    if (c_nextDelta.c_head == nullptr) {
+      break;
+    }
+    l_due = c_nextDelta;
+    c_nextDelta = EventList();
+    ++c_delta;
+  }
+  c_inStep = false;
+  if (l_profiler != nullptr) {
+    l_profiler->recordStep(c_eventsExecuted - l_startEvents, c_delta + 1, l_startPending,
+                           readCycleCounter() - l_startCycles);
+  }
+  return true;
+}
+
+void ghls::Scheduler::run() {
+  c_stopped = false;
+  while (!c_stopped && step()) {
+  }
+}
+
+void ghls::Scheduler::runUntil(SimTime f_end) {
+  c_stopped = false;
+  while (!c_stopped) {
+    runStepHooks();
+    std::optional<SimTime> l_next = nextEventTime();
+    if (!l_next || f_end < *l_next) {
+      break;
+    }
+    runStep();
+  }
+  if (!c_stopped && c_now < f_end.ticks()) {
+    c_now = f_end.ticks();
+  }
+}
+
+std::optional<ghls::SimTime> ghls::Scheduler::nextEventTime() const {
+  if (c_nextDelta.c_head != nullptr) {
+    return SimTime::fromTicks(c_now);
+  }
+  unsigned l_pos = firstSetFrom(c_occupied[0], c_cursor & (kSlots - 1));
+  if (l_pos < kSlots) {
+    return SimTime::fromTicks((c_cursor & ~SimTick(kSlots - 1)) | l_pos);
+  }
+  for (unsigned l_level = 1; l_level < kLevels; ++l_level) {
+    unsigned l_cur = (c_cursor >> (l_level * kLevelBits)) & (kSlots - 1);
+    l_pos = firstSetFrom(c_occupied[l_level], l_cur + 1);
+    if (l_pos < kSlots) {
+      // Higher level slots are not sorted, so the earliest event is found by scanning
+      SimTick l_min = ~SimTick(0);
+      for (Event* l_event = c_wheel[l_level][l_pos].c_head; l_event != nullptr;
+           l_event = l_event->c_next) {
+        l_min = std::min(l_min, l_event->c_time);
+      }
+      return SimTime::fromTicks(l_min);
+    }
+  }
+  if (!c_heap.empty()) {
+    return SimTime::fromTicks(c_heap.front()->c_time);
+  }
+  return std::nullopt;
+}
+
+std::vector<ghls::Scheduler::PendingEvent> ghls::Scheduler::pendingEvents() const {
+  assert(!c_inStep && "pending events are only stable between timesteps");
+  std::vector<const Event*> l_events;
+  l_events.reserve(c_pending);
+  for (const auto& l_level : c_wheel) {
+    for (const EventList& l_slot : l_level) {
+      for (const Event* l_event = l_slot.c_head; l_event != nullptr; l_event = l_event->c_next) {
+        l_events.push_back(l_event);
+      }
+    }
+  }
+  l_events.insert(l_events.end(), c_heap.begin(), c_heap.end());
+  std::sort(l_events.begin(), l_events.end(),
+            [](const Event* f_lhs, const Event* f_rhs) { return LaterEvent()(f_rhs, f_lhs); });
+
+  std::vector<PendingEvent> l_pending;
+  l_pending.reserve(l_events.size());
+  for (const Event* l_event : l_events) {
+    l_pending.push_back({SimTime::fromTicks(l_event->c_time), l_event->c_fn, l_event->c_ctx,
+                         l_event->c_arg,
+                         l_event->c_payload ? reinterpret_cast<const void*>(l_event->c_arg)
+                                            : nullptr});
+  }
+  return l_pending;
+}
+
+void ghls::Scheduler::reset(SimTime f_now) {
+  assert(!c_inStep && "cannot reset the queue from inside a timestep");
+  auto l_release = [this](Event* f_event) {
+    if (f_event->c_payload) {
+      c_payloads.deallocate(reinterpret_cast<void*>(f_event->c_arg));
+    }
+    c_events.deallocate(f_event);
+  };
+  for (auto& l_level : c_wheel) {
+    for (EventList& l_slot : l_level) {
+      for (Event* l_event = l_slot.c_head; l_event != nullptr;) {
+        Event* l_next = l_event->c_next;
+        l_release(l_event);
+        l_event = l_next;
+      }
+      l_slot = EventList();
+    }
+  }
+  for (Event* l_event : c_heap) {
+    l_release(l_event);
+  }
+  c_heap.clear();
+  c_occupied = {};
+  c_pending = 0;
+  c_now = c_cursor = f_now.ticks();
+  c_delta = 0;
+}
+
+void ghls::Scheduler::enqueue(SimTick f_time, EventFn f_fn, void* f_ctx, uint64_t f_arg,
+                              bool f_payload) {
+  Event* l_event = static_cast<Event*>(c_events.allocate());
+  l_event->c_time = f_time;
+  l_event->c_seq = c_seq++;
+  l_event->c_fn = f_fn;
+  l_event->c_ctx = f_ctx;
+  l_event->c_arg = f_arg;
+  l_event->c_next = nullptr;
+  l_event->c_payload = f_payload;
+  ++c_pending;
+  // Inside a timestep, an event at the current time is the next delta cycle.
+  // Outside one, it simply fires when the current time is stepped.
+  if (c_inStep && f_time == c_now) {
+    append(c_nextDelta, l_event);
+  } else {
+    insert(l_event);
+  }
+}
+
+void ghls::Scheduler::insert(Event* f_event) {
+  if (((f_event->c_time ^ c_cursor) >> kWheelBits) != 0) {
+    c_heap.push_back(f_event);
+    std::push_heap(c_heap.begin(), c_heap.end(), LaterEvent());
+    return;
+  }
+  insertWheel(f_event);
+}
+
+void ghls::Scheduler::insertWheel(Event* f_event) noexcept {
+  // The highest byte in which the event time differs from the cursor picks the
+  // level. Wheel events differ from it in the low kWheelBits only.
+  uint64_t l_diff = static_cast<uint64_t>(f_event->c_time ^ c_cursor);
+  unsigned l_level = l_diff == 0 ? 0 : highestSetBit(l_diff) / kLevelBits;
+  unsigned l_slot = (f_event->c_time >> (l_level * kLevelBits)) & (kSlots - 1);
+  append(c_wheel[l_level][l_slot], f_event);
+  c_occupied[l_level][l_slot / 64] |= uint64_t(1) << (l_slot % 64);
+}
+
+void ghls::Scheduler::cascade(unsigned f_level, unsigned f_slot) noexcept {
+  EventList& l_slot = c_wheel[f_level][f_slot];
+  Event* l_event = l_slot.c_head;
+  l_slot = EventList();
+  c_occupied[f_level][f_slot / 64] &= ~(uint64_t(1) << (f_slot % 64));
+  while (l_event != nullptr) {
+    Event* l_next = l_event->c_next;
+    l_event->c_next = nullptr;
+    insertWheel(l_event);
+    l_event = l_next;
+  }
+}
+
+bool ghls::Scheduler::advance(EventList& f_due) {
+  for (;;) {
+    unsigned l_pos = firstSetFrom(c_occupied[0], c_cursor & (kSlots - 1));
+    if (l_pos < kSlots) {
+      c_cursor = (c_cursor & ~SimTick(kSlots - 1)) | l_pos;
+      c_now = c_cursor;
+      f_due = c_wheel[0][l_pos];
+      c_wheel[0][l_pos] = EventList();
+      c_occupied[0][l_pos / 64] &= ~(uint64_t(1) << (l_pos % 64));
+      return true;
+    }
+    bool l_cascaded = false;
+    for (unsigned l_level = 1; l_level < kLevels && !l_cascaded; ++l_level) {
+      unsigned l_shift = l_level * kLevelBits;
+      unsigned l_cur = (c_cursor >> l_shift) & (kSlots - 1);
+      l_pos = firstSetFrom(c_occupied[l_level], l_cur + 1);
+      if (l_pos < kSlots) {
+        // Lower levels are empty, so jump the cursor to the start of this slot
+        SimTick l_high = (c_cursor >> (l_shift + kLevelBits)) << (l_shift + kLevelBits);
+        c_cursor = l_high | (SimTick(l_pos) << l_shift);
+        cascade(l_level, l_pos);
+        l_cascaded = true;
+      }
+    }
+    if (l_cascaded) {
+      continue;
+    }
+    if (c_heap.empty()) {
+      return false;
+    }
+    // The wheel is drained, pull the next window of far-future events in
+    c_cursor = c_heap.front()->c_time;
+    while (!c_heap.empty() && ((c_heap.front()->c_time ^ c_cursor) >> kWheelBits) == 0) {
+      std::pop_heap(c_heap.begin(), c_heap.end(), LaterEvent());
+      Event* l_event = c_heap.back();
+      c_heap.pop_back();
+      insertWheel(l_event);
+    }
+  }
+}
+
+template <bool kProfile>
+void ghls::Scheduler::runList(EventList& f_list, Profiler* f_profiler) {
+  Event* l_event = f_list.c_head;
+  while (l_event != nullptr) {
+    Event* l_next = l_event->c_next;
+    EventFn l_fn = l_event->c_fn;
+    void* l_ctx = l_event->c_ctx;
+    uint64_t l_arg = l_event->c_arg;
+    bool l_payload = l_event->c_payload;
+    // Release the node first so a callback that reschedules reuses it while it is hot
+    c_events.deallocate(l_event);
+    --c_pending;
+    ++c_eventsExecuted;
+    if (kProfile) {
+      uint64_t l_start = readCycleCounter();
+      l_fn(l_ctx, l_arg);
+      f_profiler->recordEvent(l_fn, l_ctx, readCycleCounter() - l_start);
+    } else {
+      l_fn(l_ctx, l_arg);
+    }
+    if (l_payload) {
+      c_payloads.deallocate(reinterpret_cast<void*>(l_arg));
+    }
+    l_event = l_next;
+  }
+  f_list = EventList();
+}
+
+void ghls::Scheduler::append(EventList& f_list, Event* f_event) noexcept {
+  f_event->c_next = nullptr;
+  if (f_list.c_tail == nullptr) {
+    f_list.c_head = f_event;
+  } else {
+    f_list.c_tail->c_next = f_event;
+  }
+  f_list.c_tail = f_event;
+}
+
+unsigned ghls::Scheduler::firstSetFrom(const Bitmap& f_bits, unsigned f_from) noexcept {
+  for (unsigned l_word = f_from / 64; l_word < kBitmapWords; ++l_word) {
+    uint64_t l_bits = f_bits[l_word];
+    if (l_word == f_from / 64) {
+      l_bits &= ~uint64_t(0) << (f_from % 64);
+    }
+    if (l_bits != 0) {
+      return l_word * 64 + countTrailingZeros(l_bits);
+    }
+  }
+  return kSlots;
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "allocator.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+class Profiler;
+
+// Callback invoked when an event fires
+using EventFn = void (*)(void* f_ctx, uint64_t f_arg);
+// Callback invoked at the end of every delta cycle
+using DeltaHook = void (*)(void* f_ctx);
+// Callback invoked at every timestep boundary, before the next time is picked
+using StepHook = void (*)(void* f_ctx);
+
+// Discrete-event scheduler keyed on SimTime.
+// Near-future events live in a four level hierarchical timing wheel with 256
+// slots per level (covering 2^32 ticks ahead of the wheel cursor), events
+// further out wait in a binary heap until the wheel drains up to them.
+// Events at the same time fire in the order they were scheduled.
+class Scheduler {
+ public:
+  Scheduler();
+  ~Scheduler();
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  // Schedules f_fn to fire f_delay after now(). A zero delay from inside a
+  // running timestep fires in the next delta cycle of the same timestep.
+  void schedule(SimTime f_delay, EventFn f_fn, void* f_ctx = nullptr, uint64_t f_arg = 0);
+  // Schedules f_fn at absolute time f_time, which must not be before now()
+  void scheduleAt(SimTime f_time, EventFn f_fn, void* f_ctx = nullptr, uint64_t f_arg = 0);
+  // Schedules f_fn in the next delta cycle of the current timestep
+  void scheduleDelta(EventFn f_fn, void* f_ctx = nullptr, uint64_t f_arg = 0);
+
+  // Largest payload schedulePayload() accepts
+  static constexpr size_t kMaxPayload = 64;
+  // Schedules f_fn f_delay after now() together with f_size bytes of pooled
+  // payload storage that the caller fills through the returned pointer. f_fn
+  // receives the payload address as f_arg; the storage is recycled once f_fn
+  // returns.
+  void* schedulePayload(SimTime f_delay, EventFn f_fn, void* f_ctx, size_t f_size);
+
+  // Scratch memory valid until the current timestep ends, e.g. for payloads
+  // of delta events. It is reset in bulk when the next timestep starts.
+  Arena& stepArena() noexcept { return c_stepArena; }
+
+  void setDeltaHook(DeltaHook f_hook, void* f_ctx = nullptr) noexcept;
+  // Step hooks chain and run in the order added. They may schedule events,
+  // e.g. to feed in externally queued ones.
+  void addStepHook(StepHook f_hook, void* f_ctx = nullptr);
+  // Removes the hook added with the same function and context
+  void removeStepHook(StepHook f_hook, void* f_ctx = nullptr) noexcept;
+  // Profiler timing every callback while attached; null detaches. Takes
+  // effect from the next timestep.
+  void setProfiler(Profiler* f_profiler) noexcept { c_profiler = f_profiler; }
+  Profiler* profiler() const noexcept { return c_profiler; }
+
+  // Runs the next pending timestep including all of its delta cycles.
+  // Returns false when no events are pending.
+  bool step();
+  // Runs until no events are pending or stop() is called
+  void run();
+  // Runs every event at or before f_end, then advances now() to f_end
+  void runUntil(SimTime f_end);
+  // Makes run()/runUntil() return after the current timestep
+  void stop() noexcept { c_stopped = true; }
+
+  // Time of the earliest pending event, if any
+  std::optional<SimTime> nextEventTime() const;
+
+  // A queued event as seen by checkpointing. payload is null for plain
+  // events and points at the kMaxPayload bytes of storage otherwise.
+  struct PendingEvent {
+    SimTime time;
+    EventFn fn;
+    void* ctx;
+    uint64_t arg;
+    const void* payload;
+  };
+  // Every queued event in firing order. Must be called between timesteps.
+  std::vector<PendingEvent> pendingEvents() const;
+  // Drops every queued event and moves now() to f_now, e.g. before a
+  // checkpoint re-schedules its saved events. Statistics are kept.
+  void reset(SimTime f_now);
+
+  SimTime now() const noexcept { return SimTime::fromTicks(c_now); }
+  uint32_t delta() const noexcept { return c_delta; }
+  size_t pending() const noexcept { return c_pending; }
+  bool empty() const noexcept { return c_pending == 0; }
+
+  uint64_t eventsExecuted() const noexcept { return c_eventsExecuted; }
+  uint64_t deltaCycles() const noexcept { return c_deltaCycles; }
+  uint64_t timeSteps() const noexcept { return c_timeSteps; }
+
+ private:
+  struct Event {
+    SimTick c_time;
+    uint64_t c_seq;
+    EventFn c_fn;
+    void* c_ctx;
+    uint64_t c_arg;
+    Event* c_next;
+    // c_arg points to pooled payload storage
+    bool c_payload;
+  };
+  struct EventList {
+    Event* c_head = nullptr;
+    Event* c_tail = nullptr;
+  };
+
+  static constexpr unsigned kLevelBits = 8;
+  static constexpr unsigned kSlots = 1u << kLevelBits;
+  static constexpr unsigned kLevels = 4;
+  static constexpr unsigned kWheelBits = kLevelBits * kLevels;
+  static constexpr unsigned kBitmapWords = kSlots / 64;
+
+  using Bitmap = std::array<uint64_t, kBitmapWords>;
+
+  void enqueue(SimTick f_time, EventFn f_fn, void* f_ctx, uint64_t f_arg, bool f_payload);
+  void insert(Event* f_event);
+  void insertWheel(Event* f_event) noexcept;
+  void cascade(unsigned f_level, unsigned f_slot) noexcept;
+  bool advance(EventList& f_due);
+  void runStepHooks();
+  bool runStep();
+  template <bool kProfile>
+  void runList(EventList& f_list, Profiler* f_profiler);
+
+  static void append(EventList& f_list, Event* f_event) noexcept;
+  static unsigned firstSetFrom(const Bitmap& f_bits, unsigned f_from) noexcept;
+
+  std::array<std::array<EventList, kSlots>, kLevels> c_wheel;
+  std::array<Bitmap, kLevels> c_occupied;
+  std::vector<Event*> c_heap;
+  EventList c_nextDelta;
+
+  FixedPool c_events;
+  FixedPool c_payloads;
+  Arena c_stepArena;
+
+  SimTick c_now;
+  SimTick c_cursor;
+  uint64_t c_seq;
+  uint32_t c_delta;
+  size_t c_pending;
+  bool c_inStep;
+  bool c_stopped;
+
+  DeltaHook c_deltaHook;
+  void* c_deltaHookCtx;
+  std::vector<std::pair<StepHook, void*>> c_stepHooks;
+  Profiler* c_profiler;
+
+  uint64_t c_eventsExecuted;
+  uint64_t c_deltaCycles;
+  uint64_t c_timeSteps;
+};
+
+}  // namespace ghls
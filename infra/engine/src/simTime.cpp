@@ -1,117 +1,106 @@
 #include "simTime.hpp"
-#include <sstream>
-#include <cmath>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-namespace ghls {
-double round2(double value) {
-  return std::round(value * 100.0) / 100.0;
+void ghls::simTimeOverflow(const char* f_what) noexcept {
+  std::fprintf(stderr, "ghls: %s\n", f_what);
+  std::abort();
 }
-}
-
-ghls::SimTime::SimTime() : c_simTime(round2(0.0)), c_simUnits(SimTimeUnit::ns) {}
 
-ghls::SimTime::SimTime(double f_time, SimTimeUnit f_unit) {
-  f_time = round2(f_time);
-  switch (f_unit) {
-    case SimTimeUnit::s:
-      c_simTime = f_time * 1e9;
-      break;
-    case SimTimeUnit::ms:
-      c_simTime = f_time * 1e6;
-      break;
-    case SimTimeUnit::us:
-      c_simTime = f_time * 1e3;
-      break;
-    case SimTimeUnit::ns:
-      c_simTime = f_time;
-      break;
-    case SimTimeUnit::ps:
-      c_simTime = f_time / 1e3;
-      break;
-    default:
-      c_simTime = f_time;
-      break;
+char* ghls::formatTicks(char* f_first, char* f_last, SimTick f_ticks) noexcept {
+#if GHLS_WIDE_SIMTIME
+  // std::to_chars has no 128-bit overload in ISO mode, so digits are peeled
+  // off from the end
+  char l_digits[40];
+  char* l_pos = l_digits + sizeof(l_digits);
+  do {
+    *--l_pos = static_cast<char>('0' + static_cast<unsigned>(f_ticks % 10));
+    f_ticks /= 10;
+  } while (f_ticks != 0);
+  size_t l_size = l_digits + sizeof(l_digits) - l_pos;
+  if (f_last - f_first < static_cast<std::ptrdiff_t>(l_size)) {
+    return nullptr;
   }
-  c_simUnits = SimTimeUnit::ns;
-}
-
-std::pair<double, ghls::SimTimeUnit> ghls::SimTime::simTime() const noexcept {
-  return {c_simTime, c_simUnits};
-}
-
-ghls::SimTimeUnit ghls::SimTime::simTimeUnits() const noexcept {
-  return c_simUnits;
+  std::memcpy(f_first, l_pos, l_size);
+  return f_first + l_size;
+#else
+  std::to_chars_result l_res = std::to_chars(f_first, f_last, f_ticks);
+  return l_res.ec == std::errc() ? l_res.ptr : nullptr;
+#endif
 }
 
-double ghls::SimTime::simTimeInSec() const noexcept {
-  return c_simTime / 1e9;
-}
-
-double ghls::SimTime::simTimeInMsec() const noexcept {
-  return c_simTime / 1e6;
-}
-
-double ghls::SimTime::simTimeInUsec() const noexcept {
-  return c_simTime / 1e3;
-}
-
-double ghls::SimTime::simTimeInNsec() const noexcept {
-  return c_simTime;
+char* ghls::formatSimTime(char* f_first, char* f_last, SimTime f_time,
+                          SimTimeUnit f_unit) noexcept {
+  // Split into whole units and hundredths using integer math so the output
+  // is exact and rounds half away from zero
+  const SimTick l_perUnit = ticksPerUnit(f_unit);
+  SimTick l_whole = f_time.ticks() / l_perUnit;
+  SimTick l_hundredths = ((f_time.ticks() % l_perUnit) * 100 + l_perUnit / 2) / l_perUnit;
+  if (l_hundredths == 100) {
+    ++l_whole;
+    l_hundredths = 0;
+  }
+  char* l_out = formatTicks(f_first, f_last, l_whole);
+  if (l_out == nullptr) {
+    return nullptr;
+  }
+  const char* l_unit = simTimeUnitStr(f_unit);
+  size_t l_unitLen = l_unit[1] == '\0' ? 1 : 2;
+  if (f_last - l_out < static_cast<std::ptrdiff_t>(4 + l_unitLen)) {
+    return nullptr;
+  }
+  *l_out++ = '.';
+  *l_out++ = static_cast<char>('0' + l_hundredths / 10);
+  *l_out++ = static_cast<char>('0' + l_hundredths % 10);
+  *l_out++ = ' ';
+  for (size_t l_idx = 0; l_idx < l_unitLen; ++l_idx) {
+    *l_out++ = l_unit[l_idx];
+  }
+  return l_out;
 }
 
-double ghls::SimTime::simTimeInPsec() const noexcept {
-  return c_simTime * 1e3;
+char* ghls::formatSimTime(char* f_first, char* f_last, SimTime f_time) noexcept {
+  return formatSimTime(f_first, f_last, f_time, bestUnit(f_time));
 }
 
-ghls::SimTime ghls::SimTime::operator+(const SimTime& f_rhs) const
-{
-  SimTime result = *this;
-  result.c_simTime += f_rhs.c_simTime;
-  return result;
+void ghls::appendSimTime(std::string& f_out, SimTime f_time, SimTimeUnit f_unit) {
+  char l_buf[kSimTimeStrMax];
+  char* l_end = formatSimTime(l_buf, l_buf + sizeof(l_buf), f_time, f_unit);
+  f_out.append(l_buf, l_end);
 }
 
-ghls::SimTime ghls::SimTime::operator*(uint64_t f_cycle) const
-{
-  SimTime result = *this;
-  result.c_simTime *= static_cast<double>(f_cycle);
-  return result;
+std::string ghls::conv2str(SimTime f_time, SimTimeUnit f_unit) {
+  char l_buf[kSimTimeStrMax];
+  char* l_end = formatSimTime(l_buf, l_buf + sizeof(l_buf), f_time, f_unit);
+  return std::string(l_buf, l_end);
 }
 
-std::string ghls::conv2str(SimTime f_time, SimTimeUnit f_unit) {
-  auto l_timeValue = [] (SimTime f_time, SimTimeUnit f_unit) -> double {
-      switch (f_unit) {
-        case SimTimeUnit::s:
-          return f_time.simTimeInSec();
-        case SimTimeUnit::ms:
-          return f_time.simTimeInMsec();
-        case SimTimeUnit::us:
-          return f_time.simTimeInUsec();
-        case SimTimeUnit::ns:
-          return f_time.simTimeInNsec();
-        case SimTimeUnit::ps:
-          return f_time.simTimeInPsec();
-        default:
-          return f_time.simTimeInNsec();
-      }
-  };
-  auto l_unitStr = [](SimTimeUnit l_unit) -> std::string {
-    switch (l_unit) {
-      case SimTimeUnit::s:
-        return "s";
-      case SimTimeUnit::ms:
-        return "ms";
-      case SimTimeUnit::us:
-        return "us";
-      case SimTimeUnit::ns:
-        return "ns";
-      case SimTimeUnit::ps:
-        return "ps";
-      default:
-        return "unknown";
+std::optional<ghls::SimTime> ghls::parseSimTime(const std::string& f_text) {
+  static constexpr struct {
+    const char* name;
+    int exponent;
+  } kUnits[] = {{"fs", 0}, {"ps", 3}, {"ns", 6}, {"us", 9}, {"ms", 12}, {"s", 15}};
+  size_t l_end = f_text.find_last_not_of(" \t");
+  if (l_end == std::string::npos) {
+    return std::nullopt;
+  }
+  std::string l_text = f_text.substr(0, l_end + 1);
+  for (const auto& l_unit : kUnits) {
+    size_t l_size = std::strlen(l_unit.name);
+    if (l_text.size() <= l_size ||
+        l_text.compare(l_text.size() - l_size, l_size, l_unit.name) != 0) {
+      continue;
     }
-  };
-  std::ostringstream l_stream;
-  l_stream.precision(2);
-  l_stream << std::fixed << round2(l_timeValue(f_time, f_unit));
-  return l_stream.str() + " " + l_unitStr(f_unit);
+    std::string l_number = l_text.substr(0, l_text.size() - l_size);
+    l_number.erase(l_number.find_last_not_of(" \t") + 1);
+    l_number.erase(0, l_number.find_first_not_of(" \t"));
+    detail::LiteralTicks l_parsed = detail::parseLiteralTicks(l_number.c_str(), l_unit.exponent);
+    if (!l_parsed.valid || l_parsed.overflow) {
+      return std::nullopt;
+    }
+    return SimTime::fromTicks(l_parsed.ticks);
+  }
+  return std::nullopt;
 }
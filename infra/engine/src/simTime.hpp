@@ -1,5 +1,8 @@
-
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <utility>
 #include <string>
 
@@ -9,26 +12,418 @@ namespace ghls {
 // seconds, milliseconds, microseconds, nanoseconds, picoseconds
 enum class SimTimeUnit { s, ms, us, ns, ps };
 
+// Build-time time configuration, normally set through the CMake options of
+// the same name. Both default to off so the common case stays a plain 64-bit
+// add.
+//   GHLS_WIDE_SIMTIME     128-bit ticks (GCC/Clang) for runs longer than the
+//                         ~5 hours 64-bit femtosecond ticks can hold
+//   GHLS_CHECKED_SIMTIME  SimTime arithmetic reports overflow instead of
+//                         silently wrapping
+#ifndef GHLS_WIDE_SIMTIME
+#define GHLS_WIDE_SIMTIME 0
+#endif
+#ifndef GHLS_CHECKED_SIMTIME
+#define GHLS_CHECKED_SIMTIME 0
+#endif
+
+// Simulation time is kept as an integer count of femtosecond ticks so that
+// repeated additions stay exact and arithmetic folds at compile time.
+#if GHLS_WIDE_SIMTIME
+#if !defined(__SIZEOF_INT128__)
+#error "GHLS_WIDE_SIMTIME needs a compiler providing unsigned __int128"
+#endif
+__extension__ typedef unsigned __int128 SimTick;
+#else
+using SimTick = uint64_t;
+#endif
+
+// Latest representable time in ticks
+constexpr SimTick kMaxSimTick = ~SimTick(0);
+
+// Prints f_what and aborts. Called by checked builds when a time computation
+// leaves [0, kMaxSimTick].
+[[noreturn]] void simTimeOverflow(const char* f_what) noexcept;
+
+namespace detail {
+
+// Tick arithmetic shared by SimTime and the scheduler, checked when
+// GHLS_CHECKED_SIMTIME is set. An overflow during constant evaluation is a
+// compile error since simTimeOverflow() is not constexpr.
+constexpr SimTick addTicks(SimTick f_lhs, SimTick f_rhs) noexcept {
+#if GHLS_CHECKED_SIMTIME
+  if (kMaxSimTick - f_lhs < f_rhs) {
+    simTimeOverflow("SimTime addition overflows");
+  }
+#endif
+  return f_lhs + f_rhs;
+}
+
+constexpr SimTick subTicks(SimTick f_lhs, SimTick f_rhs) noexcept {
+#if GHLS_CHECKED_SIMTIME
+  if (f_lhs < f_rhs) {
+    simTimeOverflow("SimTime subtraction is negative");
+  }
+#endif
+  return f_lhs - f_rhs;
+}
+
+constexpr SimTick mulTicks(SimTick f_ticks, uint64_t f_cycle) noexcept {
+#if GHLS_CHECKED_SIMTIME
+  if (f_cycle != 0 && f_ticks > kMaxSimTick / f_cycle) {
+    simTimeOverflow("SimTime multiplication overflows");
+  }
+#endif
+  return f_ticks * f_cycle;
+}
+
+}  // namespace detail
+
+// Number of femtosecond ticks in one f_unit
+constexpr SimTick ticksPerUnit(SimTimeUnit f_unit) noexcept {
+  switch (f_unit) {
+    case SimTimeUnit::s:
+      return 1000000000000000ULL;
+    case SimTimeUnit::ms:
+      return 1000000000000ULL;
+    case SimTimeUnit::us:
+      return 1000000000ULL;
+    case SimTimeUnit::ns:
+      return 1000000ULL;
+    case SimTimeUnit::ps:
+      return 1000ULL;
+    default:
+      return 1000000ULL;
+  }
+}
+
+constexpr const char* simTimeUnitStr(SimTimeUnit f_unit) noexcept {
+  switch (f_unit) {
+    case SimTimeUnit::s:
+      return "s";
+    case SimTimeUnit::ms:
+      return "ms";
+    case SimTimeUnit::us:
+      return "us";
+    case SimTimeUnit::ns:
+      return "ns";
+    case SimTimeUnit::ps:
+      return "ps";
+    default:
+      return "ns";
+  }
+}
+
 class SimTime {
  public:
-  SimTime();
-  SimTime(double f_time, SimTimeUnit f_unit);
-
-  SimTime operator+(const SimTime& f_rhs) const;
-  SimTime operator*(uint64_t f_cycle) const;
-
-  std::pair<double, SimTimeUnit> simTime() const noexcept;
-  SimTimeUnit simTimeUnits() const noexcept;
-  double simTimeInSec() const noexcept;
-  double simTimeInMsec() const noexcept;
-  double simTimeInUsec() const noexcept;
-  double simTimeInNsec() const noexcept;
-  double simTimeInPsec() const noexcept;
+  constexpr SimTime() noexcept : c_ticks(0) {}
+  // Rounds f_time to the nearest femtosecond. Negative and NaN times clamp to
+  // zero; times past the last tick saturate to it (or abort when checked).
+  constexpr SimTime(double f_time, SimTimeUnit f_unit) noexcept
+      : c_ticks(toTicks(f_time, f_unit)) {}
+
+  static constexpr SimTime fromTicks(SimTick f_ticks) noexcept {
+    SimTime l_time;
+    l_time.c_ticks = f_ticks;
+    return l_time;
+  }
+
+  constexpr SimTime operator+(const SimTime& f_rhs) const noexcept {
+    return fromTicks(detail::addTicks(c_ticks, f_rhs.c_ticks));
+  }
+  // f_rhs must not be later than *this
+  constexpr SimTime operator-(const SimTime& f_rhs) const noexcept {
+    return fromTicks(detail::subTicks(c_ticks, f_rhs.c_ticks));
+  }
+  constexpr SimTime operator*(uint64_t f_cycle) const noexcept {
+    return fromTicks(detail::mulTicks(c_ticks, f_cycle));
+  }
+  constexpr SimTime& operator+=(const SimTime& f_rhs) noexcept {
+    c_ticks = detail::addTicks(c_ticks, f_rhs.c_ticks);
+    return *this;
+  }
+  constexpr SimTime& operator-=(const SimTime& f_rhs) noexcept {
+    c_ticks = detail::subTicks(c_ticks, f_rhs.c_ticks);
+    return *this;
+  }
+
+  constexpr bool operator==(const SimTime& f_rhs) const noexcept {
+    return c_ticks == f_rhs.c_ticks;
+  }
+  constexpr bool operator!=(const SimTime& f_rhs) const noexcept {
+    return c_ticks != f_rhs.c_ticks;
+  }
+  constexpr bool operator<(const SimTime& f_rhs) const noexcept {
+    return c_ticks < f_rhs.c_ticks;
+  }
+  constexpr bool operator<=(const SimTime& f_rhs) const noexcept {
+    return c_ticks <= f_rhs.c_ticks;
+  }
+  constexpr bool operator>(const SimTime& f_rhs) const noexcept {
+    return c_ticks > f_rhs.c_ticks;
+  }
+  constexpr bool operator>=(const SimTime& f_rhs) const noexcept {
+    return c_ticks >= f_rhs.c_ticks;
+  }
+
+  constexpr SimTick ticks() const noexcept { return c_ticks; }
+
+  constexpr std::pair<double, SimTimeUnit> simTime() const noexcept {
+    return {simTimeInNsec(), SimTimeUnit::ns};
+  }
+  constexpr SimTimeUnit simTimeUnits() const noexcept { return SimTimeUnit::ns; }
+  constexpr double simTimeInSec() const noexcept { return static_cast<double>(c_ticks) / 1e15; }
+  constexpr double simTimeInMsec() const noexcept { return static_cast<double>(c_ticks) / 1e12; }
+  constexpr double simTimeInUsec() const noexcept { return static_cast<double>(c_ticks) / 1e9; }
+  constexpr double simTimeInNsec() const noexcept { return static_cast<double>(c_ticks) / 1e6; }
+  constexpr double simTimeInPsec() const noexcept { return static_cast<double>(c_ticks) / 1e3; }
  private:
-  double c_simTime;
-  SimTimeUnit c_simUnits;
+  static constexpr SimTick toTicks(double f_time, SimTimeUnit f_unit) noexcept {
+    double l_ticks = f_time * static_cast<double>(ticksPerUnit(f_unit));
+    // Also catches NaN, which no conversion below is defined for
+    if (!(l_ticks > 0.0)) {
+      return 0;
+    }
+    // kMaxSimTick rounds up to the next power of two as a double
+    if (l_ticks + 0.5 >= static_cast<double>(kMaxSimTick)) {
+#if GHLS_CHECKED_SIMTIME
+      simTimeOverflow("SimTime construction overflows");
+#endif
+      return kMaxSimTick;
+    }
+    return static_cast<SimTick>(l_ticks + 0.5);
+  }
+
+  SimTick c_ticks;
+};
+
+constexpr SimTime min(SimTime f_lhs, SimTime f_rhs) noexcept {
+  return f_rhs < f_lhs ? f_rhs : f_lhs;
+}
+
+constexpr SimTime max(SimTime f_lhs, SimTime f_rhs) noexcept {
+  return f_lhs < f_rhs ? f_rhs : f_lhs;
+}
+
+// SimTime whose tick count is part of the type. It is a compile-time constant
+// wherever it appears and converts to SimTime without any runtime work, so
+// delays built from it fold into immediates.
+template <SimTick kTicks>
+struct StaticSimTime {
+  static constexpr SimTick kValue = kTicks;
+
+  static constexpr SimTick ticks() noexcept { return kTicks; }
+  constexpr operator SimTime() const noexcept { return SimTime::fromTicks(kTicks); }
+};
+
+template <SimTick kLhs, SimTick kRhs>
+constexpr StaticSimTime<kLhs + kRhs> operator+(StaticSimTime<kLhs>, StaticSimTime<kRhs>) noexcept {
+  static_assert(kLhs + kRhs >= kLhs, "static time sum overflows the tick range");
+  return {};
+}
+template <SimTick kLhs, SimTick kRhs>
+constexpr StaticSimTime<kLhs - kRhs> operator-(StaticSimTime<kLhs>, StaticSimTime<kRhs>) noexcept {
+  static_assert(kLhs >= kRhs, "static time difference is negative");
+  return {};
+}
+template <SimTick kTicks>
+constexpr SimTime operator+(StaticSimTime<kTicks>, SimTime f_rhs) noexcept {
+  return SimTime::fromTicks(kTicks) + f_rhs;
+}
+template <SimTick kTicks>
+constexpr SimTime operator-(StaticSimTime<kTicks>, SimTime f_rhs) noexcept {
+  return SimTime::fromTicks(kTicks) - f_rhs;
+}
+template <SimTick kTicks>
+constexpr SimTime operator*(StaticSimTime<kTicks>, uint64_t f_cycle) noexcept {
+  return SimTime::fromTicks(kTicks) * f_cycle;
+}
+
+namespace detail {
+
+struct LiteralTicks {
+  SimTick ticks;
+  bool valid;
+  bool overflow;
 };
 
+// Parses the characters of a decimal integer or floating literal (digit
+// separators and an exponent allowed) counting units of 10^f_unitExp ticks.
+// Exact for every digit that fits SimTick, rounds half up to whole ticks.
+// Hexadecimal, binary and octal spellings are rejected.
+constexpr LiteralTicks parseLiteralTicks(const char* f_chars, int f_unitExp) noexcept {
+  const LiteralTicks l_invalid{0, false, false};
+  const SimTick l_max = kMaxSimTick;
+  SimTick l_mantissa = 0;
+  int l_scale = f_unitExp;
+  bool l_point = false;
+  bool l_digits = false;
+  size_t l_pos = 0;
+  for (; f_chars[l_pos] != '\0' && f_chars[l_pos] != 'e' && f_chars[l_pos] != 'E'; ++l_pos) {
+    char l_char = f_chars[l_pos];
+    if (l_char == '\'') {
+      continue;
+    }
+    if (l_char == '.') {
+      if (l_point) {
+        return l_invalid;
+      }
+      l_point = true;
+      continue;
+    }
+    if (l_char < '0' || l_char > '9') {
+      return l_invalid;
+    }
+    l_digits = true;
+    SimTick l_digit = static_cast<SimTick>(l_char - '0');
+    if (l_mantissa < l_max / 10 || (l_mantissa == l_max / 10 && l_digit <= l_max % 10)) {
+      l_mantissa = l_mantissa * 10 + l_digit;
+      l_scale -= l_point ? 1 : 0;
+    } else if (!l_point) {
+      // Digits past 64-bit precision only scale the value
+      ++l_scale;
+    }
+  }
+  bool l_exponent = f_chars[l_pos] != '\0';
+  if (!l_digits || (f_chars[0] == '0' && f_chars[1] >= '0' && f_chars[1] <= '9' && !l_point &&
+                    !l_exponent)) {
+    return l_invalid;
+  }
+  if (l_exponent) {
+    ++l_pos;
+    int l_sign = 1;
+    if (f_chars[l_pos] == '+' || f_chars[l_pos] == '-') {
+      l_sign = f_chars[l_pos++] == '-' ? -1 : 1;
+    }
+    int l_exp = 0;
+    if (f_chars[l_pos] == '\0') {
+      return l_invalid;
+    }
+    for (; f_chars[l_pos] != '\0'; ++l_pos) {
+      if (f_chars[l_pos] < '0' || f_chars[l_pos] > '9') {
+        return l_invalid;
+      }
+      l_exp = l_exp < 1000 ? l_exp * 10 + (f_chars[l_pos] - '0') : l_exp;
+    }
+    l_scale += l_sign * l_exp;
+  }
+  if (l_mantissa == 0) {
+    return {0, true, false};
+  }
+  for (; l_scale > 0; --l_scale) {
+    if (l_mantissa > l_max / 10) {
+      return {0, true, true};
+    }
+    l_mantissa *= 10;
+  }
+  if (l_scale < 0) {
+    if (l_scale < -40) {
+      return {0, true, false};
+    }
+    for (; l_scale < -1; ++l_scale) {
+      l_mantissa /= 10;
+    }
+    l_mantissa = l_mantissa / 10 + (l_mantissa % 10 >= 5 ? 1 : 0);
+  }
+  return {l_mantissa, true, false};
+}
+
+template <char... kChars>
+struct LiteralChars {
+  static constexpr char kValue[] = {kChars..., '\0'};
+};
+
+template <int kUnitExp, char... kChars>
+constexpr auto staticTimeLiteral() noexcept {
+  constexpr LiteralTicks l_parsed = parseLiteralTicks(LiteralChars<kChars...>::kValue, kUnitExp);
+  static_assert(l_parsed.valid, "time literals take decimal digits, a point and an exponent");
+  static_assert(!l_parsed.overflow, "time literal does not fit the femtosecond tick range");
+  return StaticSimTime<l_parsed.ticks>();
+}
+
+}  // namespace detail
+
+// Time literals resolved entirely at compile time, e.g. 1.25_ns or 10_ps.
+// Each yields a StaticSimTime; decimal values convert exactly.
+inline namespace literals {
+
+template <char... kChars>
+constexpr auto operator"" _s() noexcept {
+  return detail::staticTimeLiteral<15, kChars...>();
+}
+template <char... kChars>
+constexpr auto operator"" _ms() noexcept {
+  return detail::staticTimeLiteral<12, kChars...>();
+}
+template <char... kChars>
+constexpr auto operator"" _us() noexcept {
+  return detail::staticTimeLiteral<9, kChars...>();
+}
+template <char... kChars>
+constexpr auto operator"" _ns() noexcept {
+  return detail::staticTimeLiteral<6, kChars...>();
+}
+template <char... kChars>
+constexpr auto operator"" _ps() noexcept {
+  return detail::staticTimeLiteral<3, kChars...>();
+}
+template <char... kChars>
+constexpr auto operator"" _fs() noexcept {
+  return detail::staticTimeLiteral<0, kChars...>();
+}
+
+}  // namespace literals
+
+// Largest unit in which f_time is at least one, e.g. us for 1500 ns.
+// Zero is reported in ns.
+constexpr SimTimeUnit bestUnit(SimTime f_time) noexcept {
+  if (f_time.ticks() == 0) {
+    return SimTimeUnit::ns;
+  }
+  for (SimTimeUnit l_unit : {SimTimeUnit::s, SimTimeUnit::ms, SimTimeUnit::us, SimTimeUnit::ns}) {
+    if (f_time.ticks() >= ticksPerUnit(l_unit)) {
+      return l_unit;
+    }
+  }
+  return SimTimeUnit::ps;
+}
+
+// Longest string formatSimTime can produce, large enough for any tick count in ps
+constexpr size_t kSimTimeStrMax = GHLS_WIDE_SIMTIME ? 48 : 32;
+
+// Writes the decimal tick count into [f_first, f_last). Returns one past the
+// last digit, or nullptr if the buffer is too small.
+char* formatTicks(char* f_first, char* f_last, SimTick f_ticks) noexcept;
+
+// Writes f_time as "<value> <unit>" with two decimals into [f_first, f_last)
+// without allocating or touching the locale. Returns one past the last
+// character written, or nullptr if the buffer is too small.
+char* formatSimTime(char* f_first, char* f_last, SimTime f_time, SimTimeUnit f_unit) noexcept;
+// Same as above using bestUnit(f_time)
+char* formatSimTime(char* f_first, char* f_last, SimTime f_time) noexcept;
+// Appends the formatted time to f_out, reusing its capacity
+void appendSimTime(std::string& f_out, SimTime f_time, SimTimeUnit f_unit = SimTimeUnit::ns);
+
 std::string conv2str(SimTime f_time, SimTimeUnit f_unit = SimTimeUnit::ns);
 
+// Parses a run-time spelling such as "100us", "1.5 ns" or "2e3ps": a number
+// as accepted by the time literals, optional blanks and one of the units s,
+// ms, us, ns, ps or fs. nullopt if it is malformed or out of the tick range.
+std::optional<SimTime> parseSimTime(const std::string& f_text);
+
 }  // namespace ghls
+
+namespace std {
+
+template <>
+struct hash<ghls::SimTime> {
+  size_t operator()(const ghls::SimTime& f_time) const noexcept {
+#if GHLS_WIDE_SIMTIME
+    return hash<uint64_t>()(static_cast<uint64_t>(f_time.ticks()) ^
+                            static_cast<uint64_t>(f_time.ticks() >> 64));
+#else
+    return hash<ghls::SimTick>()(f_time.ticks());
+#endif
+  }
+};
+
+}  // namespace std
@@ -0,0 +1,223 @@
+#include "simTimeBatch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+// The AVX2 kernels work on 64-bit lanes, wide tick builds stay scalar
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !GHLS_WIDE_SIMTIME
+#define GHLS_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(ghls::SimTime) == sizeof(ghls::SimTick) &&
+                  std::is_standard_layout<ghls::SimTime>::value &&
+                  std::is_trivially_copyable<ghls::SimTime>::value,
+              "SimTime arrays are processed as packed tick arrays");
+
+namespace {
+
+std::atomic<ghls::SimdLevel> g_simdLevel{ghls::detectedSimdLevel()};
+
+void convertScalar(const ghls::SimTick* f_src, size_t f_count, double f_perUnit,
+                   double* f_dst) noexcept {
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    f_dst[l_idx] = static_cast<double>(f_src[l_idx]) / f_perUnit;
+  }
+}
+
+void addOffsetScalar(ghls::SimTick* f_data, size_t f_count, ghls::SimTick f_offset) noexcept {
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    f_data[l_idx] += f_offset;
+  }
+}
+
+void scaleScalar(const uint64_t* f_cycles, size_t f_count, ghls::SimTick f_period,
+                 ghls::SimTick* f_dst) noexcept {
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    f_dst[l_idx] = f_period * f_cycles[l_idx];
+  }
+}
+
+std::pair<ghls::SimTick, ghls::SimTick> minMaxScalar(const ghls::SimTick* f_src, size_t f_count,
+                                                     ghls::SimTick f_min,
+                                                     ghls::SimTick f_max) noexcept {
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    ghls::SimTick l_ticks = f_src[l_idx];
+    f_min = std::min(f_min, l_ticks);
+    f_max = std::max(f_max, l_ticks);
+  }
+  return {f_min, f_max};
+}
+
+#if defined(GHLS_BATCH_AVX2)
+
+// Exact uint64 -> double: the high and low 32-bit halves are spliced into the
+// mantissas of 2^84 and 2^52, so one subtract and one add give the correctly
+// rounded result
+__attribute__((target("avx2"))) void convertAvx2(const ghls::SimTick* f_src, size_t f_count,
+                                                 double f_perUnit, double* f_dst) noexcept {
+  const __m256i l_magicLo = _mm256_set1_epi64x(0x4330000000000000LL);
+  const __m256i l_magicHi = _mm256_set1_epi64x(0x4530000000000000LL);
+  const __m256d l_magicAll = _mm256_set1_pd(19342813118337666422669312.0);
+  const __m256d l_perUnit = _mm256_set1_pd(f_perUnit);
+  size_t l_idx = 0;
+  for (; l_idx + 4 <= f_count; l_idx += 4) {
+    __m256i l_ticks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f_src + l_idx));
+    __m256i l_lo = _mm256_blend_epi32(l_magicLo, l_ticks, 0x55);
+    __m256i l_hi = _mm256_xor_si256(_mm256_srli_epi64(l_ticks, 32), l_magicHi);
+    __m256d l_value = _mm256_add_pd(
+        _mm256_sub_pd(_mm256_castsi256_pd(l_hi), l_magicAll), _mm256_castsi256_pd(l_lo));
+    _mm256_storeu_pd(f_dst + l_idx, _mm256_div_pd(l_value, l_perUnit));
+  }
+  convertScalar(f_src + l_idx, f_count - l_idx, f_perUnit, f_dst + l_idx);
+}
+
+__attribute__((target("avx2"))) void addOffsetAvx2(ghls::SimTick* f_data, size_t f_count,
+                                                   ghls::SimTick f_offset) noexcept {
+  const __m256i l_offset = _mm256_set1_epi64x(static_cast<long long>(f_offset));
+  size_t l_idx = 0;
+  for (; l_idx + 4 <= f_count; l_idx += 4) {
+    __m256i* l_ptr = reinterpret_cast<__m256i*>(f_data + l_idx);
+    _mm256_storeu_si256(l_ptr, _mm256_add_epi64(_mm256_loadu_si256(l_ptr), l_offset));
+  }
+  addOffsetScalar(f_data + l_idx, f_count - l_idx, f_offset);
+}
+
+// 64x64 -> low 64 bit multiply from three 32x32 -> 64 partial products
+__attribute__((target("avx2"))) void scaleAvx2(const uint64_t* f_cycles, size_t f_count,
+                                               ghls::SimTick f_period,
+                                               ghls::SimTick* f_dst) noexcept {
+  const __m256i l_period = _mm256_set1_epi64x(static_cast<long long>(f_period));
+  const __m256i l_periodHi = _mm256_srli_epi64(l_period, 32);
+  size_t l_idx = 0;
+  for (; l_idx + 4 <= f_count; l_idx += 4) {
+    __m256i l_cycles = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f_cycles + l_idx));
+    __m256i l_cyclesHi = _mm256_srli_epi64(l_cycles, 32);
+    __m256i l_cross = _mm256_add_epi64(_mm256_mul_epu32(l_cycles, l_periodHi),
+                                       _mm256_mul_epu32(l_cyclesHi, l_period));
+    __m256i l_result =
+        _mm256_add_epi64(_mm256_mul_epu32(l_cycles, l_period), _mm256_slli_epi64(l_cross, 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(f_dst + l_idx), l_result);
+  }
+  scaleScalar(f_cycles + l_idx, f_count - l_idx, f_period, f_dst + l_idx);
+}
+
+// AVX2 only has a signed 64-bit compare, flipping the sign bit maps unsigned order onto it
+__attribute__((target("avx2"))) std::pair<ghls::SimTick, ghls::SimTick> minMaxAvx2(
+    const ghls::SimTick* f_src, size_t f_count) noexcept {
+  const __m256i l_sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+  __m256i l_min = _mm256_set1_epi64x(0x7fffffffffffffffLL);
+  __m256i l_max = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+  size_t l_idx = 0;
+  for (; l_idx + 4 <= f_count; l_idx += 4) {
+    __m256i l_value = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f_src + l_idx)), l_sign);
+    l_min = _mm256_blendv_epi8(l_min, l_value, _mm256_cmpgt_epi64(l_min, l_value));
+    l_max = _mm256_blendv_epi8(l_max, l_value, _mm256_cmpgt_epi64(l_value, l_max));
+  }
+  alignas(32) ghls::SimTick l_mins[4];
+  alignas(32) ghls::SimTick l_maxs[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(l_mins), _mm256_xor_si256(l_min, l_sign));
+  _mm256_store_si256(reinterpret_cast<__m256i*>(l_maxs), _mm256_xor_si256(l_max, l_sign));
+  ghls::SimTick l_lo = std::min(std::min(l_mins[0], l_mins[1]), std::min(l_mins[2], l_mins[3]));
+  ghls::SimTick l_hi = std::max(std::max(l_maxs[0], l_maxs[1]), std::max(l_maxs[2], l_maxs[3]));
+  return minMaxScalar(f_src + l_idx, f_count - l_idx, l_lo, l_hi);
+}
+
+bool useAvx2() noexcept {
+  return g_simdLevel.load(std::memory_order_relaxed) == ghls::SimdLevel::avx2;
+}
+
+#endif
+
+// The kernels see SimTime arrays as packed ticks; the layout is checked above
+const ghls::SimTick* asTicks(const ghls::SimTime* f_src) noexcept {
+  return reinterpret_cast<const ghls::SimTick*>(f_src);
+}
+
+ghls::SimTick* asTicks(ghls::SimTime* f_src) noexcept {
+  return reinterpret_cast<ghls::SimTick*>(f_src);
+}
+
+}  // namespace
+
+ghls::SimdLevel ghls::detectedSimdLevel() noexcept {
+#if defined(GHLS_BATCH_AVX2)
+  // May run during static initialization, before the runtime has probed the CPU
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::avx2;
+  }
+#endif
+  return SimdLevel::scalar;
+}
+
+ghls::SimdLevel ghls::activeSimdLevel() noexcept {
+  return g_simdLevel.load(std::memory_order_relaxed);
+}
+
+void ghls::setSimdLevel(SimdLevel f_level) noexcept {
+  if (f_level == SimdLevel::avx2 && detectedSimdLevel() != SimdLevel::avx2) {
+    f_level = SimdLevel::scalar;
+  }
+  g_simdLevel.store(f_level, std::memory_order_relaxed);
+}
+
+void ghls::convertTimes(const SimTime* f_src, size_t f_count, SimTimeUnit f_unit,
+                        double* f_dst) noexcept {
+  convertTicks(asTicks(f_src), f_count, f_unit, f_dst);
+}
+
+void ghls::convertTicks(const SimTick* f_src, size_t f_count, SimTimeUnit f_unit,
+                        double* f_dst) noexcept {
+  const double l_perUnit = static_cast<double>(ticksPerUnit(f_unit));
+#if defined(GHLS_BATCH_AVX2)
+  if (useAvx2()) {
+    convertAvx2(f_src, f_count, l_perUnit, f_dst);
+    return;
+  }
+#endif
+  convertScalar(f_src, f_count, l_perUnit, f_dst);
+}
+
+void ghls::addOffset(SimTime* f_data, size_t f_count, SimTime f_offset) noexcept {
+  addOffset(asTicks(f_data), f_count, f_offset.ticks());
+}
+
+void ghls::addOffset(SimTick* f_data, size_t f_count, SimTick f_offset) noexcept {
+#if defined(GHLS_BATCH_AVX2)
+  if (useAvx2()) {
+    addOffsetAvx2(f_data, f_count, f_offset);
+    return;
+  }
+#endif
+  addOffsetScalar(f_data, f_count, f_offset);
+}
+
+void ghls::scaleCycles(const uint64_t* f_cycles, size_t f_count, SimTime f_period,
+                       SimTime* f_dst) noexcept {
+#if defined(GHLS_BATCH_AVX2)
+  if (useAvx2()) {
+    scaleAvx2(f_cycles, f_count, f_period.ticks(), asTicks(f_dst));
+    return;
+  }
+#endif
+  scaleScalar(f_cycles, f_count, f_period.ticks(), asTicks(f_dst));
+}
+
+std::pair<ghls::SimTime, ghls::SimTime> ghls::minMaxTimes(const SimTime* f_src,
+                                                          size_t f_count) noexcept {
+  std::pair<SimTick, SimTick> l_range = minMaxTicks(asTicks(f_src), f_count);
+  return {SimTime::fromTicks(l_range.first), SimTime::fromTicks(l_range.second)};
+}
+
+std::pair<ghls::SimTick, ghls::SimTick> ghls::minMaxTicks(const SimTick* f_src,
+                                                          size_t f_count) noexcept {
+#if defined(GHLS_BATCH_AVX2)
+  if (useAvx2()) {
+    return minMaxAvx2(f_src, f_count);
+  }
+#endif
+  return minMaxScalar(f_src, f_count, ~SimTick(0), SimTick(0));
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "simTime.hpp"
+
+namespace ghls {
+
+// Bulk SimTime kernels over contiguous arrays. Each call dispatches once to an
+// AVX2 implementation when the CPU supports it and otherwise to a scalar loop
+// written so the compiler can vectorize it for the baseline instruction set.
+// Results are identical on every path.
+
+enum class SimdLevel { scalar, avx2 };
+
+// Best level supported by this CPU
+SimdLevel detectedSimdLevel() noexcept;
+// Level the kernels currently dispatch to
+SimdLevel activeSimdLevel() noexcept;
+// Restricts dispatch to f_level, clamped to what the CPU supports
+void setSimdLevel(SimdLevel f_level) noexcept;
+
+// f_dst[i] = f_src[i] expressed in f_unit, matching SimTime::simTimeIn*()
+void convertTimes(const SimTime* f_src, size_t f_count, SimTimeUnit f_unit, double* f_dst) noexcept;
+void convertTicks(const SimTick* f_src, size_t f_count, SimTimeUnit f_unit, double* f_dst) noexcept;
+
+// f_data[i] += f_offset
+void addOffset(SimTime* f_data, size_t f_count, SimTime f_offset) noexcept;
+void addOffset(SimTick* f_data, size_t f_count, SimTick f_offset) noexcept;
+
+// f_dst[i] = f_period * f_cycles[i]
+void scaleCycles(const uint64_t* f_cycles, size_t f_count, SimTime f_period,
+                 SimTime* f_dst) noexcept;
+
+// Earliest and latest time in the array. An empty array yields
+// {SimTime::fromTicks(kMaxSimTick), SimTime()}.
+std::pair<SimTime, SimTime> minMaxTimes(const SimTime* f_src, size_t f_count) noexcept;
+std::pair<SimTick, SimTick> minMaxTicks(const SimTick* f_src, size_t f_count) noexcept;
+
+}  // namespace ghls
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace ghls {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Head and tail sit on separate cache lines and each side keeps a
+// cached copy of the other's index, so the shared lines are only touched
+// when the ring looks full (producer) or empty (consumer).
+template <typename T>
+class SpscRing {
+  static_assert(std::is_trivially_copyable<T>::value, "ring slots are copied as plain data");
+
+ public:
+  // Capacity is rounded up to a power of two
+  explicit SpscRing(size_t f_capacity = 1024) {
+    size_t l_capacity = 2;
+    while (l_capacity < f_capacity) {
+      l_capacity *= 2;
+    }
+    c_mask = l_capacity - 1;
+    c_slots.reset(new T[l_capacity]);
+  }
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  size_t capacity() const noexcept { return c_mask + 1; }
+
+  // Producer side. Returns false if the ring is full.
+  bool tryPush(const T& f_value) noexcept {
+    size_t l_tail = c_tail.load(std::memory_order_relaxed);
+    if (l_tail - c_headCache > c_mask) {
+      c_headCache = c_head.load(std::memory_order_acquire);
+      if (l_tail - c_headCache > c_mask) {
+        return false;
+      }
+    }
+    c_slots[l_tail & c_mask] = f_value;
+    c_tail.store(l_tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false if the ring is empty.
+  bool tryPop(T& f_value) noexcept {
+    size_t l_head = c_head.load(std::memory_order_relaxed);
+    if (l_head == c_tailCache) {
+      c_tailCache = c_tail.load(std::memory_order_acquire);
+      if (l_head == c_tailCache) {
+        return false;
+      }
+    }
+    f_value = c_slots[l_head & c_mask];
+    c_head.store(l_head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called concurrently with either side
+  size_t size() const noexcept {
+    return c_tail.load(std::memory_order_acquire) - c_head.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::unique_ptr<T[]> c_slots;
+  size_t c_mask;
+  alignas(64) std::atomic<size_t> c_head{0};
+  size_t c_tailCache = 0;
+  alignas(64) std::atomic<size_t> c_tail{0};
+  size_t c_headCache = 0;
+};
+
+}  // namespace ghls
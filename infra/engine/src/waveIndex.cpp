@@ -0,0 +1,272 @@
+#include "waveIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__BYTE_ORDER__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "the index is mapped in place and stored little-endian");
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'H', 'L', 'S', 'I', 'D', 'X', GHLS_WIDE_SIMTIME ? 'W' : '1'};
+
+struct IndexHeader {
+  char magic[8];
+  uint64_t signals;
+  uint64_t changes;
+  uint64_t tableOffset;
+  uint64_t ticksOffset;
+  uint64_t valuesOffset;
+  uint64_t namesOffset;
+  uint64_t fileSize;
+};
+
+uint64_t align8(uint64_t f_offset) noexcept { return (f_offset + 7) & ~uint64_t(7); }
+
+// 128-bit ticks need 16-byte alignment
+uint64_t alignTicks(uint64_t f_offset) noexcept {
+  return (f_offset + alignof(ghls::SimTick) - 1) & ~uint64_t(alignof(ghls::SimTick) - 1);
+}
+
+uint32_t wordsOf(uint32_t f_width) noexcept { return (f_width + 63) / 64; }
+
+}  // namespace
+
+struct ghls::WaveIndex::Signal {
+  uint64_t firstChange;
+  uint64_t changes;
+  uint64_t firstWord;
+  uint64_t nameOffset;
+  uint32_t width;
+  uint32_t nameLength;
+};
+
+ghls::WaveIndex::WaveIndex()
+    : c_base(nullptr),
+      c_size(0),
+      c_signals(0),
+      c_table(nullptr),
+      c_ticks(nullptr),
+      c_values(nullptr),
+      c_names(nullptr) {}
+
+ghls::WaveIndex::~WaveIndex() { close(); }
+
+bool ghls::WaveIndex::open(const std::string& f_path) {
+  close();
+  int l_fd = ::open(f_path.c_str(), O_RDONLY);
+  if (l_fd < 0) {
+    return false;
+  }
+  struct stat l_stat;
+  void* l_map = MAP_FAILED;
+  if (::fstat(l_fd, &l_stat) == 0 && size_t(l_stat.st_size) >= sizeof(IndexHeader)) {
+    l_map = ::mmap(nullptr, l_stat.st_size, PROT_READ, MAP_SHARED, l_fd, 0);
+  }
+  ::close(l_fd);
+  if (l_map == MAP_FAILED) {
+    return false;
+  }
+  // Lookups jump around the file, read-ahead would only waste page cache
+  ::madvise(l_map, l_stat.st_size, MADV_RANDOM);
+  c_base = static_cast<const uint8_t*>(l_map);
+  c_size = l_stat.st_size;
+
+  const IndexHeader& l_header = *reinterpret_cast<const IndexHeader*>(c_base);
+  uint64_t l_tableEnd = l_header.tableOffset + l_header.signals * sizeof(Signal);
+  bool l_valid = std::memcmp(l_header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                 l_header.fileSize == c_size && l_header.signals <= c_size &&
+                 l_header.changes <= c_size && l_header.tableOffset % 8 == 0 &&
+                 l_header.ticksOffset % alignof(SimTick) == 0 && l_header.valuesOffset % 8 == 0 &&
+                 l_tableEnd <= l_header.ticksOffset &&
+                 l_header.ticksOffset + l_header.changes * sizeof(SimTick) <=
+                     l_header.valuesOffset &&
+                 l_header.valuesOffset <= l_header.namesOffset && l_header.namesOffset <= c_size;
+  if (!l_valid) {
+    close();
+    return false;
+  }
+  c_signals = l_header.signals;
+  c_table = reinterpret_cast<const Signal*>(c_base + l_header.tableOffset);
+  c_ticks = reinterpret_cast<const SimTick*>(c_base + l_header.ticksOffset);
+  c_values = reinterpret_cast<const LogicWord*>(c_base + l_header.valuesOffset);
+  c_names = reinterpret_cast<const char*>(c_base + l_header.namesOffset);
+
+  // Bounds are checked once here so lookups can trust the table
+  uint64_t l_words = (l_header.namesOffset - l_header.valuesOffset) / sizeof(LogicWord);
+  uint64_t l_nameBytes = c_size - l_header.namesOffset;
+  for (size_t l_idx = 0; l_idx < c_signals; ++l_idx) {
+    const Signal& l_signal = c_table[l_idx];
+    if (l_signal.width == 0 || l_signal.firstChange > l_header.changes ||
+        l_signal.changes > l_header.changes - l_signal.firstChange ||
+        l_signal.firstWord > l_words ||
+        l_signal.changes * wordsOf(l_signal.width) > l_words - l_signal.firstWord ||
+        l_signal.nameOffset > l_nameBytes ||
+        l_signal.nameLength > l_nameBytes - l_signal.nameOffset) {
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+
+void ghls::WaveIndex::close() {
+  if (c_base != nullptr) {
+    ::munmap(const_cast<uint8_t*>(c_base), c_size);
+  }
+  c_base = nullptr;
+  c_size = 0;
+  c_signals = 0;
+}
+
+std::string_view ghls::WaveIndex::name(WaveSignal f_signal) const noexcept {
+  const Signal& l_signal = entry(f_signal);
+  return std::string_view(c_names + l_signal.nameOffset, l_signal.nameLength);
+}
+
+uint32_t ghls::WaveIndex::width(WaveSignal f_signal) const noexcept {
+  return entry(f_signal).width;
+}
+
+std::optional<ghls::WaveSignal> ghls::WaveIndex::find(std::string_view f_name) const noexcept {
+  for (WaveSignal l_signal = 0; l_signal < c_signals; ++l_signal) {
+    if (name(l_signal) == f_name) {
+      return l_signal;
+    }
+  }
+  return std::nullopt;
+}
+
+uint64_t ghls::WaveIndex::changes(WaveSignal f_signal) const noexcept {
+  return entry(f_signal).changes;
+}
+
+ghls::SimTime ghls::WaveIndex::changeTime(WaveSignal f_signal, uint64_t f_change) const noexcept {
+  return SimTime::fromTicks(c_ticks[entry(f_signal).firstChange + f_change]);
+}
+
+const ghls::LogicWord* ghls::WaveIndex::changeValue(WaveSignal f_signal,
+                                                    uint64_t f_change) const noexcept {
+  const Signal& l_signal = entry(f_signal);
+  return c_values + l_signal.firstWord + f_change * wordsOf(l_signal.width);
+}
+
+std::optional<uint64_t> ghls::WaveIndex::changeAt(WaveSignal f_signal,
+                                                  SimTime f_time) const noexcept {
+  const Signal& l_signal = entry(f_signal);
+  const SimTick* l_begin = c_ticks + l_signal.firstChange;
+  const SimTick* l_end = l_begin + l_signal.changes;
+  // Several changes at one tick (delta cycles) resolve to the last of them
+  const SimTick* l_after = std::upper_bound(l_begin, l_end, f_time.ticks());
+  if (l_after == l_begin) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(l_after - l_begin - 1);
+}
+
+const ghls::LogicWord* ghls::WaveIndex::valueAt(WaveSignal f_signal,
+                                                SimTime f_time) const noexcept {
+  std::optional<uint64_t> l_change = changeAt(f_signal, f_time);
+  return l_change ? changeValue(f_signal, *l_change) : nullptr;
+}
+
+const ghls::WaveIndex::Signal& ghls::WaveIndex::entry(WaveSignal f_signal) const noexcept {
+  return c_table[f_signal];
+}
+
+bool ghls::buildWaveIndex(const std::string& f_wavePath, const std::string& f_indexPath) {
+  // Pass 1: changes per signal fix every section offset
+  WaveStreamReader l_reader;
+  if (!l_reader.open(f_wavePath)) {
+    return false;
+  }
+  const std::vector<WaveSignalInfo> l_infos = l_reader.signals();
+  std::vector<uint64_t> l_counts(l_infos.size(), 0);
+  WaveChange l_change;
+  while (l_reader.next(l_change)) {
+    ++l_counts[l_change.signal];
+  }
+  // A truncated or corrupt dump would answer queries from partial data
+  if (l_reader.error()) {
+    return false;
+  }
+
+  std::vector<WaveIndex::Signal> l_table(l_infos.size());
+  uint64_t l_changes = 0;
+  uint64_t l_words = 0;
+  uint64_t l_nameBytes = 0;
+  for (size_t l_idx = 0; l_idx < l_infos.size(); ++l_idx) {
+    l_table[l_idx] = {l_changes,   l_counts[l_idx], l_words,
+                      l_nameBytes, l_infos[l_idx].width,
+                      static_cast<uint32_t>(l_infos[l_idx].name.size())};
+    l_changes += l_counts[l_idx];
+    l_words += l_counts[l_idx] * wordsOf(l_infos[l_idx].width);
+    l_nameBytes += l_infos[l_idx].name.size();
+  }
+  IndexHeader l_header;
+  std::memcpy(l_header.magic, kMagic, sizeof(kMagic));
+  l_header.signals = l_infos.size();
+  l_header.changes = l_changes;
+  l_header.tableOffset = align8(sizeof(IndexHeader));
+  l_header.ticksOffset =
+      alignTicks(l_header.tableOffset + l_table.size() * sizeof(WaveIndex::Signal));
+  l_header.valuesOffset = l_header.ticksOffset + l_changes * sizeof(SimTick);
+  l_header.namesOffset = l_header.valuesOffset + l_words * sizeof(LogicWord);
+  l_header.fileSize = l_header.namesOffset + l_nameBytes;
+
+  int l_fd = ::open(f_indexPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (l_fd < 0) {
+    return false;
+  }
+  void* l_map = MAP_FAILED;
+  if (::ftruncate(l_fd, static_cast<off_t>(l_header.fileSize)) == 0) {
+    l_map = ::mmap(nullptr, l_header.fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, l_fd, 0);
+  }
+  ::close(l_fd);
+  if (l_map == MAP_FAILED) {
+    return false;
+  }
+  uint8_t* l_base = static_cast<uint8_t*>(l_map);
+  std::memcpy(l_base, &l_header, sizeof(l_header));
+  std::memcpy(l_base + l_header.tableOffset, l_table.data(),
+              l_table.size() * sizeof(WaveIndex::Signal));
+  char* l_names = reinterpret_cast<char*>(l_base + l_header.namesOffset);
+  for (size_t l_idx = 0; l_idx < l_infos.size(); ++l_idx) {
+    std::memcpy(l_names + l_table[l_idx].nameOffset, l_infos[l_idx].name.data(),
+                l_infos[l_idx].name.size());
+  }
+
+  // Pass 2: scatter each change behind the previous change of its signal
+  SimTick* l_ticks = reinterpret_cast<SimTick*>(l_base + l_header.ticksOffset);
+  LogicWord* l_values = reinterpret_cast<LogicWord*>(l_base + l_header.valuesOffset);
+  std::vector<uint64_t> l_filled(l_infos.size(), 0);
+  uint64_t l_written = 0;
+  bool l_ok = l_reader.open(f_wavePath);
+  while (l_ok && l_reader.next(l_change)) {
+    WaveIndex::Signal& l_signal = l_table[l_change.signal];
+    uint64_t l_slot = l_filled[l_change.signal]++;
+    if (l_slot >= l_signal.changes) {
+      l_ok = false;
+      break;
+    }
+    uint32_t l_count = wordsOf(l_signal.width);
+    l_ticks[l_signal.firstChange + l_slot] = l_change.tick;
+    std::memcpy(l_values + l_signal.firstWord + l_slot * l_count, l_change.words,
+                l_count * sizeof(LogicWord));
+    ++l_written;
+  }
+  l_ok = l_ok && !l_reader.error() && l_written == l_changes;
+  ::munmap(l_map, l_header.fileSize);
+  if (!l_ok) {
+    ::unlink(f_indexPath.c_str());
+  }
+  return l_ok;
+}
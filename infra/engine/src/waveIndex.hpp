@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "netStore.hpp"
+#include "simTime.hpp"
+#include "waveWriter.hpp"
+
+namespace ghls {
+
+// Random-access waveform file, read through mmap without copying. Changes are
+// grouped per signal and sorted by tick, so the value of a signal at a time is
+// a binary search over that signal's tick array and only the pages touched by
+// the search are loaded.
+//
+// Layout (little-endian, every section 8-byte aligned):
+//   header   "GHLSIDX1" ("GHLSIDXW" with wide ticks), signal count, change
+//            count, section offsets
+//   signals  per signal: first change, change count, first value word, name
+//            offset, width and name length
+//   ticks    one SimTick per change, signal by signal, 16-byte aligned with
+//            wide ticks
+//   values   one LogicWord per 64 bits of width per change, same order
+//   names    signal names, not terminated
+class WaveIndex {
+ public:
+  WaveIndex();
+  ~WaveIndex();
+  WaveIndex(const WaveIndex&) = delete;
+  WaveIndex& operator=(const WaveIndex&) = delete;
+
+  // Maps f_path read-only. Returns false if it cannot be mapped or its
+  // sections do not fit the file.
+  bool open(const std::string& f_path);
+  void close();
+  bool isOpen() const noexcept { return c_base != nullptr; }
+
+  size_t signals() const noexcept { return c_signals; }
+  std::string_view name(WaveSignal f_signal) const noexcept;
+  uint32_t width(WaveSignal f_signal) const noexcept;
+  std::optional<WaveSignal> find(std::string_view f_name) const noexcept;
+
+  uint64_t changes(WaveSignal f_signal) const noexcept;
+  SimTime changeTime(WaveSignal f_signal, uint64_t f_change) const noexcept;
+  const LogicWord* changeValue(WaveSignal f_signal, uint64_t f_change) const noexcept;
+
+  // Index of the last change at or before f_time, nullopt before the first
+  std::optional<uint64_t> changeAt(WaveSignal f_signal, SimTime f_time) const noexcept;
+  // Value in effect at f_time, null before the signal's first change. The
+  // words point into the mapping and stay valid until close().
+  const LogicWord* valueAt(WaveSignal f_signal, SimTime f_time) const noexcept;
+
+ private:
+  friend bool buildWaveIndex(const std::string& f_wavePath, const std::string& f_indexPath);
+
+  struct Signal;
+
+  const Signal& entry(WaveSignal f_signal) const noexcept;
+
+  const uint8_t* c_base;
+  size_t c_size;
+  size_t c_signals;
+  const Signal* c_table;
+  const SimTick* c_ticks;
+  const LogicWord* c_values;
+  const char* c_names;
+};
+
+// Converts a binary stream written by WaveWriter into a WaveIndex file. Two
+// passes over the stream: one to count changes per signal, one to scatter
+// them into the mapped output, so memory use does not grow with the dump.
+bool buildWaveIndex(const std::string& f_wavePath, const std::string& f_indexPath);
+
+}  // namespace ghls
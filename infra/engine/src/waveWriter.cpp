@@ -0,0 +1,603 @@
+#include "waveWriter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "blockCodec.hpp"
+
+namespace {
+
+// Encoded bytes per chunk before it is handed to the writer thread
+constexpr size_t kChunkBytes = 64 * 1024;
+// Recycled chunk buffers kept by the writer
+constexpr size_t kSpareChunks = 64;
+// Wide tick builds write a distinct format so neither build misreads the other
+constexpr char kMagic[8] = {'G', 'H', 'L', 'S', 'W', 'A', 'V', GHLS_WIDE_SIMTIME ? 'W' : '1'};
+constexpr size_t kBlockHeader = 8 + 2 * sizeof(ghls::SimTick);
+constexpr ghls::WaveSignal kNoSignal = UINT32_MAX;
+
+std::atomic<uint64_t> g_nextSerial{1};
+
+// Producers of the calling thread, keyed by writer serial
+struct ThreadProducers {
+  uint64_t lastSerial = 0;
+  void* lastProducer = nullptr;
+  std::vector<std::pair<uint64_t, void*>> all;
+};
+thread_local ThreadProducers t_producers;
+
+// Serials of the open writers, so thread caches can drop the closed ones
+std::mutex g_openMutex;
+std::vector<uint64_t> g_openSerials;
+
+void dropClosed(ThreadProducers& f_cache) {
+  std::lock_guard<std::mutex> l_lock(g_openMutex);
+  auto l_closed = [](uint64_t f_serial) {
+    return std::find(g_openSerials.begin(), g_openSerials.end(), f_serial) == g_openSerials.end();
+  };
+  f_cache.all.erase(std::remove_if(f_cache.all.begin(), f_cache.all.end(),
+                                   [&](const std::pair<uint64_t, void*>& f_entry) {
+                                     return l_closed(f_entry.first);
+                                   }),
+                    f_cache.all.end());
+  if (l_closed(f_cache.lastSerial)) {
+    f_cache.lastSerial = 0;
+    f_cache.lastProducer = nullptr;
+  }
+}
+
+void putLE(uint8_t* f_dst, ghls::SimTick f_value, size_t f_bytes) {
+  for (size_t l_idx = 0; l_idx < f_bytes; ++l_idx) {
+    f_dst[l_idx] = static_cast<uint8_t>(f_value >> (8 * l_idx));
+  }
+}
+
+uint64_t getLE(const uint8_t* f_src, size_t f_bytes) {
+  uint64_t l_value = 0;
+  for (size_t l_idx = 0; l_idx < f_bytes; ++l_idx) {
+    l_value |= uint64_t(f_src[l_idx]) << (8 * l_idx);
+  }
+  return l_value;
+}
+
+ghls::SimTick getTickLE(const uint8_t* f_src) {
+  ghls::SimTick l_value = 0;
+  for (size_t l_idx = 0; l_idx < sizeof(ghls::SimTick); ++l_idx) {
+    l_value |= ghls::SimTick(f_src[l_idx]) << (8 * l_idx);
+  }
+  return l_value;
+}
+
+// VCD identifier codes, base 94 over the printable characters
+std::string vcdId(uint32_t f_index) {
+  std::string l_id;
+  do {
+    l_id.push_back(static_cast<char>('!' + f_index % 94));
+    f_index /= 94;
+  } while (f_index != 0);
+  return l_id;
+}
+
+}  // namespace
+
+ghls::WaveWriter::WaveWriter()
+    : c_file(nullptr),
+      c_format(WaveFormat::vcd),
+      c_serial(0),
+      c_producerCount(0),
+      c_closing(false),
+      c_headerDone(false),
+      c_vcdTick(0),
+      c_vcdStarted(false),
+      c_bytesWritten(0),
+      c_blocksWritten(0) {}
+
+ghls::WaveWriter::~WaveWriter() { close(); }
+
+bool ghls::WaveWriter::open(const std::string& f_path, WaveFormat f_format) {
+  close();
+  c_file = std::fopen(f_path.c_str(), "wb");
+  if (c_file == nullptr) {
+    return false;
+  }
+  c_format = f_format;
+  c_serial = g_nextSerial.fetch_add(1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> l_lock(g_openMutex);
+    g_openSerials.push_back(c_serial);
+  }
+  c_signals.clear();
+  c_netSignal.clear();
+  c_producers.clear();
+  c_producerCount.store(0, std::memory_order_relaxed);
+  c_closing = false;
+  c_headerDone = false;
+  c_vcdStarted = false;
+  c_bytesWritten = 0;
+  c_blocksWritten = 0;
+  c_writer = std::thread(&WaveWriter::writerLoop, this);
+  return true;
+}
+
+ghls::WaveSignal ghls::WaveWriter::declare(const std::string& f_name, uint32_t f_width) {
+  assert(f_width > 0 && "signals must be at least one bit wide");
+  assert(changesRecorded() == 0 && "signals must be declared before recording");
+  c_signals.push_back({f_name, f_width});
+  return static_cast<WaveSignal>(c_signals.size() - 1);
+}
+
+ghls::WaveSignal ghls::WaveWriter::declareNet(const std::string& f_name, const NetStore& f_nets,
+                                              NetId f_net) {
+  WaveSignal l_signal = declare(f_name, f_nets.width(f_net));
+  if (c_netSignal.size() <= f_net) {
+    c_netSignal.resize(f_net + 1, kNoSignal);
+  }
+  c_netSignal[f_net] = l_signal;
+  return l_signal;
+}
+
+void ghls::WaveWriter::change(SimTime f_time, WaveSignal f_signal, const LogicWord* f_words) {
+  assert(c_file != nullptr && f_signal < c_signals.size());
+  Producer& l_producer = producer();
+  if (!l_producer.chunk) {
+    l_producer.chunk = takeChunk();
+  }
+  Chunk& l_chunk = *l_producer.chunk;
+  SimTick l_tick = f_time.ticks();
+  if (l_chunk.changes == 0) {
+    assert(l_tick >= l_producer.lastTick && "changes must be recorded in time order");
+    l_chunk.firstTick = l_tick;
+    l_chunk.lastTick = l_tick;
+  }
+  assert(l_tick >= l_chunk.lastTick && "changes must be recorded in time order");
+  putTicks(l_chunk.data, l_tick - l_chunk.lastTick);
+  l_chunk.lastTick = l_tick;
+  l_producer.lastTick = l_tick;
+
+  uint32_t l_words = (c_signals[f_signal].width + 63) / 64;
+  bool l_unknown = false;
+  for (uint32_t l_word = 0; l_word < l_words; ++l_word) {
+    l_unknown |= f_words[l_word].bval != 0;
+  }
+  putVarint(l_chunk.data, (uint64_t(f_signal) << 1) | (l_unknown ? 1 : 0));
+  for (uint32_t l_word = 0; l_word < l_words; ++l_word) {
+    putVarint(l_chunk.data, f_words[l_word].aval);
+    if (l_unknown) {
+      putVarint(l_chunk.data, f_words[l_word].bval);
+    }
+  }
+  ++l_chunk.changes;
+  ++l_producer.changes;
+  if (l_chunk.data.size() >= kChunkBytes) {
+    submit(l_producer);
+  }
+}
+
+void ghls::WaveWriter::dumpChanges(SimTime f_now, const NetStore& f_nets) {
+  for (NetId l_net : f_nets.changed()) {
+    if (l_net >= c_netSignal.size() || c_netSignal[l_net] == kNoSignal) {
+      continue;
+    }
+    uint32_t l_words = f_nets.words(l_net);
+    if (l_words == 1) {
+      change(f_now, c_netSignal[l_net], f_nets.word(l_net));
+      continue;
+    }
+    c_netWords.resize(l_words);
+    for (uint32_t l_word = 0; l_word < l_words; ++l_word) {
+      c_netWords[l_word] = f_nets.word(l_net, l_word);
+    }
+    change(f_now, c_netSignal[l_net], c_netWords.data());
+  }
+}
+
+void ghls::WaveWriter::flush() {
+  if (c_file == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l_lock(c_producerMutex);
+    for (std::unique_ptr<Producer>& l_producer : c_producers) {
+      if (l_producer->chunk && l_producer->chunk->changes != 0) {
+        submit(*l_producer);
+      }
+    }
+  }
+  {
+    std::lock_guard<std::mutex> l_lock(c_queueMutex);
+    c_queue.push_back(Item());
+  }
+  c_queueReady.notify_one();
+}
+
+void ghls::WaveWriter::close() {
+  if (c_file == nullptr) {
+    return;
+  }
+  flush();
+  {
+    std::lock_guard<std::mutex> l_lock(c_queueMutex);
+    c_closing = true;
+  }
+  c_queueReady.notify_one();
+  c_writer.join();
+  std::fclose(c_file);
+  c_file = nullptr;
+  // The calling thread forgets its producer now, other threads the next time
+  // they start recording into a writer
+  {
+    std::lock_guard<std::mutex> l_lock(g_openMutex);
+    g_openSerials.erase(std::find(g_openSerials.begin(), g_openSerials.end(), c_serial));
+  }
+  dropClosed(t_producers);
+}
+
+uint64_t ghls::WaveWriter::changesRecorded() const noexcept {
+  std::lock_guard<std::mutex> l_lock(c_producerMutex);
+  uint64_t l_changes = 0;
+  for (const std::unique_ptr<Producer>& l_producer : c_producers) {
+    l_changes += l_producer->changes;
+  }
+  return l_changes;
+}
+
+ghls::WaveWriter::Producer& ghls::WaveWriter::producer() {
+  ThreadProducers& l_cache = t_producers;
+  if (l_cache.lastSerial == c_serial) {
+    return *static_cast<Producer*>(l_cache.lastProducer);
+  }
+  Producer* l_found = nullptr;
+  for (const std::pair<uint64_t, void*>& l_entry : l_cache.all) {
+    if (l_entry.first == c_serial) {
+      l_found = static_cast<Producer*>(l_entry.second);
+    }
+  }
+  if (l_found == nullptr) {
+    dropClosed(l_cache);
+    std::lock_guard<std::mutex> l_lock(c_producerMutex);
+    c_producers.emplace_back(new Producer());
+    l_found = c_producers.back().get();
+    l_found->index = static_cast<uint32_t>(c_producers.size() - 1);
+    c_producerCount.store(static_cast<uint32_t>(c_producers.size()), std::memory_order_relaxed);
+    l_cache.all.emplace_back(c_serial, l_found);
+  }
+  l_cache.lastSerial = c_serial;
+  l_cache.lastProducer = l_found;
+  return *l_found;
+}
+
+std::unique_ptr<ghls::WaveWriter::Chunk> ghls::WaveWriter::takeChunk() {
+  std::unique_ptr<Chunk> l_chunk;
+  {
+    std::lock_guard<std::mutex> l_lock(c_queueMutex);
+    if (!c_spare.empty()) {
+      l_chunk = std::move(c_spare.back());
+      c_spare.pop_back();
+    }
+  }
+  if (!l_chunk) {
+    l_chunk.reset(new Chunk());
+    l_chunk->data.reserve(kChunkBytes + 256);
+  }
+  l_chunk->data.clear();
+  l_chunk->changes = 0;
+  return l_chunk;
+}
+
+void ghls::WaveWriter::submit(Producer& f_producer) {
+  std::unique_ptr<Chunk> l_chunk = std::move(f_producer.chunk);
+  l_chunk->producer = f_producer.index;
+  l_chunk->ordered = f_producer.index == 0 && c_producerCount.load(std::memory_order_relaxed) == 1;
+  {
+    std::lock_guard<std::mutex> l_lock(c_queueMutex);
+    c_queue.push_back(Item{std::move(l_chunk)});
+  }
+  c_queueReady.notify_one();
+}
+
+void ghls::WaveWriter::recycle(std::unique_ptr<Chunk> f_chunk) {
+  std::lock_guard<std::mutex> l_lock(c_queueMutex);
+  if (c_spare.size() < kSpareChunks) {
+    c_spare.push_back(std::move(f_chunk));
+  }
+}
+
+void ghls::WaveWriter::writerLoop() {
+  for (;;) {
+    Item l_item;
+    {
+      std::unique_lock<std::mutex> l_lock(c_queueMutex);
+      c_queueReady.wait(l_lock, [this] { return !c_queue.empty() || c_closing; });
+      if (c_queue.empty()) {
+        break;
+      }
+      l_item = std::move(c_queue.front());
+      c_queue.pop_front();
+    }
+    if (!c_headerDone) {
+      writeHeader();
+    }
+    if (!l_item.chunk) {
+      mergeEpoch();
+    } else if (l_item.chunk->ordered && c_epoch.empty()) {
+      const Chunk& l_chunk = *l_item.chunk;
+      emit(l_chunk.data.data(), l_chunk.data.data() + l_chunk.data.size(), l_chunk.firstTick,
+           l_chunk.lastTick);
+      recycle(std::move(l_item.chunk));
+    } else {
+      c_epoch.push_back(std::move(l_item.chunk));
+    }
+  }
+  mergeEpoch();
+  if (!c_text.empty()) {
+    put(c_text.data(), c_text.size());
+    c_text.clear();
+  }
+  std::fflush(c_file);
+}
+
+void ghls::WaveWriter::writeHeader() {
+  c_headerDone = true;
+  if (c_format == WaveFormat::binary) {
+    std::vector<uint8_t> l_header(kMagic, kMagic + sizeof(kMagic));
+    uint8_t l_field[4];
+    putLE(l_field, c_signals.size(), 4);
+    l_header.insert(l_header.end(), l_field, l_field + 4);
+    for (const WaveSignalInfo& l_signal : c_signals) {
+      putLE(l_field, l_signal.width, 4);
+      l_header.insert(l_header.end(), l_field, l_field + 4);
+      putLE(l_field, l_signal.name.size(), 4);
+      l_header.insert(l_header.end(), l_field, l_field + 4);
+      l_header.insert(l_header.end(), l_signal.name.begin(), l_signal.name.end());
+    }
+    put(l_header.data(), l_header.size());
+    return;
+  }
+  c_vcdIds.clear();
+  c_text = "$version ghls $end\n$timescale 1fs $end\n$scope module top $end\n";
+  for (uint32_t l_idx = 0; l_idx < c_signals.size(); ++l_idx) {
+    c_vcdIds.push_back(vcdId(l_idx));
+    c_text += "$var wire " + std::to_string(c_signals[l_idx].width) + ' ' + c_vcdIds.back() + ' ' +
+              c_signals[l_idx].name + " $end\n";
+  }
+  c_text += "$upscope $end\n$enddefinitions $end\n";
+}
+
+void ghls::WaveWriter::mergeEpoch() {
+  if (c_epoch.empty()) {
+    return;
+  }
+  // Decode the tick of every change, then order them by time. Ties keep the
+  // recording thread order and, within a thread, the recording order.
+  c_merge.clear();
+  for (const std::unique_ptr<Chunk>& l_chunk : c_epoch) {
+    const uint8_t* l_pos = l_chunk->data.data();
+    const uint8_t* l_end = l_pos + l_chunk->data.size();
+    SimTick l_tick = l_chunk->firstTick;
+    SimTick l_delta;
+    while (l_pos < l_end && getTicks(l_pos, l_end, l_delta)) {
+      l_tick += l_delta;
+      const uint8_t* l_next = skipRecord(l_pos, l_end);
+      c_merge.push_back({l_tick, l_chunk->producer, l_pos, l_next});
+      l_pos = l_next;
+    }
+  }
+  std::stable_sort(c_merge.begin(), c_merge.end(), [](const Change& f_lhs, const Change& f_rhs) {
+    return f_lhs.tick != f_rhs.tick ? f_lhs.tick < f_rhs.tick : f_lhs.producer < f_rhs.producer;
+  });
+
+  c_scratch.clear();
+  SimTick l_first = c_merge.empty() ? 0 : c_merge.front().tick;
+  SimTick l_prev = l_first;
+  for (const Change& l_change : c_merge) {
+    if (c_scratch.size() >= kChunkBytes) {
+      emit(c_scratch.data(), c_scratch.data() + c_scratch.size(), l_first, l_prev);
+      c_scratch.clear();
+      l_first = l_change.tick;
+      l_prev = l_first;
+    }
+    putTicks(c_scratch, l_change.tick - l_prev);
+    c_scratch.insert(c_scratch.end(), l_change.begin, l_change.end);
+    l_prev = l_change.tick;
+  }
+  if (!c_scratch.empty()) {
+    emit(c_scratch.data(), c_scratch.data() + c_scratch.size(), l_first, l_prev);
+  }
+  for (std::unique_ptr<Chunk>& l_chunk : c_epoch) {
+    recycle(std::move(l_chunk));
+  }
+  c_epoch.clear();
+}
+
+void ghls::WaveWriter::emit(const uint8_t* f_records, const uint8_t* f_end, SimTick f_first,
+                            SimTick f_last) {
+  if (c_format == WaveFormat::vcd) {
+    writeVcd(f_records, f_end, f_first);
+    return;
+  }
+  size_t l_raw = f_end - f_records;
+  c_packed.assign(kBlockHeader, 0);
+  compressBlock(f_records, l_raw, c_packed);
+  putLE(c_packed.data(), l_raw, 4);
+  putLE(c_packed.data() + 4, c_packed.size() - kBlockHeader, 4);
+  putLE(c_packed.data() + 8, f_first, sizeof(SimTick));
+  putLE(c_packed.data() + 8 + sizeof(SimTick), f_last, sizeof(SimTick));
+  put(c_packed.data(), c_packed.size());
+  ++c_blocksWritten;
+}
+
+void ghls::WaveWriter::writeVcd(const uint8_t* f_records, const uint8_t* f_end, SimTick f_first) {
+  static const char kChars[] = {'0', '1', 'z', 'x'};
+  const uint8_t* l_pos = f_records;
+  SimTick l_tick = f_first;
+  SimTick l_delta;
+  while (l_pos < f_end && getTicks(l_pos, f_end, l_delta)) {
+    l_tick += l_delta;
+    if (!c_vcdStarted || l_tick != c_vcdTick) {
+      char l_digits[kSimTimeStrMax];
+      char* l_last = formatTicks(l_digits, l_digits + sizeof(l_digits), l_tick);
+      c_text.push_back('#');
+      c_text.append(l_digits, l_last);
+      c_text.push_back('\n');
+      c_vcdTick = l_tick;
+      c_vcdStarted = true;
+    }
+    uint64_t l_code;
+    getVarint(l_pos, f_end, l_code);
+    WaveSignal l_signal = static_cast<WaveSignal>(l_code >> 1);
+    bool l_unknown = (l_code & 1) != 0;
+    uint32_t l_width = c_signals[l_signal].width;
+    if (l_width > 1) {
+      c_text.push_back('b');
+    }
+    size_t l_bits = c_text.size();
+    c_text.append(l_width, '0');
+    for (uint32_t l_word = 0; l_word * 64 < l_width; ++l_word) {
+      uint64_t l_aval = 0;
+      uint64_t l_bval = 0;
+      getVarint(l_pos, f_end, l_aval);
+      if (l_unknown) {
+        getVarint(l_pos, f_end, l_bval);
+      }
+      uint32_t l_count = std::min<uint32_t>(64, l_width - l_word * 64);
+      for (uint32_t l_bit = 0; l_bit < l_count; ++l_bit) {
+        unsigned l_value = ((l_aval >> l_bit) & 1) | (((l_bval >> l_bit) & 1) << 1);
+        c_text[l_bits + l_width - 1 - (l_word * 64 + l_bit)] = kChars[l_value];
+      }
+    }
+    if (l_width > 1) {
+      c_text.push_back(' ');
+    }
+    c_text += c_vcdIds[l_signal];
+    c_text.push_back('\n');
+    if (c_text.size() >= kChunkBytes) {
+      put(c_text.data(), c_text.size());
+      c_text.clear();
+    }
+  }
+}
+
+void ghls::WaveWriter::put(const void* f_data, size_t f_size) {
+  c_bytesWritten += std::fwrite(f_data, 1, f_size, c_file);
+}
+
+const uint8_t* ghls::WaveWriter::skipRecord(const uint8_t* f_pos, const uint8_t* f_end) const {
+  uint64_t l_code;
+  uint64_t l_word;
+  if (!getVarint(f_pos, f_end, l_code) || (l_code >> 1) >= c_signals.size()) {
+    return f_end;
+  }
+  uint32_t l_words = (c_signals[l_code >> 1].width + 63) / 64;
+  uint32_t l_varints = (l_code & 1) != 0 ? 2 * l_words : l_words;
+  for (uint32_t l_idx = 0; l_idx < l_varints; ++l_idx) {
+    getVarint(f_pos, f_end, l_word);
+  }
+  return f_pos;
+}
+
+ghls::WaveStreamReader::WaveStreamReader()
+    : c_file(nullptr), c_pos(nullptr), c_end(nullptr), c_tick(0), c_error(false), c_eof(false) {}
+
+ghls::WaveStreamReader::~WaveStreamReader() {
+  if (c_file != nullptr) {
+    std::fclose(c_file);
+  }
+}
+
+bool ghls::WaveStreamReader::open(const std::string& f_path) {
+  if (c_file != nullptr) {
+    std::fclose(c_file);
+  }
+  c_signals.clear();
+  c_pos = c_end = nullptr;
+  c_eof = false;
+  // Anything short of a complete signal table is an error
+  c_error = true;
+  c_file = std::fopen(f_path.c_str(), "rb");
+  if (c_file == nullptr) {
+    return false;
+  }
+  uint8_t l_header[12];
+  if (std::fread(l_header, 1, sizeof(l_header), c_file) != sizeof(l_header) ||
+      std::memcmp(l_header, kMagic, sizeof(kMagic)) != 0) {
+    return false;
+  }
+  uint32_t l_count = static_cast<uint32_t>(getLE(l_header + 8, 4));
+  for (uint32_t l_idx = 0; l_idx < l_count; ++l_idx) {
+    uint8_t l_fields[8];
+    if (std::fread(l_fields, 1, sizeof(l_fields), c_file) != sizeof(l_fields)) {
+      return false;
+    }
+    WaveSignalInfo l_signal{std::string(getLE(l_fields + 4, 4), '\0'),
+                            static_cast<uint32_t>(getLE(l_fields, 4))};
+    if (std::fread(&l_signal.name[0], 1, l_signal.name.size(), c_file) != l_signal.name.size()) {
+      return false;
+    }
+    c_signals.push_back(std::move(l_signal));
+  }
+  c_error = false;
+  return true;
+}
+
+bool ghls::WaveStreamReader::next(WaveChange& f_change) {
+  if (c_error || c_eof) {
+    return false;
+  }
+  while (c_pos == c_end) {
+    if (!loadBlock()) {
+      return false;
+    }
+  }
+  SimTick l_delta;
+  uint64_t l_code;
+  if (!getTicks(c_pos, c_end, l_delta) || !getVarint(c_pos, c_end, l_code) ||
+      (l_code >> 1) >= c_signals.size()) {
+    c_error = true;
+    return false;
+  }
+  c_tick += l_delta;
+  WaveSignal l_signal = static_cast<WaveSignal>(l_code >> 1);
+  uint32_t l_words = (c_signals[l_signal].width + 63) / 64;
+  c_words.resize(l_words);
+  for (LogicWord& l_word : c_words) {
+    l_word.bval = 0;
+    if (!getVarint(c_pos, c_end, l_word.aval) ||
+        ((l_code & 1) != 0 && !getVarint(c_pos, c_end, l_word.bval))) {
+      c_error = true;
+      return false;
+    }
+  }
+  f_change = {c_tick, l_signal, c_words.data()};
+  return true;
+}
+
+bool ghls::WaveStreamReader::loadBlock() {
+  uint8_t l_header[kBlockHeader];
+  if (c_file == nullptr) {
+    c_error = true;
+    return false;
+  }
+  size_t l_read = std::fread(l_header, 1, sizeof(l_header), c_file);
+  if (l_read != sizeof(l_header)) {
+    // Only a file that ends exactly between blocks ends cleanly
+    c_eof = l_read == 0 && std::feof(c_file) != 0;
+    c_error = !c_eof;
+    return false;
+  }
+  size_t l_raw = getLE(l_header, 4);
+  size_t l_packed = getLE(l_header + 4, 4);
+  c_tick = getTickLE(l_header + 8);
+  c_packed.resize(l_packed);
+  c_block.resize(l_raw);
+  if (std::fread(c_packed.data(), 1, l_packed, c_file) != l_packed ||
+      !decompressBlock(c_packed.data(), l_packed, c_block.data(), l_raw)) {
+    c_error = true;
+    return false;
+  }
+  c_pos = c_block.data();
+  c_end = c_pos + l_raw;
+  return true;
+}
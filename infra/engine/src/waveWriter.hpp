@@ -0,0 +1,203 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "netStore.hpp"
+#include "simTime.hpp"
+
+namespace ghls {
+
+enum class WaveFormat { vcd, binary };
+
+// Dense handle of a signal declared with a WaveWriter
+using WaveSignal = uint32_t;
+
+struct WaveSignalInfo {
+  std::string name;
+  uint32_t width;
+};
+
+// Streams value changes to a VCD or block-compressed binary waveform file.
+// Each recording thread appends to its own chunk without locking; full chunks
+// are handed to a background thread that formats, compresses and writes them,
+// so recording never waits for the disk.
+//
+// Inside a chunk a change is stored as the tick delta to the previous change,
+// the signal id and the value words, all as varints. Changes from one thread
+// must be recorded in time order. With several recording threads, flush() is
+// the ordering point: it must be called while no thread records (e.g. at a
+// timestep boundary), and the chunks received since the previous flush are
+// merged by time before they are written. A thread that starts recording
+// must do so after a flush(), not in the middle of another thread's epoch.
+//
+// Binary layout: "GHLSWAV1", signal count, then width, name length and name
+// per signal, followed by blocks of {raw size, packed size, first tick, last
+// tick, compressed change records}. The first change of a block is relative
+// to the block's first tick. GHLS_WIDE_SIMTIME builds write "GHLSWAVW" with
+// 16-byte block ticks.
+class WaveWriter {
+ public:
+  WaveWriter();
+  ~WaveWriter();
+  WaveWriter(const WaveWriter&) = delete;
+  WaveWriter& operator=(const WaveWriter&) = delete;
+
+  // Creates f_path, clears the signal table and starts the writer thread.
+  // Returns false if the file cannot be created.
+  bool open(const std::string& f_path, WaveFormat f_format);
+  bool isOpen() const noexcept { return c_file != nullptr; }
+
+  // Signals must be declared before the first change is recorded
+  WaveSignal declare(const std::string& f_name, uint32_t f_width);
+  // Declares a signal that dumpChanges() records whenever f_net changes
+  WaveSignal declareNet(const std::string& f_name, const NetStore& f_nets, NetId f_net);
+  const std::vector<WaveSignalInfo>& signals() const noexcept { return c_signals; }
+
+  // f_words holds one LogicWord per 64 bits of the signal width
+  void change(SimTime f_time, WaveSignal f_signal, const LogicWord* f_words);
+  void change(SimTime f_time, WaveSignal f_signal, LogicWord f_value) {
+    change(f_time, f_signal, &f_value);
+  }
+  // Records the declared nets among f_nets.changed(), call after each commit
+  void dumpChanges(SimTime f_now, const NetStore& f_nets);
+
+  // Hands every partial chunk to the writer thread, see the class comment
+  void flush();
+  // Flushes, waits for the writer thread and closes the file
+  void close();
+
+  uint64_t changesRecorded() const noexcept;
+  // Valid after close()
+  uint64_t bytesWritten() const noexcept { return c_bytesWritten; }
+  uint64_t blocksWritten() const noexcept { return c_blocksWritten; }
+
+ private:
+  struct Chunk {
+    std::vector<uint8_t> data;
+    SimTick firstTick = 0;
+    SimTick lastTick = 0;
+    uint32_t changes = 0;
+    uint32_t producer = 0;
+    // Set when it was the only recording thread, so the chunk needs no merge
+    bool ordered = false;
+  };
+
+  struct Producer {
+    std::unique_ptr<Chunk> chunk;
+    uint32_t index = 0;
+    SimTick lastTick = 0;
+    uint64_t changes = 0;
+  };
+
+  // Queue item, a null chunk marks a flush
+  struct Item {
+    std::unique_ptr<Chunk> chunk;
+  };
+
+  // Change located inside a chunk during an epoch merge
+  struct Change {
+    SimTick tick;
+    uint32_t producer;
+    const uint8_t* begin;
+    const uint8_t* end;
+  };
+
+  Producer& producer();
+  std::unique_ptr<Chunk> takeChunk();
+  void submit(Producer& f_producer);
+  void recycle(std::unique_ptr<Chunk> f_chunk);
+
+  void writerLoop();
+  void writeHeader();
+  void mergeEpoch();
+  // Writes change records whose first delta is relative to f_first
+  void emit(const uint8_t* f_records, const uint8_t* f_end, SimTick f_first, SimTick f_last);
+  void writeVcd(const uint8_t* f_records, const uint8_t* f_end, SimTick f_first);
+  void put(const void* f_data, size_t f_size);
+  // Returns the end of the signal and value part of a record, or null if corrupt
+  const uint8_t* skipRecord(const uint8_t* f_pos, const uint8_t* f_end) const;
+
+  std::FILE* c_file;
+  WaveFormat c_format;
+  uint64_t c_serial;
+  std::vector<WaveSignalInfo> c_signals;
+  std::vector<WaveSignal> c_netSignal;
+  std::vector<LogicWord> c_netWords;
+
+  mutable std::mutex c_producerMutex;
+  std::vector<std::unique_ptr<Producer>> c_producers;
+  std::atomic<uint32_t> c_producerCount;
+
+  std::mutex c_queueMutex;
+  std::condition_variable c_queueReady;
+  std::deque<Item> c_queue;
+  std::vector<std::unique_ptr<Chunk>> c_spare;
+  bool c_closing;
+  std::thread c_writer;
+
+  // Writer thread state
+  std::vector<std::unique_ptr<Chunk>> c_epoch;
+  std::vector<Change> c_merge;
+  std::vector<uint8_t> c_scratch;
+  std::vector<uint8_t> c_packed;
+  std::vector<std::string> c_vcdIds;
+  std::string c_text;
+  bool c_headerDone;
+  SimTick c_vcdTick;
+  bool c_vcdStarted;
+  uint64_t c_bytesWritten;
+  uint64_t c_blocksWritten;
+};
+
+// A decoded change; words points into the reader and stays valid until the
+// next call to next()
+struct WaveChange {
+  SimTick tick;
+  WaveSignal signal;
+  const LogicWord* words;
+};
+
+// Sequential reader for the binary format written by WaveWriter
+class WaveStreamReader {
+ public:
+  WaveStreamReader();
+  ~WaveStreamReader();
+  WaveStreamReader(const WaveStreamReader&) = delete;
+  WaveStreamReader& operator=(const WaveStreamReader&) = delete;
+
+  // Opens f_path and reads the signal table. Returns false if the file cannot
+  // be read or is not a binary waveform.
+  bool open(const std::string& f_path);
+  const std::vector<WaveSignalInfo>& signals() const noexcept { return c_signals; }
+
+  // Returns false at the end of the file or on a corrupt or truncated
+  // block; error() tells the two apart
+  bool next(WaveChange& f_change);
+  bool error() const noexcept { return c_error; }
+  bool eof() const noexcept { return c_eof; }
+
+ private:
+  bool loadBlock();
+
+  std::FILE* c_file;
+  std::vector<WaveSignalInfo> c_signals;
+  std::vector<uint8_t> c_packed;
+  std::vector<uint8_t> c_block;
+  const uint8_t* c_pos;
+  const uint8_t* c_end;
+  SimTick c_tick;
+  std::vector<LogicWord> c_words;
+  bool c_error;
+  bool c_eof;
+};
+
+}  // namespace ghls
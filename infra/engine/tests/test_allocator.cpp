@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <map>
+#include <thread>
+#include <vector>
+#include "../src/allocator.hpp"
+
+using namespace ghls;
+
+TEST_CASE("Arena hands out aligned memory and reuses it after reset") {
+  Arena l_arena(1024);
+  REQUIRE(l_arena.used() == 0);
+  char* l_first = static_cast<char*>(l_arena.allocate(3, 1));
+  void* l_aligned = l_arena.allocate(8, 64);
+  REQUIRE(reinterpret_cast<uintptr_t>(l_aligned) % 64 == 0);
+  // Larger than a block, gets a dedicated block
+  void* l_big = l_arena.allocate(5000);
+  REQUIRE(l_big != nullptr);
+  for (int l_idx = 0; l_idx < 100; ++l_idx) {
+    l_arena.allocate(100);
+  }
+  size_t l_capacity = l_arena.capacity();
+  REQUIRE(l_arena.used() >= 15000);
+
+  l_arena.reset();
+  REQUIRE(l_arena.used() == 0);
+  REQUIRE(static_cast<char*>(l_arena.allocate(3, 1)) == l_first);
+  l_arena.allocate(5000);
+  for (int l_idx = 0; l_idx < 100; ++l_idx) {
+    l_arena.allocate(100);
+  }
+  // The second round fits the blocks kept from the first
+  REQUIRE(l_arena.capacity() == l_capacity);
+}
+
+TEST_CASE("Arena returns memory for zero-byte requests") {
+  Arena l_arena(1024);
+  REQUIRE(l_arena.allocate(0) != nullptr);
+  Arena l_other(1024);
+  l_other.reset();
+  REQUIRE(l_other.allocate(0, 1) != nullptr);
+  REQUIRE(l_other.used() == 0);
+}
+
+TEST_CASE("Arena creates trivially destructible objects") {
+  struct Point {
+    int x;
+    int y;
+  };
+  Arena l_arena;
+  Point* l_point = l_arena.create<Point>(Point{3, 4});
+  REQUIRE(l_point->x == 3);
+  REQUIRE(l_point->y == 4);
+  REQUIRE(reinterpret_cast<uintptr_t>(l_point) % alignof(Point) == 0);
+}
+
+TEST_CASE("threadArena is distinct per thread") {
+  Arena* l_main = &threadArena();
+  Arena* l_other = nullptr;
+  std::thread([&] { l_other = &threadArena(); }).join();
+  REQUIRE(l_main == &threadArena());
+  REQUIRE(l_other != l_main);
+}
+
+TEST_CASE("FixedPool recycles slots") {
+  FixedPool l_pool(24, 4);
+  REQUIRE(l_pool.slotSize() % alignof(std::max_align_t) == 0);
+  std::vector<void*> l_slots;
+  for (int l_idx = 0; l_idx < 10; ++l_idx) {
+    l_slots.push_back(l_pool.allocate());
+  }
+  REQUIRE(l_pool.inUse() == 10);
+  REQUIRE(l_pool.capacity() == 12);
+  void* l_last = l_slots.back();
+  l_pool.deallocate(l_last);
+  REQUIRE(l_pool.allocate() == l_last);
+  for (void* l_slot : l_slots) {
+    l_pool.deallocate(l_slot);
+  }
+  REQUIRE(l_pool.inUse() == 0);
+  REQUIRE(l_pool.capacity() == 12);
+}
+
+TEST_CASE("Standard containers run on the engine allocators") {
+  Arena l_arena;
+  std::vector<int, ArenaAllocator<int>> l_vec{ArenaAllocator<int>(l_arena)};
+  for (int l_idx = 0; l_idx < 1000; ++l_idx) {
+    l_vec.push_back(l_idx);
+  }
+  REQUIRE(l_vec[999] == 999);
+  REQUIRE(l_arena.used() >= 1000 * sizeof(int));
+
+  FixedPool l_pool(64);
+  {
+    using Alloc = PoolAllocator<std::pair<const int, int>>;
+    std::map<int, int, std::less<int>, Alloc> l_map{Alloc(l_pool)};
+    for (int l_idx = 0; l_idx < 500; ++l_idx) {
+      l_map[l_idx] = l_idx * 2;
+    }
+    REQUIRE(l_map.at(250) == 500);
+    REQUIRE(l_pool.inUse() == 500);
+
+    std::list<int, PoolAllocator<int>> l_list{PoolAllocator<int>(l_pool)};
+    l_list.assign(10, 7);
+    REQUIRE(l_pool.inUse() == 510);
+  }
+  REQUIRE(l_pool.inUse() == 0);
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include "../src/blockCodec.hpp"
+
+using namespace ghls;
+
+static std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& f_raw, size_t& f_packed) {
+  std::vector<uint8_t> l_packed;
+  compressBlock(f_raw.data(), f_raw.size(), l_packed);
+  f_packed = l_packed.size();
+  std::vector<uint8_t> l_out(f_raw.size());
+  REQUIRE(decompressBlock(l_packed.data(), l_packed.size(), l_out.data(), l_out.size()));
+  return l_out;
+}
+
+TEST_CASE("Block codec round trips repetitive and random data") {
+  size_t l_packed = 0;
+  std::vector<uint8_t> l_empty;
+  REQUIRE(roundTrip(l_empty, l_packed).empty());
+
+  std::vector<uint8_t> l_small = {1, 2, 3};
+  REQUIRE(roundTrip(l_small, l_packed) == l_small);
+
+  std::vector<uint8_t> l_repeat;
+  for (int l_idx = 0; l_idx < 10000; ++l_idx) {
+    l_repeat.push_back(static_cast<uint8_t>(l_idx % 7));
+  }
+  REQUIRE(roundTrip(l_repeat, l_packed) == l_repeat);
+  REQUIRE(l_packed < l_repeat.size() / 20);
+
+  std::mt19937 l_rng(7);
+  std::vector<uint8_t> l_random(70000);
+  for (uint8_t& l_byte : l_random) {
+    l_byte = static_cast<uint8_t>(l_rng());
+  }
+  REQUIRE(roundTrip(l_random, l_packed) == l_random);
+}
+
+TEST_CASE("Block codec rejects a wrong size or truncated input") {
+  std::vector<uint8_t> l_raw(1000, 42);
+  std::vector<uint8_t> l_packed;
+  compressBlock(l_raw.data(), l_raw.size(), l_packed);
+  std::vector<uint8_t> l_out(l_raw.size());
+  REQUIRE_FALSE(decompressBlock(l_packed.data(), l_packed.size(), l_out.data(), 999));
+  REQUIRE_FALSE(decompressBlock(l_packed.data(), l_packed.size() / 2, l_out.data(), 1000));
+}
+
+TEST_CASE("Varints round trip at the encoding boundaries") {
+  std::vector<uint64_t> l_values = {0, 1, 127, 128, 16383, 16384, UINT64_MAX};
+  std::vector<uint8_t> l_bytes;
+  for (uint64_t l_value : l_values) {
+    putVarint(l_bytes, l_value);
+  }
+  const uint8_t* l_pos = l_bytes.data();
+  const uint8_t* l_end = l_pos + l_bytes.size();
+  for (uint64_t l_value : l_values) {
+    uint64_t l_read = 0;
+    REQUIRE(getVarint(l_pos, l_end, l_read));
+    REQUIRE(l_read == l_value);
+  }
+  REQUIRE(l_pos == l_end);
+  uint64_t l_read = 0;
+  REQUIRE_FALSE(getVarint(l_pos, l_end, l_read));
+}
+
+TEST_CASE("Tick varints cover the full SimTick range") {
+  std::vector<SimTick> l_values = {0, 127, 128, UINT64_MAX, kMaxSimTick};
+  std::vector<uint8_t> l_bytes;
+  for (SimTick l_value : l_values) {
+    putTicks(l_bytes, l_value);
+  }
+  const uint8_t* l_pos = l_bytes.data();
+  const uint8_t* l_end = l_pos + l_bytes.size();
+  for (SimTick l_value : l_values) {
+    SimTick l_read = 0;
+    REQUIRE(getTicks(l_pos, l_end, l_read));
+    REQUIRE(l_read == l_value);
+  }
+  REQUIRE(l_pos == l_end);
+
+  // Values that fit 64 bits are interchangeable with putVarint()
+  std::vector<uint8_t> l_narrow;
+  std::vector<uint8_t> l_wide;
+  putVarint(l_narrow, 1234567890123ULL);
+  putTicks(l_wide, 1234567890123ULL);
+  REQUIRE(l_narrow == l_wide);
+}
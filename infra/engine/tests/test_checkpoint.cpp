@@ -0,0 +1,233 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include "../src/blockCodec.hpp"
+#include "../src/checkpoint.hpp"
+#include "../src/compiledSim.hpp"
+
+using namespace ghls;
+
+static std::string tempPath(const char* f_name) {
+  return (std::filesystem::temp_directory_path() / f_name).string();
+}
+
+namespace {
+
+// Counter with an enable input: q' = en ? q + 1 : q, 4 bits wide, plus a
+// user process that toggles the enable through payload events
+struct Design {
+  Netlist netlist;
+  NetId en;
+  NetId q[4];
+
+  Design() {
+    en = netlist.addNet(1, Logic::one);
+    for (NetId& l_q : q) {
+      l_q = netlist.addNet(1, Logic::zero);
+    }
+    NetId l_carry = en;
+    for (NetId l_q : q) {
+      NetId l_d = netlist.addNet();
+      NetId l_next = netlist.addNet();
+      netlist.addGate(GateOp::xor2, l_d, l_q, l_carry);
+      netlist.addGate(GateOp::and2, l_next, l_q, l_carry);
+      netlist.addFlop(l_d, l_q);
+      l_carry = l_next;
+    }
+  }
+};
+
+struct Toggler {
+  Scheduler* sched;
+  CompiledSim* sim;
+  NetId net;
+  uint64_t toggles = 0;
+};
+
+struct Toggle {
+  uint64_t value;
+  uint64_t period;
+};
+
+void onToggle(void* f_ctx, uint64_t f_arg) {
+  Toggler* l_toggler = static_cast<Toggler*>(f_ctx);
+  const Toggle* l_toggle = reinterpret_cast<const Toggle*>(f_arg);
+  l_toggler->sim->setInput(l_toggler->net, {l_toggle->value, 0});
+  ++l_toggler->toggles;
+  void* l_next = l_toggler->sched->schedulePayload(SimTime::fromTicks(l_toggle->period),
+                                                    onToggle, l_toggler, sizeof(Toggle));
+  *static_cast<Toggle*>(l_next) = Toggle{l_toggle->value ^ 1, l_toggle->period};
+}
+
+// One simulation instance with everything registered for checkpoints
+struct Instance {
+  Scheduler sched;
+  CompiledSim sim;
+  Toggler toggler;
+  Checkpointer cp;
+
+  explicit Instance(const Design& f_design)
+      : sim(f_design.netlist, sched), toggler{&sched, &sim, f_design.en}, cp(sched) {
+    sim.addClock(Clock(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)), 0);
+    void* l_first = sched.schedulePayload(SimTime(33.0, SimTimeUnit::ns), onToggle, &toggler,
+                                          sizeof(Toggle));
+    *static_cast<Toggle*>(l_first) = Toggle{0, SimTime(47.0, SimTimeUnit::ns).ticks()};
+    sim.checkpoint(cp, "cpu");
+    cp.addEvent("toggle", onToggle);
+    cp.addContext("toggler", &toggler);
+    cp.addState(
+        "toggles", &toggler,
+        [](const void* f_ctx, std::vector<uint8_t>& f_out) {
+          putVarint(f_out, static_cast<const Toggler*>(f_ctx)->toggles);
+        },
+        [](void* f_ctx, const uint8_t* f_data, size_t f_size) {
+          return getVarint(f_data, f_data + f_size, static_cast<Toggler*>(f_ctx)->toggles);
+        });
+  }
+
+  uint64_t count(const Design& f_design) const {
+    uint64_t l_count = 0;
+    for (unsigned l_bit = 0; l_bit < 4; ++l_bit) {
+      l_count |= sim.value(f_design.q[l_bit]).aval << l_bit;
+    }
+    return l_count;
+  }
+};
+
+}  // namespace
+
+TEST_CASE("Checkpointer restores a run that continues identically") {
+  Design l_design;
+  std::string l_path = tempPath("ghls_test_checkpoint.ghck");
+  for (bool l_async : {false, true}) {
+    Instance l_first(l_design);
+    l_first.sched.runUntil(SimTime(200.0, SimTimeUnit::ns));
+    REQUIRE((l_async ? l_first.cp.saveAsync(l_path) : l_first.cp.save(l_path)));
+    // The original keeps running while a forked child writes
+    l_first.sched.runUntil(SimTime(700.0, SimTimeUnit::ns));
+    REQUIRE(l_first.cp.wait());
+    REQUIRE(l_first.cp.saved() == 1);
+
+    Instance l_second(l_design);
+    l_second.sched.runUntil(SimTime(15.0, SimTimeUnit::ns));
+    REQUIRE(l_second.cp.restore(l_path));
+    REQUIRE(l_second.sched.now() == SimTime(200.0, SimTimeUnit::ns));
+    REQUIRE(l_second.sched.pending() == 2);
+    l_second.sched.runUntil(SimTime(700.0, SimTimeUnit::ns));
+    REQUIRE(l_second.toggler.toggles == l_first.toggler.toggles);
+    REQUIRE(l_second.count(l_design) == l_first.count(l_design));
+    for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+      REQUIRE(l_second.sim.value(l_net) == l_first.sim.value(l_net));
+    }
+  }
+  std::filesystem::remove(l_path);
+}
+
+TEST_CASE("Checkpointer restores event-driven state mid-propagation") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet(8, Logic::zero);
+  NetId l_b = l_nl.addNet(8, Logic::zero);
+  NetId l_c = l_nl.addNet(8);
+  NetId l_d = l_nl.addNet(8);
+  l_nl.addGate(GateOp::xor2, l_c, l_a, l_b);
+  l_nl.addGate(GateOp::inv, l_d, l_c);
+  std::string l_path = tempPath("ghls_test_checkpoint_event.ghck");
+
+  Scheduler l_sched;
+  EventSim l_sim(l_nl, l_sched);
+  Checkpointer l_cp(l_sched);
+  l_sim.checkpoint(l_cp, "top");
+  l_sched.run();
+  // Uncommitted write and a queued delta event go into the snapshot
+  l_sim.setInput(l_a, {0x5a, 0});
+  REQUIRE(l_cp.save(l_path));
+
+  Scheduler l_other;
+  EventSim l_copy(l_nl, l_other);
+  Checkpointer l_copyCp(l_other);
+  l_copy.checkpoint(l_copyCp, "top");
+  REQUIRE(l_copyCp.restore(l_path));
+  l_other.run();
+  REQUIRE(l_copy.value(l_d) == LogicWord{0xa5, 0});
+  std::filesystem::remove(l_path);
+}
+
+TEST_CASE("Checkpointer rejects what it cannot represent or read") {
+  Design l_design;
+  std::string l_path = tempPath("ghls_test_checkpoint_bad.ghck");
+  Instance l_inst(l_design);
+  l_inst.sched.schedule(SimTime(1.0, SimTimeUnit::ns), [](void*, uint64_t) {});
+  REQUIRE_FALSE(l_inst.cp.save(l_path));
+  REQUIRE_FALSE(std::filesystem::exists(l_path));
+  REQUIRE(l_inst.cp.failed() == 1);
+  // Clocks never run out of events, so run past the unregistered one
+  l_inst.sched.runUntil(SimTime(50.0, SimTimeUnit::ns));
+  REQUIRE(l_inst.cp.save(l_path));
+
+  // Truncated file
+  std::filesystem::resize_file(l_path, std::filesystem::file_size(l_path) - 3);
+  Instance l_other(l_design);
+  size_t l_pending = l_other.sched.pending();
+  REQUIRE_FALSE(l_other.cp.restore(l_path));
+  REQUIRE(l_other.sched.pending() == l_pending);
+
+  // Raw size of the first section, after the magic, state count and empty
+  // name, claiming far more than its packed bytes can hold
+  REQUIRE(l_inst.cp.save(l_path));
+  {
+    std::FILE* l_file = std::fopen(l_path.c_str(), "rb");
+    std::vector<uint8_t> l_bytes(std::filesystem::file_size(l_path));
+    REQUIRE(std::fread(l_bytes.data(), 1, l_bytes.size(), l_file) == l_bytes.size());
+    std::fclose(l_file);
+    const uint8_t* l_pos = l_bytes.data() + 10;
+    const uint8_t* l_end = l_bytes.data() + l_bytes.size();
+    uint64_t l_rawSize;
+    REQUIRE(getVarint(l_pos, l_end, l_rawSize));
+    std::vector<uint8_t> l_corrupt(l_bytes.data(), l_bytes.data() + 10);
+    putVarint(l_corrupt, uint64_t(1) << 62);
+    l_corrupt.insert(l_corrupt.end(), l_pos, l_end);
+    l_file = std::fopen(l_path.c_str(), "wb");
+    std::fwrite(l_corrupt.data(), 1, l_corrupt.size(), l_file);
+    std::fclose(l_file);
+  }
+  REQUIRE_FALSE(l_other.cp.restore(l_path));
+  REQUIRE(l_other.sched.pending() == l_pending);
+
+  // A design registering different names
+  REQUIRE(l_inst.cp.save(l_path));
+  Scheduler l_sched;
+  CompiledSim l_sim(l_design.netlist, l_sched);
+  Checkpointer l_cp(l_sched);
+  l_sim.checkpoint(l_cp, "gpu");
+  REQUIRE_FALSE(l_cp.restore(l_path));
+  REQUIRE_FALSE(l_cp.restore(tempPath("ghls_test_checkpoint_missing.ghck")));
+  std::filesystem::remove(l_path);
+}
+
+TEST_CASE("Checkpointer keeps a bounded set of periodic snapshots") {
+  Design l_design;
+  std::filesystem::path l_dir = std::filesystem::temp_directory_path() / "ghls_test_periodic";
+  std::filesystem::remove_all(l_dir);
+  std::filesystem::create_directories(l_dir);
+  for (bool l_async : {false, true}) {
+    Instance l_inst(l_design);
+    l_inst.cp.setPeriodic(SimTime(100.0, SimTimeUnit::ns), l_dir.string(), 3, l_async);
+    l_inst.cp.runUntil(SimTime(1050.0, SimTimeUnit::ns));
+    REQUIRE(l_inst.sched.now() == SimTime(1050.0, SimTimeUnit::ns));
+    REQUIRE(l_inst.cp.wait());
+    REQUIRE(l_inst.cp.saved() == 10);
+    REQUIRE(l_inst.cp.kept().size() == 3);
+    size_t l_files = std::distance(std::filesystem::directory_iterator(l_dir),
+                                   std::filesystem::directory_iterator());
+    REQUIRE(l_files == 3);
+
+    // The newest snapshot resumes at 1000 ns and catches up with the original
+    Instance l_resumed(l_design);
+    REQUIRE(l_resumed.cp.restore(l_inst.cp.kept().back()));
+    REQUIRE(l_resumed.sched.now() == SimTime(1000.0, SimTimeUnit::ns));
+    l_resumed.sched.runUntil(SimTime(1050.0, SimTimeUnit::ns));
+    REQUIRE(l_resumed.count(l_design) == l_inst.count(l_design));
+  }
+  std::filesystem::remove_all(l_dir);
+}
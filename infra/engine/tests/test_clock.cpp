@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include "../src/clock.hpp"
+
+using namespace ghls;
+
+TEST_CASE("Clock generates alternating rising and falling edges") {
+  Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(4.0, SimTimeUnit::ns),
+              SimTime(1.0, SimTimeUnit::ns));
+  ClockEdge l_edge = l_clk.nextEdge();
+  REQUIRE(l_edge.rising);
+  REQUIRE(l_edge.cycle == 0);
+  REQUIRE(l_edge.time == SimTime(1.0, SimTimeUnit::ns));
+  l_edge = l_clk.nextEdge();
+  REQUIRE_FALSE(l_edge.rising);
+  REQUIRE(l_edge.time == SimTime(5.0, SimTimeUnit::ns));
+  l_edge = l_clk.nextEdge();
+  REQUIRE(l_edge.rising);
+  REQUIRE(l_edge.cycle == 1);
+  REQUIRE(l_edge.time == SimTime(11.0, SimTimeUnit::ns));
+  REQUIRE(l_clk.peekEdge().time == SimTime(15.0, SimTimeUnit::ns));
+  REQUIRE(l_clk.risingEdge(7) == SimTime(71.0, SimTimeUnit::ns));
+}
+
+TEST_CASE("Clock edges do not drift over many cycles") {
+  SimTime l_period(1.25, SimTimeUnit::ns);
+  Clock l_clk(l_period, SimTime(0.625, SimTimeUnit::ns));
+  ClockEdge l_edge{};
+  for (uint64_t l_idx = 0; l_idx < 2000001; ++l_idx) {
+    l_edge = l_clk.nextEdge();
+  }
+  REQUIRE(l_edge.rising);
+  REQUIRE(l_edge.cycle == 1000000);
+  REQUIRE(l_edge.time == l_period * 1000000);
+  REQUIRE(l_edge.time == SimTime(1.25, SimTimeUnit::ms));
+}
+
+TEST_CASE("Clock resetTo lands on the first edge at or after the time") {
+  Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+              SimTime(2.0, SimTimeUnit::ns));
+  l_clk.resetTo(SimTime(0.0, SimTimeUnit::ns));
+  REQUIRE(l_clk.peekEdge().time == SimTime(2.0, SimTimeUnit::ns));
+  l_clk.resetTo(SimTime(32.0, SimTimeUnit::ns));
+  REQUIRE(l_clk.peekEdge().rising);
+  REQUIRE(l_clk.peekEdge().cycle == 3);
+  REQUIRE(l_clk.peekEdge().time == SimTime(32.0, SimTimeUnit::ns));
+  l_clk.resetTo(SimTime(33.0, SimTimeUnit::ns));
+  REQUIRE_FALSE(l_clk.peekEdge().rising);
+  REQUIRE(l_clk.peekEdge().time == SimTime(37.0, SimTimeUnit::ns));
+  l_clk.resetTo(SimTime(38.0, SimTimeUnit::ns));
+  REQUIRE(l_clk.peekEdge().rising);
+  REQUIRE(l_clk.peekEdge().cycle == 4);
+  REQUIRE(l_clk.peekEdge().time == SimTime(42.0, SimTimeUnit::ns));
+}
+
+TEST_CASE("periodRatio reduces rational clock ratios") {
+  Clock l_fast(SimTime(1.25, SimTimeUnit::ns), SimTime(0.5, SimTimeUnit::ns));
+  Clock l_slow(SimTime(3.0, SimTimeUnit::ns), SimTime(1.5, SimTimeUnit::ns));
+  REQUIRE((periodRatio(l_fast, l_slow) == std::make_pair(SimTick(5), SimTick(12))));
+  REQUIRE((periodRatio(l_slow, l_slow) == std::make_pair(SimTick(1), SimTick(1))));
+}
+
+#if GHLS_WIDE_SIMTIME
+TEST_CASE("Clock ratios and hyperperiods use the full wide tick range") {
+  // Coprime periods whose product does not fit in 64 bits
+  const SimTick l_a = (SimTick(1) << 40) + 1;
+  const SimTick l_b = SimTick(1) << 40;
+  Clock l_lhs(SimTime::fromTicks(l_a << 30), SimTime::fromTicks(l_a));
+  Clock l_rhs(SimTime::fromTicks(l_b << 30), SimTime::fromTicks(l_b));
+  REQUIRE((periodRatio(l_lhs, l_rhs) == std::make_pair(l_a, l_b)));
+
+  ClockSet l_set;
+  l_set.add(Clock(SimTime::fromTicks(l_a), SimTime::fromTicks(1)));
+  l_set.add(Clock(SimTime::fromTicks(l_b), SimTime::fromTicks(1)));
+  std::optional<SimTime> l_hyper = l_set.hyperperiod();
+  REQUIRE(l_hyper.has_value());
+  REQUIRE((l_hyper->ticks() == l_a * l_b));
+}
+#endif
+
+TEST_CASE("ClockSet merges domains in time order") {
+  std::vector<Clock> l_clocks = {
+      Clock(SimTime(1.25, SimTimeUnit::ns), SimTime(0.5, SimTimeUnit::ns)),
+      Clock(SimTime(3.0, SimTimeUnit::ns), SimTime(1.5, SimTimeUnit::ns),
+            SimTime(0.25, SimTimeUnit::ns)),
+      Clock(SimTime(2.5, SimTimeUnit::ns), SimTime(1.25, SimTimeUnit::ns)),
+      Clock(SimTime(7.0, SimTimeUnit::ns), SimTime(1.0, SimTimeUnit::ns),
+            SimTime(3.0, SimTimeUnit::ns)),
+  };
+  ClockSet l_set;
+  for (const Clock& l_clock : l_clocks) {
+    l_set.add(l_clock);
+  }
+  REQUIRE(l_set.size() == 4);
+  REQUIRE(l_set.hyperperiod() == SimTime(105.0, SimTimeUnit::ns));
+
+  SECTION("matches a brute-force scan over all domains") {
+    for (int l_idx = 0; l_idx < 1000; ++l_idx) {
+      size_t l_best = 0;
+      for (size_t l_domain = 1; l_domain < l_clocks.size(); ++l_domain) {
+        if (l_clocks[l_domain].peekEdge().time < l_clocks[l_best].peekEdge().time) {
+          l_best = l_domain;
+        }
+      }
+      ClockEdge l_expected = l_clocks[l_best].nextEdge();
+      DomainEdge l_got = l_set.pop();
+      REQUIRE(l_got.domain == l_best);
+      REQUIRE(l_got.edge.time == l_expected.time);
+      REQUIRE(l_got.edge.rising == l_expected.rising);
+      REQUIRE(l_got.edge.cycle == l_expected.cycle);
+    }
+  }
+
+  SECTION("pattern repeats after the hyperperiod") {
+    std::vector<DomainEdge> l_first;
+    SimTime l_hyper = *l_set.hyperperiod();
+    while (l_set.peek().edge.time < l_hyper) {
+      l_first.push_back(l_set.pop());
+    }
+    for (const DomainEdge& l_prev : l_first) {
+      DomainEdge l_next = l_set.pop();
+      REQUIRE(l_next.domain == l_prev.domain);
+      REQUIRE(l_next.edge.time == l_prev.edge.time + l_hyper);
+      REQUIRE(l_next.edge.rising == l_prev.edge.rising);
+    }
+  }
+
+  SECTION("resetTo repositions every domain") {
+    l_set.resetTo(SimTime(100.0, SimTimeUnit::ns));
+    DomainEdge l_edge = l_set.peek();
+    REQUIRE(l_edge.domain == 0);
+    REQUIRE(l_edge.edge.time == SimTime(100.0, SimTimeUnit::ns));
+    REQUIRE(l_edge.edge.cycle == 80);
+  }
+}
@@ -0,0 +1,414 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include "../src/checkpoint.hpp"
+#include "../src/compiledSim.hpp"
+#include "../src/profiler.hpp"
+
+using namespace ghls;
+
+namespace {
+
+// Random layered design: inputs and flop outputs feed a DAG of gates whose
+// later outputs drive the flops
+struct RandomDesign {
+  Netlist netlist;
+  std::vector<NetId> inputs;
+};
+
+RandomDesign makeDesign(uint32_t f_seed, uint32_t f_width) {
+  std::mt19937 l_rng(f_seed);
+  RandomDesign l_design;
+  Netlist& l_nl = l_design.netlist;
+  std::vector<NetId> l_sources;
+  for (int l_idx = 0; l_idx < 8; ++l_idx) {
+    l_design.inputs.push_back(l_nl.addNet(f_width, Logic::zero));
+    l_sources.push_back(l_design.inputs.back());
+  }
+  std::vector<NetId> l_qs;
+  for (int l_idx = 0; l_idx < 16; ++l_idx) {
+    l_qs.push_back(l_nl.addNet(f_width, l_idx % 3 == 0 ? Logic::x : Logic::zero));
+    l_sources.push_back(l_qs.back());
+  }
+  for (int l_idx = 0; l_idx < 300; ++l_idx) {
+    GateOp l_op = static_cast<GateOp>(l_rng() % 9);
+    NetId l_out = l_nl.addNet(f_width);
+    // Operands come from the last 40 nets so the cones get deep
+    auto l_pick = [&] {
+      return l_sources[l_sources.size() - 1 - l_rng() % std::min<size_t>(40, l_sources.size())];
+    };
+    l_nl.addGate(l_op, l_out, l_pick(), l_pick(), l_pick());
+    l_sources.push_back(l_out);
+  }
+  for (size_t l_idx = 0; l_idx < l_qs.size(); ++l_idx) {
+    l_nl.addFlop(l_sources[l_sources.size() - 1 - l_idx * 7], l_qs[l_idx], l_idx % 2);
+  }
+  return l_design;
+}
+
+}  // namespace
+
+TEST_CASE("CompiledSim counts with flops and a levelized cone") {
+  // Two-bit counter: q0' = ~q0, q1' = q1 ^ q0
+  Netlist l_nl;
+  NetId l_q0 = l_nl.addNet(1, Logic::zero);
+  NetId l_q1 = l_nl.addNet(1, Logic::zero);
+  NetId l_d0 = l_nl.addNet();
+  NetId l_d1 = l_nl.addNet();
+  l_nl.addGate(GateOp::xor2, l_d1, l_q1, l_q0);
+  l_nl.addGate(GateOp::inv, l_d0, l_q0);
+  l_nl.addFlop(l_d0, l_q0);
+  l_nl.addFlop(l_d1, l_q1);
+
+  Scheduler l_sched;
+  CompiledSim l_sim(l_nl, l_sched);
+  REQUIRE(l_sim.compiled());
+  REQUIRE(l_sim.instructions() == 2);
+  REQUIRE(l_sim.levels() == 1);
+  Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+              SimTime(10.0, SimTimeUnit::ns));
+  l_sim.addClock(l_clk, 0);
+  for (uint64_t l_cycle = 1; l_cycle <= 6; ++l_cycle) {
+    l_sched.runUntil(SimTime(10.0, SimTimeUnit::ns) * l_cycle);
+    uint64_t l_count = l_sim.value(l_q0).aval | (l_sim.value(l_q1).aval << 1);
+    REQUIRE(l_count == l_cycle % 4);
+  }
+}
+
+TEST_CASE("CompiledSim names its events in profiles") {
+  Netlist l_nl;
+  NetId l_in = l_nl.addNet(1, Logic::zero);
+  NetId l_q = l_nl.addNet(1, Logic::zero);
+  l_nl.addFlop(l_in, l_q);
+  Scheduler l_sched;
+  CompiledSim l_sim(l_nl, l_sched);
+  l_sim.addClock(Clock(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)), 0);
+  Profiler l_profiler(l_sched);
+  l_sim.nameEvents(l_profiler, "top");
+  l_profiler.enable();
+  l_sched.runUntil(SimTime(12.0, SimTimeUnit::ns));
+  l_sim.setInput(l_in, {1, 0});
+  l_sched.runUntil(SimTime(35.0, SimTimeUnit::ns));
+  l_profiler.disable();
+
+  std::vector<Profiler::ProcessStats> l_stats = l_profiler.processes();
+  auto l_events = [&](const std::string& f_name) {
+    auto l_it = std::find_if(l_stats.begin(), l_stats.end(),
+                             [&](const Profiler::ProcessStats& f_s) { return f_s.name == f_name; });
+    return l_it == l_stats.end() ? uint64_t(0) : l_it->events;
+  };
+  REQUIRE(l_events("top.clock") == 4);
+  REQUIRE(l_events("top.input") == 1);
+  REQUIRE(l_stats.size() == 2);
+}
+
+TEST_CASE("CompiledSim rejects combinational loops") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet();
+  NetId l_b = l_nl.addNet();
+  l_nl.addGate(GateOp::inv, l_b, l_a);
+  l_nl.addGate(GateOp::inv, l_a, l_b);
+  Scheduler l_sched;
+  CompiledSim l_sim(l_nl, l_sched);
+  REQUIRE_FALSE(l_sim.compiled());
+}
+
+TEST_CASE("CompiledSim matches event-driven simulation cycle by cycle") {
+  for (uint32_t l_width : {1u, 13u, 64u}) {
+    RandomDesign l_design = makeDesign(42 + l_width, l_width);
+    Scheduler l_eventSched;
+    Scheduler l_compiledSched;
+    EventSim l_event(l_design.netlist, l_eventSched);
+    CompiledSim l_compiled(l_design.netlist, l_compiledSched);
+    REQUIRE(l_compiled.compiled());
+    // Two domains with unrelated periods
+    Clock l_fast(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+                 SimTime(10.0, SimTimeUnit::ns));
+    Clock l_slow(SimTime(25.0, SimTimeUnit::ns), SimTime(10.0, SimTimeUnit::ns),
+                 SimTime(3.0, SimTimeUnit::ns));
+    l_event.addClock(l_fast, 0);
+    l_event.addClock(l_slow, 1);
+    l_compiled.addClock(l_fast, 0);
+    l_compiled.addClock(l_slow, 1);
+
+    std::mt19937_64 l_rng(l_width);
+    for (uint64_t l_step = 1; l_step <= 100; ++l_step) {
+      // Inputs change between clock edges
+      SimTime l_at = SimTime(10.0, SimTimeUnit::ns) * l_step + SimTime(1.0, SimTimeUnit::ns);
+      l_eventSched.runUntil(l_at);
+      l_compiledSched.runUntil(l_at);
+      NetId l_input = l_design.inputs[l_rng() % l_design.inputs.size()];
+      LogicWord l_value{l_rng(), l_step % 17 == 0 ? l_rng() : 0};
+      l_event.setInput(l_input, l_value);
+      l_compiled.setInput(l_input, l_value);
+      SimTime l_end = l_at + SimTime(8.0, SimTimeUnit::ns);
+      l_eventSched.runUntil(l_end);
+      l_compiledSched.runUntil(l_end);
+      for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+        REQUIRE(l_event.value(l_net) == l_compiled.value(l_net));
+      }
+    }
+    // The compiled program never evaluates a gate more than once per pass
+    REQUIRE(l_compiled.passes() < l_eventSched.deltaCycles());
+  }
+}
+
+TEST_CASE("CompiledSim samples pre-edge values across coinciding domains") {
+  // Synchronizer chain hopping between domains: in -> q0 (0) -> q1 (1) -> q2 (0)
+  Netlist l_nl;
+  NetId l_in = l_nl.addNet(1, Logic::zero);
+  NetId l_q0 = l_nl.addNet(1, Logic::zero);
+  NetId l_q1 = l_nl.addNet(1, Logic::zero);
+  NetId l_q2 = l_nl.addNet(1, Logic::zero);
+  l_nl.addFlop(l_in, l_q0, 0);
+  l_nl.addFlop(l_q0, l_q1, 1);
+  l_nl.addFlop(l_q1, l_q2, 0);
+
+  Scheduler l_eventSched;
+  Scheduler l_compiledSched;
+  EventSim l_event(l_nl, l_eventSched);
+  CompiledSim l_compiled(l_nl, l_compiledSched);
+  // Every rising edge of the 20 ns clock coincides with one of the 10 ns clock
+  Clock l_fast(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+               SimTime(10.0, SimTimeUnit::ns));
+  Clock l_slow(SimTime(20.0, SimTimeUnit::ns), SimTime(10.0, SimTimeUnit::ns),
+               SimTime(20.0, SimTimeUnit::ns));
+  l_event.addClock(l_fast, 0);
+  l_event.addClock(l_slow, 1);
+  l_compiled.addClock(l_fast, 0);
+  l_compiled.addClock(l_slow, 1);
+  l_event.setInput(l_in, {1, 0});
+  l_compiled.setInput(l_in, {1, 0});
+
+  for (uint64_t l_step = 1; l_step <= 12; ++l_step) {
+    SimTime l_at = SimTime(10.0, SimTimeUnit::ns) * l_step + SimTime(1.0, SimTimeUnit::ns);
+    if (l_step == 6) {
+      l_event.setInput(l_in, {0, 0});
+      l_compiled.setInput(l_in, {0, 0});
+    }
+    l_eventSched.runUntil(l_at);
+    l_compiledSched.runUntil(l_at);
+    for (NetId l_net = 0; l_net < l_nl.nets(); ++l_net) {
+      REQUIRE(l_event.value(l_net) == l_compiled.value(l_net));
+    }
+  }
+  // One domain fed by another on the same clock still takes a cycle per stage
+  Scheduler l_sched;
+  CompiledSim l_same(l_nl, l_sched);
+  l_same.addClock(l_fast, 0);
+  l_same.addClock(l_fast, 1);
+  l_same.setInput(l_in, {1, 0});
+  l_sched.runUntil(SimTime(11.0, SimTimeUnit::ns));
+  REQUIRE(l_same.value(l_q0).aval == 1);
+  REQUIRE(l_same.value(l_q1).aval == 0);
+}
+
+TEST_CASE("CompiledSim commits inputs after edges at the same time") {
+  Netlist l_nl;
+  NetId l_in = l_nl.addNet(1, Logic::zero);
+  NetId l_q = l_nl.addNet(1, Logic::zero);
+  l_nl.addFlop(l_in, l_q);
+  const Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+                    SimTime(10.0, SimTimeUnit::ns));
+
+  Scheduler l_eventSched;
+  Scheduler l_compiledSched;
+  EventSim l_event(l_nl, l_eventSched);
+  CompiledSim l_compiled(l_nl, l_compiledSched);
+  // Input events queued ahead of the first edge, so they share its delta cycle
+  struct Drive {
+    EventSim* event;
+    CompiledSim* compiled;
+    NetId net;
+  };
+  auto l_set = [](void* f_ctx, uint64_t f_value) {
+    Drive* l_d = static_cast<Drive*>(f_ctx);
+    if (l_d->event != nullptr) {
+      l_d->event->setInput(l_d->net, {f_value, 0});
+    } else {
+      l_d->compiled->setInput(l_d->net, {f_value, 0});
+    }
+  };
+  Drive l_toEvent{&l_event, nullptr, l_in};
+  Drive l_toCompiled{nullptr, &l_compiled, l_in};
+  l_eventSched.scheduleAt(SimTime(10.0, SimTimeUnit::ns), l_set, &l_toEvent, 1);
+  l_compiledSched.scheduleAt(SimTime(10.0, SimTimeUnit::ns), l_set, &l_toCompiled, 1);
+  l_event.addClock(l_clk, 0);
+  l_compiled.addClock(l_clk, 0);
+
+  for (uint64_t l_step = 1; l_step <= 3; ++l_step) {
+    SimTime l_at = SimTime(10.0, SimTimeUnit::ns) * l_step + SimTime(1.0, SimTimeUnit::ns);
+    l_eventSched.runUntil(l_at);
+    l_compiledSched.runUntil(l_at);
+    REQUIRE(l_compiled.value(l_q) == l_event.value(l_q));
+    REQUIRE(l_compiled.value(l_q).aval == (l_step > 1 ? 1u : 0u));
+  }
+}
+
+TEST_CASE("CompiledSim fast-forwards over idle stretches") {
+  // Counter with enable in domain 0, four stage shift register in domain 1
+  Netlist l_nl;
+  NetId l_en = l_nl.addNet(1, Logic::zero);
+  NetId l_din = l_nl.addNet(1, Logic::zero);
+  std::vector<NetId> l_watch;
+  NetId l_carry = l_en;
+  for (int l_bit = 0; l_bit < 4; ++l_bit) {
+    NetId l_q = l_nl.addNet(1, Logic::zero);
+    NetId l_d = l_nl.addNet();
+    NetId l_next = l_nl.addNet();
+    l_nl.addGate(GateOp::xor2, l_d, l_q, l_carry);
+    l_nl.addGate(GateOp::and2, l_next, l_q, l_carry);
+    l_nl.addFlop(l_d, l_q, 0);
+    l_watch.push_back(l_q);
+    l_carry = l_next;
+  }
+  NetId l_prev = l_din;
+  for (int l_stage = 0; l_stage < 4; ++l_stage) {
+    NetId l_q = l_nl.addNet(1, Logic::zero);
+    l_nl.addFlop(l_prev, l_q, 1);
+    l_watch.push_back(l_q);
+    l_prev = l_q;
+  }
+
+  Scheduler l_refSched;
+  Scheduler l_ffSched;
+  CompiledSim l_ref(l_nl, l_refSched);
+  CompiledSim l_ff(l_nl, l_ffSched);
+  l_ff.setFastForward(true);
+  for (CompiledSim* l_sim : {&l_ref, &l_ff}) {
+    l_sim->addClock(Clock(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)), 0);
+    l_sim->addClock(Clock(SimTime(25.0, SimTimeUnit::ns), SimTime(10.0, SimTimeUnit::ns),
+                          SimTime(3.0, SimTimeUnit::ns)),
+                    1);
+  }
+  // Bursts of activity separated by long idle stretches
+  struct Drive {
+    double at;
+    NetId net;
+    uint64_t value;
+  };
+  std::vector<Drive> l_drives = {{1, l_en, 1},       {2, l_din, 1},      {61, l_din, 0},
+                                 {101, l_en, 0},     {50007, l_en, 1},   {50011, l_din, 1},
+                                 {50088, l_en, 0},   {50092, l_din, 0},  {123456, l_en, 1},
+                                 {123500, l_en, 0}};
+  auto l_check = [&] {
+    for (NetId l_net : l_watch) {
+      REQUIRE(l_ff.value(l_net) == l_ref.value(l_net));
+    }
+  };
+  for (const Drive& l_drive : l_drives) {
+    SimTime l_at(l_drive.at, SimTimeUnit::ns);
+    // Sample a few points before each drive, idle or not
+    for (double l_back : {997.0, 31.0, 0.5}) {
+      if (l_drive.at > l_back) {
+        l_refSched.runUntil(SimTime(l_drive.at - l_back, SimTimeUnit::ns));
+        l_ffSched.runUntil(SimTime(l_drive.at - l_back, SimTimeUnit::ns));
+        l_check();
+      }
+    }
+    l_refSched.runUntil(l_at);
+    l_ffSched.runUntil(l_at);
+    l_ref.setInput(l_drive.net, {l_drive.value, 0});
+    l_ff.setInput(l_drive.net, {l_drive.value, 0});
+    // Every cycle after waking stays on the original edge grid
+    for (int l_cycle = 1; l_cycle <= 12; ++l_cycle) {
+      SimTime l_step = l_at + SimTime(7.0, SimTimeUnit::ns) * l_cycle;
+      l_refSched.runUntil(l_step);
+      l_ffSched.runUntil(l_step);
+      l_check();
+    }
+  }
+  SimTime l_end(200000.0, SimTimeUnit::ns);
+  l_refSched.runUntil(l_end);
+  l_ffSched.runUntil(l_end);
+  l_check();
+
+  REQUIRE(l_ref.fastForwards() == 0);
+  REQUIRE(l_ref.skippedEdges() == 0);
+  // Asleep through the three long gaps, the last one up to the end
+  REQUIRE(l_ff.fastForwards() == 2);
+  REQUIRE(l_ff.skippedTime() > SimTime(190000.0, SimTimeUnit::ns));
+  // Edges are counted when the clocks resume, the first two gaps only
+  REQUIRE(l_ff.skippedEdges() > 10000);
+  REQUIRE(l_ffSched.eventsExecuted() * 20 < l_refSched.eventsExecuted());
+
+  SECTION("parked clocks survive a checkpoint") {
+    std::string l_path =
+        (std::filesystem::temp_directory_path() / "ghls_test_fast_forward.ghck").string();
+    Checkpointer l_cp(l_ffSched);
+    l_ff.checkpoint(l_cp, "sim");
+    REQUIRE(l_cp.save(l_path));
+
+    Scheduler l_sched;
+    CompiledSim l_restored(l_nl, l_sched);
+    l_restored.setFastForward(true);
+    l_restored.addClock(Clock(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)), 0);
+    l_restored.addClock(Clock(SimTime(25.0, SimTimeUnit::ns), SimTime(10.0, SimTimeUnit::ns),
+                              SimTime(3.0, SimTimeUnit::ns)),
+                        1);
+    Checkpointer l_restoreCp(l_sched);
+    l_restored.checkpoint(l_restoreCp, "sim");
+    REQUIRE(l_restoreCp.restore(l_path));
+    REQUIRE(l_sched.empty());
+    SimTime l_wake(200003.0, SimTimeUnit::ns);
+    l_refSched.runUntil(l_wake);
+    l_sched.runUntil(l_wake);
+    l_ref.setInput(l_en, {1, 0});
+    l_restored.setInput(l_en, {1, 0});
+    l_refSched.runUntil(l_wake + SimTime(100.0, SimTimeUnit::ns));
+    l_sched.runUntil(l_wake + SimTime(100.0, SimTimeUnit::ns));
+    for (NetId l_net : l_watch) {
+      REQUIRE(l_restored.value(l_net) == l_ref.value(l_net));
+    }
+    std::remove(l_path.c_str());
+  }
+}
+
+TEST_CASE("Native CompiledSim matches the interpreted pass") {
+  NativeOptions l_options;
+  l_options.cacheDir = (std::filesystem::temp_directory_path() / "ghls_test_native_sim").string();
+  for (uint32_t l_width : {1u, 13u, 64u}) {
+    RandomDesign l_design = makeDesign(7 + l_width, l_width);
+    Scheduler l_nativeSched;
+    Scheduler l_interpSched;
+    CompiledSim l_native(l_design.netlist, l_nativeSched);
+    CompiledSim l_interp(l_design.netlist, l_interpSched);
+    std::string l_error;
+    REQUIRE(l_native.useNative(l_options, &l_error));
+    REQUIRE(l_native.native() != nullptr);
+    REQUIRE(l_interp.native() == nullptr);
+    Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+                SimTime(10.0, SimTimeUnit::ns));
+    l_native.addClock(l_clk, 0);
+    l_native.addClock(l_clk, 1);
+    l_interp.addClock(l_clk, 0);
+    l_interp.addClock(l_clk, 1);
+
+    std::mt19937_64 l_rng(l_width);
+    for (uint64_t l_step = 1; l_step <= 50; ++l_step) {
+      SimTime l_at = SimTime(10.0, SimTimeUnit::ns) * l_step + SimTime(1.0, SimTimeUnit::ns);
+      l_nativeSched.runUntil(l_at);
+      l_interpSched.runUntil(l_at);
+      NetId l_input = l_design.inputs[l_rng() % l_design.inputs.size()];
+      LogicWord l_value{l_rng(), l_step % 5 == 0 ? l_rng() : 0};
+      l_native.setInput(l_input, l_value);
+      l_interp.setInput(l_input, l_value);
+      l_nativeSched.runUntil(l_at + SimTime(8.0, SimTimeUnit::ns));
+      l_interpSched.runUntil(l_at + SimTime(8.0, SimTimeUnit::ns));
+      for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+        REQUIRE(l_native.value(l_net) == l_interp.value(l_net));
+      }
+    }
+    REQUIRE(l_native.passes() == l_interp.passes());
+  }
+
+  SECTION("an unchanged design reuses the cached module") {
+    RandomDesign l_design = makeDesign(8, 1);
+    Scheduler l_sched;
+    CompiledSim l_sim(l_design.netlist, l_sched);
+    REQUIRE(l_sim.useNative(l_options));
+    REQUIRE(l_sim.native()->cached());
+  }
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include "../src/compiledSim.hpp"
+#include "../src/design.hpp"
+
+using namespace ghls;
+
+namespace {
+
+// Two bit counter counting while en is 1
+const char* kCounter = R"(
+# two bit counter
+net en 1 0
+net q0 1 0
+net q1 1 0
+net d0
+net d1
+net carry
+gate xor2 d0 q0 en
+gate and2 carry q0 en
+gate xor2 d1 q1 carry
+flop d0 q0
+flop d1 q1 0
+clock 0 10ns 5ns        # rising edges at 0, 10, 20, ...
+input 21ns en 1
+input 1ns en 0
+watch q0 q1
+)";
+
+std::string errorOf(const std::string& f_text) {
+  Design l_design;
+  std::string l_error;
+  REQUIRE_FALSE(parseDesign(f_text, l_design, &l_error));
+  return l_error;
+}
+
+}  // namespace
+
+TEST_CASE("A design description builds its netlist, clocks and stimulus") {
+  Design l_design;
+  std::string l_error;
+  REQUIRE(parseDesign(kCounter, l_design, &l_error));
+  REQUIRE(l_error.empty());
+  REQUIRE(l_design.netlist.nets() == 6);
+  REQUIRE(l_design.netlist.gates().size() == 3);
+  REQUIRE(l_design.netlist.flops().size() == 2);
+  REQUIRE(l_design.netlist.init(1) == Logic::zero);
+  REQUIRE(l_design.netlist.init(3) == Logic::x);
+  REQUIRE(l_design.names[2] == "q1");
+  REQUIRE(l_design.find("carry") == NetId(5));
+  REQUIRE_FALSE(l_design.find("nope").has_value());
+  REQUIRE(l_design.watched == std::vector<NetId>{1, 2});
+
+  REQUIRE(l_design.clocks.size() == 1);
+  REQUIRE(l_design.clocks[0].clock.period() == SimTime(10.0, SimTimeUnit::ns));
+  REQUIRE(l_design.clocks[0].clock.highTime() == SimTime(5.0, SimTimeUnit::ns));
+
+  // Sorted by time
+  REQUIRE(l_design.stimulus.size() == 2);
+  REQUIRE(l_design.stimulus[0].at == SimTime(1.0, SimTimeUnit::ns));
+  REQUIRE(l_design.stimulus[1].at == SimTime(21.0, SimTimeUnit::ns));
+  REQUIRE(l_design.stimulus[1].value == LogicWord{1, 0});
+
+  SECTION("the loaded design simulates") {
+    Scheduler l_sched;
+    CompiledSim l_sim(l_design.netlist, l_sched);
+    l_sim.addClock(l_design.clocks[0].clock, l_design.clocks[0].domain);
+    for (const Stimulus& l_entry : l_design.stimulus) {
+      l_sched.runUntil(l_entry.at);
+      l_sim.setInput(l_entry.net, l_entry.value);
+    }
+    // Edges at 30, 40 and 50 ns count while en is 1
+    l_sched.runUntil(SimTime(55.0, SimTimeUnit::ns));
+    REQUIRE(l_sim.value(*l_design.find("q0")) == LogicWord{1, 0});
+    REQUIRE(l_sim.value(*l_design.find("q1")) == LogicWord{1, 0});
+  }
+}
+
+TEST_CASE("Design values take hex, x and z") {
+  Design l_design;
+  REQUIRE(parseDesign("net bus 8\ninput 0ns bus 0xa5\ninput 1ns bus x\ninput 2ns bus z\n",
+                      l_design));
+  REQUIRE(l_design.netlist.width(0) == 8);
+  REQUIRE(l_design.stimulus[0].value == LogicWord{0xa5, 0});
+  REQUIRE(l_design.stimulus[1].value == LogicWord{0xff, 0xff});
+  REQUIRE(l_design.stimulus[2].value == LogicWord{0, 0xff});
+}
+
+TEST_CASE("Malformed design statements report their line") {
+  REQUIRE(errorOf("net a\nnet a\n") == "line 2: net 'a' declared twice");
+  REQUIRE(errorOf("net a\ngate and2 a a b\n") == "line 2: undeclared net 'b'");
+  REQUIRE(errorOf("net a\ngate nand3 a a a a\n") == "line 2: unknown gate 'nand3'");
+  REQUIRE(errorOf("net a\ngate inv a a a\n") == "line 2: wrong number of operands for 'inv'");
+  REQUIRE(errorOf("net a 2\nnet b\ngate inv a b\n") ==
+          "line 3: operand 'b' is not as wide as the output");
+  REQUIRE(errorOf("net a 65\n") == "line 1: net width must be 1 to 64");
+  REQUIRE(errorOf("net a 1 q\n") == "line 1: initial value must be 0, 1, x or z");
+  REQUIRE(errorOf("clock 0 10\n") == "line 1: bad time '10'");
+  REQUIRE(errorOf("clock 0 10ns 10ns\n") ==
+          "line 1: clock high time must lie strictly within the period");
+  REQUIRE(errorOf("net a 4\ninput 0ns a 16\n") == "line 2: value '16' does not fit the net");
+  REQUIRE(errorOf("\n\nwire a\n") == "line 3: unknown statement 'wire'");
+}
+
+TEST_CASE("Designs load from files") {
+  std::filesystem::path l_path = std::filesystem::temp_directory_path() / "ghls_test_design.txt";
+  std::FILE* l_out = std::fopen(l_path.c_str(), "w");
+  REQUIRE(l_out != nullptr);
+  std::fputs(kCounter, l_out);
+  std::fclose(l_out);
+
+  Design l_design;
+  std::string l_error;
+  REQUIRE(loadDesign(l_path.string(), l_design, &l_error));
+  REQUIRE(l_design.netlist.flops().size() == 2);
+  std::filesystem::remove(l_path);
+
+  REQUIRE_FALSE(loadDesign(l_path.string(), l_design, &l_error));
+  REQUIRE(l_error == "cannot open " + l_path.string());
+}
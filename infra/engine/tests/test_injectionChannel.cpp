@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../src/injectionChannel.hpp"
+
+using namespace ghls;
+
+namespace {
+
+struct Received {
+  Scheduler* sched;
+  std::vector<std::pair<SimTick, uint64_t>> events;
+};
+
+void record(void* f_ctx, uint64_t f_arg) {
+  Received* l_received = static_cast<Received*>(f_ctx);
+  l_received->events.emplace_back(l_received->sched->now().ticks(), f_arg);
+}
+
+}  // namespace
+
+TEST_CASE("InjectionChannel drains at timestep boundaries") {
+  Scheduler l_sched;
+  Received l_received{&l_sched, {}};
+  InjectionChannel l_channel(l_sched, 8);
+  l_channel.post({SimTime::fromTicks(30), record, &l_received, 3});
+  Injection l_batch[] = {{SimTime::fromTicks(10), record, &l_received, 1},
+                         {SimTime::fromTicks(20), record, &l_received, 2}};
+  REQUIRE(l_channel.tryPost(l_batch, 2));
+  REQUIRE(l_channel.pending() == 3);
+  // Nothing is in the scheduler until the run reaches a boundary
+  REQUIRE(l_sched.empty());
+  l_sched.runUntil(SimTime::fromTicks(15));
+  REQUIRE(l_channel.drained() == 3);
+  REQUIRE(l_received.events == std::vector<std::pair<SimTick, uint64_t>>{{10, 1}});
+
+  // Posted while the simulation sits at 15: the late one fires right away
+  l_channel.post({SimTime::fromTicks(5), record, &l_received, 4});
+  l_sched.run();
+  REQUIRE(l_channel.late() == 1);
+  REQUIRE(l_received.events ==
+          std::vector<std::pair<SimTick, uint64_t>>{{10, 1}, {15, 4}, {20, 2}, {30, 3}});
+}
+
+TEST_CASE("InjectionChannel chains with other step hooks") {
+  Scheduler l_sched;
+  Received l_received{&l_sched, {}};
+  int l_steps = 0;
+  StepHook l_count = [](void* f_ctx) { ++*static_cast<int*>(f_ctx); };
+  l_sched.addStepHook(l_count, &l_steps);
+  {
+    InjectionChannel l_channel(l_sched, 8);
+    l_channel.post({SimTime::fromTicks(10), record, &l_received, 1});
+    l_sched.run();
+    REQUIRE(l_received.events == std::vector<std::pair<SimTick, uint64_t>>{{10, 1}});
+    REQUIRE(l_steps == 2);
+  }
+  // The channel only removes its own hook
+  l_sched.schedule(SimTime::fromTicks(20), record, &l_received, 2);
+  l_sched.run();
+  REQUIRE(l_received.events.size() == 2);
+  REQUIRE(l_steps == 4);
+}
+
+TEST_CASE("InjectionChannel refuses posts when full") {
+  Scheduler l_sched;
+  Received l_received{&l_sched, {}};
+  InjectionChannel l_channel(l_sched, 4);
+  REQUIRE(l_channel.capacity() == 4);
+  std::vector<Injection> l_events;
+  for (uint64_t l_idx = 0; l_idx < 4; ++l_idx) {
+    l_events.push_back({SimTime::fromTicks(l_idx), record, &l_received, l_idx});
+  }
+  REQUIRE(l_channel.tryPost(l_events.data(), 3));
+  // A batch goes in whole or not at all
+  REQUIRE_FALSE(l_channel.tryPost(l_events.data(), 2));
+  REQUIRE(l_channel.tryPost(l_events[3]));
+  REQUIRE_FALSE(l_channel.tryPost(l_events[0]));
+  REQUIRE(l_channel.drain() == 4);
+  REQUIRE(l_channel.tryPost(l_events.data(), 4));
+  REQUIRE(l_channel.drain() == 4);
+  REQUIRE(l_sched.pending() == 8);
+}
+
+TEST_CASE("InjectionChannel delivers every event from many producers") {
+  const unsigned kProducers = 4;
+  const uint64_t kPerProducer = 20000;
+  Scheduler l_sched;
+  Received l_received{&l_sched, {}};
+  // Small capacity so producers regularly hit backpressure
+  InjectionChannel l_channel(l_sched, 64);
+  std::atomic<unsigned> l_done{0};
+  std::vector<std::thread> l_producers;
+  for (unsigned l_producer = 0; l_producer < kProducers; ++l_producer) {
+    l_producers.emplace_back([&, l_producer] {
+      std::vector<Injection> l_batch;
+      for (uint64_t l_idx = 0; l_idx < kPerProducer; ++l_idx) {
+        // Producer id in the top bits, sequence number below
+        uint64_t l_arg = (uint64_t(l_producer) << 32) | l_idx;
+        Injection l_event{SimTime::fromTicks(1000000 + l_idx), record, &l_received, l_arg};
+        if (l_producer % 2 == 0) {
+          l_channel.post(l_event);
+        } else {
+          l_batch.push_back(l_event);
+          if (l_batch.size() == 100) {
+            l_channel.post(l_batch.data(), l_batch.size());
+            l_batch.clear();
+          }
+        }
+      }
+      l_channel.post(l_batch.data(), l_batch.size());
+      l_done.fetch_add(1);
+    });
+  }
+  // The simulation thread keeps draining while producers run
+  while (l_done.load() < kProducers || l_channel.pending() != 0) {
+    l_channel.drain();
+    std::this_thread::yield();
+  }
+  for (std::thread& l_producer : l_producers) {
+    l_producer.join();
+  }
+  l_sched.run();
+  REQUIRE(l_received.events.size() == kProducers * kPerProducer);
+  // Every event at its time, and per producer in posting order
+  std::vector<uint64_t> l_next(kProducers, 0);
+  bool l_ok = true;
+  for (const auto& l_event : l_received.events) {
+    uint64_t l_producer = l_event.second >> 32;
+    uint64_t l_idx = l_event.second & 0xffffffff;
+    l_ok = l_ok && l_idx == l_next[l_producer] && l_event.first == 1000000 + l_idx;
+    ++l_next[l_producer];
+  }
+  REQUIRE(l_ok);
+  REQUIRE(l_channel.late() == 0);
+}
@@ -0,0 +1,205 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include "../src/compiledSim.hpp"
+#include "../src/laneSim.hpp"
+
+using namespace ghls;
+
+namespace {
+
+struct RandomDesign {
+  Netlist netlist;
+  std::vector<NetId> inputs;
+};
+
+RandomDesign makeDesign(uint32_t f_seed) {
+  std::mt19937 l_rng(f_seed);
+  RandomDesign l_design;
+  Netlist& l_nl = l_design.netlist;
+  // Mixed widths: every gate works on nets of one width
+  std::vector<NetId> l_sources[2];
+  const uint32_t l_widths[2] = {1, 5};
+  for (int l_idx = 0; l_idx < 12; ++l_idx) {
+    l_design.inputs.push_back(l_nl.addNet(l_widths[l_idx % 2], Logic::zero));
+    l_sources[l_idx % 2].push_back(l_design.inputs.back());
+  }
+  std::vector<NetId> l_qs;
+  for (int l_idx = 0; l_idx < 12; ++l_idx) {
+    l_qs.push_back(l_nl.addNet(l_widths[l_idx % 2], l_idx % 4 == 0 ? Logic::x : Logic::zero));
+    l_sources[l_idx % 2].push_back(l_qs.back());
+  }
+  for (int l_idx = 0; l_idx < 200; ++l_idx) {
+    std::vector<NetId>& l_from = l_sources[l_idx % 2];
+    auto l_pick = [&] {
+      return l_from[l_from.size() - 1 - l_rng() % std::min<size_t>(24, l_from.size())];
+    };
+    NetId l_out = l_nl.addNet(l_widths[l_idx % 2]);
+    l_nl.addGate(static_cast<GateOp>(l_rng() % 9), l_out, l_pick(), l_pick(), l_pick());
+    l_from.push_back(l_out);
+  }
+  for (size_t l_idx = 0; l_idx < l_qs.size(); ++l_idx) {
+    l_nl.addFlop(l_sources[l_idx % 2][l_sources[l_idx % 2].size() - 1 - l_idx], l_qs[l_idx]);
+  }
+  return l_design;
+}
+
+}  // namespace
+
+TEST_CASE("LaneSim lane accessors round trip") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet(3, Logic::zero);
+  NetId l_b = l_nl.addNet(3);
+  l_nl.addGate(GateOp::inv, l_b, l_a);
+  Scheduler l_sched;
+  LaneSim l_sim(l_nl, l_sched, 128);
+  REQUIRE(l_sim.lanes() == 128);
+  REQUIRE(l_sim.value(l_b, 100) == LogicWord{7, 0});
+
+  l_sim.setInput(l_a, LogicWord{5, 0});
+  l_sim.setInput(l_a, 70, LogicWord{2, 4});
+  l_sim.setLanes(l_a, 0, 0, LogicWord{0, 0});
+  l_sched.run();
+  REQUIRE(l_sim.value(l_a, 70) == LogicWord{2, 4});
+  REQUIRE(l_sim.value(l_b, 70) == LogicWord{5, 4});
+  REQUIRE(l_sim.value(l_b, 3) == LogicWord{3, 0});
+  REQUIRE(l_sim.value(l_b, 127) == LogicWord{2, 0});
+  REQUIRE(l_sim.lanesOf(l_b, 0, 0) == LogicWord{~uint64_t(0), 0});
+  REQUIRE(l_sim.lanesOf(l_b, 2, 1).bval == uint64_t(1) << 6);
+}
+
+TEST_CASE("LaneSim lanes match independent compiled runs") {
+  RandomDesign l_design = makeDesign(5);
+  const size_t kLanes = 128;
+  const uint64_t kCycles = 30;
+  const Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+                    SimTime(10.0, SimTimeUnit::ns));
+  auto l_stimulus = [](size_t f_lane, uint64_t f_cycle) {
+    std::mt19937_64 l_rng(f_lane * 1000 + f_cycle);
+    uint64_t l_value = l_rng();
+    return LogicWord{l_value, l_rng() % 23 == 0 ? l_rng() : 0};
+  };
+  auto l_at = [](uint64_t f_cycle) {
+    return SimTime(10.0, SimTimeUnit::ns) * f_cycle + SimTime(2.0, SimTimeUnit::ns);
+  };
+
+  Scheduler l_laneSched;
+  LaneSim l_lanes(l_design.netlist, l_laneSched, kLanes);
+  REQUIRE(l_lanes.compiled());
+  l_lanes.addClock(l_clk, 0);
+  for (uint64_t l_cycle = 1; l_cycle <= kCycles; ++l_cycle) {
+    l_laneSched.runUntil(l_at(l_cycle));
+    NetId l_input = l_design.inputs[l_cycle % l_design.inputs.size()];
+    for (size_t l_lane = 0; l_lane < kLanes; ++l_lane) {
+      l_lanes.setInput(l_input, l_lane, l_stimulus(l_lane, l_cycle));
+    }
+  }
+  l_laneSched.runUntil(l_at(kCycles + 1));
+
+  for (size_t l_lane = 0; l_lane < kLanes; l_lane += 9) {
+    Scheduler l_sched;
+    CompiledSim l_sim(l_design.netlist, l_sched);
+    l_sim.addClock(l_clk, 0);
+    for (uint64_t l_cycle = 1; l_cycle <= kCycles; ++l_cycle) {
+      l_sched.runUntil(l_at(l_cycle));
+      l_sim.setInput(l_design.inputs[l_cycle % l_design.inputs.size()],
+                     l_stimulus(l_lane, l_cycle));
+    }
+    l_sched.runUntil(l_at(kCycles + 1));
+    for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+      REQUIRE(l_lanes.value(l_net, l_lane) == l_sim.value(l_net));
+    }
+  }
+}
+
+TEST_CASE("LaneSim samples pre-edge values across coinciding domains") {
+  // Synchronizer chain hopping between domains: in -> q0 (0) -> q1 (1) -> q2 (0)
+  Netlist l_nl;
+  NetId l_in = l_nl.addNet(1, Logic::zero);
+  NetId l_q0 = l_nl.addNet(1, Logic::zero);
+  NetId l_q1 = l_nl.addNet(1, Logic::zero);
+  NetId l_q2 = l_nl.addNet(1, Logic::zero);
+  l_nl.addFlop(l_in, l_q0, 0);
+  l_nl.addFlop(l_q0, l_q1, 1);
+  l_nl.addFlop(l_q1, l_q2, 0);
+  // Every rising edge of the 20 ns clock coincides with one of the 10 ns clock
+  const Clock l_fast(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+                     SimTime(10.0, SimTimeUnit::ns));
+  const Clock l_slow(SimTime(20.0, SimTimeUnit::ns), SimTime(10.0, SimTimeUnit::ns),
+                     SimTime(20.0, SimTimeUnit::ns));
+
+  Scheduler l_laneSched;
+  LaneSim l_lanes(l_nl, l_laneSched);
+  l_lanes.addClock(l_fast, 0);
+  l_lanes.addClock(l_slow, 1);
+  // A clock for a domain without flops does nothing
+  l_lanes.addClock(l_fast, 7);
+  // Odd lanes see a pulse, even lanes stay low
+  l_lanes.setLanes(l_in, 0, 0, LogicWord{0xaaaaaaaaaaaaaaaaull, 0});
+  Scheduler l_eventSched;
+  EventSim l_event(l_nl, l_eventSched);
+  l_event.addClock(l_fast, 0);
+  l_event.addClock(l_slow, 1);
+  l_event.setInput(l_in, {1, 0});
+
+  for (uint64_t l_step = 1; l_step <= 12; ++l_step) {
+    SimTime l_at = SimTime(10.0, SimTimeUnit::ns) * l_step + SimTime(1.0, SimTimeUnit::ns);
+    if (l_step == 6) {
+      l_lanes.setInput(l_in, {0, 0});
+      l_event.setInput(l_in, {0, 0});
+    }
+    l_laneSched.runUntil(l_at);
+    l_eventSched.runUntil(l_at);
+    for (NetId l_net = 0; l_net < l_nl.nets(); ++l_net) {
+      REQUIRE(l_lanes.value(l_net, 1) == l_event.value(l_net));
+      REQUIRE(l_lanes.value(l_net, 0) == LogicWord{0, 0});
+    }
+  }
+}
+
+TEST_CASE("LaneSim commits inputs after edges at the same time") {
+  Netlist l_nl;
+  NetId l_in = l_nl.addNet(1, Logic::zero);
+  NetId l_q = l_nl.addNet(1, Logic::zero);
+  l_nl.addFlop(l_in, l_q);
+  const Clock l_clk(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns),
+                    SimTime(10.0, SimTimeUnit::ns));
+
+  Scheduler l_laneSched;
+  LaneSim l_lanes(l_nl, l_laneSched, 128);
+  Scheduler l_eventSched;
+  EventSim l_event(l_nl, l_eventSched);
+  // Input events queued ahead of the first edge, so they share its delta cycle
+  struct Drive {
+    LaneSim* lanes;
+    EventSim* event;
+    NetId net;
+  } l_drive{&l_lanes, &l_event, l_in};
+  l_laneSched.scheduleAt(
+      SimTime(10.0, SimTimeUnit::ns),
+      [](void* f_ctx, uint64_t) {
+        Drive* l_d = static_cast<Drive*>(f_ctx);
+        l_d->lanes->setInput(l_d->net, 3, {1, 0});
+        l_d->lanes->setLanes(l_d->net, 0, 1, {~uint64_t(0), 0});
+      },
+      &l_drive);
+  l_eventSched.scheduleAt(
+      SimTime(10.0, SimTimeUnit::ns),
+      [](void* f_ctx, uint64_t) {
+        Drive* l_d = static_cast<Drive*>(f_ctx);
+        l_d->event->setInput(l_d->net, {1, 0});
+      },
+      &l_drive);
+  l_lanes.addClock(l_clk, 0);
+  l_event.addClock(l_clk, 0);
+
+  for (uint64_t l_step = 1; l_step <= 3; ++l_step) {
+    SimTime l_at = SimTime(10.0, SimTimeUnit::ns) * l_step + SimTime(1.0, SimTimeUnit::ns);
+    l_laneSched.runUntil(l_at);
+    l_eventSched.runUntil(l_at);
+    for (size_t l_lane : {size_t(3), size_t(64), size_t(127)}) {
+      REQUIRE(l_lanes.value(l_q, l_lane) == l_event.value(l_q));
+    }
+    REQUIRE(l_lanes.value(l_q, 0) == LogicWord{0, 0});
+  }
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include "../src/nativeModule.hpp"
+
+using namespace ghls;
+
+namespace {
+
+std::string freshCache(const char* f_name) {
+  std::filesystem::path l_dir = std::filesystem::temp_directory_path() / f_name;
+  std::filesystem::remove_all(l_dir);
+  return l_dir.string();
+}
+
+// Swaps the two words of net 0 into net 1
+const char kSwap[] =
+    "#include <stdint.h>\n"
+    "struct W { uint64_t aval, bval; };\n"
+    "extern \"C\" void ghls_eval(W* v) { v[1] = W{v[0].bval, v[0].aval}; }\n";
+
+}  // namespace
+
+TEST_CASE("NativeModule compiles once and loads from the cache after") {
+  NativeOptions l_options;
+  l_options.cacheDir = freshCache("ghls_test_native");
+  std::string l_error;
+  std::unique_ptr<NativeModule> l_first = NativeModule::load(kSwap, l_options, &l_error);
+  REQUIRE(l_first != nullptr);
+  REQUIRE_FALSE(l_first->cached());
+  REQUIRE(l_first->hash() == NativeModule::hashOf(kSwap, l_options));
+  REQUIRE(std::filesystem::exists(l_first->path()));
+
+  LogicWord l_values[2] = {{5, 9}, {0, 0}};
+  l_first->eval()(l_values);
+  REQUIRE(l_values[1] == LogicWord{9, 5});
+
+  std::unique_ptr<NativeModule> l_second = NativeModule::load(kSwap, l_options);
+  REQUIRE(l_second != nullptr);
+  REQUIRE(l_second->cached());
+  REQUIRE(l_second->path() == l_first->path());
+  // Only the finished object is left behind, no sources or partial builds
+  size_t l_files = std::distance(std::filesystem::directory_iterator(l_options.cacheDir),
+                                 std::filesystem::directory_iterator());
+  REQUIRE(l_files == 1);
+
+  SECTION("different flags are a different module") {
+    NativeOptions l_o1 = l_options;
+    l_o1.flags = "-O1";
+    REQUIRE(NativeModule::hashOf(kSwap, l_o1) != l_first->hash());
+    std::unique_ptr<NativeModule> l_other = NativeModule::load(kSwap, l_o1);
+    REQUIRE(l_other != nullptr);
+    REQUIRE_FALSE(l_other->cached());
+  }
+}
+
+TEST_CASE("NativeModule reports compile failures") {
+  NativeOptions l_options;
+  l_options.cacheDir = freshCache("ghls_test_native_bad");
+  std::string l_error;
+  REQUIRE(NativeModule::load("this is not C++\n", l_options, &l_error) == nullptr);
+  REQUIRE_FALSE(l_error.empty());
+  REQUIRE(std::filesystem::is_empty(l_options.cacheDir));
+
+  SECTION("a missing entry point fails the load") {
+    l_error.clear();
+    REQUIRE(NativeModule::load("extern \"C\" void other() {}\n", l_options, &l_error) == nullptr);
+    REQUIRE(l_error.find("ghls_eval") != std::string::npos);
+  }
+}
+
+TEST_CASE("NativeModule refuses caches others can write to") {
+  namespace fs = std::filesystem;
+  NativeOptions l_options;
+  l_options.cacheDir = freshCache("ghls_test_native_shared");
+  std::string l_error;
+
+  SECTION("a group-writable directory") {
+    fs::create_directory(l_options.cacheDir);
+    fs::permissions(l_options.cacheDir, fs::perms::group_write, fs::perm_options::add);
+    REQUIRE(NativeModule::load(kSwap, l_options, &l_error) == nullptr);
+    REQUIRE(l_error.find("cache directory") != std::string::npos);
+    REQUIRE(fs::is_empty(l_options.cacheDir));
+  }
+
+  SECTION("a planted object others can write to") {
+    std::unique_ptr<NativeModule> l_module = NativeModule::load(kSwap, l_options);
+    REQUIRE(l_module != nullptr);
+    REQUIRE((fs::status(l_options.cacheDir).permissions() & fs::perms::others_all) ==
+            fs::perms::none);
+    std::string l_path = l_module->path();
+    l_module.reset();
+    fs::permissions(l_path, fs::perms::others_write, fs::perm_options::add);
+    REQUIRE(NativeModule::load(kSwap, l_options, &l_error) == nullptr);
+    REQUIRE(l_error.find("refusing") != std::string::npos);
+  }
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/netStore.hpp"
+
+using namespace ghls;
+
+TEST_CASE("NetStore allocates dense handles with initial values") {
+  NetStore l_nets;
+  NetId l_clk = l_nets.addNet(1, Logic::zero);
+  NetId l_bus = l_nets.addNet(8);
+  NetId l_wide = l_nets.addNet(100, Logic::z);
+  REQUIRE(l_clk == 0);
+  REQUIRE(l_bus == 1);
+  REQUIRE(l_wide == 2);
+  REQUIRE(l_nets.size() == 3);
+  REQUIRE(l_nets.words(l_wide) == 2);
+  REQUIRE(l_nets.toString(l_clk) == "0");
+  REQUIRE(l_nets.toString(l_bus) == "xxxxxxxx");
+  REQUIRE(l_nets.bit(l_wide, 99) == Logic::z);
+  REQUIRE(l_nets.isKnown(l_clk));
+  REQUIRE_FALSE(l_nets.isKnown(l_bus));
+  // Bits above the width stay clear
+  REQUIRE(l_nets.word(l_bus).aval == 0xff);
+  REQUIRE(l_nets.word(l_wide, 1).bval == (uint64_t(1) << 36) - 1);
+}
+
+TEST_CASE("NetStore writes stay pending until commit") {
+  NetStore l_nets;
+  NetId l_a = l_nets.addNet(4, Logic::zero);
+  NetId l_b = l_nets.addNet(1, Logic::zero);
+  l_nets.writeValue(l_a, 0xa);
+  l_nets.writeBit(l_b, 0, Logic::x);
+  REQUIRE(l_nets.toString(l_a) == "0000");
+  REQUIRE(l_nets.pendingWord(l_a).aval == 0xa);
+
+  SimTime l_now(5.0, SimTimeUnit::ns);
+  REQUIRE(l_nets.commit(l_now) == 2);
+  REQUIRE(l_nets.toString(l_a) == "1010");
+  REQUIRE(l_nets.bit(l_b, 0) == Logic::x);
+  REQUIRE(l_nets.lastChange(l_a) == l_now);
+  REQUIRE(l_nets.changed() == std::vector<NetId>{l_a, l_b});
+
+  SECTION("rewriting the same value is not a change") {
+    l_nets.writeValue(l_a, 0xa);
+    REQUIRE(l_nets.commit(SimTime(6.0, SimTimeUnit::ns)) == 0);
+    REQUIRE(l_nets.lastChange(l_a) == l_now);
+  }
+
+  SECTION("writes above the width are masked") {
+    l_nets.writeValue(l_a, 0xf5);
+    REQUIRE(l_nets.commit(SimTime(7.0, SimTimeUnit::ns)) == 1);
+    REQUIRE(l_nets.word(l_a).aval == 0x5);
+  }
+
+  SECTION("multiple writes in one delta keep the last value") {
+    l_nets.writeBit(l_b, 0, Logic::one);
+    l_nets.writeBit(l_b, 0, Logic::z);
+    l_nets.writeBit(l_b, 0, Logic::one);
+    REQUIRE(l_nets.commit(SimTime(8.0, SimTimeUnit::ns)) == 1);
+    REQUIRE(l_nets.bit(l_b, 0) == Logic::one);
+    REQUIRE(l_nets.changed().size() == 1);
+  }
+}
+
+TEST_CASE("NetStore handles multi-word 4-state nets") {
+  NetStore l_nets;
+  NetId l_net = l_nets.addNet(130, Logic::zero);
+  l_nets.writeBit(l_net, 129, Logic::one);
+  l_nets.writeBit(l_net, 64, Logic::z);
+  l_nets.writeBit(l_net, 0, Logic::x);
+  l_nets.commit(SimTime(1.0, SimTimeUnit::ns));
+  REQUIRE(l_nets.bit(l_net, 129) == Logic::one);
+  REQUIRE(l_nets.bit(l_net, 128) == Logic::zero);
+  REQUIRE(l_nets.bit(l_net, 64) == Logic::z);
+  REQUIRE(l_nets.bit(l_net, 0) == Logic::x);
+  std::string l_str = l_nets.toString(l_net);
+  REQUIRE(l_str.size() == 130);
+  REQUIRE(l_str.front() == '1');
+  REQUIRE(l_str[130 - 1 - 64] == 'z');
+  REQUIRE(l_str.back() == 'x');
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/netlist.hpp"
+
+using namespace ghls;
+
+static Logic gate1(GateOp f_op, Logic f_a, Logic f_b = Logic::zero, Logic f_c = Logic::zero) {
+  auto l_word = [](Logic f_bit) {
+    uint8_t l_code = static_cast<uint8_t>(f_bit);
+    return LogicWord{uint64_t(l_code & 1), uint64_t(l_code >> 1)};
+  };
+  LogicWord l_out = evalGate(f_op, l_word(f_a), l_word(f_b), l_word(f_c));
+  return static_cast<Logic>((l_out.aval & 1) | ((l_out.bval & 1) << 1));
+}
+
+TEST_CASE("evalGate follows 4-state truth tables") {
+  const Logic l_0 = Logic::zero, l_1 = Logic::one, l_x = Logic::x, l_z = Logic::z;
+  REQUIRE(gate1(GateOp::buf, l_z) == l_x);
+  REQUIRE(gate1(GateOp::inv, l_0) == l_1);
+  REQUIRE(gate1(GateOp::inv, l_z) == l_x);
+
+  REQUIRE(gate1(GateOp::and2, l_0, l_x) == l_0);
+  REQUIRE(gate1(GateOp::and2, l_1, l_x) == l_x);
+  REQUIRE(gate1(GateOp::and2, l_1, l_1) == l_1);
+  REQUIRE(gate1(GateOp::or2, l_1, l_x) == l_1);
+  REQUIRE(gate1(GateOp::or2, l_0, l_z) == l_x);
+  REQUIRE(gate1(GateOp::or2, l_0, l_0) == l_0);
+  REQUIRE(gate1(GateOp::xor2, l_1, l_1) == l_0);
+  REQUIRE(gate1(GateOp::xor2, l_1, l_x) == l_x);
+  REQUIRE(gate1(GateOp::nand2, l_0, l_x) == l_1);
+  REQUIRE(gate1(GateOp::nor2, l_1, l_x) == l_0);
+  REQUIRE(gate1(GateOp::xnor2, l_0, l_0) == l_1);
+
+  REQUIRE(gate1(GateOp::mux2, l_0, l_1, l_0) == l_1);
+  REQUIRE(gate1(GateOp::mux2, l_1, l_1, l_0) == l_0);
+  REQUIRE(gate1(GateOp::mux2, l_x, l_1, l_1) == l_1);
+  REQUIRE(gate1(GateOp::mux2, l_x, l_1, l_0) == l_x);
+  REQUIRE(gate1(GateOp::mux2, l_z, l_0, l_z) == l_x);
+
+  // All 64 lanes are independent
+  LogicWord l_out = evalGate(GateOp::and2, {0xff00, 0}, {0xf0f0, 0}, {0, 0});
+  REQUIRE(l_out == LogicWord{0xf000, 0});
+}
+
+TEST_CASE("Netlist levelizes gates in dependency order") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet();
+  NetId l_b = l_nl.addNet();
+  NetId l_n1 = l_nl.addNet();
+  NetId l_n2 = l_nl.addNet();
+  NetId l_n3 = l_nl.addNet();
+  NetId l_q = l_nl.addNet();
+  // Declared out of order on purpose
+  uint32_t l_g3 = l_nl.addGate(GateOp::and2, l_n3, l_n2, l_q);
+  uint32_t l_g2 = l_nl.addGate(GateOp::or2, l_n2, l_n1, l_b);
+  uint32_t l_g1 = l_nl.addGate(GateOp::inv, l_n1, l_a);
+  l_nl.addFlop(l_n3, l_q);
+
+  std::vector<uint32_t> l_levels;
+  auto l_order = l_nl.levelize(&l_levels);
+  REQUIRE(l_order.has_value());
+  REQUIRE(*l_order == std::vector<uint32_t>{l_g1, l_g2, l_g3});
+  REQUIRE(l_levels[l_g1] == 0);
+  REQUIRE(l_levels[l_g3] == 2);
+
+  std::vector<uint32_t> l_offsets, l_gates;
+  l_nl.fanout(l_offsets, l_gates);
+  REQUIRE(l_offsets[l_q + 1] - l_offsets[l_q] == 1);
+  REQUIRE(l_gates[l_offsets[l_q]] == l_g3);
+  REQUIRE(l_nl.domains() == 1);
+}
+
+TEST_CASE("Netlist reports combinational loops") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet();
+  NetId l_b = l_nl.addNet();
+  NetId l_c = l_nl.addNet();
+  l_nl.addGate(GateOp::and2, l_b, l_a, l_c);
+  l_nl.addGate(GateOp::inv, l_c, l_b);
+  REQUIRE_FALSE(l_nl.levelize().has_value());
+}
+
+TEST_CASE("EventSim propagates through gates in delta cycles") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet(1, Logic::zero);
+  NetId l_b = l_nl.addNet(1, Logic::zero);
+  NetId l_n = l_nl.addNet();
+  NetId l_out = l_nl.addNet();
+  l_nl.addGate(GateOp::xor2, l_n, l_a, l_b);
+  l_nl.addGate(GateOp::inv, l_out, l_n);
+
+  Scheduler l_sched;
+  EventSim l_sim(l_nl, l_sched);
+  l_sched.run();
+  REQUIRE(l_sim.value(l_out) == LogicWord{1, 0});
+  l_sim.setInput(l_a, {1, 0});
+  l_sched.run();
+  REQUIRE(l_sim.value(l_n) == LogicWord{1, 0});
+  REQUIRE(l_sim.value(l_out) == LogicWord{0, 0});
+}
+
+TEST_CASE("EventSim ignores clocks of domains without flops") {
+  Netlist l_nl;
+  NetId l_a = l_nl.addNet(1, Logic::zero);
+  NetId l_out = l_nl.addNet();
+  l_nl.addGate(GateOp::inv, l_out, l_a);
+  REQUIRE(l_nl.domains() == 0);
+
+  Scheduler l_sched;
+  EventSim l_sim(l_nl, l_sched);
+  l_sim.addClock(Clock(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)), 0);
+  l_sim.addClock(Clock(SimTime(10.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)), 3);
+  l_sched.runUntil(SimTime(35.0, SimTimeUnit::ns));
+  REQUIRE(l_sim.value(l_out) == LogicWord{1, 0});
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <vector>
+#include "../src/partitionSim.hpp"
+
+using namespace ghls;
+
+namespace {
+
+uint64_t mix(uint64_t f_value) {
+  f_value ^= f_value >> 33;
+  f_value *= 0xff51afd7ed558ccdULL;
+  f_value ^= f_value >> 33;
+  return f_value;
+}
+
+// PHOLD-style model: tokens hop between nodes; the next hop and delay only
+// depend on the token and the time, so the trajectory is the same in any
+// engine. Each node keeps an order-independent sum and an order-sensitive
+// hash of what it received.
+struct Model;
+
+struct Node {
+  Model* model;
+  uint32_t id;
+  uint64_t sum = 0;
+  uint64_t ordered = 0;
+  uint64_t received = 0;
+};
+
+struct Model {
+  static constexpr uint32_t kNodesPerPart = 8;
+  uint32_t parts;
+  PartitionedSim* pdes = nullptr;
+  Scheduler* sequential = nullptr;
+  std::vector<Node> nodes;
+
+  explicit Model(uint32_t f_parts) : parts(f_parts), nodes(f_parts * kNodesPerPart) {
+    for (uint32_t l_idx = 0; l_idx < nodes.size(); ++l_idx) {
+      nodes[l_idx].model = this;
+      nodes[l_idx].id = l_idx;
+    }
+  }
+
+  Scheduler& schedulerOf(uint32_t f_node) {
+    return pdes != nullptr ? pdes->scheduler(f_node / kNodesPerPart) : *sequential;
+  }
+
+  static void onToken(void* f_ctx, uint64_t f_token) {
+    Node* l_node = static_cast<Node*>(f_ctx);
+    Model* l_model = l_node->model;
+    SimTick l_now = l_model->schedulerOf(l_node->id).now().ticks();
+    l_node->sum += mix(f_token ^ l_now);
+    l_node->ordered = mix(l_node->ordered * 31 + f_token);
+    ++l_node->received;
+
+    uint64_t l_hash = mix(f_token + l_now);
+    uint32_t l_to = static_cast<uint32_t>(l_hash % l_model->nodes.size());
+    // Remote hops take at least the 100 tick link delay
+    SimTick l_delay = 100 + (l_hash >> 40) % 400;
+    uint32_t l_fromPart = l_node->id / kNodesPerPart;
+    uint32_t l_toPart = l_to / kNodesPerPart;
+    if (l_model->pdes != nullptr) {
+      l_model->pdes->send(l_fromPart, l_toPart, SimTime::fromTicks(l_delay), onToken,
+                          &l_model->nodes[l_to], mix(f_token));
+    } else {
+      l_model->sequential->schedule(SimTime::fromTicks(l_delay), onToken, &l_model->nodes[l_to],
+                                    mix(f_token));
+    }
+  }
+
+  void seed(uint32_t f_tokens) {
+    for (uint32_t l_token = 0; l_token < f_tokens; ++l_token) {
+      uint32_t l_node = l_token % nodes.size();
+      schedulerOf(l_node).schedule(SimTime::fromTicks(l_token % 50), onToken, &nodes[l_node],
+                                   l_token + 1);
+    }
+  }
+};
+
+void runPartitioned(Model& f_model, unsigned f_threads, size_t f_ring, SimTime f_end) {
+  PartitionedSim l_sim(f_model.parts, f_threads, f_ring);
+  for (uint32_t l_from = 0; l_from < f_model.parts; ++l_from) {
+    for (uint32_t l_to = 0; l_to < f_model.parts; ++l_to) {
+      if (l_from != l_to) {
+        l_sim.link(l_from, l_to, SimTime::fromTicks(100));
+      }
+    }
+  }
+  REQUIRE(l_sim.lookahead().ticks() == 100);
+  f_model.pdes = &l_sim;
+  f_model.seed(64);
+  l_sim.runUntil(f_end);
+  REQUIRE(l_sim.windows() > 0);
+  REQUIRE(l_sim.messages() > 0);
+  for (uint32_t l_part = 0; l_part < f_model.parts; ++l_part) {
+    REQUIRE(l_sim.scheduler(l_part).now() == f_end);
+  }
+  f_model.pdes = nullptr;
+}
+
+}  // namespace
+
+TEST_CASE("PartitionedSim matches the sequential run") {
+  const SimTime l_end = SimTime::fromTicks(200000);
+  Model l_reference(4);
+  Scheduler l_sched;
+  l_reference.sequential = &l_sched;
+  l_reference.seed(64);
+  l_sched.runUntil(l_end);
+
+  Model l_parallel(4);
+  runPartitioned(l_parallel, 4, 4096, l_end);
+  uint64_t l_total = 0;
+  for (size_t l_idx = 0; l_idx < l_reference.nodes.size(); ++l_idx) {
+    REQUIRE(l_parallel.nodes[l_idx].received == l_reference.nodes[l_idx].received);
+    REQUIRE(l_parallel.nodes[l_idx].sum == l_reference.nodes[l_idx].sum);
+    l_total += l_parallel.nodes[l_idx].received;
+  }
+  REQUIRE(l_total == l_sched.eventsExecuted());
+}
+
+TEST_CASE("PartitionedSim results do not depend on threads or ring size") {
+  const SimTime l_end = SimTime::fromTicks(100000);
+  Model l_single(6);
+  runPartitioned(l_single, 1, 4096, l_end);
+  for (unsigned l_threads : {2u, 3u, 6u}) {
+    for (size_t l_ring : {size_t(2), size_t(4096)}) {
+      Model l_model(6);
+      runPartitioned(l_model, l_threads, l_ring, l_end);
+      for (size_t l_idx = 0; l_idx < l_model.nodes.size(); ++l_idx) {
+        REQUIRE(l_model.nodes[l_idx].ordered == l_single.nodes[l_idx].ordered);
+      }
+    }
+  }
+}
+
+TEST_CASE("PartitionedSim runs unlinked partitions independently") {
+  PartitionedSim l_sim(3, 2);
+  std::vector<uint64_t> l_fired(3, 0);
+  for (uint32_t l_part = 0; l_part < 3; ++l_part) {
+    for (uint64_t l_idx = 1; l_idx <= 10; ++l_idx) {
+      l_sim.scheduler(l_part).schedule(
+          SimTime::fromTicks(l_idx * 1000),
+          [](void* f_ctx, uint64_t) { ++*static_cast<uint64_t*>(f_ctx); }, &l_fired[l_part]);
+    }
+  }
+  l_sim.runUntil(SimTime::fromTicks(5500));
+  REQUIRE(l_fired == std::vector<uint64_t>{5, 5, 5});
+  // Without links the whole run is a single window
+  REQUIRE(l_sim.windows() == 1);
+}
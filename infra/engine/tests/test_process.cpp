@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/process.hpp"
+
+using namespace ghls;
+
+namespace {
+
+struct Log {
+  Scheduler* sched;
+  std::vector<std::pair<SimTick, std::string>> entries;
+
+  void add(const std::string& f_what) { entries.emplace_back(sched->now().ticks(), f_what); }
+  // Appends rather than "d" + ..., which trips GCC's -Wrestrict inside coroutines
+  void addDelta() {
+    std::string l_what = "d";
+    l_what.append(std::to_string(sched->delta()));
+    add(l_what);
+  }
+};
+
+Process ticker(Log& f_log, std::string f_name, SimTime f_period, int f_count) {
+  for (int l_idx = 0; l_idx < f_count; ++l_idx) {
+    co_await delay(f_period);
+    f_log.add(f_name);
+  }
+}
+
+Process deltaSteps(Log& f_log) {
+  f_log.addDelta();
+  co_await delay(SimTime());
+  f_log.addDelta();
+  co_await delay(SimTime());
+  f_log.addDelta();
+}
+
+Process clockGen(Signal& f_clk, SimTime f_half, int f_cycles) {
+  for (int l_idx = 0; l_idx < f_cycles; ++l_idx) {
+    f_clk.writeValue(0);
+    co_await delay(f_half);
+    f_clk.writeValue(1);
+    co_await delay(f_half);
+  }
+}
+
+Process counter(Signal& f_clk, Signal& f_count) {
+  uint64_t l_value = 0;
+  for (;;) {
+    co_await posedge(f_clk);
+    f_count.writeValue(++l_value);
+  }
+}
+
+Process watcher(Log& f_log, Signal& f_signal, EdgeKind f_kind, std::string f_name) {
+  for (;;) {
+    co_await SignalEdge{&f_signal, f_kind};
+    f_log.add(f_name);
+  }
+}
+
+Process forever(Signal& f_signal) {
+  std::vector<int> l_local(100, 7);
+  co_await edge(f_signal);
+  (void)l_local;
+}
+
+}  // namespace
+
+TEST_CASE("Processes resume after their delays in time order") {
+  Scheduler l_sched;
+  Log l_log{&l_sched, {}};
+  {
+    ProcessGroup l_group(l_sched);
+    l_group.spawn(ticker(l_log, "a", SimTime::fromTicks(10), 3));
+    l_group.spawn(ticker(l_log, "b", SimTime::fromTicks(15), 2));
+    REQUIRE(l_group.live() == 2);
+    l_sched.run();
+    REQUIRE(l_group.live() == 0);
+    REQUIRE(l_group.finished() == 2);
+  }
+  // Within a timestep resumes follow scheduling order: b waited first for 30
+  std::vector<std::pair<SimTick, std::string>> l_expected = {
+      {10, "a"}, {15, "b"}, {20, "a"}, {30, "b"}, {30, "a"}};
+  REQUIRE(l_log.entries == l_expected);
+}
+
+TEST_CASE("A zero delay resumes in the next delta cycle") {
+  Scheduler l_sched;
+  Log l_log{&l_sched, {}};
+  ProcessGroup l_group(l_sched);
+  l_group.spawn(deltaSteps(l_log));
+  l_sched.run();
+  REQUIRE(l_log.entries ==
+          std::vector<std::pair<SimTick, std::string>>{{0, "d0"}, {0, "d1"}, {0, "d2"}});
+  REQUIRE(l_sched.timeSteps() == 1);
+}
+
+TEST_CASE("Signals commit in the next delta and wake matching edges") {
+  Scheduler l_sched;
+  Log l_log{&l_sched, {}};
+  Signal l_sig(l_sched);
+  ProcessGroup l_group(l_sched);
+  l_group.spawn(watcher(l_log, l_sig, EdgeKind::any, "any"));
+  l_group.spawn(watcher(l_log, l_sig, EdgeKind::pos, "pos"));
+  l_group.spawn(watcher(l_log, l_sig, EdgeKind::neg, "neg"));
+  l_sched.run();
+  REQUIRE(l_sig.waiters() == 3);
+  REQUIRE(l_sig.bit(0) == Logic::x);
+
+  SECTION("x to 1 is a rising edge, 1 to 0 a falling one") {
+    l_sig.writeValue(1);
+    REQUIRE(l_sig.bit(0) == Logic::x);
+    l_sched.run();
+    REQUIRE(l_sig.bit(0) == Logic::one);
+    l_sched.runUntil(SimTime::fromTicks(5));
+    l_sig.writeValue(0);
+    l_sched.run();
+    std::vector<std::pair<SimTick, std::string>> l_expected = {
+        {0, "any"}, {0, "pos"}, {5, "any"}, {5, "neg"}};
+    REQUIRE(l_log.entries == l_expected);
+    REQUIRE(l_sig.lastChange() == SimTime::fromTicks(5));
+    REQUIRE(l_sig.waiters() == 3);
+  }
+
+  SECTION("the last write of a delta wins and no change wakes nobody") {
+    l_sig.writeValue(0);
+    l_sig.writeValue(1);
+    l_sig.write({~uint64_t(0), ~uint64_t(0)});
+    l_sched.run();
+    REQUIRE(l_log.entries.empty());
+  }
+
+  SECTION("upper bits change only the any edge") {
+    l_sig.writeValue(0);
+    l_sched.run();
+    l_log.entries.clear();
+    l_sig.writeValue(2);
+    l_sched.run();
+    REQUIRE(l_log.entries == std::vector<std::pair<SimTick, std::string>>{{0, "any"}});
+  }
+}
+
+TEST_CASE("A clocked counter process follows a generated clock") {
+  Scheduler l_sched;
+  Signal l_clk(l_sched);
+  Signal l_count(l_sched, {0, 0});
+  ProcessGroup l_group(l_sched);
+  l_group.spawn(counter(l_clk, l_count));
+  l_group.spawn(clockGen(l_clk, SimTime(5.0, SimTimeUnit::ns), 10));
+  l_sched.run();
+  REQUIRE(l_count.value().aval == 10);
+  REQUIRE(l_group.live() == 1);
+  REQUIRE(l_group.finished() == 1);
+}
+
+TEST_CASE("Process frames come from the thread's frame pool") {
+  Scheduler l_sched;
+  Signal l_sig(l_sched);
+  size_t l_before = threadFramePool().inUse();
+  {
+    ProcessGroup l_group(l_sched);
+    for (int l_idx = 0; l_idx < 100; ++l_idx) {
+      l_group.spawn(forever(l_sig));
+    }
+    REQUIRE(threadFramePool().inUse() == l_before + 100);
+    l_sched.run();
+    REQUIRE(l_sig.waiters() == 100);
+
+    SECTION("finished processes release their frame") {
+      l_sig.writeValue(1);
+      l_sched.run();
+      REQUIRE(l_group.live() == 0);
+      REQUIRE(l_group.finished() == 100);
+      REQUIRE(threadFramePool().inUse() == l_before);
+    }
+  }
+  // Destroying the group destroys suspended processes and leaves the signal
+  REQUIRE(l_sig.waiters() == 0);
+  REQUIRE(threadFramePool().inUse() == l_before);
+
+  SECTION("large frames bypass the pools") {
+    void* l_big = threadFramePool().allocate(FramePool::kMaxPooled + 1);
+    REQUIRE(threadFramePool().inUse() == l_before);
+    threadFramePool().deallocate(l_big, FramePool::kMaxPooled + 1);
+  }
+}
+
+TEST_CASE("An unspawned process is destroyed with its handle") {
+  Scheduler l_sched;
+  Signal l_sig(l_sched);
+  size_t l_before = threadFramePool().inUse();
+  {
+    Process l_process = forever(l_sig);
+    REQUIRE(threadFramePool().inUse() == l_before + 1);
+  }
+  REQUIRE(threadFramePool().inUse() == l_before);
+  REQUIRE(l_sched.empty());
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/profiler.hpp"
+
+using namespace ghls;
+
+namespace {
+
+std::string tempPath(const std::string& f_name) {
+  return (std::filesystem::temp_directory_path() / f_name).string();
+}
+
+struct Chain {
+  Scheduler* sched;
+  uint64_t fired = 0;
+};
+
+// Fires f_arg more delta cycles in the same timestep
+void deltaChain(void* f_ctx, uint64_t f_arg) {
+  Chain* l_chain = static_cast<Chain*>(f_ctx);
+  ++l_chain->fired;
+  if (f_arg > 0) {
+    l_chain->sched->scheduleDelta(deltaChain, l_chain, f_arg - 1);
+  }
+}
+
+void count(void* f_ctx, uint64_t) { ++static_cast<Chain*>(f_ctx)->fired; }
+
+}  // namespace
+
+TEST_CASE("Histogram buckets by powers of two") {
+  Histogram l_hist;
+  for (uint64_t l_value : {0, 1, 2, 3, 4, 100}) {
+    l_hist.add(l_value);
+  }
+  REQUIRE(l_hist.count() == 6);
+  REQUIRE(l_hist.sum() == 110);
+  REQUIRE(l_hist.max() == 100);
+  REQUIRE(l_hist.bucket(0) == 1);
+  REQUIRE(l_hist.bucket(1) == 1);
+  REQUIRE(l_hist.bucket(2) == 2);
+  REQUIRE(l_hist.bucket(3) == 1);
+  REQUIRE(l_hist.bucket(7) == 1);
+  REQUIRE(l_hist.quantile(0.5) == 3);
+  REQUIRE(l_hist.quantile(1.0) == 100);
+  l_hist.reset();
+  REQUIRE(l_hist.count() == 0);
+  REQUIRE(l_hist.quantile(0.5) == 0);
+}
+
+TEST_CASE("Profiler counts events per process and per timestep") {
+  Scheduler l_sched;
+  Chain l_a{&l_sched};
+  Chain l_b{&l_sched};
+  Profiler l_profiler(l_sched);
+  l_profiler.name(deltaChain, "chain");
+  l_profiler.name(count, &l_a, "count.a");
+  l_profiler.name(count, &l_b, "count.b");
+  l_profiler.enable();
+  REQUIRE(l_sched.profiler() == &l_profiler);
+
+  // Step at 10: a chain three deltas deep plus one count; step at 20: two counts
+  l_sched.scheduleAt(SimTime::fromTicks(10), deltaChain, &l_a, 2);
+  l_sched.scheduleAt(SimTime::fromTicks(10), count, &l_a);
+  l_sched.scheduleAt(SimTime::fromTicks(20), count, &l_b);
+  l_sched.scheduleAt(SimTime::fromTicks(20), count, &l_b);
+  l_sched.run();
+
+  std::map<std::string, uint64_t> l_events;
+  for (const Profiler::ProcessStats& l_stats : l_profiler.processes()) {
+    l_events[l_stats.name] = l_stats.events;
+    REQUIRE(l_stats.maxCycles <= l_stats.cycles);
+  }
+  REQUIRE(l_events == std::map<std::string, uint64_t>{{"chain", 3}, {"count.a", 1},
+                                                      {"count.b", 2}});
+  REQUIRE(l_profiler.eventsPerStep().count() == 2);
+  REQUIRE(l_profiler.eventsPerStep().sum() == 6);
+  REQUIRE(l_profiler.eventsPerStep().max() == 4);
+  REQUIRE(l_profiler.deltaDepth().max() == 3);
+  REQUIRE(l_profiler.deltaDepth().sum() == 4);
+  // Everything was queued when the first step started
+  REQUIRE(l_profiler.queueOccupancy().max() == 4);
+  REQUIRE(l_profiler.stepCycles().count() == 2);
+}
+
+TEST_CASE("Profiler records nothing while disabled") {
+  Scheduler l_sched;
+  Chain l_chain{&l_sched};
+  Profiler l_profiler(l_sched);
+  l_sched.scheduleAt(SimTime::fromTicks(1), count, &l_chain);
+  l_sched.run();
+  REQUIRE(l_profiler.processes().empty());
+
+  l_profiler.enable();
+  l_sched.scheduleAt(SimTime::fromTicks(2), count, &l_chain);
+  l_sched.run();
+  l_profiler.disable();
+  REQUIRE(l_sched.profiler() == nullptr);
+  l_sched.scheduleAt(SimTime::fromTicks(3), count, &l_chain);
+  l_sched.run();
+
+  REQUIRE(l_chain.fired == 3);
+  REQUIRE(l_profiler.processes().size() == 1);
+  REQUIRE(l_profiler.processes()[0].events == 1);
+  REQUIRE(l_profiler.eventsPerStep().count() == 1);
+  // Unnamed processes are reported by address
+  REQUIRE(l_profiler.processes()[0].name.rfind("fn@", 0) == 0);
+
+  l_profiler.reset();
+  REQUIRE(l_profiler.processes().empty());
+  REQUIRE(l_profiler.eventsPerStep().count() == 0);
+}
+
+TEST_CASE("Profiler writes folded stacks and a summary at exit") {
+  std::string l_folded = tempPath("ghls_profile.folded");
+  std::string l_summary = tempPath("ghls_profile.txt");
+  std::remove(l_folded.c_str());
+  std::remove(l_summary.c_str());
+  {
+    Scheduler l_sched;
+    Chain l_chain{&l_sched};
+    Profiler l_profiler(l_sched);
+    l_profiler.name(deltaChain, "top;chain one");
+    l_profiler.reportAtExit(l_folded, l_summary);
+    l_profiler.enable();
+    for (uint64_t l_time = 1; l_time <= 100; ++l_time) {
+      l_sched.scheduleAt(SimTime::fromTicks(l_time), deltaChain, &l_chain, 4);
+    }
+    l_sched.run();
+    REQUIRE(l_chain.fired == 500);
+  }
+
+  std::ifstream l_in(l_folded);
+  REQUIRE(l_in.good());
+  std::map<std::string, uint64_t> l_stacks;
+  std::string l_line;
+  while (std::getline(l_in, l_line)) {
+    std::istringstream l_fields(l_line);
+    std::string l_stack;
+    uint64_t l_value = 0;
+    REQUIRE(static_cast<bool>(l_fields >> l_stack >> l_value));
+    l_stacks[l_stack] = l_value;
+  }
+  // Separators in process names are escaped so the stack keeps two frames
+  REQUIRE(l_stacks.count("ghls;top_chain_one") == 1);
+  REQUIRE(l_stacks.size() <= 2);
+
+  std::ifstream l_table(l_summary);
+  std::stringstream l_text;
+  l_text << l_table.rdbuf();
+  REQUIRE(l_text.str().find("top;chain one") != std::string::npos);
+  REQUIRE(l_text.str().find("delta depth") != std::string::npos);
+  std::remove(l_folded.c_str());
+  std::remove(l_summary.c_str());
+}
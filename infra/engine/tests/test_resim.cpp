@@ -0,0 +1,194 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/resim.hpp"
+
+using namespace ghls;
+
+namespace {
+
+// Counter with an enable (a lasting effect of the input) next to a four flop
+// shift register fed by din (an effect gone after four cycles)
+struct Design {
+  Netlist netlist;
+  NetId en;
+  NetId din;
+  std::vector<NetId> watched;
+  std::vector<NetId> counter;
+  std::vector<NetId> shift;
+
+  Design() {
+    en = netlist.addNet(1, Logic::zero);
+    din = netlist.addNet(1, Logic::zero);
+    NetId l_carry = en;
+    for (int l_bit = 0; l_bit < 4; ++l_bit) {
+      NetId l_q = netlist.addNet(1, Logic::zero);
+      NetId l_d = netlist.addNet();
+      NetId l_next = netlist.addNet();
+      netlist.addGate(GateOp::xor2, l_d, l_q, l_carry);
+      netlist.addGate(GateOp::and2, l_next, l_q, l_carry);
+      netlist.addFlop(l_d, l_q);
+      counter.push_back(l_q);
+      l_carry = l_next;
+    }
+    NetId l_prev = din;
+    for (int l_stage = 0; l_stage < 4; ++l_stage) {
+      NetId l_q = netlist.addNet(1, Logic::zero);
+      netlist.addFlop(l_prev, l_q);
+      shift.push_back(l_q);
+      l_prev = l_q;
+    }
+    watched = counter;
+    watched.insert(watched.end(), shift.begin(), shift.end());
+  }
+};
+
+const SimTime kCycle(10.0, SimTimeUnit::ns);
+const SimTime kEnd(1000.0, SimTimeUnit::ns);
+
+// Both inputs driven 3 ns into every cycle
+std::vector<Stimulus> makeStimulus(const Design& f_design) {
+  std::mt19937 l_rng(11);
+  std::vector<Stimulus> l_out;
+  for (uint64_t l_cycle = 0; l_cycle < 100; ++l_cycle) {
+    SimTime l_at = kCycle * l_cycle + SimTime(3.0, SimTimeUnit::ns);
+    l_out.push_back({l_at, f_design.en, {l_rng() % 4 != 0 ? 1u : 0u, 0}});
+    l_out.push_back({l_at, f_design.din, {l_rng() & 1, 0}});
+  }
+  return l_out;
+}
+
+// Flips the input f_net at f_at
+void flip(std::vector<Stimulus>& f_stimulus, NetId f_net, SimTime f_at) {
+  for (Stimulus& l_entry : f_stimulus) {
+    if (l_entry.net == f_net && l_entry.at == f_at) {
+      l_entry.value.aval ^= 1;
+    }
+  }
+}
+
+std::string freshDir(const char* f_name) {
+  std::filesystem::path l_dir = std::filesystem::temp_directory_path() / f_name;
+  std::filesystem::remove_all(l_dir);
+  std::filesystem::create_directories(l_dir);
+  return l_dir.string();
+}
+
+struct Run {
+  Resim resim;
+
+  Run(const Design& f_design, const std::string& f_dir)
+      : resim(f_design.netlist, SimTime(50.0, SimTimeUnit::ns), f_dir) {
+    resim.addClock(Clock(kCycle, SimTime(5.0, SimTimeUnit::ns), SimTime(5.0, SimTimeUnit::ns)),
+                   0);
+    for (NetId l_net : f_design.watched) {
+      resim.watch(l_net);
+    }
+  }
+};
+
+bool sameTrace(const std::vector<NetChange>& f_lhs, const std::vector<NetChange>& f_rhs) {
+  return std::equal(f_lhs.begin(), f_lhs.end(), f_rhs.begin(), f_rhs.end(),
+                    [](const NetChange& f_a, const NetChange& f_b) {
+                      return f_a.at == f_b.at && f_a.net == f_b.net && f_a.value == f_b.value;
+                    });
+}
+
+// Reference: the edited stimulus simulated from scratch
+std::vector<NetChange> fullRun(const Design& f_design, const std::vector<Stimulus>& f_stimulus,
+                               std::vector<LogicWord>& f_final) {
+  Run l_run(f_design, freshDir("ghls_test_resim_ref"));
+  l_run.resim.setStimulus(f_stimulus);
+  REQUIRE(l_run.resim.run(kEnd));
+  f_final.clear();
+  for (NetId l_net = 0; l_net < f_design.netlist.nets(); ++l_net) {
+    f_final.push_back(l_run.resim.sim().value(l_net));
+  }
+  return l_run.resim.trace();
+}
+
+}  // namespace
+
+TEST_CASE("Resim records windows and reruns nothing without edits") {
+  Design l_design;
+  Run l_run(l_design, freshDir("ghls_test_resim"));
+  l_run.resim.setStimulus(makeStimulus(l_design));
+  REQUIRE(l_run.resim.run(kEnd));
+  REQUIRE(l_run.resim.windows() == 20);
+  REQUIRE(l_run.resim.windowsSimulated() == 20);
+  REQUIRE(l_run.resim.now() == kEnd);
+  REQUIRE(l_run.resim.inputsRead(3) == std::vector<NetId>{l_design.en, l_design.din});
+  REQUIRE_FALSE(l_run.resim.trace().empty());
+
+  REQUIRE(l_run.resim.rerun());
+  REQUIRE(l_run.resim.windowsSimulated() == 0);
+  REQUIRE(l_run.resim.windowsReused() == 20);
+}
+
+TEST_CASE("Resim resumes from the window of the earliest edit") {
+  Design l_design;
+  Run l_run(l_design, freshDir("ghls_test_resim"));
+  std::vector<Stimulus> l_stimulus = makeStimulus(l_design);
+  l_run.resim.setStimulus(l_stimulus);
+  REQUIRE(l_run.resim.run(kEnd));
+
+  // A lasting edit: the counter differs up to the end
+  flip(l_stimulus, l_design.en, SimTime(723.0, SimTimeUnit::ns));
+  l_run.resim.setStimulus(l_stimulus);
+  REQUIRE(l_run.resim.rerun());
+  REQUIRE(l_run.resim.resumedFrom() == SimTime(700.0, SimTimeUnit::ns));
+  REQUIRE(l_run.resim.windowsSimulated() == 6);
+  REQUIRE(l_run.resim.windowsReused() == 14);
+  REQUIRE(l_run.resim.now() == kEnd);
+  for (NetId l_net : l_design.counter) {
+    REQUIRE(l_run.resim.cone()[l_net] == 1);
+  }
+  for (NetId l_net : l_design.shift) {
+    REQUIRE(l_run.resim.cone()[l_net] == 0);
+  }
+
+  std::vector<LogicWord> l_final;
+  REQUIRE(sameTrace(l_run.resim.trace(), fullRun(l_design, l_stimulus, l_final)));
+  for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+    REQUIRE(l_run.resim.sim().value(l_net) == l_final[l_net]);
+  }
+
+  SECTION("a second edit builds on the first") {
+    flip(l_stimulus, l_design.din, SimTime(303.0, SimTimeUnit::ns));
+    flip(l_stimulus, l_design.en, SimTime(903.0, SimTimeUnit::ns));
+    l_run.resim.setStimulus(l_stimulus);
+    REQUIRE(l_run.resim.rerun());
+    REQUIRE(l_run.resim.resumedFrom() == SimTime(300.0, SimTimeUnit::ns));
+    REQUIRE(sameTrace(l_run.resim.trace(), fullRun(l_design, l_stimulus, l_final)));
+    for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+      REQUIRE(l_run.resim.sim().value(l_net) == l_final[l_net]);
+    }
+  }
+}
+
+TEST_CASE("Resim reuses the recorded run once the state converges") {
+  Design l_design;
+  Run l_run(l_design, freshDir("ghls_test_resim"));
+  std::vector<Stimulus> l_stimulus = makeStimulus(l_design);
+  l_run.resim.setStimulus(l_stimulus);
+  REQUIRE(l_run.resim.run(kEnd));
+
+  // din is driven again next cycle and leaves the shift register four edges
+  // later, well before the 750 ns boundary
+  flip(l_stimulus, l_design.din, SimTime(703.0, SimTimeUnit::ns));
+  l_run.resim.setStimulus(l_stimulus);
+  REQUIRE(l_run.resim.rerun());
+  REQUIRE(l_run.resim.windowsSimulated() == 1);
+  REQUIRE(l_run.resim.windowsReused() == 19);
+  REQUIRE(l_run.resim.now() == kEnd);
+  REQUIRE(l_run.resim.cone()[l_design.din] == 1);
+  REQUIRE(l_run.resim.cone()[l_design.counter[0]] == 0);
+
+  std::vector<LogicWord> l_final;
+  REQUIRE(sameTrace(l_run.resim.trace(), fullRun(l_design, l_stimulus, l_final)));
+  for (NetId l_net = 0; l_net < l_design.netlist.nets(); ++l_net) {
+    REQUIRE(l_run.resim.sim().value(l_net) == l_final[l_net]);
+  }
+}
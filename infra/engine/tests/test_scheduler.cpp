@@ -0,0 +1,234 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../src/scheduler.hpp"
+
+using namespace ghls;
+
+namespace {
+
+struct Trace {
+  Scheduler* sched;
+  std::vector<std::pair<SimTick, uint64_t>> fired;
+};
+
+void record(void* f_ctx, uint64_t f_arg) {
+  auto* l_trace = static_cast<Trace*>(f_ctx);
+  l_trace->fired.emplace_back(l_trace->sched->now().ticks(), f_arg);
+}
+
+}  // namespace
+
+TEST_CASE("Scheduler starts empty at time zero") {
+  Scheduler l_sched;
+  REQUIRE(l_sched.empty());
+  REQUIRE(l_sched.now() == SimTime());
+  REQUIRE_FALSE(l_sched.nextEventTime().has_value());
+  REQUIRE_FALSE(l_sched.step());
+}
+
+TEST_CASE("Scheduler fires events in time order") {
+  Scheduler l_sched;
+  Trace l_trace{&l_sched, {}};
+  l_sched.schedule(SimTime(30.0, SimTimeUnit::ns), record, &l_trace, 3);
+  l_sched.schedule(SimTime(10.0, SimTimeUnit::ns), record, &l_trace, 1);
+  l_sched.schedule(SimTime(20.0, SimTimeUnit::ns), record, &l_trace, 2);
+  REQUIRE(l_sched.pending() == 3);
+  REQUIRE(*l_sched.nextEventTime() == SimTime(10.0, SimTimeUnit::ns));
+  l_sched.run();
+  REQUIRE(l_sched.empty());
+  REQUIRE(l_trace.fired.size() == 3);
+  REQUIRE(l_trace.fired[0].second == 1);
+  REQUIRE(l_trace.fired[1].second == 2);
+  REQUIRE(l_trace.fired[2].second == 3);
+  REQUIRE(l_trace.fired[2].first == SimTime(30.0, SimTimeUnit::ns).ticks());
+  REQUIRE(l_sched.now() == SimTime(30.0, SimTimeUnit::ns));
+  REQUIRE(l_sched.timeSteps() == 3);
+}
+
+TEST_CASE("Scheduler keeps FIFO order for events at the same time") {
+  Scheduler l_sched;
+  Trace l_trace{&l_sched, {}};
+  // Same far-future time so the events travel through heap and every wheel level
+  SimTime l_when(2.0, SimTimeUnit::ms);
+  for (uint64_t l_idx = 0; l_idx < 100; ++l_idx) {
+    l_sched.scheduleAt(l_when, record, &l_trace, l_idx);
+  }
+  l_sched.run();
+  REQUIRE(l_trace.fired.size() == 100);
+  for (uint64_t l_idx = 0; l_idx < 100; ++l_idx) {
+    REQUIRE(l_trace.fired[l_idx].second == l_idx);
+  }
+  REQUIRE(l_sched.timeSteps() == 1);
+}
+
+namespace {
+
+struct DeltaCtx {
+  Scheduler* sched;
+  std::vector<uint32_t> deltas;
+  int hookCalls = 0;
+};
+
+void deltaChain(void* f_ctx, uint64_t f_arg) {
+  auto* l_ctx = static_cast<DeltaCtx*>(f_ctx);
+  l_ctx->deltas.push_back(l_ctx->sched->delta());
+  if (f_arg > 0) {
+    l_ctx->sched->schedule(SimTime(), deltaChain, l_ctx, f_arg - 1);
+  }
+}
+
+void countHook(void* f_ctx) {
+  ++static_cast<DeltaCtx*>(f_ctx)->hookCalls;
+}
+
+}  // namespace
+
+TEST_CASE("Scheduler runs zero-delay events as delta cycles") {
+  Scheduler l_sched;
+  DeltaCtx l_ctx{&l_sched, {}};
+  l_sched.setDeltaHook(countHook, &l_ctx);
+  l_sched.schedule(SimTime(5.0, SimTimeUnit::ns), deltaChain, &l_ctx, 3);
+  REQUIRE(l_sched.step());
+  REQUIRE(l_ctx.deltas == std::vector<uint32_t>{0, 1, 2, 3});
+  REQUIRE(l_ctx.hookCalls == 4);
+  REQUIRE(l_sched.now() == SimTime(5.0, SimTimeUnit::ns));
+  REQUIRE(l_sched.timeSteps() == 1);
+  REQUIRE(l_sched.deltaCycles() == 4);
+  REQUIRE(l_sched.empty());
+}
+
+TEST_CASE("Scheduler runUntil stops at the end time") {
+  Scheduler l_sched;
+  Trace l_trace{&l_sched, {}};
+  l_sched.schedule(SimTime(1.0, SimTimeUnit::us), record, &l_trace, 1);
+  l_sched.schedule(SimTime(3.0, SimTimeUnit::us), record, &l_trace, 2);
+  l_sched.runUntil(SimTime(2.0, SimTimeUnit::us));
+  REQUIRE(l_trace.fired.size() == 1);
+  REQUIRE(l_sched.now() == SimTime(2.0, SimTimeUnit::us));
+  // Scheduling relative to the advanced time still lands before the pending event
+  l_sched.schedule(SimTime(500.0, SimTimeUnit::ns), record, &l_trace, 3);
+  l_sched.run();
+  REQUIRE(l_trace.fired.size() == 3);
+  REQUIRE(l_trace.fired[1].second == 3);
+  REQUIRE(l_trace.fired[1].first == SimTime(2.5, SimTimeUnit::us).ticks());
+  REQUIRE(l_trace.fired[2].second == 2);
+}
+
+TEST_CASE("Scheduler matches a sorted reference on random workloads") {
+  std::mt19937_64 l_rng(1234);
+  Scheduler l_sched;
+  Trace l_trace{&l_sched, {}};
+  std::vector<std::pair<SimTick, uint64_t>> l_expected;
+  for (uint64_t l_idx = 0; l_idx < 20000; ++l_idx) {
+    // Mix of same-slot, every wheel level and far-future heap delays
+    SimTick l_delay = l_rng() >> (l_rng() % 64);
+    l_delay %= SimTick(1) << 40;
+    l_sched.scheduleAt(SimTime::fromTicks(l_delay), record, &l_trace, l_idx);
+    l_expected.emplace_back(l_delay, l_idx);
+  }
+  std::stable_sort(l_expected.begin(), l_expected.end(),
+                   [](const auto& f_lhs, const auto& f_rhs) { return f_lhs.first < f_rhs.first; });
+  l_sched.run();
+  REQUIRE(l_trace.fired == l_expected);
+  REQUIRE(l_sched.eventsExecuted() == 20000);
+}
+
+TEST_CASE("Scheduler payload events carry pooled storage") {
+  struct Message {
+    uint64_t id;
+    double value;
+  };
+  struct Sink {
+    std::vector<uint64_t> ids;
+    double sum = 0;
+  } l_sink;
+  Scheduler l_sched;
+  for (uint64_t l_idx = 0; l_idx < 100; ++l_idx) {
+    void* l_storage = l_sched.schedulePayload(
+        SimTime(1.0, SimTimeUnit::ns) * (100 - l_idx),
+        [](void* f_ctx, uint64_t f_arg) {
+          Sink* l_sink = static_cast<Sink*>(f_ctx);
+          const Message* l_msg = reinterpret_cast<const Message*>(f_arg);
+          l_sink->ids.push_back(l_msg->id);
+          l_sink->sum += l_msg->value;
+        },
+        &l_sink, sizeof(Message));
+    *static_cast<Message*>(l_storage) = Message{l_idx, 0.5};
+  }
+  l_sched.run();
+  REQUIRE(l_sink.ids.size() == 100);
+  REQUIRE(l_sink.ids.front() == 99);
+  REQUIRE(l_sink.ids.back() == 0);
+  REQUIRE(l_sink.sum == 50.0);
+}
+
+TEST_CASE("Scheduler step arena is reset at every timestep") {
+  struct State {
+    Scheduler* sched;
+    std::vector<size_t> used;
+  } l_state{nullptr, {}};
+  Scheduler l_sched;
+  l_state.sched = &l_sched;
+  auto l_fill = [](void* f_ctx, uint64_t) {
+    State* l_state = static_cast<State*>(f_ctx);
+    l_state->sched->stepArena().allocate(1000);
+    l_state->used.push_back(l_state->sched->stepArena().used());
+  };
+  for (int l_idx = 0; l_idx < 3; ++l_idx) {
+    l_sched.schedule(SimTime(1.0, SimTimeUnit::ns), l_fill, &l_state);
+    l_sched.schedule(SimTime(2.0, SimTimeUnit::ns), l_fill, &l_state);
+  }
+  l_sched.run();
+  // Three allocations accumulate within a timestep and start over in the next
+  REQUIRE(l_state.used.size() == 6);
+  REQUIRE(l_state.used[2] >= 3000);
+  REQUIRE(l_state.used[3] == l_state.used[0]);
+}
+
+TEST_CASE("Scheduler lists pending events in firing order and resets") {
+  Scheduler l_sched;
+  Trace l_trace{&l_sched, {}};
+  // Spread over the wheel levels and the far-future heap
+  const SimTick l_times[] = {uint64_t(1) << 40, 5, 70000, 5, 300, uint64_t(1) << 33};
+  for (uint64_t l_idx = 0; l_idx < 6; ++l_idx) {
+    l_sched.scheduleAt(SimTime::fromTicks(l_times[l_idx]), record, &l_trace, l_idx);
+  }
+  void* l_payload = l_sched.schedulePayload(SimTime::fromTicks(300), record, &l_trace, 8);
+
+  std::vector<Scheduler::PendingEvent> l_pending = l_sched.pendingEvents();
+  REQUIRE(l_pending.size() == 7);
+  std::vector<uint64_t> l_args;
+  for (const Scheduler::PendingEvent& l_event : l_pending) {
+    l_args.push_back(l_event.payload != nullptr ? 99 : l_event.arg);
+  }
+  REQUIRE(l_args == std::vector<uint64_t>{1, 3, 4, 99, 2, 5, 0});
+  REQUIRE(l_pending[3].payload == l_payload);
+
+  l_sched.reset(SimTime::fromTicks(1000));
+  REQUIRE(l_sched.empty());
+  REQUIRE(l_sched.now().ticks() == 1000);
+  l_sched.scheduleAt(SimTime::fromTicks(1000), record, &l_trace, 7);
+  l_sched.schedule(SimTime::fromTicks(5), record, &l_trace, 8);
+  l_sched.run();
+  REQUIRE(l_trace.fired == std::vector<std::pair<SimTick, uint64_t>>{{1000, 7}, {1005, 8}});
+}
+
+#if GHLS_WIDE_SIMTIME
+TEST_CASE("Scheduler runs past the 64-bit tick limit with wide SimTime") {
+  Scheduler l_sched;
+  Trace l_trace{&l_sched, {}};
+  const SimTick l_limit = SimTick(1) << 64;
+  l_sched.reset(SimTime::fromTicks(l_limit - 100));
+  l_sched.schedule(SimTime::fromTicks(50), record, &l_trace, 1);
+  l_sched.schedule(SimTime::fromTicks(150), record, &l_trace, 2);
+  l_sched.schedule(SimTime::fromTicks(SimTick(1) << 40), record, &l_trace, 3);
+  l_sched.run();
+  REQUIRE(l_trace.fired ==
+          std::vector<std::pair<SimTick, uint64_t>>{{l_limit - 50, 1},
+                                                    {l_limit + 50, 2},
+                                                    {l_limit - 100 + (SimTick(1) << 40), 3}});
+}
+#endif
@@ -1,6 +1,18 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
 #include "../src/simTime.hpp"
+#if GHLS_CHECKED_SIMTIME
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using namespace ghls;
 
@@ -469,11 +481,11 @@ TEST_CASE("SimTime operator* exhaustive tests") {
   }
 
   SECTION("Maximum uint64_t value handling") {
-    SECTION("small time * max uint64_t") {
+    SECTION("small time * max representable cycle count") {
       SimTime t1(1.0, SimTimeUnit::ps);
-      uint64_t max_val = UINT64_MAX;
+      // 1 ps is 1000 fs ticks, so this is the largest cycle count that stays in range
+      uint64_t max_val = UINT64_MAX / 1000;
       SimTime result = t1 * max_val;
-      // Result should be approximately max_val / 1000 nanoseconds
       REQUIRE(result.simTimeInPsec() == Catch::Approx(static_cast<double>(max_val)));
     }
   }
@@ -485,3 +497,287 @@ TEST_CASE("SimTime operator* exhaustive tests") {
     REQUIRE(result.simTimeInMsec() == Catch::Approx(50.0));
   }
 }
+
+TEST_CASE("SimTime integer tick representation") {
+  SECTION("constructors round to femtosecond ticks") {
+    REQUIRE(SimTime(1.0, SimTimeUnit::s).ticks() == 1000000000000000ULL);
+    REQUIRE(SimTime(1.25, SimTimeUnit::ns).ticks() == 1250000ULL);
+    REQUIRE(SimTime(0.5, SimTimeUnit::ps).ticks() == 500ULL);
+    REQUIRE(SimTime(-3.0, SimTimeUnit::ns).ticks() == 0ULL);
+    REQUIRE(SimTime(std::numeric_limits<double>::quiet_NaN(), SimTimeUnit::ns).ticks() == 0ULL);
+#if !GHLS_CHECKED_SIMTIME
+    // Past the last tick saturates instead of wrapping
+    REQUIRE(SimTime(1e40, SimTimeUnit::s).ticks() == std::numeric_limits<SimTick>::max());
+#endif
+    REQUIRE(SimTime::fromTicks(42).ticks() == 42ULL);
+  }
+
+  SECTION("arithmetic and comparisons fold at compile time") {
+    constexpr SimTime l_period(1.25, SimTimeUnit::ns);
+    constexpr SimTime l_edge = l_period * 4 + l_period;
+    static_assert(l_edge.ticks() == 6250000ULL, "constexpr tick arithmetic");
+    static_assert(l_period < l_edge, "constexpr comparison");
+    static_assert(l_edge == SimTime(6.25, SimTimeUnit::ns), "constexpr equality");
+    static_assert(l_edge != l_period, "constexpr inequality");
+    REQUIRE(l_edge.simTimeInNsec() == Catch::Approx(6.25));
+  }
+
+  SECTION("repeated addition does not drift") {
+    SimTime l_period(1.25, SimTimeUnit::ns);
+    SimTime l_acc;
+    for (uint64_t l_cycle = 0; l_cycle < 1000000; ++l_cycle) {
+      l_acc = l_acc + l_period;
+    }
+    REQUIRE(l_acc == l_period * 1000000);
+    REQUIRE(l_acc == SimTime(1.25, SimTimeUnit::ms));
+  }
+}
+
+TEST_CASE("SimTime ordering, difference and container keys") {
+  SimTime l_early(1.0, SimTimeUnit::ns);
+  SimTime l_late(1.5, SimTimeUnit::ns);
+
+  SECTION("relational operators") {
+    REQUIRE(l_early < l_late);
+    REQUIRE(l_early <= l_late);
+    REQUIRE(l_early <= l_early);
+    REQUIRE(l_late > l_early);
+    REQUIRE(l_late >= l_early);
+    REQUIRE(l_late >= l_late);
+    REQUIRE_FALSE(l_late < l_early);
+    REQUIRE_FALSE(l_early > l_late);
+  }
+
+  SECTION("operator- and compound assignment") {
+    REQUIRE((l_late - l_early) == SimTime(500.0, SimTimeUnit::ps));
+    SimTime l_acc = l_early;
+    l_acc += l_late;
+    REQUIRE(l_acc == SimTime(2.5, SimTimeUnit::ns));
+    l_acc -= l_early;
+    REQUIRE(l_acc == l_late);
+    static_assert((SimTime(3.0, SimTimeUnit::us) - SimTime(1.0, SimTimeUnit::us)) ==
+                      SimTime(2.0, SimTimeUnit::us),
+                  "constexpr difference");
+  }
+
+  SECTION("min and max") {
+    REQUIRE(ghls::min(l_early, l_late) == l_early);
+    REQUIRE(ghls::min(l_late, l_early) == l_early);
+    REQUIRE(ghls::max(l_early, l_late) == l_late);
+    REQUIRE(ghls::max(l_late, l_early) == l_late);
+  }
+
+  SECTION("ordered and hashed container keys") {
+    std::map<SimTime, int> l_map;
+    l_map[l_late] = 2;
+    l_map[l_early] = 1;
+    l_map[SimTime(1000.0, SimTimeUnit::ps)] = 3;
+    REQUIRE(l_map.size() == 2);
+    REQUIRE(l_map.begin()->first == l_early);
+    REQUIRE(l_map.begin()->second == 3);
+
+    std::unordered_set<SimTime> l_set{l_early, l_late, SimTime(0.001, SimTimeUnit::us)};
+    REQUIRE(l_set.size() == 2);
+    REQUIRE(l_set.count(SimTime(1.5, SimTimeUnit::ns)) == 1);
+  }
+}
+
+TEST_CASE("formatSimTime writes into caller buffers") {
+  char l_buf[kSimTimeStrMax];
+  auto l_format = [&l_buf](SimTime f_time, SimTimeUnit f_unit) {
+    char* l_end = formatSimTime(l_buf, l_buf + sizeof(l_buf), f_time, f_unit);
+    REQUIRE(l_end != nullptr);
+    return std::string(l_buf, l_end);
+  };
+
+  SECTION("fixed unit output matches conv2str") {
+    REQUIRE(l_format(SimTime(1.5, SimTimeUnit::ms), SimTimeUnit::ms) == "1.50 ms");
+    REQUIRE(l_format(SimTime(1.5, SimTimeUnit::ms), SimTimeUnit::ns) == "1500000.00 ns");
+    REQUIRE(l_format(SimTime(0.000123, SimTimeUnit::s), SimTimeUnit::s) == "0.00 s");
+    REQUIRE(l_format(SimTime(1.0, SimTimeUnit::ps), SimTimeUnit::ns) == "0.00 ns");
+    REQUIRE(l_format(SimTime(), SimTimeUnit::ps) == "0.00 ps");
+    REQUIRE(conv2str(SimTime(2.25, SimTimeUnit::us), SimTimeUnit::ns) == "2250.00 ns");
+  }
+
+  SECTION("rounds half away from zero on the exact value") {
+    REQUIRE(l_format(SimTime(0.125, SimTimeUnit::ns), SimTimeUnit::ns) == "0.13 ns");
+    REQUIRE(l_format(SimTime(0.124, SimTimeUnit::ns), SimTimeUnit::ns) == "0.12 ns");
+    REQUIRE(l_format(SimTime(1.999, SimTimeUnit::us), SimTimeUnit::us) == "2.00 us");
+  }
+
+  SECTION("best unit selection") {
+    REQUIRE(bestUnit(SimTime()) == SimTimeUnit::ns);
+    REQUIRE(bestUnit(SimTime(1500.0, SimTimeUnit::ns)) == SimTimeUnit::us);
+    REQUIRE(bestUnit(SimTime(999.0, SimTimeUnit::ps)) == SimTimeUnit::ps);
+    REQUIRE(bestUnit(SimTime(2.0, SimTimeUnit::s)) == SimTimeUnit::s);
+    char* l_end = formatSimTime(l_buf, l_buf + sizeof(l_buf), SimTime(1500.0, SimTimeUnit::ns));
+    REQUIRE(std::string(l_buf, l_end) == "1.50 us");
+  }
+
+  SECTION("largest tick count fits kSimTimeStrMax") {
+    REQUIRE(l_format(SimTime::fromTicks(UINT64_MAX), SimTimeUnit::ps) ==
+            "18446744073709551.62 ps");
+  }
+
+  SECTION("too small buffer reports failure") {
+    REQUIRE(formatSimTime(l_buf, l_buf + 6, SimTime(1.5, SimTimeUnit::ms), SimTimeUnit::ms) ==
+            nullptr);
+    REQUIRE(formatSimTime(l_buf, l_buf + 7, SimTime(1.5, SimTimeUnit::ms), SimTimeUnit::ms) ==
+            l_buf + 7);
+  }
+
+  SECTION("appendSimTime reuses the string") {
+    std::string l_line = "t=";
+    appendSimTime(l_line, SimTime(3.0, SimTimeUnit::ns));
+    REQUIRE(l_line == "t=3.00 ns");
+  }
+}
+
+TEST_CASE("SimTime literals resolve at compile time") {
+  SECTION("literals carry their ticks in the type") {
+    static_assert(std::is_same<decltype(1.25_ns), StaticSimTime<1250000>>::value, "1.25 ns");
+    static_assert(decltype(10_ps)::kValue == 10000, "integer literal");
+    static_assert((1_s).ticks() == 1000000000000000ULL, "seconds");
+    static_assert((2_ms).ticks() == 2000000000000ULL, "milliseconds");
+    static_assert((3_us).ticks() == 3000000000ULL, "microseconds");
+    static_assert((7_fs).ticks() == 7, "femtoseconds");
+    REQUIRE(SimTime(1.25_ns) == SimTime(1.25, SimTimeUnit::ns));
+    REQUIRE(SimTime(0.5_ps) == SimTime(0.5, SimTimeUnit::ps));
+  }
+
+  SECTION("decimal spellings convert exactly") {
+    static_assert((1'000_ps).ticks() == (1_ns).ticks(), "digit separators");
+    static_assert((1.5e3_ps).ticks() == (1.5_ns).ticks(), "exponent");
+    static_assert((2500e-3_ns).ticks() == (2.5_ns).ticks(), "negative exponent");
+    static_assert((0.1_ns).ticks() == 100000, "no binary rounding error");
+    static_assert((0.0005_ps).ticks() == 1, "half a tick rounds up");
+    static_assert((0.0004_ps).ticks() == 0, "less than half a tick rounds down");
+    static_assert((18446.744073709551615_s).ticks() == UINT64_MAX, "largest time");
+    REQUIRE((0.3_ns).ticks() == 300000);
+  }
+
+  SECTION("invalid and overflowing spellings are reported") {
+    REQUIRE_FALSE(detail::parseLiteralTicks("0x10", 6).valid);
+    REQUIRE_FALSE(detail::parseLiteralTicks("017", 6).valid);
+    REQUIRE_FALSE(detail::parseLiteralTicks("1e", 6).valid);
+#if !GHLS_WIDE_SIMTIME
+    REQUIRE(detail::parseLiteralTicks("18447", 15).overflow);
+    REQUIRE(detail::parseLiteralTicks("1e20", 0).overflow);
+#endif
+    REQUIRE(detail::parseLiteralTicks("1e40", 0).overflow);
+    REQUIRE(detail::parseLiteralTicks("0e99", 0).ticks == 0);
+  }
+
+  SECTION("arithmetic stays static until a runtime value joins") {
+    constexpr auto l_edge = 1.25_ns + 250_ps;
+    static_assert(std::is_same<decltype(l_edge), const StaticSimTime<1500000>>::value, "sum");
+    static_assert(std::is_same<decltype(1_ns - 250_ps), StaticSimTime<750000>>::value, "diff");
+    uint64_t l_cycles = 4;
+    SimTime l_at = 1.25_ns * l_cycles + SimTime(1.0, SimTimeUnit::ns);
+    REQUIRE(l_at == SimTime(6.0, SimTimeUnit::ns));
+    REQUIRE(10_ps + l_at == SimTime(6.01, SimTimeUnit::ns));
+    REQUIRE(l_at + 10_ps == SimTime(6.01, SimTimeUnit::ns));
+    REQUIRE(7_ns - l_at == 1_ns);
+  }
+}
+
+TEST_CASE("SimTime parses run-time spellings with units") {
+  REQUIRE(parseSimTime("100us") == SimTime(100.0, SimTimeUnit::us));
+  REQUIRE(parseSimTime("1.5 ns") == SimTime(1.5, SimTimeUnit::ns));
+  REQUIRE(parseSimTime("2e3ps ") == SimTime(2.0, SimTimeUnit::ns));
+  REQUIRE(parseSimTime("3ms") == SimTime(3.0, SimTimeUnit::ms));
+  REQUIRE(parseSimTime("1s") == SimTime(1.0, SimTimeUnit::s));
+  REQUIRE(parseSimTime("7fs") == SimTime::fromTicks(7));
+  REQUIRE(parseSimTime("0ns") == SimTime());
+
+  REQUIRE_FALSE(parseSimTime("100").has_value());
+  REQUIRE_FALSE(parseSimTime("ns").has_value());
+  REQUIRE_FALSE(parseSimTime("").has_value());
+  REQUIRE_FALSE(parseSimTime("-1ns").has_value());
+  REQUIRE_FALSE(parseSimTime("1.2.3ns").has_value());
+  REQUIRE_FALSE(parseSimTime("10 min").has_value());
+  REQUIRE_FALSE(parseSimTime("1e40s").has_value());
+}
+
+TEST_CASE("SimTime tick range follows the build configuration") {
+  SECTION("tick width") {
+    REQUIRE(sizeof(SimTick) == (GHLS_WIDE_SIMTIME ? 16 : 8));
+    REQUIRE(kMaxSimTick == ~SimTick(0));
+    REQUIRE(sizeof(SimTime) == sizeof(SimTick));
+  }
+
+  SECTION("formatTicks writes every digit of the largest tick count") {
+    char l_buf[kSimTimeStrMax];
+    char* l_end = formatTicks(l_buf, l_buf + sizeof(l_buf), kMaxSimTick);
+    REQUIRE(l_end != nullptr);
+    REQUIRE(std::string(l_buf, l_end) ==
+            (GHLS_WIDE_SIMTIME ? "340282366920938463463374607431768211455"
+                               : "18446744073709551615"));
+    REQUIRE(formatTicks(l_buf, l_buf + 2, 100) == nullptr);
+    l_end = formatTicks(l_buf, l_buf + 1, 0);
+    REQUIRE(std::string(l_buf, l_end) == "0");
+  }
+
+  SECTION("in-range arithmetic is unaffected by the checks") {
+    SimTime l_time = SimTime::fromTicks(kMaxSimTick - 10);
+    REQUIRE((l_time + SimTime::fromTicks(10)).ticks() == kMaxSimTick);
+    REQUIRE((l_time - l_time).ticks() == 0);
+    REQUIRE((SimTime::fromTicks(kMaxSimTick / 4) * 4).ticks() == kMaxSimTick - 3);
+    SimTime l_acc;
+    l_acc += SimTime::fromTicks(7);
+    l_acc -= SimTime::fromTicks(7);
+    REQUIRE(l_acc == SimTime());
+  }
+
+#if GHLS_WIDE_SIMTIME
+  SECTION("wide ticks run past the 64-bit limit") {
+    // 24 hours at 1 fs is about 4.7 times what 64 bits hold
+    SimTime l_day(86400.0, SimTimeUnit::s);
+    REQUIRE(l_day.ticks() == SimTick(86400) * 1000000000000000ULL);
+    SimTime l_later = l_day + SimTime(0.001, SimTimeUnit::ps);
+    REQUIRE(l_later.ticks() - l_day.ticks() == 1);
+    REQUIRE(l_later > l_day);
+    REQUIRE(conv2str(l_day, SimTimeUnit::s) == "86400.00 s");
+    REQUIRE((l_day * 1000).simTimeInSec() == Catch::Approx(86400000.0));
+    REQUIRE(std::hash<SimTime>()(l_day) != std::hash<SimTime>()(l_later));
+  }
+#endif
+}
+
+#if GHLS_CHECKED_SIMTIME
+namespace {
+
+// Runs f_fn in a child process and reports whether it aborted
+template <typename Fn>
+bool aborts(Fn f_fn) {
+  pid_t l_child = ::fork();
+  if (l_child == 0) {
+    // Keep the expected diagnostic out of the test output
+    std::freopen("/dev/null", "w", stderr);
+    f_fn();
+    std::_Exit(0);
+  }
+  int l_status = 0;
+  ::waitpid(l_child, &l_status, 0);
+  return WIFSIGNALED(l_status) && WTERMSIG(l_status) == SIGABRT;
+}
+
+}  // namespace
+
+TEST_CASE("Checked SimTime arithmetic aborts on overflow") {
+  volatile SimTick l_max = kMaxSimTick;
+  REQUIRE(aborts([&] { (void)(SimTime::fromTicks(l_max) + SimTime::fromTicks(1)); }));
+  REQUIRE(aborts([&] { (void)(SimTime::fromTicks(1) - SimTime::fromTicks(2)); }));
+  REQUIRE(aborts([&] { (void)(SimTime::fromTicks(l_max / 2 + 1) * 2); }));
+  REQUIRE(aborts([&] {
+    SimTime l_time = SimTime::fromTicks(l_max);
+    l_time += SimTime::fromTicks(1);
+  }));
+  REQUIRE(aborts([&] {
+    SimTime l_time;
+    l_time -= SimTime::fromTicks(1);
+  }));
+  REQUIRE(aborts([] { (void)SimTime(1e40, SimTimeUnit::s); }));
+  REQUIRE_FALSE(aborts([&] { (void)(SimTime::fromTicks(l_max - 1) + SimTime::fromTicks(1)); }));
+}
+#endif
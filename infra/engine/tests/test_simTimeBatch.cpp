@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+#include "../src/simTimeBatch.hpp"
+
+using namespace ghls;
+
+namespace {
+
+std::vector<SimTime> randomTimes(size_t f_count, uint64_t f_seed) {
+  std::mt19937_64 l_rng(f_seed);
+  std::vector<SimTime> l_times;
+  for (size_t l_idx = 0; l_idx < f_count; ++l_idx) {
+    // Spread across the whole tick range, including values above 2^53 and 2^63
+    l_times.push_back(SimTime::fromTicks(l_rng() >> (l_rng() % 64)));
+  }
+  return l_times;
+}
+
+}  // namespace
+
+TEST_CASE("Batch kernels match per-element SimTime operations on every SIMD level") {
+  std::vector<SimdLevel> l_levels = {SimdLevel::scalar};
+  if (detectedSimdLevel() == SimdLevel::avx2) {
+    l_levels.push_back(SimdLevel::avx2);
+  }
+  for (SimdLevel l_level : l_levels) {
+    setSimdLevel(l_level);
+    REQUIRE(activeSimdLevel() == l_level);
+    // Odd lengths exercise the scalar tails behind the vector loops
+    for (size_t l_count : {size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(1001)}) {
+      CAPTURE(static_cast<int>(l_level), l_count);
+      std::vector<SimTime> l_times = randomTimes(l_count, 77 + l_count);
+
+      {  // unit conversion
+        std::vector<double> l_out(l_count);
+        for (SimTimeUnit l_unit : {SimTimeUnit::s, SimTimeUnit::ms, SimTimeUnit::us,
+                                   SimTimeUnit::ns, SimTimeUnit::ps}) {
+          convertTimes(l_times.data(), l_count, l_unit, l_out.data());
+          for (size_t l_idx = 0; l_idx < l_count; ++l_idx) {
+            double l_expected = 0.0;
+            switch (l_unit) {
+              case SimTimeUnit::s: l_expected = l_times[l_idx].simTimeInSec(); break;
+              case SimTimeUnit::ms: l_expected = l_times[l_idx].simTimeInMsec(); break;
+              case SimTimeUnit::us: l_expected = l_times[l_idx].simTimeInUsec(); break;
+              case SimTimeUnit::ns: l_expected = l_times[l_idx].simTimeInNsec(); break;
+              case SimTimeUnit::ps: l_expected = l_times[l_idx].simTimeInPsec(); break;
+            }
+            REQUIRE(l_out[l_idx] == l_expected);
+          }
+        }
+      }
+
+      {  // offset add
+        std::vector<SimTime> l_shifted = l_times;
+        SimTime l_offset(1.25, SimTimeUnit::ns);
+        addOffset(l_shifted.data(), l_count, l_offset);
+        for (size_t l_idx = 0; l_idx < l_count; ++l_idx) {
+          REQUIRE(l_shifted[l_idx] == l_times[l_idx] + l_offset);
+        }
+      }
+
+      {  // cycle scaling
+        std::vector<uint64_t> l_cycles(l_count);
+        for (size_t l_idx = 0; l_idx < l_count; ++l_idx) {
+          l_cycles[l_idx] = l_times[l_idx].ticks();
+        }
+        std::vector<SimTime> l_out(l_count);
+        SimTime l_period(1.25, SimTimeUnit::ns);
+        scaleCycles(l_cycles.data(), l_count, l_period, l_out.data());
+        for (size_t l_idx = 0; l_idx < l_count; ++l_idx) {
+          // Kernels wrap like unchecked tick arithmetic
+          REQUIRE(l_out[l_idx].ticks() == l_period.ticks() * l_cycles[l_idx]);
+        }
+      }
+
+      {  // min/max reduction
+        SimTick l_min = kMaxSimTick;
+        SimTick l_max = 0;
+        for (const SimTime& l_time : l_times) {
+          l_min = std::min(l_min, l_time.ticks());
+          l_max = std::max(l_max, l_time.ticks());
+        }
+        std::pair<SimTime, SimTime> l_range = minMaxTimes(l_times.data(), l_count);
+        REQUIRE(l_range.first.ticks() == l_min);
+        REQUIRE(l_range.second.ticks() == l_max);
+      }
+    }
+  }
+  setSimdLevel(detectedSimdLevel());
+}
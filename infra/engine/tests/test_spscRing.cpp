@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <thread>
+#include "../src/spscRing.hpp"
+
+using namespace ghls;
+
+TEST_CASE("SpscRing reports full and empty") {
+  SpscRing<uint32_t> l_ring(3);
+  REQUIRE(l_ring.capacity() == 4);
+  uint32_t l_value = 0;
+  REQUIRE_FALSE(l_ring.tryPop(l_value));
+  for (uint32_t l_idx = 0; l_idx < 4; ++l_idx) {
+    REQUIRE(l_ring.tryPush(l_idx));
+  }
+  REQUIRE_FALSE(l_ring.tryPush(99));
+  REQUIRE(l_ring.size() == 4);
+  // Wraps around the end of the storage
+  for (uint32_t l_idx = 0; l_idx < 10; ++l_idx) {
+    REQUIRE(l_ring.tryPop(l_value));
+    REQUIRE(l_value == l_idx);
+    REQUIRE(l_ring.tryPush(l_idx + 4));
+  }
+  REQUIRE(l_ring.size() == 4);
+}
+
+TEST_CASE("SpscRing passes values between threads in order") {
+  SpscRing<uint64_t> l_ring(64);
+  const uint64_t kCount = 200000;
+  std::thread l_producer([&] {
+    for (uint64_t l_idx = 0; l_idx < kCount;) {
+      if (l_ring.tryPush(l_idx)) {
+        ++l_idx;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  uint64_t l_expected = 0;
+  bool l_inOrder = true;
+  while (l_expected < kCount) {
+    uint64_t l_value;
+    if (l_ring.tryPop(l_value)) {
+      l_inOrder = l_inOrder && l_value == l_expected;
+      ++l_expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  l_producer.join();
+  REQUIRE(l_inOrder);
+  REQUIRE(l_ring.size() == 0);
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <filesystem>
+#include "../src/waveIndex.hpp"
+
+using namespace ghls;
+
+static std::string tempPath(const char* f_name) {
+  return (std::filesystem::temp_directory_path() / f_name).string();
+}
+
+TEST_CASE("WaveIndex answers value-at-time queries") {
+  std::string l_wavePath = tempPath("ghls_test_index.ghw");
+  std::string l_indexPath = tempPath("ghls_test_index.idx");
+  {
+    WaveWriter l_wave;
+    REQUIRE(l_wave.open(l_wavePath, WaveFormat::binary));
+    WaveSignal l_clk = l_wave.declare("top.clk", 1);
+    WaveSignal l_count = l_wave.declare("top.count", 70);
+    l_wave.declare("top.idle", 8);
+    for (uint64_t l_cycle = 0; l_cycle < 1000; ++l_cycle) {
+      SimTime l_rise = SimTime(10.0, SimTimeUnit::ns) * l_cycle;
+      l_wave.change(l_rise, l_clk, LogicWord{1, 0});
+      LogicWord l_value[2] = {{l_cycle, 0}, {0, l_cycle == 500 ? uint64_t(2) : 0}};
+      l_wave.change(l_rise, l_count, l_value);
+      l_wave.change(l_rise + SimTime(5.0, SimTimeUnit::ns), l_clk, LogicWord{0, 0});
+    }
+    // Two changes at one time, the later one wins
+    l_wave.change(SimTime(20.0, SimTimeUnit::us), l_clk, LogicWord{0, 1});
+    l_wave.change(SimTime(20.0, SimTimeUnit::us), l_clk, LogicWord{1, 1});
+  }
+  REQUIRE(buildWaveIndex(l_wavePath, l_indexPath));
+
+  WaveIndex l_index;
+  REQUIRE(l_index.open(l_indexPath));
+  REQUIRE(l_index.signals() == 3);
+  REQUIRE(l_index.name(1) == "top.count");
+  REQUIRE(l_index.width(1) == 70);
+  REQUIRE(l_index.find("top.clk") == WaveSignal(0));
+  REQUIRE_FALSE(l_index.find("top.missing").has_value());
+  REQUIRE(l_index.changes(0) == 2002);
+  REQUIRE(l_index.changes(1) == 1000);
+  REQUIRE(l_index.changes(2) == 0);
+  REQUIRE(l_index.changeTime(1, 3) == SimTime(30.0, SimTimeUnit::ns));
+
+  REQUIRE(l_index.valueAt(0, SimTime(12.0, SimTimeUnit::ns))->aval == 1);
+  REQUIRE(l_index.valueAt(0, SimTime(15.0, SimTimeUnit::ns))->aval == 0);
+  REQUIRE(l_index.valueAt(0, SimTime(14999.0, SimTimeUnit::ps))->aval == 1);
+  const LogicWord* l_count = l_index.valueAt(1, SimTime(5004.0, SimTimeUnit::ns));
+  REQUIRE(l_count[0].aval == 500);
+  REQUIRE(l_count[1].bval == 2);
+  REQUIRE(l_index.valueAt(1, SimTime(1.0, SimTimeUnit::s))[0].aval == 999);
+  REQUIRE(l_index.valueAt(2, SimTime(1.0, SimTimeUnit::s)) == nullptr);
+  REQUIRE(*l_index.valueAt(0, SimTime(20.0, SimTimeUnit::us)) == LogicWord{1, 1});
+  REQUIRE(l_index.changeAt(0, SimTime(20.0, SimTimeUnit::us)) == uint64_t(2001));
+
+  l_index.close();
+  std::filesystem::remove(l_wavePath);
+  std::filesystem::remove(l_indexPath);
+}
+
+TEST_CASE("WaveIndex rejects files that are not an index") {
+  std::string l_path = tempPath("ghls_test_index_bad.idx");
+  std::FILE* l_file = std::fopen(l_path.c_str(), "wb");
+  std::vector<char> l_junk(256, 'x');
+  std::fwrite(l_junk.data(), 1, l_junk.size(), l_file);
+  std::fclose(l_file);
+  WaveIndex l_index;
+  REQUIRE_FALSE(l_index.open(l_path));
+  REQUIRE_FALSE(l_index.isOpen());
+  REQUIRE_FALSE(l_index.open(tempPath("ghls_test_index_missing.idx")));
+  REQUIRE_FALSE(buildWaveIndex(l_path, tempPath("ghls_test_index_out.idx")));
+  std::filesystem::remove(l_path);
+}
+
+TEST_CASE("WaveIndex refuses to index a truncated waveform") {
+  std::string l_wavePath = tempPath("ghls_test_index_cut.ghw");
+  std::string l_indexPath = tempPath("ghls_test_index_cut.idx");
+  {
+    WaveWriter l_wave;
+    REQUIRE(l_wave.open(l_wavePath, WaveFormat::binary));
+    WaveSignal l_count = l_wave.declare("top.count", 32);
+    for (uint64_t l_cycle = 0; l_cycle < 100000; ++l_cycle) {
+      l_wave.change(SimTime(10.0, SimTimeUnit::ns) * l_cycle, l_count, LogicWord{l_cycle, 0});
+    }
+  }
+  REQUIRE(buildWaveIndex(l_wavePath, l_indexPath));
+  std::filesystem::remove(l_indexPath);
+
+  // As left by a crashed run: the last block is cut short
+  std::filesystem::resize_file(l_wavePath, std::filesystem::file_size(l_wavePath) - 10);
+  WaveStreamReader l_reader;
+  REQUIRE(l_reader.open(l_wavePath));
+  WaveChange l_change;
+  uint64_t l_read = 0;
+  while (l_reader.next(l_change)) {
+    ++l_read;
+  }
+  REQUIRE(l_read < 100000);
+  REQUIRE(l_reader.error());
+  REQUIRE_FALSE(l_reader.eof());
+  REQUIRE_FALSE(buildWaveIndex(l_wavePath, l_indexPath));
+  REQUIRE_FALSE(std::filesystem::exists(l_indexPath));
+  std::filesystem::remove(l_wavePath);
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "../src/waveWriter.hpp"
+
+using namespace ghls;
+
+static std::string tempPath(const char* f_name) {
+  return (std::filesystem::temp_directory_path() / f_name).string();
+}
+
+static std::string readText(const std::string& f_path) {
+  std::ifstream l_file(f_path);
+  std::stringstream l_text;
+  l_text << l_file.rdbuf();
+  return l_text.str();
+}
+
+TEST_CASE("WaveWriter writes VCD value changes") {
+  std::string l_path = tempPath("ghls_test_wave.vcd");
+  WaveWriter l_wave;
+  REQUIRE(l_wave.open(l_path, WaveFormat::vcd));
+  WaveSignal l_clk = l_wave.declare("clk", 1);
+  WaveSignal l_bus = l_wave.declare("bus", 4);
+  l_wave.change(SimTime(), l_clk, LogicWord{0, 0});
+  l_wave.change(SimTime(), l_bus, LogicWord{0x5, 0x2});
+  l_wave.change(SimTime(5.0, SimTimeUnit::ps), l_clk, LogicWord{1, 0});
+  l_wave.change(SimTime(1.0, SimTimeUnit::ns), l_bus, LogicWord{0xa, 0});
+  l_wave.close();
+  REQUIRE(l_wave.changesRecorded() == 4);
+
+  std::string l_text = readText(l_path);
+  REQUIRE(l_text.find("$timescale 1fs $end") != std::string::npos);
+  REQUIRE(l_text.find("$var wire 1 ! clk $end") != std::string::npos);
+  REQUIRE(l_text.find("$var wire 4 \" bus $end") != std::string::npos);
+  std::string l_body = l_text.substr(l_text.find("$enddefinitions $end\n") + 21);
+  REQUIRE(l_body == "#0\n0!\nb01z1 \"\n#5000\n1!\n#1000000\nb1010 \"\n");
+  std::filesystem::remove(l_path);
+}
+
+TEST_CASE("WaveWriter binary output round trips through the stream reader") {
+  std::string l_path = tempPath("ghls_test_wave.ghw");
+  NetStore l_nets;
+  NetId l_bit = l_nets.addNet(1, Logic::zero);
+  NetId l_wide = l_nets.addNet(100, Logic::zero);
+  NetId l_hidden = l_nets.addNet(8, Logic::zero);
+
+  WaveWriter l_wave;
+  REQUIRE(l_wave.open(l_path, WaveFormat::binary));
+  l_wave.declareNet("top.bit", l_nets, l_bit);
+  l_wave.declareNet("top.wide", l_nets, l_wide);
+  // Enough changes to span several blocks
+  const uint64_t kSteps = 20000;
+  for (uint64_t l_step = 1; l_step <= kSteps; ++l_step) {
+    l_nets.writeValue(l_bit, l_step & 1);
+    l_nets.write(l_wide, 1, {l_step, l_step % 3 == 0 ? uint64_t(1) : 0});
+    l_nets.writeValue(l_hidden, l_step);
+    l_nets.commit(SimTime::fromTicks(l_step * 1000));
+    l_wave.dumpChanges(SimTime::fromTicks(l_step * 1000), l_nets);
+  }
+  REQUIRE(l_wave.changesRecorded() == 2 * kSteps);
+  l_wave.close();
+  REQUIRE(l_wave.blocksWritten() > 1);
+
+  WaveStreamReader l_reader;
+  REQUIRE(l_reader.open(l_path));
+  REQUIRE(l_reader.signals().size() == 2);
+  REQUIRE(l_reader.signals()[1].name == "top.wide");
+  REQUIRE(l_reader.signals()[1].width == 100);
+  WaveChange l_change;
+  for (uint64_t l_step = 1; l_step <= kSteps; ++l_step) {
+    REQUIRE(l_reader.next(l_change));
+    REQUIRE(l_change.tick == l_step * 1000);
+    REQUIRE(l_change.signal == 0);
+    REQUIRE(l_change.words[0].aval == (l_step & 1));
+    REQUIRE(l_reader.next(l_change));
+    REQUIRE(l_change.signal == 1);
+    REQUIRE(l_change.words[0].aval == 0);
+    REQUIRE(l_change.words[1].aval == l_step % (uint64_t(1) << 36));
+    REQUIRE(l_change.words[1].bval == (l_step % 3 == 0 ? 1u : 0u));
+  }
+  REQUIRE_FALSE(l_reader.next(l_change));
+  std::filesystem::remove(l_path);
+}
+
+TEST_CASE("WaveWriter merges chunks recorded on several threads by time") {
+  std::string l_path = tempPath("ghls_test_wave_mt.ghw");
+  WaveWriter l_wave;
+  REQUIRE(l_wave.open(l_path, WaveFormat::binary));
+  const unsigned kThreads = 4;
+  for (unsigned l_thread = 0; l_thread < kThreads; ++l_thread) {
+    l_wave.declare("sig" + std::to_string(l_thread), 32);
+  }
+  // Each epoch every thread records 5000 changes, then flush() orders them
+  const uint64_t kPerEpoch = 5000;
+  for (uint64_t l_epoch = 0; l_epoch < 3; ++l_epoch) {
+    std::vector<std::thread> l_threads;
+    for (unsigned l_thread = 0; l_thread < kThreads; ++l_thread) {
+      l_threads.emplace_back([&, l_thread] {
+        for (uint64_t l_idx = 0; l_idx < kPerEpoch; ++l_idx) {
+          uint64_t l_tick = (l_epoch * kPerEpoch + l_idx) * 10 + l_thread;
+          l_wave.change(SimTime::fromTicks(l_tick), l_thread, LogicWord{l_idx, 0});
+        }
+      });
+    }
+    for (std::thread& l_worker : l_threads) {
+      l_worker.join();
+    }
+    l_wave.flush();
+  }
+  l_wave.close();
+
+  WaveStreamReader l_reader;
+  REQUIRE(l_reader.open(l_path));
+  WaveChange l_change;
+  uint64_t l_count = 0;
+  while (l_reader.next(l_change)) {
+    // Ticks are unique and dense, so the merged order is fully determined
+    REQUIRE(l_change.tick == l_count / kThreads * 10 + l_count % kThreads);
+    REQUIRE(l_change.signal == l_count % kThreads);
+    ++l_count;
+  }
+  REQUIRE(l_count == 3 * kPerEpoch * kThreads);
+  std::filesystem::remove(l_path);
+}